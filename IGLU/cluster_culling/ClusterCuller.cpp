@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/cluster_culling/ClusterCuller.h>
+
+#include <IGLU/mesh_cache/MeshCacheReader.h>
+#include <cmath>
+#include <cstddef>
+#include <igl/CommandBuffer.h>
+#include <igl/ComputeCommandEncoder.h>
+#include <igl/ComputePipelineState.h>
+#include <igl/Device.h>
+#include <igl/RenderCommandEncoder.h>
+#include <igl/ShaderCreator.h>
+#include <string>
+#include <vector>
+
+namespace iglu::clusterculling {
+
+namespace {
+
+constexpr uint32_t kThreadgroupSize = 64;
+constexpr size_t kBoundsBufferIndex = 0;
+constexpr size_t kCommandsBufferIndex = 1;
+
+// Shared by all backends: MeshletBounds is read as 3 vec4s and commands as 5 uints
+const char kCullingShaderBody[] = R"(
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+bool isVisible(uint cluster) {
+  vec4 centerRadius = bounds[cluster * 3u];
+  vec3 coneApex = bounds[cluster * 3u + 1u].xyz;
+  vec4 coneAxisCutoff = bounds[cluster * 3u + 2u];
+  for (int i = 0; i < 6; i++) {
+    if (dot(frustumPlanes[i].xyz, centerRadius.xyz) + frustumPlanes[i].w < -centerRadius.w) {
+      return false;
+    }
+  }
+  if (uint(coneCulling) != 0u &&
+      dot(normalize(coneApex - cameraPosition.xyz), coneAxisCutoff.xyz) >= coneAxisCutoff.w) {
+    return false;
+  }
+  return true;
+}
+
+void main() {
+  uint cluster = gl_GlobalInvocationID.x;
+  if (cluster < uint(numClusters)) {
+    commands[cluster * 5u + 1u] = isVisible(cluster) ? 1u : 0u;
+  }
+}
+)";
+
+std::string getVulkanShaderSource() {
+  return std::string(R"(
+layout (push_constant) uniform CullingParams {
+  vec4 frustumPlanes[6];
+  vec4 cameraPosition;
+  uint numClusters;
+  uint coneCulling;
+};
+layout (set = 2, binding = 0, std430) readonly buffer Bounds {
+  vec4 bounds[];
+};
+layout (set = 2, binding = 1, std430) writeonly buffer Commands {
+  uint commands[];
+};
+)") + kCullingShaderBody;
+}
+
+std::string getOpenGLShaderSource(igl::ShaderVersion shaderVersion) {
+  std::string shader = shaderVersion.family == igl::ShaderFamily::GlslEs
+                           ? "#version 310 es\nprecision highp float;\n"
+                           : "#version 430\n";
+  shader += R"(
+uniform vec4 frustumPlanes[6];
+uniform vec4 cameraPosition;
+uniform int numClusters;
+uniform int coneCulling;
+layout (std430, binding = 0) readonly buffer Bounds {
+  vec4 bounds[];
+};
+layout (std430, binding = 1) writeonly buffer Commands {
+  uint commands[];
+};
+)";
+  return shader + kCullingShaderBody;
+}
+
+std::unique_ptr<igl::IShaderStages> createShaderStages(igl::IDevice& device,
+                                                       igl::Result* IGL_NULLABLE outResult) {
+  switch (device.getBackendType()) {
+  case igl::BackendType::Invalid:
+    IGL_ASSERT_NOT_REACHED();
+    return nullptr;
+  case igl::BackendType::Vulkan: {
+    const std::string source = getVulkanShaderSource();
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, source.c_str(), "main", "Shader Module: cluster culling", outResult);
+  }
+  // @fb-only
+    // @fb-only
+    // @fb-only
+  case igl::BackendType::Metal:
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Cluster culling is not supported on Metal");
+    return nullptr;
+  case igl::BackendType::OpenGL: {
+    const std::string source = getOpenGLShaderSource(device.getShaderVersion());
+    return igl::ShaderStagesCreator::fromModuleStringInput(
+        device, source.c_str(), "main", "Shader Module: cluster culling", outResult);
+  }
+  }
+  IGL_UNREACHABLE_RETURN(nullptr)
+}
+
+} // namespace
+
+void extractFrustumPlanes(const float viewProj[16], bool depthZeroToOne, float outPlanes[6][4]) {
+  // rows of the column-major matrix
+  auto row = [viewProj](int r, int c) { return viewProj[c * 4 + r]; };
+  for (int c = 0; c != 4; c++) {
+    outPlanes[0][c] = row(3, c) + row(0, c);
+    outPlanes[1][c] = row(3, c) - row(0, c);
+    outPlanes[2][c] = row(3, c) + row(1, c);
+    outPlanes[3][c] = row(3, c) - row(1, c);
+    outPlanes[4][c] = depthZeroToOne ? row(2, c) : row(3, c) + row(2, c);
+    outPlanes[5][c] = row(3, c) - row(2, c);
+  }
+  for (int p = 0; p != 6; p++) {
+    float* plane = outPlanes[p];
+    const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+    if (length > 0.0f) {
+      for (int c = 0; c != 4; c++) {
+        plane[c] /= length;
+      }
+    }
+  }
+}
+
+bool isClusterVisible(const meshcache::MeshletBounds& bounds, const CullingParams& params) {
+  for (const auto& plane : params.frustumPlanes) {
+    const float distance = plane[0] * bounds.center[0] + plane[1] * bounds.center[1] +
+                           plane[2] * bounds.center[2] + plane[3];
+    if (distance < -bounds.radius) {
+      return false;
+    }
+  }
+  if (params.coneCulling) {
+    float view[3] = {bounds.coneApex[0] - params.cameraPosition[0],
+                     bounds.coneApex[1] - params.cameraPosition[1],
+                     bounds.coneApex[2] - params.cameraPosition[2]};
+    const float length = std::sqrt(view[0] * view[0] + view[1] * view[1] + view[2] * view[2]);
+    const float cosAngle = length > 0.0f ? (view[0] * bounds.coneAxis[0] +
+                                            view[1] * bounds.coneAxis[1] +
+                                            view[2] * bounds.coneAxis[2]) /
+                                               length
+                                         : 0.0f;
+    if (cosAngle >= bounds.coneCutoff) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<ClusterCuller> ClusterCuller::create(igl::IDevice& device,
+                                                     meshcache::MeshCacheReader& reader,
+                                                     igl::Result* IGL_NULLABLE outResult) {
+  size_t numMeshlets = 0;
+  size_t numBounds = 0;
+  size_t numVertices = 0;
+  size_t numTriangles = 0;
+  const auto* meshlets =
+      reader.getChunk<meshcache::Meshlet>(meshcache::ChunkId::Meshlets, numMeshlets, outResult);
+  if (!meshlets) {
+    return nullptr;
+  }
+  const auto* bounds = reader.getChunk<meshcache::MeshletBounds>(
+      meshcache::ChunkId::MeshletBounds, numBounds, outResult);
+  if (!bounds) {
+    return nullptr;
+  }
+  const auto* vertices =
+      reader.getChunk<uint32_t>(meshcache::ChunkId::MeshletVertices, numVertices, outResult);
+  if (!vertices) {
+    return nullptr;
+  }
+  const auto* triangles =
+      reader.getChunk<uint8_t>(meshcache::ChunkId::MeshletTriangles, numTriangles, outResult);
+  if (!triangles) {
+    return nullptr;
+  }
+  if (numBounds != numMeshlets) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::InvalidOperation, "Meshlet bounds count mismatch");
+    return nullptr;
+  }
+  for (size_t i = 0; i != numMeshlets; i++) {
+    const meshcache::Meshlet& m = meshlets[i];
+    if (size_t(m.vertexOffset) + m.vertexCount > numVertices ||
+        size_t(m.triangleOffset) + size_t(m.triangleCount) * 3 > numTriangles) {
+      igl::Result::setResult(outResult, igl::Result::Code::InvalidOperation, "Corrupt meshlet");
+      return nullptr;
+    }
+  }
+  return create(device, meshlets, bounds, numMeshlets, vertices, triangles, outResult);
+}
+
+std::unique_ptr<ClusterCuller> ClusterCuller::create(
+    igl::IDevice& device,
+    const meshcache::Meshlet* IGL_NONNULL meshlets,
+    const meshcache::MeshletBounds* IGL_NONNULL bounds,
+    size_t numMeshlets,
+    const uint32_t* IGL_NONNULL meshletVertices,
+    const uint8_t* IGL_NONNULL meshletTriangles,
+    igl::Result* IGL_NULLABLE outResult) {
+  if (!device.hasFeature(igl::DeviceFeatures::Compute) ||
+      !device.hasFeature(igl::DeviceFeatures::DrawIndexedIndirect)) {
+    igl::Result::setResult(outResult,
+                           igl::Result::Code::Unsupported,
+                           "Cluster culling requires compute and indirect draws");
+    return nullptr;
+  }
+  if (numMeshlets == 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "No meshlets");
+    return nullptr;
+  }
+
+  // Expand the meshlets into a regular index buffer with one draw command per meshlet
+  std::vector<uint32_t> indices;
+  std::vector<DrawIndexedIndirectCommand> commands(numMeshlets);
+  for (size_t i = 0; i != numMeshlets; i++) {
+    const meshcache::Meshlet& m = meshlets[i];
+    commands[i].indexCount = m.triangleCount * 3;
+    commands[i].instanceCount = 1;
+    commands[i].firstIndex = static_cast<uint32_t>(indices.size());
+    for (uint32_t j = 0; j != m.triangleCount * 3; j++) {
+      indices.push_back(meshletVertices[m.vertexOffset + meshletTriangles[m.triangleOffset + j]]);
+    }
+  }
+
+  auto shaderStages = createShaderStages(device, outResult);
+  if (!shaderStages) {
+    return nullptr;
+  }
+  igl::ComputePipelineDesc desc;
+  desc.shaderStages = std::move(shaderStages);
+  desc.buffersMap[kBoundsBufferIndex] = igl::genNameHandle("Bounds");
+  desc.buffersMap[kCommandsBufferIndex] = igl::genNameHandle("Commands");
+  desc.debugName = "Pipeline: cluster culling";
+
+  std::unique_ptr<ClusterCuller> culler(new ClusterCuller());
+  culler->numClusters_ = static_cast<uint32_t>(numMeshlets);
+  culler->pipelineState_ = device.createComputePipeline(desc, outResult);
+  if (!culler->pipelineState_) {
+    return nullptr;
+  }
+  if (device.getBackendType() == igl::BackendType::OpenGL) {
+    const auto& ps = *culler->pipelineState_;
+    culler->frustumPlanesLocation_ = ps.getIndexByName(igl::genNameHandle("frustumPlanes"));
+    culler->cameraPositionLocation_ = ps.getIndexByName(igl::genNameHandle("cameraPosition"));
+    culler->numClustersLocation_ = ps.getIndexByName(igl::genNameHandle("numClusters"));
+    culler->coneCullingLocation_ = ps.getIndexByName(igl::genNameHandle("coneCulling"));
+  }
+
+  culler->boundsBuffer_ = device.createBuffer(
+      igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Storage,
+                      bounds,
+                      numMeshlets * sizeof(meshcache::MeshletBounds),
+                      igl::ResourceStorage::Private,
+                      0,
+                      "Buffer: cluster bounds"),
+      outResult);
+  if (!culler->boundsBuffer_) {
+    return nullptr;
+  }
+  culler->indexBuffer_ =
+      device.createBuffer(igl::BufferDesc(igl::BufferDesc::BufferTypeBits::Index,
+                                          indices.data(),
+                                          indices.size() * sizeof(uint32_t),
+                                          igl::ResourceStorage::Private,
+                                          0,
+                                          "Buffer: cluster indices"),
+                          outResult);
+  if (!culler->indexBuffer_) {
+    return nullptr;
+  }
+  culler->indirectBuffer_ = device.createBuffer(
+      igl::BufferDesc(
+          igl::BufferDesc::BufferTypeBits::Storage | igl::BufferDesc::BufferTypeBits::Indirect,
+          commands.data(),
+          commands.size() * sizeof(DrawIndexedIndirectCommand),
+          igl::ResourceStorage::Private,
+          0,
+          "Buffer: cluster draw commands"),
+      outResult);
+  if (!culler->indirectBuffer_) {
+    return nullptr;
+  }
+
+  igl::Result::setOk(outResult);
+  return culler;
+}
+
+ClusterCuller::~ClusterCuller() = default;
+
+void ClusterCuller::cull(igl::ICommandBuffer& commandBuffer, const CullingParams& params) {
+  CullingParams p = params;
+  p.numClusters = numClusters_;
+
+  auto encoder = commandBuffer.createComputeCommandEncoder();
+  if (!IGL_VERIFY(encoder)) {
+    return;
+  }
+  encoder->pushDebugGroupLabel("Cluster culling");
+  encoder->bindComputePipelineState(pipelineState_);
+  encoder->bindBuffer(kBoundsBufferIndex, boundsBuffer_, 0);
+  encoder->bindBuffer(kCommandsBufferIndex, indirectBuffer_, 0);
+  if (frustumPlanesLocation_ >= 0) {
+    // OpenGL has no push constants
+    auto bindUniform = [&](int location, igl::UniformType type, size_t count, size_t offset) {
+      igl::UniformDesc desc;
+      desc.location = location;
+      desc.type = type;
+      desc.numElements = count;
+      desc.offset = offset;
+      encoder->bindUniform(desc, &p);
+    };
+    bindUniform(
+        frustumPlanesLocation_, igl::UniformType::Float4, 6, offsetof(CullingParams, frustumPlanes));
+    bindUniform(cameraPositionLocation_,
+                igl::UniformType::Float4,
+                1,
+                offsetof(CullingParams, cameraPosition));
+    bindUniform(
+        numClustersLocation_, igl::UniformType::Int, 1, offsetof(CullingParams, numClusters));
+    bindUniform(
+        coneCullingLocation_, igl::UniformType::Int, 1, offsetof(CullingParams, coneCulling));
+  } else {
+    encoder->bindPushConstants(&p, sizeof(p));
+  }
+
+  igl::Dependencies dependencies;
+  dependencies.buffers[0] = indirectBuffer_.get();
+  encoder->dispatchThreadGroups(
+      igl::Dimensions((numClusters_ + kThreadgroupSize - 1) / kThreadgroupSize, 1, 1),
+      igl::Dimensions(kThreadgroupSize, 1, 1),
+      dependencies);
+  encoder->popDebugGroupLabel();
+  encoder->endEncoding();
+}
+
+igl::Dependencies ClusterCuller::getDependencies() const noexcept {
+  igl::Dependencies dependencies;
+  dependencies.buffers[0] = indirectBuffer_.get();
+  return dependencies;
+}
+
+void ClusterCuller::draw(igl::IRenderCommandEncoder& encoder,
+                         uint32_t firstCluster,
+                         uint32_t numClusters) const {
+  IGL_ASSERT(firstCluster + numClusters <= numClusters_);
+  if (numClusters == 0) {
+    return;
+  }
+  encoder.multiDrawIndexedIndirect(igl::PrimitiveType::Triangle,
+                                   igl::IndexFormat::UInt32,
+                                   *indexBuffer_,
+                                   *indirectBuffer_,
+                                   firstCluster * sizeof(DrawIndexedIndirectCommand),
+                                   numClusters,
+                                   sizeof(DrawIndexedIndirectCommand));
+}
+
+} // namespace iglu::clusterculling
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/mesh_cache/MeshCacheFormat.h>
+#include <igl/CommandBuffer.h>
+#include <igl/Common.h>
+#include <memory>
+
+namespace igl {
+class IComputePipelineState;
+class IDevice;
+class IRenderCommandEncoder;
+} // namespace igl
+
+namespace iglu::meshcache {
+class MeshCacheReader;
+} // namespace iglu::meshcache
+
+namespace iglu::clusterculling {
+
+/// Binary compatible with VkDrawIndexedIndirectCommand and OpenGL's DrawElementsIndirectCommand.
+struct DrawIndexedIndirectCommand {
+  uint32_t indexCount = 0;
+  uint32_t instanceCount = 0;
+  uint32_t firstIndex = 0;
+  int32_t vertexOffset = 0;
+  uint32_t firstInstance = 0;
+};
+
+/// Per-frame inputs of the culling pass, expressed in the space of the meshlet bounds (usually
+/// model space). The layout fits in the 128 bytes of push constants guaranteed by Vulkan.
+struct CullingParams {
+  /// Left, right, bottom, top, near and far planes as (a, b, c, d) with a*x + b*y + c*z + d >= 0
+  /// for points inside the frustum. See extractFrustumPlanes().
+  float frustumPlanes[6][4] = {};
+  /// xyz is the camera position used for cone culling, w is unused.
+  float cameraPosition[4] = {};
+  uint32_t numClusters = 0;
+  /// If zero, only frustum culling is performed.
+  uint32_t coneCulling = 1;
+  uint32_t reserved[2] = {};
+};
+
+static_assert(sizeof(DrawIndexedIndirectCommand) == 20);
+static_assert(sizeof(CullingParams) == 128);
+
+/// Extracts normalized frustum planes from a column-major view-projection matrix. depthZeroToOne
+/// selects the Vulkan clip space depth range [0, 1] instead of the OpenGL range [-1, 1].
+void extractFrustumPlanes(const float viewProj[16], bool depthZeroToOne, float outPlanes[6][4]);
+
+/// CPU reference of the test performed by the culling shader.
+[[nodiscard]] bool isClusterVisible(const meshcache::MeshletBounds& bounds,
+                                    const CullingParams& params);
+
+/// GPU-driven culling and drawing of meshlets ("clusters").
+///
+/// Every meshlet owns one DrawIndexedIndirectCommand covering its triangles in an index buffer
+/// owned by the culler. cull() encodes a compute pass that sets the instance count of each
+/// command to 0 or 1 from frustum and backface cone tests against the MeshletBounds, so a whole
+/// shape is then drawn with a single multiDrawIndexedIndirect() call regardless of the number of
+/// meshlets it contains. Culled commands are skipped by the GPU but not compacted.
+///
+/// Typical frame:
+///
+///   culler->cull(*commandBuffer, params);
+///   auto encoder = commandBuffer->createRenderCommandEncoder(
+///       renderPass, framebuffer, culler->getDependencies(), nullptr);
+///   // bind the render pipeline and the vertex buffer of the mesh cache
+///   for (const Shape& shape : shapes) {
+///     culler->draw(*encoder, shape.firstMeshlet, shape.numMeshlets);
+///   }
+class ClusterCuller final {
+ public:
+  /// Creates a culler for the meshlets of a mesh cache built with MeshBuildOptions::buildMeshlets.
+  /// Meshlet indices refer to the ChunkId::Vertices chunk of the same cache.
+  static std::unique_ptr<ClusterCuller> create(igl::IDevice& device,
+                                               meshcache::MeshCacheReader& reader,
+                                               igl::Result* IGL_NULLABLE outResult);
+
+  static std::unique_ptr<ClusterCuller> create(igl::IDevice& device,
+                                               const meshcache::Meshlet* IGL_NONNULL meshlets,
+                                               const meshcache::MeshletBounds* IGL_NONNULL
+                                                   bounds,
+                                               size_t numMeshlets,
+                                               const uint32_t* IGL_NONNULL meshletVertices,
+                                               const uint8_t* IGL_NONNULL meshletTriangles,
+                                               igl::Result* IGL_NULLABLE outResult);
+
+  ~ClusterCuller();
+  ClusterCuller(const ClusterCuller&) = delete;
+  ClusterCuller& operator=(const ClusterCuller&) = delete;
+
+  /// Encodes the culling pass for all clusters. params.numClusters is filled in by the culler.
+  /// Must be called outside of render passes.
+  void cull(igl::ICommandBuffer& commandBuffer, const CullingParams& params);
+
+  /// Pass to ICommandBuffer::createRenderCommandEncoder() so draws observe the results of cull().
+  [[nodiscard]] igl::Dependencies getDependencies() const noexcept;
+
+  /// Draws clusters [firstCluster, firstCluster + numClusters) as triangle lists. The render
+  /// pipeline and the vertex buffer must already be bound.
+  void draw(igl::IRenderCommandEncoder& encoder, uint32_t firstCluster, uint32_t numClusters) const;
+
+  [[nodiscard]] uint32_t getNumClusters() const noexcept {
+    return numClusters_;
+  }
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getIndexBuffer() const noexcept {
+    return indexBuffer_;
+  }
+  [[nodiscard]] const std::shared_ptr<igl::IBuffer>& getIndirectBuffer() const noexcept {
+    return indirectBuffer_;
+  }
+
+ private:
+  ClusterCuller() = default;
+
+  uint32_t numClusters_ = 0;
+  int numClustersLocation_ = -1;
+  int frustumPlanesLocation_ = -1;
+  int cameraPositionLocation_ = -1;
+  int coneCullingLocation_ = -1;
+  std::shared_ptr<igl::IComputePipelineState> pipelineState_;
+  std::shared_ptr<igl::IBuffer> boundsBuffer_;
+  std::shared_ptr<igl::IBuffer> indexBuffer_;
+  std::shared_ptr<igl::IBuffer> indirectBuffer_;
+};
+
+} // namespace iglu::clusterculling
@@ -11,6 +11,7 @@
 #include <IGLU/managedUniformBuffer/ManagedUniformBuffer.h>
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <igl/Macros.h>
 
@@ -30,6 +31,21 @@
 #endif
 
 namespace iglu {
+namespace {
+void extendRange(igl::BufferRange& range, const igl::BufferRange& other) {
+  if (other.size == 0) {
+    return;
+  }
+  if (range.size == 0) {
+    range = other;
+    return;
+  }
+  const size_t start = std::min(range.offset, other.offset);
+  const size_t end = std::max(range.offset + range.size, other.offset + other.size);
+  range = igl::BufferRange(end - start, start);
+}
+} // namespace
+
 ManagedUniformBuffer::ManagedUniformBuffer(igl::IDevice& device,
                                            const ManagedUniformBufferInfo& info) :
   uniformInfo(info) {
@@ -41,11 +57,16 @@ ManagedUniformBuffer::ManagedUniformBuffer(igl::IDevice& device,
     return;
   }
 
+  for (size_t i = 0; i < uniformInfo.uniforms.size(); ++i) {
+    uniformHandleLUT_.insert({igl::genNameHandle(uniformInfo.uniforms[i].name), i});
+  }
+
   // Currently, the OpenGL code path always uses individual uniforms so no need to allocate a
   // buffer.
   bool createBuffer = device.getBackendType() != igl::BackendType::OpenGL;
+  useRing_ = createBuffer && info.numFramesInFlight != 0;
   // Allocate memory
-  if (device.getBackendType() == igl::BackendType::Metal) {
+  if (device.getBackendType() == igl::BackendType::Metal && !useRing_) {
 #if IGL_PLATFORM_APPLE
 
     // Metal must be page aligned
@@ -92,7 +113,16 @@ ManagedUniformBuffer::ManagedUniformBuffer(igl::IDevice& device,
     result.code = igl::Result::Code::RuntimeError;
     return;
   }
-  if (createBuffer) {
+  if (useRing_) {
+    size_t alignment = 0;
+    device.getFeatureLimits(igl::DeviceFeatureLimits::BufferAlignment, alignment);
+    alignment = std::max(alignment, size_t(16));
+    ringSlotStride_ = ((desc.length + alignment - 1) / alignment) * alignment;
+    maxBindsPerFrame_ = std::max(info.maxBindsPerFrame, 1u);
+    // the first bind has to write the slot in full
+    dirtyRange_ = igl::BufferRange(desc.length, 0);
+    result = createRingBuffer(device);
+  } else if (createBuffer) {
     desc.data = data_;
     desc.type = igl::BufferDesc::BufferTypeBits::Uniform;
     desc.storage = igl::ResourceStorage::Shared;
@@ -146,7 +176,10 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device,
     IGL_ASSERT_MSG(0, "Should not use OpenGL backend on Mac Catalyst, use Metal instead\n");
 #endif
   } else {
-    if (useBindBytes_) {
+    if (useRing_) {
+      const size_t offset = commitRingSlot(device);
+      encoder.bindBuffer(uniformInfo.index, bindTarget, buffer_, offset);
+    } else if (useBindBytes_) {
       encoder.bindBytes(uniformInfo.index, bindTarget, data_, length_);
     } else {
       // Need to ensure the latest data is present in the buffer
@@ -165,7 +198,10 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device, igl::IComputeCommand
   if (device.getBackendType() == igl::BackendType::OpenGL) {
     IGL_ASSERT_MSG(0, "No ComputeEncoder supported for OpenGL\n");
   } else {
-    if (useBindBytes_) {
+    if (useRing_) {
+      const size_t offset = commitRingSlot(device);
+      encoder.bindBuffer(uniformInfo.index, buffer_, offset);
+    } else if (useBindBytes_) {
       encoder.bindBytes(uniformInfo.index, data_, length_);
     } else {
       // Need to ensure the latest data is present in the buffer
@@ -180,7 +216,88 @@ void ManagedUniformBuffer::bind(const igl::IDevice& device, igl::IComputeCommand
   }
 }
 
+igl::Result ManagedUniformBuffer::createRingBuffer(const igl::IDevice& device) {
+  const uint32_t numSlots = uniformInfo.numFramesInFlight * maxBindsPerFrame_;
+  // every slot has to be written in full the first time it is used
+  staleRanges_.assign(numSlots, igl::BufferRange(uniformInfo.length, 0));
+
+  igl::BufferDesc desc;
+  desc.length = ringSlotStride_ * numSlots;
+  desc.type = igl::BufferDesc::BufferTypeBits::Uniform;
+  desc.storage = igl::ResourceStorage::Shared;
+  desc.debugName = "Buffer: managed uniform ring";
+  igl::Result ret;
+  std::shared_ptr<igl::IBuffer> buffer = device.createBuffer(desc, &ret);
+  if (buffer) {
+    // binds recorded before this call keep the previous buffer alive
+    buffer_ = std::move(buffer);
+  }
+  return ret;
+}
+
+void ManagedUniformBuffer::beginFrame() {
+  if (!useRing_) {
+    return;
+  }
+  frameIndex_ = (frameIndex_ + 1) % uniformInfo.numFramesInFlight;
+  bindsInFrame_ = 0;
+  // The slot holding the latest data may belong to this frame and would be overwritten by the
+  // next modification after being bound, so the first bind of the frame writes a new slot
+  forceCommit_ = ringSlot_ / maxBindsPerFrame_ == frameIndex_;
+}
+
+size_t ManagedUniformBuffer::commitRingSlot(const igl::IDevice& device) {
+  if ((dirtyRange_.size == 0 && !forceCommit_) || !buffer_) {
+    return ringSlot_ * ringSlotStride_;
+  }
+
+  if (bindsInFrame_ == maxBindsPerFrame_) {
+    // All slots of this frame may still be read by the GPU. Binds in earlier frames and earlier in
+    // this frame keep reading from the current buffer, which is never written again.
+    IGL_LOG_INFO("ManagedUniformBuffer: more than %u modified binds in a frame, growing the ring\n",
+                 maxBindsPerFrame_);
+    maxBindsPerFrame_ *= 2;
+    const igl::Result ret = createRingBuffer(device);
+    if (!IGL_VERIFY(ret.isOk())) {
+      maxBindsPerFrame_ /= 2;
+      staleRanges_.assign(staleRanges_.size() / 2, igl::BufferRange(uniformInfo.length, 0));
+      // overwrite the last slot of the frame instead of writing out of bounds
+      bindsInFrame_--;
+    }
+  }
+
+  ringSlot_ = frameIndex_ * maxBindsPerFrame_ + bindsInFrame_++;
+  for (auto& staleRange : staleRanges_) {
+    extendRange(staleRange, dirtyRange_);
+  }
+
+  // The slot holds the data from its previous use, numFramesInFlight frames ago, so only the bytes
+  // modified since then need to be written
+  const igl::BufferRange range = staleRanges_[ringSlot_];
+  const size_t slotOffset = ringSlot_ * ringSlotStride_;
+  igl::Result mapResult;
+  void* dst = buffer_->map(igl::BufferRange(range.size, slotOffset + range.offset), &mapResult);
+  if (IGL_VERIFY(dst)) {
+    checked_memcpy(
+        dst, range.size, reinterpret_cast<const uint8_t*>(data_) + range.offset, range.size);
+    buffer_->unmap();
+  }
+  staleRanges_[ringSlot_] = igl::BufferRange();
+  dirtyRange_ = igl::BufferRange();
+  forceCommit_ = false;
+
+  return slotOffset;
+}
+
+void ManagedUniformBuffer::markDirty(const igl::BufferRange& range) {
+  extendRange(dirtyRange_, range);
+}
+
 void* ManagedUniformBuffer::getData() {
+  if (useRing_) {
+    // the caller can modify anything through the returned pointer
+    markDirty(igl::BufferRange(uniformInfo.length, 0));
+  }
   return data_;
 }
 
@@ -215,28 +332,48 @@ bool ManagedUniformBuffer::updateData(const char* name, const void* data, size_t
   if (index >= 0) {
     auto& uniform = uniformInfo.uniforms[index];
     if (strcmp(name, uniform.name.c_str()) == 0) {
-      // If dataSize is smaller than the expected size, we will just update as client requested.
-      // This could mean the user knows only a portion of the uniform data needs updating
-      // However, if dataSize is larger than or equal to what we expect for this uniform, we will
-      // only copy data up to the expected data size for this uniform
-      size_t uniformDataSize = getUniformDataSizeInternal(uniform);
-      if (dataSize > uniformDataSize) {
-        dataSize = uniformDataSize;
-#if IGL_DEBUG
-        IGL_LOG_INFO_ONCE(
-            "IGLU/ManagedBufferBuffer/updateData: dataSize is larger than expected. This could be "
-            "benign. See comments in updateData for more details. \n");
-#endif
-      }
-      char* ptr = reinterpret_cast<char*>(data_);
-      checked_memcpy(ptr + uniform.offset, uniformDataSize, data, dataSize);
-      return true;
+      return updateDataInternal(uniform, data, dataSize);
     }
   }
-  IGL_ASSERT_MSG(0, "call to updateData: uniform with name %s not found, skipping update\n");
+  IGL_ASSERT_MSG(0, "call to updateData: uniform with name %s not found, skipping update\n", name);
+  return false;
+}
+
+bool ManagedUniformBuffer::updateData(const igl::NameHandle& name,
+                                      const void* data,
+                                      size_t dataSize) {
+  auto search = uniformHandleLUT_.find(name);
+  if (search != uniformHandleLUT_.end()) {
+    return updateDataInternal(uniformInfo.uniforms[search->second], data, dataSize);
+  }
+  IGL_ASSERT_MSG(0,
+                 "call to updateData: uniform with name %s not found, skipping update\n",
+                 name.c_str());
   return false;
 }
 
+bool ManagedUniformBuffer::updateDataInternal(igl::UniformDesc& uniform,
+                                              const void* data,
+                                              size_t dataSize) {
+  // If dataSize is smaller than the expected size, we will just update as client requested.
+  // This could mean the user knows only a portion of the uniform data needs updating
+  // However, if dataSize is larger than or equal to what we expect for this uniform, we will
+  // only copy data up to the expected data size for this uniform
+  size_t uniformDataSize = getUniformDataSizeInternal(uniform);
+  if (dataSize > uniformDataSize) {
+    dataSize = uniformDataSize;
+#if IGL_DEBUG
+    IGL_LOG_INFO_ONCE(
+        "IGLU/ManagedBufferBuffer/updateData: dataSize is larger than expected. This could be "
+        "benign. See comments in updateData for more details. \n");
+#endif
+  }
+  char* ptr = reinterpret_cast<char*>(data_);
+  checked_memcpy(ptr + uniform.offset, uniformDataSize, data, dataSize);
+  markDirty(igl::BufferRange(dataSize, uniform.offset));
+  return true;
+}
+
 size_t ManagedUniformBuffer::getUniformDataSize(const char* name) {
   for (auto& uniform : uniformInfo.uniforms) {
     if (strcmp(name, uniform.name.c_str()) == 0) {
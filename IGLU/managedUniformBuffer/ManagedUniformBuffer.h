@@ -8,6 +8,7 @@
 #pragma once
 
 #include <igl/IGL.h>
+#include <unordered_map>
 #include <vector>
 
 namespace igl {
@@ -19,6 +20,15 @@ struct ManagedUniformBufferInfo {
   int index = -1;
   size_t length = 0;
   std::vector<igl::UniformDesc> uniforms;
+  /// If non-zero, the uniforms are stored in a persistently mapped ring buffer with
+  /// numFramesInFlight * maxBindsPerFrame slots, usually numFramesInFlight is the number of
+  /// swapchain images. Each bind() following an update writes only the modified bytes into the
+  /// next slot of the current frame and binds the buffer at the offset of that slot. Call
+  /// ManagedUniformBuffer::beginFrame() once per frame; a frame with more than maxBindsPerFrame
+  /// binds with new data grows the ring. Ignored by the OpenGL backend, which always binds
+  /// individual uniforms.
+  uint32_t numFramesInFlight = 0;
+  uint32_t maxBindsPerFrame = 1;
 };
 
 class ManagedUniformBuffer {
@@ -29,6 +39,8 @@ class ManagedUniformBuffer {
   ~ManagedUniformBuffer();
   // This function takes a chunk of data and use it to update the value of uniform 'name'
   bool updateData(const char* name, const void* data, size_t dataSize);
+  // Same as above, using a lookup table of precomputed offsets built by the constructor
+  bool updateData(const igl::NameHandle& name, const void* data, size_t dataSize);
   // This function returns the expected data size for uniform with given name
   // If uniform has type UniformType::Float3, this function will return
   // 3 * sizeof(float) if elementStride is zero and return elementStride otherwise
@@ -44,16 +56,38 @@ class ManagedUniformBuffer {
             uint8_t bindTarget); // see igl::BindTarget
   void bind(const igl::IDevice& device, igl::IComputeCommandEncoder& encoder);
 
+  // In ring buffer mode, this marks the whole buffer as modified
   void* getData();
 
+  // In ring buffer mode, moves to the slots of the next frame. Slots are reused numFramesInFlight
+  // frames after they were written, so the GPU must be done with the frame by then.
+  void beginFrame();
+
   void buildUnifromLUT();
 
  private:
   size_t getUniformDataSizeInternal(igl::UniformDesc& uniform);
+  bool updateDataInternal(igl::UniformDesc& uniform, const void* data, size_t dataSize);
+  void markDirty(const igl::BufferRange& range);
+  igl::Result createRingBuffer(const igl::IDevice& device);
+  // Writes the modified bytes into the next ring slot and returns the offset of the current slot
+  size_t commitRingSlot(const igl::IDevice& device);
   void* data_ = nullptr;
   int length_ = 0;
   std::shared_ptr<igl::IBuffer> buffer_ = nullptr;
   std::unique_ptr<std::unordered_map<std::string, size_t>> uniformLUT_ = nullptr;
+  std::unordered_map<igl::NameHandle, size_t> uniformHandleLUT_;
+  // Ring buffer mode
+  bool useRing_ = false;
+  size_t ringSlotStride_ = 0;
+  uint32_t ringSlot_ = 0;
+  uint32_t maxBindsPerFrame_ = 1;
+  uint32_t frameIndex_ = 0;
+  uint32_t bindsInFrame_ = 0;
+  bool forceCommit_ = false;
+  // Bytes modified since the last commit, and in each slot, bytes modified since it was written
+  igl::BufferRange dirtyRange_;
+  std::vector<igl::BufferRange> staleRanges_;
 #if IGL_PLATFORM_IOS_SIMULATOR
   /// If we're in the simulator we need to hold onto length so we can deallocate memory buffer
   /// properly.
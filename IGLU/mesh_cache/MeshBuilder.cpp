@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/mesh_cache/MeshBuilder.h>
+
+#include <IGLU/mesh_cache/MeshCacheWriter.h>
+#include <algorithm>
+#include <meshoptimizer.h>
+
+namespace iglu::meshcache {
+
+static_assert(sizeof(Meshlet) == sizeof(meshopt_Meshlet));
+
+namespace {
+
+bool validate(const MeshDesc& desc, igl::Result* IGL_NULLABLE outResult) {
+  const size_t numIndices = desc.indices ? desc.numIndices : desc.numVertices;
+  if (!desc.vertices || desc.numVertices == 0 || numIndices % 3 != 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Invalid mesh");
+    return false;
+  }
+  if (desc.positionOffset + 3 * sizeof(float) > desc.vertexSize) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Position is outside of the vertex");
+    return false;
+  }
+  for (const Shape& shape : desc.shapes) {
+    if (shape.firstIndex % 3 != 0 || shape.numIndices % 3 != 0 ||
+        size_t(shape.firstIndex) + shape.numIndices > numIndices) {
+      igl::Result::setResult(outResult, igl::Result::Code::ArgumentOutOfRange, "Invalid shape");
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+bool buildMeshCache(const MeshDesc& desc,
+                    const MeshBuildOptions& options,
+                    MeshCacheWriter& writer,
+                    igl::Result* IGL_NULLABLE outResult) {
+  if (!validate(desc, outResult)) {
+    return false;
+  }
+
+  const size_t numIndices = desc.indices ? desc.numIndices : desc.numVertices;
+  const size_t vertexSize = desc.vertexSize;
+
+  std::vector<Shape> shapes = desc.shapes;
+  if (shapes.empty()) {
+    shapes.push_back({0, static_cast<uint32_t>(numIndices)});
+  }
+
+  // 1. Weld bitwise identical vertices
+  std::vector<uint32_t> remap(desc.numVertices);
+  size_t numVertices = meshopt_generateVertexRemap(
+      remap.data(), desc.indices, numIndices, desc.vertices, desc.numVertices, vertexSize);
+  std::vector<uint32_t> indices(numIndices);
+  std::vector<uint8_t> vertices(numVertices * vertexSize);
+  meshopt_remapIndexBuffer(indices.data(), desc.indices, numIndices, remap.data());
+  meshopt_remapVertexBuffer(
+      vertices.data(), desc.vertices, desc.numVertices, vertexSize, remap.data());
+
+  auto positions = [&]() {
+    return reinterpret_cast<const float*>(vertices.data() + desc.positionOffset);
+  };
+
+  // 2. Optimize each shape for vertex cache reuse and overdraw
+  for (const Shape& shape : shapes) {
+    uint32_t* shapeIndices = indices.data() + shape.firstIndex;
+    if (options.optimizeVertexCache) {
+      meshopt_optimizeVertexCache(shapeIndices, shapeIndices, shape.numIndices, numVertices);
+    }
+    if (options.overdrawThreshold > 1.0f) {
+      meshopt_optimizeOverdraw(shapeIndices,
+                               shapeIndices,
+                               shape.numIndices,
+                               positions(),
+                               numVertices,
+                               vertexSize,
+                               options.overdrawThreshold);
+    }
+  }
+
+  // 3. Reorder vertices in the order they are referenced
+  if (options.optimizeVertexFetch) {
+    numVertices = meshopt_optimizeVertexFetch(
+        vertices.data(), indices.data(), numIndices, vertices.data(), numVertices, vertexSize);
+    vertices.resize(numVertices * vertexSize);
+  }
+
+  // 4. Split each shape into meshlets
+  std::vector<meshopt_Meshlet> meshlets;
+  std::vector<uint32_t> meshletVertices;
+  std::vector<uint8_t> meshletTriangles;
+  std::vector<MeshletBounds> meshletBounds;
+  if (options.buildMeshlets) {
+    const size_t maxVertices = options.maxMeshletVertices;
+    const size_t maxTriangles = options.maxMeshletTriangles;
+    for (Shape& shape : shapes) {
+      const size_t bound = meshopt_buildMeshletsBound(shape.numIndices, maxVertices, maxTriangles);
+      const size_t firstMeshlet = meshlets.size();
+      const size_t vertexBase = meshletVertices.size();
+      const size_t triangleBase = meshletTriangles.size();
+      meshlets.resize(firstMeshlet + bound);
+      meshletVertices.resize(vertexBase + bound * maxVertices);
+      meshletTriangles.resize(triangleBase + bound * maxTriangles * 3);
+      const size_t numMeshlets = meshopt_buildMeshlets(meshlets.data() + firstMeshlet,
+                                                       meshletVertices.data() + vertexBase,
+                                                       meshletTriangles.data() + triangleBase,
+                                                       indices.data() + shape.firstIndex,
+                                                       shape.numIndices,
+                                                       positions(),
+                                                       numVertices,
+                                                       vertexSize,
+                                                       maxVertices,
+                                                       maxTriangles,
+                                                       options.meshletConeWeight);
+      meshlets.resize(firstMeshlet + numMeshlets);
+      size_t vertexEnd = vertexBase;
+      size_t triangleEnd = triangleBase;
+      for (size_t i = firstMeshlet; i != meshlets.size(); i++) {
+        meshopt_Meshlet& m = meshlets[i];
+        m.vertex_offset += static_cast<uint32_t>(vertexBase);
+        m.triangle_offset += static_cast<uint32_t>(triangleBase);
+        vertexEnd = m.vertex_offset + m.vertex_count;
+        // meshopt_buildMeshlets() keeps triangle offsets 4-byte aligned
+        triangleEnd = m.triangle_offset + ((m.triangle_count * 3 + 3) & ~3u);
+      }
+      meshletVertices.resize(vertexEnd);
+      meshletTriangles.resize(triangleEnd);
+      shape.firstMeshlet = static_cast<uint32_t>(firstMeshlet);
+      shape.numMeshlets = static_cast<uint32_t>(numMeshlets);
+    }
+    meshletBounds.reserve(meshlets.size());
+    for (const meshopt_Meshlet& m : meshlets) {
+      const meshopt_Bounds b = meshopt_computeMeshletBounds(&meshletVertices[m.vertex_offset],
+                                                            &meshletTriangles[m.triangle_offset],
+                                                            m.triangle_count,
+                                                            positions(),
+                                                            numVertices,
+                                                            vertexSize);
+      MeshletBounds& bounds = meshletBounds.emplace_back();
+      std::copy(b.center, b.center + 3, bounds.center);
+      bounds.radius = b.radius;
+      std::copy(b.cone_apex, b.cone_apex + 3, bounds.coneApex);
+      std::copy(b.cone_axis, b.cone_axis + 3, bounds.coneAxis);
+      bounds.coneCutoff = b.cone_cutoff;
+    }
+  }
+
+  // 5. Store everything
+  const bool compressVertices = options.compress && vertexSize % 4 == 0 && vertexSize <= 256;
+  if (!writer.addChunk(ChunkId::Vertices,
+                       vertices.data(),
+                       vertexSize,
+                       numVertices,
+                       compressVertices ? Encoding::MeshoptVertex : Encoding::Raw,
+                       outResult) ||
+      !writer.addChunk(ChunkId::Indices,
+                       indices,
+                       options.compress ? Encoding::MeshoptIndex : Encoding::Raw,
+                       outResult) ||
+      !writer.addChunk(ChunkId::Shapes, shapes, Encoding::Raw, outResult)) {
+    return false;
+  }
+  if (options.buildMeshlets) {
+    if (!writer.addChunk(ChunkId::Meshlets,
+                         meshlets.data(),
+                         sizeof(Meshlet),
+                         meshlets.size(),
+                         Encoding::Raw,
+                         outResult) ||
+        !writer.addChunk(ChunkId::MeshletVertices, meshletVertices, Encoding::Raw, outResult) ||
+        !writer.addChunk(ChunkId::MeshletTriangles, meshletTriangles, Encoding::Raw, outResult) ||
+        !writer.addChunk(ChunkId::MeshletBounds, meshletBounds, Encoding::Raw, outResult)) {
+      return false;
+    }
+  }
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+} // namespace iglu::meshcache
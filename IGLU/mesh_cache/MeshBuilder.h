@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/mesh_cache/MeshCacheFormat.h>
+#include <igl/Common.h>
+#include <vector>
+
+namespace iglu::meshcache {
+
+class MeshCacheWriter;
+
+/// Source geometry for buildMeshCache().
+struct MeshDesc {
+  /// numVertices vertices of vertexSize bytes each. The vertex layout is opaque except for the
+  /// position, which must be 3 floats at positionOffset. Attributes should already be quantized
+  /// to their GPU formats: vertices are compared bitwise when welding duplicates.
+  const void* IGL_NULLABLE vertices = nullptr;
+  size_t numVertices = 0;
+  size_t vertexSize = 0;
+  size_t positionOffset = 0;
+  /// Triangle list. If nullptr, the vertices are an unindexed triangle list.
+  const uint32_t* IGL_NULLABLE indices = nullptr;
+  size_t numIndices = 0;
+  /// Ranges of the index stream (or of the vertices, if unindexed) sharing a material. Only
+  /// firstIndex, numIndices and materialIndex are used. If empty, the whole mesh is one shape.
+  std::vector<Shape> shapes;
+};
+
+struct MeshBuildOptions {
+  bool optimizeVertexCache = true;
+  /// Reorders triangles to reduce overdraw, allowing the vertex cache efficiency to degrade by at
+  /// most overdrawThreshold. Values <= 1 disable the optimization.
+  float overdrawThreshold = 1.05f;
+  bool optimizeVertexFetch = true;
+  /// Build meshlets for each shape
+  bool buildMeshlets = false;
+  uint32_t maxMeshletVertices = 64;
+  uint32_t maxMeshletTriangles = 124;
+  float meshletConeWeight = 0.25f;
+  /// Store vertices and indices with the meshoptimizer codecs. This usually shrinks the file
+  /// 2-4x but those chunks can no longer be uploaded straight from the mapped file.
+  bool compress = false;
+};
+
+/// Welds and optimizes the mesh with meshoptimizer and stores the result in writer as the
+/// ChunkId::Vertices, Indices and Shapes chunks, plus ChunkId::Meshlets, MeshletVertices,
+/// MeshletTriangles and MeshletBounds if options.buildMeshlets is set. Shapes keep their order
+/// and material but their index ranges refer to the optimized index stream.
+bool buildMeshCache(const MeshDesc& desc,
+                    const MeshBuildOptions& options,
+                    MeshCacheWriter& writer,
+                    igl::Result* IGL_NULLABLE outResult);
+
+} // namespace iglu::meshcache
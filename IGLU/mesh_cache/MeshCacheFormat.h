@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/// On-disk layout of IGLU mesh cache files.
+///
+/// A mesh cache file is a FileHeader followed by an array of FileHeader::numChunks ChunkHeader
+/// entries. Every chunk payload starts at an offset aligned to kChunkAlignment so raw chunks can be
+/// used directly from a memory-mapped file, e.g. as the source of IDevice::createBuffer(). All
+/// values are stored little-endian.
+///
+///   FileHeader
+///   ChunkHeader[numChunks]
+///   padding to kChunkAlignment
+///   chunk 0 payload, padding to kChunkAlignment
+///   chunk 1 payload, padding to kChunkAlignment
+///   ...
+namespace iglu::meshcache {
+
+constexpr uint32_t kMagic = 0x4843534D; // "MSCH"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kChunkAlignment = 64;
+
+[[nodiscard]] constexpr uint32_t makeChunkId(char a, char b, char c, char d) noexcept {
+  return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+/// Chunk identifiers produced by MeshBuilder. Applications are free to store their own chunks
+/// (materials, skinning data, etc.) using any other identifier.
+namespace ChunkId {
+/// Vertex stream, one element per vertex. The layout is defined by the application.
+constexpr uint32_t Vertices = makeChunkId('V', 'T', 'X', '0');
+/// 32-bit triangle list indices.
+constexpr uint32_t Indices = makeChunkId('I', 'D', 'X', '0');
+/// Array of Shape.
+constexpr uint32_t Shapes = makeChunkId('S', 'H', 'P', '0');
+/// Array of Meshlet.
+constexpr uint32_t Meshlets = makeChunkId('M', 'L', 'T', '0');
+/// 32-bit indices into the vertex stream referenced by Meshlet::vertexOffset.
+constexpr uint32_t MeshletVertices = makeChunkId('M', 'L', 'V', '0');
+/// 8-bit local triangle indices referenced by Meshlet::triangleOffset.
+constexpr uint32_t MeshletTriangles = makeChunkId('M', 'L', 'I', '0');
+/// Array of MeshletBounds, one per Meshlet.
+constexpr uint32_t MeshletBounds = makeChunkId('M', 'L', 'B', '0');
+} // namespace ChunkId
+
+/// How a chunk payload is stored.
+enum class Encoding : uint32_t {
+  /// Payload is elementSize * count bytes and can be used in place.
+  Raw = 0,
+  /// Payload is compressed with meshopt_encodeVertexBuffer().
+  MeshoptVertex = 1,
+  /// Payload is compressed with meshopt_encodeIndexBuffer(). elementSize must be 4.
+  MeshoptIndex = 2,
+};
+
+struct FileHeader {
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint32_t numChunks = 0;
+  uint32_t flags = 0;
+  /// Total size of the file in bytes, used to detect truncated files.
+  uint64_t fileSize = 0;
+  uint64_t reserved = 0;
+};
+
+struct ChunkHeader {
+  uint32_t id = 0;
+  Encoding encoding = Encoding::Raw;
+  /// Size in bytes of a single decoded element.
+  uint32_t elementSize = 0;
+  uint32_t reserved = 0;
+  /// Number of decoded elements.
+  uint64_t count = 0;
+  /// Offset of the payload from the start of the file. Always a multiple of kChunkAlignment.
+  uint64_t offset = 0;
+  /// Size of the payload in bytes as stored in the file.
+  uint64_t size = 0;
+};
+
+/// A contiguous range of the index stream drawn with a single material.
+struct Shape {
+  uint32_t firstIndex = 0;
+  uint32_t numIndices = 0;
+  uint32_t materialIndex = 0;
+  /// Range of Meshlet entries covering this shape. Both are 0 if meshlets were not built.
+  uint32_t firstMeshlet = 0;
+  uint32_t numMeshlets = 0;
+  uint32_t reserved[3] = {};
+};
+
+/// Binary compatible with meshopt_Meshlet.
+struct Meshlet {
+  uint32_t vertexOffset = 0;
+  uint32_t triangleOffset = 0;
+  uint32_t vertexCount = 0;
+  uint32_t triangleCount = 0;
+};
+
+/// Culling data of a Meshlet, laid out as 3 vec4s so it can be read by shaders as std430 data.
+struct MeshletBounds {
+  /// Bounding sphere: xyz is the center, w the radius.
+  float center[3] = {};
+  float radius = 0.0f;
+  /// Apex of the normal cone, w is unused.
+  float coneApex[3] = {};
+  float reserved = 0.0f;
+  /// Axis of the normal cone, w is the cosine of its half angle. The meshlet is backfacing for
+  /// any viewer for which dot(normalize(coneApex - viewer), coneAxis) >= coneCutoff.
+  float coneAxis[3] = {};
+  float coneCutoff = 1.0f;
+};
+
+static_assert(sizeof(FileHeader) == 32);
+static_assert(sizeof(ChunkHeader) == 40);
+static_assert(sizeof(Shape) == 32);
+static_assert(sizeof(Meshlet) == 16);
+static_assert(sizeof(MeshletBounds) == 48);
+
+} // namespace iglu::meshcache
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/mesh_cache/MeshCacheReader.h>
+
+#include <cstring>
+#include <igl/Device.h>
+#include <meshoptimizer.h>
+
+#if IGL_PLATFORM_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif IGL_PLATFORM_EMSCRIPTEN
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace iglu::meshcache {
+
+/// Read-only mapping of a whole file. Platforms without mmap read the file into memory instead.
+class MeshCacheReader::MappedFile {
+ public:
+  static std::unique_ptr<MappedFile> tryOpen(const std::string& path,
+                                             igl::Result* IGL_NULLABLE outResult) {
+    auto file = std::make_unique<MappedFile>();
+#if IGL_PLATFORM_WIN
+    file->file_ = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (file->file_ == INVALID_HANDLE_VALUE) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open file");
+      return nullptr;
+    }
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file->file_, &size) || size.QuadPart == 0) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot stat file");
+      return nullptr;
+    }
+    file->length_ = static_cast<size_t>(size.QuadPart);
+    file->mapping_ = CreateFileMappingA(file->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!file->mapping_) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map file");
+      return nullptr;
+    }
+    file->data_ =
+        static_cast<const uint8_t*>(MapViewOfFile(file->mapping_, FILE_MAP_READ, 0, 0, 0));
+#elif IGL_PLATFORM_EMSCRIPTEN
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open file");
+      return nullptr;
+    }
+    const long size = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    if (size <= 0 || fseek(f, 0, SEEK_SET) != 0) {
+      fclose(f);
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot stat file");
+      return nullptr;
+    }
+    file->storage_.resize(static_cast<size_t>(size));
+    const size_t read = fread(file->storage_.data(), 1, file->storage_.size(), f);
+    fclose(f);
+    if (read != file->storage_.size() || read == 0) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot read file");
+      return nullptr;
+    }
+    file->data_ = file->storage_.data();
+    file->length_ = file->storage_.size();
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open file");
+      return nullptr;
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+      close(fd);
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot stat file");
+      return nullptr;
+    }
+    file->length_ = static_cast<size_t>(st.st_size);
+    void* ptr = mmap(nullptr, file->length_, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (ptr != MAP_FAILED) {
+      file->data_ = static_cast<const uint8_t*>(ptr);
+    }
+#endif
+    if (!file->data_) {
+      igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot map file");
+      return nullptr;
+    }
+    igl::Result::setOk(outResult);
+    return file;
+  }
+
+  ~MappedFile() {
+#if IGL_PLATFORM_WIN
+    if (data_) {
+      UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+      CloseHandle(mapping_);
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+      CloseHandle(file_);
+    }
+#elif !IGL_PLATFORM_EMSCRIPTEN
+    if (data_) {
+      munmap(const_cast<uint8_t*>(data_), length_);
+    }
+#endif
+  }
+
+  [[nodiscard]] const uint8_t* data() const noexcept {
+    return data_;
+  }
+  [[nodiscard]] size_t length() const noexcept {
+    return length_;
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t length_ = 0;
+#if IGL_PLATFORM_WIN
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#elif IGL_PLATFORM_EMSCRIPTEN
+  std::vector<uint8_t> storage_;
+#endif
+};
+
+std::unique_ptr<MeshCacheReader> MeshCacheReader::tryOpen(const std::string& path,
+                                                          igl::Result* IGL_NULLABLE outResult) {
+  auto file = MappedFile::tryOpen(path, outResult);
+  if (!file) {
+    return nullptr;
+  }
+  const uint8_t* data = file->data();
+  const size_t length = file->length();
+  std::unique_ptr<MeshCacheReader> reader(new MeshCacheReader(std::move(file), data, length));
+  return reader->parse(outResult) ? std::move(reader) : nullptr;
+}
+
+std::unique_ptr<MeshCacheReader> MeshCacheReader::tryCreate(const uint8_t* IGL_NONNULL data,
+                                                            size_t length,
+                                                            igl::Result* IGL_NULLABLE outResult) {
+  if (data == nullptr) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentNull, "data is nullptr.");
+    return nullptr;
+  }
+  std::unique_ptr<MeshCacheReader> reader(new MeshCacheReader(nullptr, data, length));
+  return reader->parse(outResult) ? std::move(reader) : nullptr;
+}
+
+MeshCacheReader::MeshCacheReader(std::unique_ptr<MappedFile> file,
+                                 const uint8_t* IGL_NONNULL data,
+                                 size_t length) noexcept :
+  file_(std::move(file)), data_(data), length_(length) {}
+
+MeshCacheReader::~MeshCacheReader() = default;
+
+bool MeshCacheReader::parse(igl::Result* IGL_NULLABLE outResult) {
+  if (length_ < sizeof(FileHeader)) {
+    igl::Result::setResult(outResult, igl::Result::Code::InvalidOperation, "File is too small");
+    return false;
+  }
+  std::memcpy(&header_, data_, sizeof(FileHeader));
+  if (header_.magic != kMagic) {
+    igl::Result::setResult(outResult, igl::Result::Code::InvalidOperation, "Not a mesh cache");
+    return false;
+  }
+  if (header_.version != kVersion) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::Unsupported, "Unsupported mesh cache version");
+    return false;
+  }
+  if (header_.fileSize != length_ ||
+      header_.numChunks > (length_ - sizeof(FileHeader)) / sizeof(ChunkHeader)) {
+    igl::Result::setResult(outResult, igl::Result::Code::InvalidOperation, "File is truncated");
+    return false;
+  }
+
+  chunks_.resize(header_.numChunks);
+  if (header_.numChunks) {
+    std::memcpy(chunks_.data(), data_ + sizeof(FileHeader), sizeof(ChunkHeader) * chunks_.size());
+  }
+  for (const ChunkHeader& chunk : chunks_) {
+    const bool inBounds = chunk.offset <= length_ && chunk.size <= length_ - chunk.offset;
+    const bool validElements =
+        chunk.elementSize != 0 && chunk.count <= SIZE_MAX / chunk.elementSize;
+    // the same limits MeshCacheWriter::addChunk() enforces, which the meshopt decoders assert on
+    const bool validEncoding =
+        (chunk.encoding == Encoding::Raw && chunk.size == chunk.count * chunk.elementSize) ||
+        (chunk.encoding == Encoding::MeshoptVertex && chunk.elementSize % 4 == 0 &&
+         chunk.elementSize <= 256) ||
+        (chunk.encoding == Encoding::MeshoptIndex && chunk.elementSize == sizeof(uint32_t) &&
+         chunk.count % 3 == 0);
+    if (chunk.offset % kChunkAlignment != 0 || !inBounds || !validElements || !validEncoding) {
+      igl::Result::setResult(outResult, igl::Result::Code::InvalidOperation, "Corrupt chunk table");
+      return false;
+    }
+  }
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+const FileHeader& MeshCacheReader::header() const noexcept {
+  return header_;
+}
+
+const ChunkHeader* IGL_NULLABLE MeshCacheReader::findChunk(uint32_t id) const noexcept {
+  for (const ChunkHeader& chunk : chunks_) {
+    if (chunk.id == id) {
+      return &chunk;
+    }
+  }
+  return nullptr;
+}
+
+const uint8_t* IGL_NULLABLE MeshCacheReader::getChunkData(uint32_t id,
+                                                          igl::Result* IGL_NULLABLE outResult) {
+  const ChunkHeader* chunk = findChunk(id);
+  if (!chunk) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Chunk not found");
+    return nullptr;
+  }
+  const uint8_t* payload = data_ + chunk->offset;
+  if (chunk->encoding == Encoding::Raw) {
+    igl::Result::setOk(outResult);
+    return payload;
+  }
+
+  auto it = decodedChunks_.find(id);
+  if (it != decodedChunks_.end()) {
+    igl::Result::setOk(outResult);
+    return it->second.data();
+  }
+
+  std::vector<uint8_t> decoded(static_cast<size_t>(chunk->count * chunk->elementSize));
+  const size_t count = static_cast<size_t>(chunk->count);
+  const size_t size = static_cast<size_t>(chunk->size);
+  const int error =
+      chunk->encoding == Encoding::MeshoptVertex
+          ? meshopt_decodeVertexBuffer(decoded.data(), count, chunk->elementSize, payload, size)
+          : meshopt_decodeIndexBuffer(decoded.data(), count, sizeof(uint32_t), payload, size);
+  if (error != 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::InvalidOperation, "Cannot decode chunk");
+    return nullptr;
+  }
+
+  igl::Result::setOk(outResult);
+  return decodedChunks_.emplace(id, std::move(decoded)).first->second.data();
+}
+
+std::unique_ptr<igl::IBuffer> MeshCacheReader::createBuffer(igl::IDevice& device,
+                                                            uint32_t id,
+                                                            igl::BufferDesc::BufferType type,
+                                                            igl::Result* IGL_NULLABLE outResult,
+                                                            igl::ResourceStorage storage) {
+  const uint8_t* data = getChunkData(id, outResult);
+  if (!data) {
+    return nullptr;
+  }
+  const ChunkHeader* chunk = findChunk(id);
+  const char name[] = {static_cast<char>(id & 0xFF),
+                       static_cast<char>((id >> 8) & 0xFF),
+                       static_cast<char>((id >> 16) & 0xFF),
+                       static_cast<char>((id >> 24) & 0xFF),
+                       0};
+  return device.createBuffer(igl::BufferDesc(type,
+                                             data,
+                                             static_cast<size_t>(chunk->count * chunk->elementSize),
+                                             storage,
+                                             0,
+                                             std::string("Buffer: mesh cache ") + name),
+                             outResult);
+}
+
+} // namespace iglu::meshcache
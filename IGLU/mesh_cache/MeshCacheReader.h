@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/mesh_cache/MeshCacheFormat.h>
+#include <igl/Buffer.h>
+#include <igl/Common.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace igl {
+class IDevice;
+} // namespace igl
+
+namespace iglu::meshcache {
+
+/// Read-only view of a mesh cache file.
+///
+/// Files are memory-mapped where the platform supports it, so raw chunks are never copied on the
+/// CPU: getChunkData() returns a pointer into the mapping and createBuffer() uploads straight from
+/// it. Compressed chunks are decoded on first access and kept for the lifetime of the reader.
+class MeshCacheReader final {
+ public:
+  /// Maps the file at path and validates its headers.
+  static std::unique_ptr<MeshCacheReader> tryOpen(const std::string& path,
+                                                  igl::Result* IGL_NULLABLE outResult);
+
+  /// Validates a mesh cache that is already in memory. data must outlive the reader and should be
+  /// aligned to kChunkAlignment so typed chunk pointers are suitably aligned.
+  static std::unique_ptr<MeshCacheReader> tryCreate(const uint8_t* IGL_NONNULL data,
+                                                    size_t length,
+                                                    igl::Result* IGL_NULLABLE outResult);
+
+  ~MeshCacheReader();
+  MeshCacheReader(const MeshCacheReader&) = delete;
+  MeshCacheReader& operator=(const MeshCacheReader&) = delete;
+
+  [[nodiscard]] const FileHeader& header() const noexcept;
+  [[nodiscard]] const ChunkHeader* IGL_NULLABLE findChunk(uint32_t id) const noexcept;
+
+  /// Returns the decoded contents of chunk id, which are findChunk(id)->elementSize * count bytes.
+  [[nodiscard]] const uint8_t* IGL_NULLABLE getChunkData(uint32_t id,
+                                                         igl::Result* IGL_NULLABLE outResult);
+
+  /// Returns the decoded contents of chunk id as an array of T. Fails if the chunk element size is
+  /// not sizeof(T).
+  template<typename T>
+  [[nodiscard]] const T* IGL_NULLABLE getChunk(uint32_t id,
+                                               size_t& outCount,
+                                               igl::Result* IGL_NULLABLE outResult) {
+    outCount = 0;
+    const ChunkHeader* chunk = findChunk(id);
+    if (chunk && chunk->elementSize != sizeof(T)) {
+      igl::Result::setResult(
+          outResult, igl::Result::Code::ArgumentInvalid, "Chunk element size mismatch");
+      return nullptr;
+    }
+    const uint8_t* data = getChunkData(id, outResult);
+    if (data) {
+      outCount = static_cast<size_t>(chunk->count);
+    }
+    return reinterpret_cast<const T*>(data);
+  }
+
+  /// Creates a buffer initialized with the decoded contents of chunk id.
+  [[nodiscard]] std::unique_ptr<igl::IBuffer> createBuffer(
+      igl::IDevice& device,
+      uint32_t id,
+      igl::BufferDesc::BufferType type,
+      igl::Result* IGL_NULLABLE outResult,
+      igl::ResourceStorage storage = igl::ResourceStorage::Private);
+
+ private:
+  class MappedFile;
+
+  MeshCacheReader(std::unique_ptr<MappedFile> file,
+                  const uint8_t* IGL_NONNULL data,
+                  size_t length) noexcept;
+
+  [[nodiscard]] bool parse(igl::Result* IGL_NULLABLE outResult);
+
+  std::unique_ptr<MappedFile> file_;
+  const uint8_t* data_;
+  size_t length_;
+  FileHeader header_;
+  std::vector<ChunkHeader> chunks_;
+  std::unordered_map<uint32_t, std::vector<uint8_t>> decodedChunks_;
+};
+
+} // namespace iglu::meshcache
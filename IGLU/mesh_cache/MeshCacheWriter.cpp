@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/mesh_cache/MeshCacheWriter.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <meshoptimizer.h>
+
+namespace iglu::meshcache {
+
+namespace {
+
+constexpr uint64_t alignUp(uint64_t value) noexcept {
+  return (value + kChunkAlignment - 1) & ~static_cast<uint64_t>(kChunkAlignment - 1);
+}
+
+} // namespace
+
+bool MeshCacheWriter::addChunk(uint32_t id,
+                               const void* IGL_NULLABLE data,
+                               size_t elementSize,
+                               size_t count,
+                               Encoding encoding,
+                               igl::Result* IGL_NULLABLE outResult) {
+  if (hasChunk(id)) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Duplicate chunk id");
+    return false;
+  }
+  if (elementSize == 0 || elementSize > UINT32_MAX || (data == nullptr && count != 0)) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentInvalid, "Invalid chunk data");
+    return false;
+  }
+
+  Chunk chunk;
+  chunk.header.id = id;
+  chunk.header.encoding = encoding;
+  chunk.header.elementSize = static_cast<uint32_t>(elementSize);
+  chunk.header.count = count;
+
+  switch (encoding) {
+  case Encoding::Raw: {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    chunk.payload.assign(bytes, bytes + elementSize * count);
+    break;
+  }
+  case Encoding::MeshoptVertex:
+    if (elementSize % 4 != 0 || elementSize > 256) {
+      igl::Result::setResult(outResult,
+                             igl::Result::Code::ArgumentInvalid,
+                             "Vertex codec requires a vertex size that is a multiple of 4 and "
+                             "not larger than 256 bytes");
+      return false;
+    }
+    chunk.payload.resize(meshopt_encodeVertexBufferBound(count, elementSize));
+    chunk.payload.resize(meshopt_encodeVertexBuffer(
+        chunk.payload.data(), chunk.payload.size(), data, count, elementSize));
+    break;
+  case Encoding::MeshoptIndex: {
+    if (elementSize != sizeof(uint32_t) || count % 3 != 0) {
+      igl::Result::setResult(outResult,
+                             igl::Result::Code::ArgumentInvalid,
+                             "Index codec requires a 32-bit triangle list");
+      return false;
+    }
+    const auto* indices = static_cast<const uint32_t*>(data);
+    const size_t vertexCount = count ? size_t(*std::max_element(indices, indices + count)) + 1 : 0;
+    chunk.payload.resize(meshopt_encodeIndexBufferBound(count, vertexCount));
+    chunk.payload.resize(
+        meshopt_encodeIndexBuffer(chunk.payload.data(), chunk.payload.size(), indices, count));
+    break;
+  }
+  default:
+    igl::Result::setResult(outResult, igl::Result::Code::Unsupported, "Unknown chunk encoding");
+    return false;
+  }
+
+  chunk.header.size = chunk.payload.size();
+  chunks_.push_back(std::move(chunk));
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+bool MeshCacheWriter::hasChunk(uint32_t id) const noexcept {
+  return std::any_of(
+      chunks_.begin(), chunks_.end(), [id](const Chunk& c) { return c.header.id == id; });
+}
+
+std::vector<uint8_t> MeshCacheWriter::serialize() const {
+  FileHeader fileHeader;
+  fileHeader.numChunks = static_cast<uint32_t>(chunks_.size());
+
+  std::vector<ChunkHeader> chunkHeaders;
+  chunkHeaders.reserve(chunks_.size());
+
+  uint64_t offset = alignUp(sizeof(FileHeader) + sizeof(ChunkHeader) * chunks_.size());
+  for (const auto& chunk : chunks_) {
+    ChunkHeader header = chunk.header;
+    header.offset = offset;
+    chunkHeaders.push_back(header);
+    offset = alignUp(offset + chunk.payload.size());
+  }
+  fileHeader.fileSize = offset;
+
+  std::vector<uint8_t> out(static_cast<size_t>(offset), 0);
+  std::memcpy(out.data(), &fileHeader, sizeof(fileHeader));
+  if (!chunkHeaders.empty()) {
+    std::memcpy(out.data() + sizeof(fileHeader),
+                chunkHeaders.data(),
+                sizeof(ChunkHeader) * chunkHeaders.size());
+  }
+  for (size_t i = 0; i != chunks_.size(); i++) {
+    if (!chunks_[i].payload.empty()) {
+      std::memcpy(out.data() + chunkHeaders[i].offset,
+                  chunks_[i].payload.data(),
+                  chunks_[i].payload.size());
+    }
+  }
+
+  return out;
+}
+
+bool MeshCacheWriter::writeToFile(const std::string& path,
+                                  igl::Result* IGL_NULLABLE outResult) const {
+  const std::vector<uint8_t> data = serialize();
+
+  FILE* file = fopen(path.c_str(), "wb");
+  if (!file) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot open file");
+    return false;
+  }
+  const bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+  if (fclose(file) != 0 || !written) {
+    igl::Result::setResult(outResult, igl::Result::Code::RuntimeError, "Cannot write file");
+    return false;
+  }
+
+  igl::Result::setOk(outResult);
+  return true;
+}
+
+} // namespace iglu::meshcache
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/mesh_cache/MeshCacheFormat.h>
+#include <igl/Common.h>
+#include <string>
+#include <vector>
+
+namespace iglu::meshcache {
+
+/// Assembles chunks and serializes them into the mesh cache file format.
+class MeshCacheWriter {
+ public:
+  /// Copies count elements of elementSize bytes each into a new chunk. Chunks with encoding
+  /// MeshoptVertex or MeshoptIndex are compressed here.
+  /// Returns false and leaves the writer unchanged if id is already used or the data cannot be
+  /// stored with the requested encoding.
+  bool addChunk(uint32_t id,
+                const void* IGL_NULLABLE data,
+                size_t elementSize,
+                size_t count,
+                Encoding encoding,
+                igl::Result* IGL_NULLABLE outResult);
+
+  template<typename T>
+  bool addChunk(uint32_t id,
+                const std::vector<T>& data,
+                Encoding encoding,
+                igl::Result* IGL_NULLABLE outResult) {
+    return addChunk(id, data.data(), sizeof(T), data.size(), encoding, outResult);
+  }
+
+  [[nodiscard]] bool hasChunk(uint32_t id) const noexcept;
+
+  /// Returns the complete file contents.
+  [[nodiscard]] std::vector<uint8_t> serialize() const;
+
+  bool writeToFile(const std::string& path, igl::Result* IGL_NULLABLE outResult) const;
+
+ private:
+  struct Chunk {
+    ChunkHeader header;
+    std::vector<uint8_t> payload;
+  };
+  std::vector<Chunk> chunks_;
+};
+
+} // namespace iglu::meshcache
@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/render_graph/RenderGraph.h>
+
+#include <algorithm>
+#include <igl/Device.h>
+#include <igl/RenderCommandEncoder.h>
+#include <numeric>
+
+namespace iglu::rendergraph {
+
+namespace {
+
+igl::TextureDesc withoutDebugName(igl::TextureDesc desc) {
+  desc.debugName.clear();
+  return desc;
+}
+
+template<typename F>
+void forEachWrite(const PassDesc& desc, F&& func) {
+  for (const AttachmentWrite& w : desc.colorAttachments) {
+    func(w);
+  }
+  func(desc.depthAttachment);
+  func(desc.stencilAttachment);
+}
+
+} // namespace
+
+RenderGraph::RenderGraph() = default;
+
+RenderGraph::~RenderGraph() = default;
+
+void RenderGraph::reset() {
+  resources_.clear();
+  passes_.clear();
+  isCompiled_ = false;
+  stats_ = {};
+}
+
+ResourceHandle RenderGraph::createTexture(const igl::TextureDesc& desc, std::string name) {
+  Resource resource;
+  resource.name = std::move(name);
+  resource.desc = desc;
+  resources_.emplace_back(std::move(resource));
+  isCompiled_ = false;
+  return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+ResourceHandle RenderGraph::importTexture(std::shared_ptr<igl::ITexture> texture,
+                                          std::string name) {
+  IGL_ASSERT(texture);
+  Resource resource;
+  resource.name = std::move(name);
+  resource.texture = std::move(texture);
+  resource.isImported = true;
+  resources_.emplace_back(std::move(resource));
+  isCompiled_ = false;
+  return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+void RenderGraph::exportTexture(ResourceHandle handle) {
+  if (IGL_VERIFY(isValid(handle))) {
+    resources_[handle].isExported = true;
+    isCompiled_ = false;
+  }
+}
+
+uint32_t RenderGraph::addPass(PassDesc desc) {
+  Pass pass;
+  pass.desc = std::move(desc);
+  passes_.emplace_back(std::move(pass));
+  isCompiled_ = false;
+  return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+std::shared_ptr<igl::ITexture> RenderGraph::getTexture(ResourceHandle handle) const {
+  return isValid(handle) ? resources_[handle].texture : nullptr;
+}
+
+bool RenderGraph::isPassCulled(uint32_t passIndex) const {
+  return passIndex < passes_.size() ? passes_[passIndex].isCulled : true;
+}
+
+const igl::RenderPassDesc& RenderGraph::getRenderPass(uint32_t passIndex) const {
+  static const igl::RenderPassDesc kEmpty;
+  return passIndex < passes_.size() ? passes_[passIndex].renderPass : kEmpty;
+}
+
+igl::Result RenderGraph::compile(igl::IDevice& device) {
+  isCompiled_ = false;
+  stats_ = {};
+  stats_.numPasses = static_cast<uint32_t>(passes_.size());
+
+  for (const Pass& pass : passes_) {
+    const PassDesc& desc = pass.desc;
+    if (desc.colorAttachments.size() > igl::IGL_COLOR_ATTACHMENTS_MAX) {
+      return igl::Result(igl::Result::Code::ArgumentOutOfRange,
+                         "Too many color attachments in render graph pass");
+    }
+    if (desc.reads.size() > igl::Dependencies::IGL_MAX_TEXTURE_DEPENDENCIES) {
+      return igl::Result(igl::Result::Code::ArgumentOutOfRange,
+                         "Too many sampled textures in render graph pass");
+    }
+    bool isValidPass = std::all_of(desc.reads.begin(), desc.reads.end(), [this](auto handle) {
+      return isValid(handle);
+    });
+    forEachWrite(desc, [this, &isValidPass](const AttachmentWrite& w) {
+      isValidPass = isValidPass && (w.resource == kInvalidResource || isValid(w.resource)) &&
+                    (w.resolveResource == kInvalidResource || isValid(w.resolveResource));
+    });
+    if (!isValidPass) {
+      return igl::Result(igl::Result::Code::ArgumentInvalid,
+                         "Invalid resource handle in render graph pass");
+    }
+  }
+
+  cullPasses();
+  inferLoadStoreActions();
+
+  auto result = allocateTextures(device);
+  if (!result.isOk()) {
+    return result;
+  }
+  result = createFramebuffers(device);
+  if (!result.isOk()) {
+    return result;
+  }
+
+  isCompiled_ = true;
+
+  return igl::Result();
+}
+
+void RenderGraph::cullPasses() {
+  // Walk the passes backwards while tracking which resources have their current contents consumed
+  // by a later pass or by the application. A pass survives only if it produces such contents.
+  // Store actions fall out of the same walk: an attachment is stored iff its contents are needed.
+  std::vector<bool> isNeeded(resources_.size());
+  for (size_t i = 0; i != resources_.size(); i++) {
+    isNeeded[i] = resources_[i].isImported || resources_[i].isExported;
+  }
+
+  auto storeAction = [&isNeeded, this](const AttachmentWrite& w) {
+    if (w.resource == kInvalidResource) {
+      return igl::StoreAction::DontCare;
+    }
+    if (isNeeded[w.resource]) {
+      return igl::StoreAction::Store;
+    }
+    stats_.numStoresAvoided++;
+    return w.resolveResource != kInvalidResource ? igl::StoreAction::MsaaResolve
+                                                 : igl::StoreAction::DontCare;
+  };
+
+  for (size_t p = passes_.size(); p-- > 0;) {
+    Pass& pass = passes_[p];
+    const PassDesc& desc = pass.desc;
+
+    bool isLive = desc.hasSideEffects;
+    forEachWrite(desc, [&isNeeded, &isLive](const AttachmentWrite& w) {
+      isLive = isLive || (w.resource != kInvalidResource && isNeeded[w.resource]) ||
+               (w.resolveResource != kInvalidResource && isNeeded[w.resolveResource]);
+    });
+
+    pass.isCulled = !isLive;
+    pass.renderPass = {};
+    pass.framebuffer = nullptr;
+    pass.dependencies = {};
+
+    if (!isLive) {
+      stats_.numCulledPasses++;
+      continue;
+    }
+
+    igl::RenderPassDesc& renderPass = pass.renderPass;
+    renderPass.colorAttachments.resize(desc.colorAttachments.size());
+    for (size_t i = 0; i != desc.colorAttachments.size(); i++) {
+      renderPass.colorAttachments[i].storeAction = storeAction(desc.colorAttachments[i]);
+    }
+    renderPass.depthAttachment.storeAction = storeAction(desc.depthAttachment);
+    renderPass.stencilAttachment.storeAction = storeAction(desc.stencilAttachment);
+
+    // contents written by this pass are consumed only if it loads them; resolves overwrite
+    forEachWrite(desc, [&isNeeded](const AttachmentWrite& w) {
+      if (w.resolveResource != kInvalidResource) {
+        isNeeded[w.resolveResource] = false;
+      }
+      if (w.resource != kInvalidResource && w.clear) {
+        isNeeded[w.resource] = false;
+      }
+    });
+    forEachWrite(desc, [&isNeeded](const AttachmentWrite& w) {
+      if (w.resource != kInvalidResource && !w.clear) {
+        isNeeded[w.resource] = true;
+      }
+    });
+    for (const ResourceHandle handle : desc.reads) {
+      isNeeded[handle] = true;
+    }
+  }
+}
+
+void RenderGraph::inferLoadStoreActions() {
+  // Walk the live passes forwards: an attachment is loaded only if an earlier pass wrote it.
+  std::vector<bool> isWritten(resources_.size());
+  for (size_t i = 0; i != resources_.size(); i++) {
+    Resource& resource = resources_[i];
+    isWritten[i] = resource.isImported;
+    resource.firstPass = ~0u;
+    resource.lastPass = 0;
+  }
+
+  auto use = [this](ResourceHandle handle,
+                    uint32_t passIndex,
+                    igl::TextureDesc::TextureUsage usage) {
+    Resource& resource = resources_[handle];
+    resource.firstPass = std::min(resource.firstPass, passIndex);
+    resource.lastPass = std::max(resource.lastPass, passIndex);
+    if (!resource.isImported) {
+      resource.desc.usage |= usage;
+    }
+  };
+
+  auto loadAction = [&isWritten, this](const AttachmentWrite& w) {
+    if (w.resource == kInvalidResource) {
+      return igl::LoadAction::DontCare;
+    }
+    if (w.clear) {
+      return igl::LoadAction::Clear;
+    }
+    if (isWritten[w.resource]) {
+      return igl::LoadAction::Load;
+    }
+    stats_.numLoadsAvoided++;
+    return igl::LoadAction::DontCare;
+  };
+
+  for (uint32_t p = 0; p != passes_.size(); p++) {
+    Pass& pass = passes_[p];
+    if (pass.isCulled) {
+      continue;
+    }
+    const PassDesc& desc = pass.desc;
+    igl::RenderPassDesc& renderPass = pass.renderPass;
+
+    for (size_t i = 0; i != desc.colorAttachments.size(); i++) {
+      const AttachmentWrite& w = desc.colorAttachments[i];
+      renderPass.colorAttachments[i].loadAction = loadAction(w);
+      renderPass.colorAttachments[i].clearColor = w.clearColor;
+    }
+    renderPass.depthAttachment.loadAction = loadAction(desc.depthAttachment);
+    renderPass.depthAttachment.clearDepth = desc.depthAttachment.clearDepth;
+    renderPass.stencilAttachment.loadAction = loadAction(desc.stencilAttachment);
+    renderPass.stencilAttachment.clearStencil = desc.stencilAttachment.clearStencil;
+
+    forEachWrite(desc, [&isWritten, &use, p](const AttachmentWrite& w) {
+      if (w.resource != kInvalidResource) {
+        isWritten[w.resource] = true;
+        use(w.resource, p, igl::TextureDesc::TextureUsageBits::Attachment);
+      }
+      if (w.resolveResource != kInvalidResource) {
+        isWritten[w.resolveResource] = true;
+        use(w.resolveResource, p, igl::TextureDesc::TextureUsageBits::Attachment);
+      }
+    });
+    for (const ResourceHandle handle : desc.reads) {
+      IGL_ASSERT_MSG(isWritten[handle],
+                     "Render graph pass '%s' samples '%s' before anything writes it",
+                     desc.name.c_str(),
+                     resources_[handle].name.c_str());
+      use(handle, p, igl::TextureDesc::TextureUsageBits::Sampled);
+    }
+  }
+}
+
+igl::Result RenderGraph::allocateTextures(igl::IDevice& device) {
+  for (PhysicalTexture& physical : physicalTextures_) {
+    physical.isUsed = false;
+    physical.isExported = false;
+    physical.lastPass = 0;
+  }
+
+  // place resources in the order their lifetimes start, so a physical texture can be reused as
+  // soon as the last pass of its previous resource is done
+  std::vector<ResourceHandle> order(resources_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](ResourceHandle a, ResourceHandle b) {
+    return resources_[a].firstPass < resources_[b].firstPass;
+  });
+
+  for (const ResourceHandle handle : order) {
+    Resource& resource = resources_[handle];
+    if (resource.isImported) {
+      continue;
+    }
+    resource.texture = nullptr;
+    if (resource.firstPass > resource.lastPass) {
+      // only referenced by culled passes
+      continue;
+    }
+    stats_.numTransientTextures++;
+
+    const igl::TextureDesc desc = withoutDebugName(resource.desc);
+
+    auto it = std::find_if(
+        physicalTextures_.begin(), physicalTextures_.end(), [&](const PhysicalTexture& physical) {
+          if (physical.desc != desc || physical.isExported) {
+            return false;
+          }
+          if (!physical.isUsed) {
+            return true;
+          }
+          return !resource.isExported && physical.lastPass < resource.firstPass;
+        });
+
+    if (it == physicalTextures_.end()) {
+      igl::TextureDesc textureDesc = resource.desc;
+      textureDesc.debugName = resource.name;
+      igl::Result result;
+      auto texture = device.createTexture(textureDesc, &result);
+      if (!result.isOk() || !texture) {
+        return result.isOk() ? igl::Result(igl::Result::Code::RuntimeError,
+                                           "Cannot create render graph texture")
+                             : result;
+      }
+      PhysicalTexture physical;
+      physical.desc = desc;
+      physical.texture = std::move(texture);
+      it = physicalTextures_.insert(physicalTextures_.end(), std::move(physical));
+    }
+
+    it->isUsed = true;
+    it->isExported = resource.isExported;
+    it->lastPass = resource.lastPass;
+    resource.texture = it->texture;
+  }
+
+  // release the textures which were not needed this frame
+  physicalTextures_.erase(
+      std::remove_if(physicalTextures_.begin(),
+                     physicalTextures_.end(),
+                     [](const PhysicalTexture& physical) { return !physical.isUsed; }),
+      physicalTextures_.end());
+
+  stats_.numPhysicalTextures = static_cast<uint32_t>(physicalTextures_.size());
+
+  return igl::Result();
+}
+
+igl::Result RenderGraph::createFramebuffers(igl::IDevice& device) {
+  for (auto& it : framebuffers_) {
+    it.second.isUsed = false;
+  }
+
+  auto getTexture = [this](ResourceHandle handle) {
+    return handle != kInvalidResource ? resources_[handle].texture : nullptr;
+  };
+
+  for (Pass& pass : passes_) {
+    if (pass.isCulled) {
+      continue;
+    }
+    const PassDesc& desc = pass.desc;
+
+    igl::FramebufferDesc framebufferDesc;
+    framebufferDesc.debugName = desc.name;
+    for (size_t i = 0; i != desc.colorAttachments.size(); i++) {
+      framebufferDesc.colorAttachments[i].texture = getTexture(desc.colorAttachments[i].resource);
+      framebufferDesc.colorAttachments[i].resolveTexture =
+          getTexture(desc.colorAttachments[i].resolveResource);
+    }
+    framebufferDesc.depthAttachment.texture = getTexture(desc.depthAttachment.resource);
+    framebufferDesc.depthAttachment.resolveTexture =
+        getTexture(desc.depthAttachment.resolveResource);
+    framebufferDesc.stencilAttachment.texture = getTexture(desc.stencilAttachment.resource);
+    framebufferDesc.stencilAttachment.resolveTexture =
+        getTexture(desc.stencilAttachment.resolveResource);
+
+    std::vector<const igl::ITexture*> key;
+    key.reserve(2 * (desc.colorAttachments.size() + 2));
+    for (size_t i = 0; i != desc.colorAttachments.size(); i++) {
+      key.push_back(framebufferDesc.colorAttachments[i].texture.get());
+      key.push_back(framebufferDesc.colorAttachments[i].resolveTexture.get());
+    }
+    key.push_back(framebufferDesc.depthAttachment.texture.get());
+    key.push_back(framebufferDesc.depthAttachment.resolveTexture.get());
+    key.push_back(framebufferDesc.stencilAttachment.texture.get());
+    key.push_back(framebufferDesc.stencilAttachment.resolveTexture.get());
+
+    CachedFramebuffer& cached = framebuffers_[key];
+    if (!cached.framebuffer) {
+      igl::Result result;
+      cached.framebuffer = device.createFramebuffer(framebufferDesc, &result);
+      if (!result.isOk() || !cached.framebuffer) {
+        framebuffers_.erase(key);
+        return result.isOk() ? igl::Result(igl::Result::Code::RuntimeError,
+                                           "Cannot create render graph framebuffer")
+                             : result;
+      }
+    }
+    cached.isUsed = true;
+    pass.framebuffer = cached.framebuffer;
+
+    // all sampled textures are transitioned together when the render encoder is created
+    for (size_t i = 0; i != desc.reads.size(); i++) {
+      pass.dependencies.textures[i] = resources_[desc.reads[i]].texture.get();
+    }
+  }
+
+  for (auto it = framebuffers_.begin(); it != framebuffers_.end();) {
+    it = it->second.isUsed ? std::next(it) : framebuffers_.erase(it);
+  }
+
+  return igl::Result();
+}
+
+igl::Result RenderGraph::execute(igl::ICommandBuffer& commandBuffer) {
+  if (!isCompiled_) {
+    return igl::Result(igl::Result::Code::InvalidOperation, "The render graph is not compiled");
+  }
+
+  for (const Pass& pass : passes_) {
+    if (pass.isCulled) {
+      continue;
+    }
+    igl::Result result;
+    auto encoder = commandBuffer.createRenderCommandEncoder(
+        pass.renderPass, pass.framebuffer, pass.dependencies, &result);
+    if (!result.isOk() || !encoder) {
+      return result.isOk() ? igl::Result(igl::Result::Code::RuntimeError,
+                                         "Cannot create render graph encoder")
+                           : result;
+    }
+    if (!pass.desc.name.empty()) {
+      encoder->pushDebugGroupLabel(pass.desc.name.c_str());
+    }
+    if (pass.desc.execute) {
+      pass.desc.execute(*encoder);
+    }
+    if (!pass.desc.name.empty()) {
+      encoder->popDebugGroupLabel();
+    }
+    encoder->endEncoding();
+  }
+
+  return igl::Result();
+}
+
+} // namespace iglu::rendergraph
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <functional>
+#include <igl/CommandBuffer.h>
+#include <igl/Common.h>
+#include <igl/Framebuffer.h>
+#include <igl/RenderPass.h>
+#include <igl/Texture.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace igl {
+class IDevice;
+class IRenderCommandEncoder;
+} // namespace igl
+
+namespace iglu::rendergraph {
+
+using ResourceHandle = uint32_t;
+
+constexpr ResourceHandle kInvalidResource = ~0u;
+
+/// An attachment written by a pass. Without `clear`, the pass preserves the contents written by
+/// earlier passes; if there are none, the contents are undefined.
+struct AttachmentWrite {
+  ResourceHandle resource = kInvalidResource;
+  /// Single-sampled texture receiving the MSAA resolve of `resource` at the end of the pass
+  ResourceHandle resolveResource = kInvalidResource;
+  bool clear = false;
+  igl::Color clearColor = {0.0f, 0.0f, 0.0f, 0.0f};
+  float clearDepth = 1.0f;
+  uint32_t clearStencil = 0;
+};
+
+struct PassDesc {
+  std::string name;
+  std::vector<AttachmentWrite> colorAttachments;
+  AttachmentWrite depthAttachment;
+  AttachmentWrite stencilAttachment;
+  /// Textures sampled by the pass. They are transitioned for shader reads before the pass starts.
+  std::vector<ResourceHandle> reads;
+  /// Passes with side effects (e.g. writing buffers) are never culled.
+  bool hasSideEffects = false;
+  std::function<void(igl::IRenderCommandEncoder& encoder)> execute;
+};
+
+/// A per-frame graph of render passes.
+///
+/// Passes declare the textures they render to and the textures they sample instead of hand-picking
+/// load and store actions. compile() then:
+///  - culls passes whose results never reach an imported texture, an exported texture or a pass
+///    with side effects;
+///  - infers the cheapest LoadAction (Clear if requested, Load only if an earlier pass wrote the
+///    attachment, DontCare otherwise) and StoreAction (Store only if a later pass or the
+///    application consumes the contents, MsaaResolve for MSAA attachments which are only
+///    resolved, DontCare otherwise) of every attachment;
+///  - places transient textures with identical descriptors and disjoint lifetimes into the same
+///    physical texture, which is kept across frames together with its framebuffers;
+///  - collects the textures sampled by every pass into the igl::Dependencies of its render
+///    encoder, so the backend transitions all of them with a single batch of barriers.
+///
+///   graph.reset();
+///   const auto gbuffer = graph.createTexture(gbufferDesc, "G-buffer");
+///   const auto backbuffer = graph.importTexture(drawable, "Backbuffer");
+///   graph.addPass({"Geometry", {{gbuffer, kInvalidResource, true}}, {}, {}, {}, false, drawScene});
+///   graph.addPass({"Lighting", {{backbuffer}}, {}, {}, {gbuffer}, false, drawLights});
+///   graph.compile(device);
+///   graph.execute(*commandBuffer);
+///
+/// Execution goes through the regular ICommandBuffer and IRenderCommandEncoder interfaces, so the
+/// graph works with every backend.
+class RenderGraph final {
+ public:
+  struct Stats {
+    uint32_t numPasses = 0;
+    uint32_t numCulledPasses = 0;
+    /// transient textures referenced by the passes which were not culled
+    uint32_t numTransientTextures = 0;
+    /// physical textures backing them after aliasing
+    uint32_t numPhysicalTextures = 0;
+    /// attachments which are not stored because nothing consumes their contents
+    uint32_t numStoresAvoided = 0;
+    /// attachments which are not loaded because nothing wrote them before
+    uint32_t numLoadsAvoided = 0;
+  };
+
+  RenderGraph();
+  ~RenderGraph();
+  RenderGraph(const RenderGraph&) = delete;
+  RenderGraph& operator=(const RenderGraph&) = delete;
+
+  /// Removes all resources and passes. Physical textures and framebuffers are kept and reused by
+  /// the next compile().
+  void reset();
+
+  /// Declares a texture owned by the graph. Its contents do not outlive the frame unless it is
+  /// exported.
+  [[nodiscard]] ResourceHandle createTexture(const igl::TextureDesc& desc, std::string name);
+
+  /// Declares an external texture, e.g. a swapchain image. Imported textures are always stored.
+  [[nodiscard]] ResourceHandle importTexture(std::shared_ptr<igl::ITexture> texture,
+                                             std::string name);
+
+  /// Marks a transient texture as consumed after the graph executes, e.g. by a compute pass or a
+  /// readback. Its physical texture is not shared with other resources of the same frame.
+  void exportTexture(ResourceHandle handle);
+
+  /// Returns the index of the pass.
+  uint32_t addPass(PassDesc desc);
+
+  /// Culls passes, infers load/store actions and creates the textures and framebuffers.
+  igl::Result compile(igl::IDevice& device);
+
+  /// Encodes all passes which were not culled.
+  igl::Result execute(igl::ICommandBuffer& commandBuffer);
+
+  /// The texture backing a resource. Transient textures are available after compile().
+  [[nodiscard]] std::shared_ptr<igl::ITexture> getTexture(ResourceHandle handle) const;
+
+  [[nodiscard]] bool isPassCulled(uint32_t passIndex) const;
+
+  /// The render pass compiled for a pass; only valid after compile().
+  [[nodiscard]] const igl::RenderPassDesc& getRenderPass(uint32_t passIndex) const;
+
+  [[nodiscard]] const Stats& getStats() const noexcept {
+    return stats_;
+  }
+
+ private:
+  struct Resource {
+    std::string name;
+    igl::TextureDesc desc;
+    std::shared_ptr<igl::ITexture> texture;
+    bool isImported = false;
+    bool isExported = false;
+    // the range of live passes using the resource; firstPass > lastPass if there are none
+    uint32_t firstPass = ~0u;
+    uint32_t lastPass = 0;
+  };
+
+  struct Pass {
+    PassDesc desc;
+    bool isCulled = false;
+    igl::RenderPassDesc renderPass;
+    igl::Dependencies dependencies;
+    std::shared_ptr<igl::IFramebuffer> framebuffer;
+  };
+
+  struct PhysicalTexture {
+    igl::TextureDesc desc;
+    std::shared_ptr<igl::ITexture> texture;
+    // the last pass of the resources placed into this texture in the current frame
+    uint32_t lastPass = 0;
+    bool isUsed = false;
+    bool isExported = false;
+  };
+
+  struct CachedFramebuffer {
+    std::shared_ptr<igl::IFramebuffer> framebuffer;
+    bool isUsed = false;
+  };
+
+  void cullPasses();
+  void inferLoadStoreActions();
+  igl::Result allocateTextures(igl::IDevice& device);
+  igl::Result createFramebuffers(igl::IDevice& device);
+  [[nodiscard]] bool isValid(ResourceHandle handle) const {
+    return handle < resources_.size();
+  }
+
+ private:
+  std::vector<Resource> resources_;
+  std::vector<Pass> passes_;
+  std::vector<PhysicalTexture> physicalTextures_;
+  // keyed by the attachment textures of a framebuffer
+  std::map<std::vector<const igl::ITexture*>, CachedFramebuffer> framebuffers_;
+  bool isCompiled_ = false;
+  Stats stats_;
+};
+
+} // namespace iglu::rendergraph
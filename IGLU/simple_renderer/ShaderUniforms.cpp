@@ -12,6 +12,8 @@
 #include <igl/Log.h>
 #include <igl/Uniform.h>
 #if IGL_BACKEND_OPENGL
+#include <igl/opengl/Buffer.h>
+#include <igl/opengl/Device.h>
 #include <igl/opengl/RenderCommandEncoder.h>
 #include <igl/opengl/RenderPipelineState.h>
 #endif
@@ -61,8 +63,18 @@ ShaderUniforms::ShaderUniforms(igl::IDevice& device,
   size_t uniformBufferLimit = 0;
   device.getFeatureLimits(igl::DeviceFeatureLimits::MaxUniformBufferBytes, uniformBufferLimit);
 
-  const bool isSuballocated = device_.getBackendType() == igl::BackendType::Vulkan;
+  bool hasUniformBlockArena = false;
+#if IGL_BACKEND_OPENGL
+  if (device_.getBackendType() == igl::BackendType::OpenGL) {
+    hasUniformBlockArena = igl::opengl::UniformBlockArena::isSupported(
+        static_cast<igl::opengl::Device&>(device_).getContext());
+  }
+#endif
+
   for (const igl::BufferArgDesc& iglDesc : reflection.allUniformBuffers()) {
+    // On OpenGL, uniform blocks are suballocated from the context's uniform block arena
+    const bool isSuballocated = device_.getBackendType() == igl::BackendType::Vulkan ||
+                                (hasUniformBlockArena && iglDesc.isUniformBlock);
     size_t length = iglDesc.bufferDataSize;
     IGL_ASSERT_MSG(length > 0, "unexpected buffer with size 0");
     IGL_ASSERT_MSG(length <= MAX_SUBALLOCATED_BUFFER_SIZE_BYTES &&
@@ -80,7 +92,8 @@ ShaderUniforms::ShaderUniforms(igl::IDevice& device,
     bool createBuffer = false;
     if (device_.getBackendType() == igl::BackendType::OpenGL) {
       // On OpenGL, create buffers only when dealing with uniform blocks (and not single uniforms)
-      createBuffer = iglDesc.isUniformBlock;
+      // that cannot be suballocated from the uniform block arena
+      createBuffer = iglDesc.isUniformBlock && !hasUniformBlockArena;
     } else if (device_.getBackendType() == igl::BackendType::Vulkan) {
       createBuffer = true;
     } else if (device_.getBackendType() == igl::BackendType::Metal) {
@@ -847,15 +860,32 @@ void ShaderUniforms::bindBuffer(igl::IDevice& device,
 #if IGL_BACKEND_OPENGL
     const auto& uniformName = buffer->iglBufferDesc.name;
     if (buffer->iglBufferDesc.isUniformBlock) {
-      IGL_ASSERT(buffer->allocation->iglBuffer != nullptr);
-      buffer->allocation->iglBuffer->upload(buffer->allocation->ptr,
-                                            igl::BufferRange(buffer->allocation->size, 0));
       const auto& glPipelineState =
           static_cast<const igl::opengl::RenderPipelineState&>(pipelineState);
-      encoder.bindBuffer(glPipelineState.getUniformBlockBindingPoint(uniformName),
-                         bindTargetForShaderStage(buffer->iglBufferDesc.shaderStage),
-                         buffer->allocation->iglBuffer,
-                         0);
+      const int bindingPoint = glPipelineState.getUniformBlockBindingPoint(uniformName);
+      const uint8_t bindTarget = bindTargetForShaderStage(buffer->iglBufferDesc.shaderStage);
+      if (buffer->isSuballocated) {
+        uintptr_t subAllocatedOffset = 0;
+        if (buffer->currentAllocation >= 0) {
+          subAllocatedOffset = buffer->currentAllocation * buffer->suballocationsSize;
+        }
+        auto arena = static_cast<igl::opengl::Device&>(device).getContext().getUniformBlockArena();
+        size_t arenaOffset = 0;
+        if (arena != nullptr &&
+            arena->write((uint8_t*)buffer->allocation->ptr + subAllocatedOffset,
+                         buffer->suballocationsSize,
+                         arenaOffset)) {
+          encoder.bindBuffer(bindingPoint, bindTarget, arena, arenaOffset);
+        } else {
+          IGL_LOG_ERROR_ONCE("[IGL][Error] Failed to suballocate uniform block %s\n",
+                             uniformName.c_str());
+        }
+      } else {
+        IGL_ASSERT(buffer->allocation->iglBuffer != nullptr);
+        buffer->allocation->iglBuffer->upload(buffer->allocation->ptr,
+                                              igl::BufferRange(buffer->allocation->size, 0));
+        encoder.bindBuffer(bindingPoint, bindTarget, buffer->allocation->iglBuffer, 0);
+      }
     } else {
       // not a uniform block
       IGL_ASSERT(buffer->iglBufferDesc.name == buffer->iglBufferDesc.members[0].name);
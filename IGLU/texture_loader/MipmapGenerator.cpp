@@ -0,0 +1,781 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <IGLU/texture_loader/MipmapGenerator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <igl/IGLSafeC.h>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGLU_MIPMAP_SSE2 1
+#include <emmintrin.h>
+#if defined(__F16C__)
+#define IGLU_MIPMAP_F16C 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IGLU_MIPMAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace iglu::textureloader {
+
+namespace {
+
+constexpr size_t kNumComponents = 4;
+constexpr int kKaiserNumTaps = 6;
+constexpr float kKaiserAlpha = 4.0f;
+constexpr size_t kSrgbEncodeTableSize = 16384;
+// Levels smaller than this are not worth spreading across threads.
+constexpr size_t kMinPixelsPerThread = 64 * 64;
+
+enum class PixelType : uint8_t {
+  UNorm8,
+  SRGB8,
+  Half,
+  Float,
+};
+
+bool toPixelType(igl::TextureFormat format, PixelType& outType) noexcept {
+  switch (format) {
+  case igl::TextureFormat::RGBA_UNorm8:
+    outType = PixelType::UNorm8;
+    return true;
+  case igl::TextureFormat::RGBA_SRGB:
+    outType = PixelType::SRGB8;
+    return true;
+  case igl::TextureFormat::RGBA_F16:
+    outType = PixelType::Half;
+    return true;
+  case igl::TextureFormat::RGBA_F32:
+    outType = PixelType::Float;
+    return true;
+  default:
+    return false;
+  }
+}
+
+size_t getBytesPerPixel(PixelType type) noexcept {
+  switch (type) {
+  case PixelType::UNorm8:
+  case PixelType::SRGB8:
+    return 4;
+  case PixelType::Half:
+    return 8;
+  case PixelType::Float:
+    return 16;
+  }
+  IGL_UNREACHABLE_RETURN(4)
+}
+
+//
+// 4-wide float helpers
+//
+#if IGLU_MIPMAP_SSE2
+using Vec4 = __m128;
+inline Vec4 load4(const float* p) {
+  return _mm_loadu_ps(p);
+}
+inline void store4(float* p, Vec4 v) {
+  _mm_storeu_ps(p, v);
+}
+inline Vec4 add4(Vec4 a, Vec4 b) {
+  return _mm_add_ps(a, b);
+}
+inline Vec4 mul4(Vec4 a, Vec4 b) {
+  return _mm_mul_ps(a, b);
+}
+inline Vec4 splat4(float f) {
+  return _mm_set1_ps(f);
+}
+#elif IGLU_MIPMAP_NEON
+using Vec4 = float32x4_t;
+inline Vec4 load4(const float* p) {
+  return vld1q_f32(p);
+}
+inline void store4(float* p, Vec4 v) {
+  vst1q_f32(p, v);
+}
+inline Vec4 add4(Vec4 a, Vec4 b) {
+  return vaddq_f32(a, b);
+}
+inline Vec4 mul4(Vec4 a, Vec4 b) {
+  return vmulq_f32(a, b);
+}
+inline Vec4 splat4(float f) {
+  return vdupq_n_f32(f);
+}
+#else
+struct Vec4 {
+  float v[4];
+};
+inline Vec4 load4(const float* p) {
+  return {{p[0], p[1], p[2], p[3]}};
+}
+inline void store4(float* p, Vec4 v) {
+  p[0] = v.v[0];
+  p[1] = v.v[1];
+  p[2] = v.v[2];
+  p[3] = v.v[3];
+}
+inline Vec4 add4(Vec4 a, Vec4 b) {
+  return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+}
+inline Vec4 mul4(Vec4 a, Vec4 b) {
+  return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+}
+inline Vec4 splat4(float f) {
+  return {{f, f, f, f}};
+}
+#endif
+
+//
+// Half float conversion
+//
+float halfToFloat(uint16_t h) noexcept {
+  const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1fu;
+  const uint32_t mantissa = h & 0x3ffu;
+  uint32_t bits = 0;
+  if (exponent == 0) {
+    // Zero or subnormal: mantissa * 2^-24
+    const float f = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    std::memcpy(&bits, &f, sizeof(bits));
+    bits |= sign;
+  } else if (exponent == 0x1fu) {
+    bits = sign | 0x7f800000u | (mantissa << 13);
+  } else {
+    bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+  }
+  float result = 0.0f;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+uint16_t floatToHalf(float f) noexcept {
+  uint32_t x = 0;
+  std::memcpy(&x, &f, sizeof(x));
+  const uint32_t sign = x & 0x80000000u;
+  x ^= sign;
+
+  uint32_t result = 0;
+  if (x >= 0x47800000u) {
+    // Inf or NaN
+    result = x > 0x7f800000u ? 0x7e00u : 0x7c00u;
+  } else if (x < 0x38800000u) {
+    // Subnormal or zero: let the FPU do the rounding by adding 0.5f
+    constexpr uint32_t kDenormMagic = 126u << 23;
+    float magic = 0.0f;
+    std::memcpy(&magic, &kDenormMagic, sizeof(magic));
+    float value = 0.0f;
+    std::memcpy(&value, &x, sizeof(value));
+    value += magic;
+    std::memcpy(&result, &value, sizeof(result));
+    result -= kDenormMagic;
+  } else {
+    // Normal: rebias exponent and round to nearest even
+    const uint32_t mantissaOdd = (x >> 13) & 1u;
+    x += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu + mantissaOdd;
+    result = x >> 13;
+  }
+  return static_cast<uint16_t>((sign >> 16) | result);
+}
+
+//
+// sRGB conversion tables
+//
+struct SrgbTables {
+  SrgbTables() noexcept {
+    for (size_t i = 0; i < 256; ++i) {
+      const float c = static_cast<float>(i) / 255.0f;
+      decode[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    for (size_t i = 0; i < kSrgbEncodeTableSize; ++i) {
+      const float l = static_cast<float>(i) / static_cast<float>(kSrgbEncodeTableSize - 1);
+      const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+      encode[i] = static_cast<uint8_t>(std::clamp(s * 255.0f + 0.5f, 0.0f, 255.0f));
+    }
+  }
+
+  float decode[256] = {};
+  uint8_t encode[kSrgbEncodeTableSize] = {};
+};
+
+const SrgbTables& getSrgbTables() noexcept {
+  static const SrgbTables kTables;
+  return kTables;
+}
+
+inline uint8_t encodeUNorm8(float v) noexcept {
+  return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline uint8_t encodeSrgb8(const SrgbTables& tables, float v) noexcept {
+  const float index = std::clamp(v, 0.0f, 1.0f) * static_cast<float>(kSrgbEncodeTableSize - 1);
+  return tables.encode[static_cast<size_t>(index + 0.5f)];
+}
+
+/// Converts one row of pixels into linear RGBA floats.
+void decodeRow(PixelType type, const uint8_t* src, float* dst, size_t width) noexcept {
+  const size_t count = width * kNumComponents;
+  switch (type) {
+  case PixelType::UNorm8:
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = static_cast<float>(src[i]) * (1.0f / 255.0f);
+    }
+    break;
+  case PixelType::SRGB8: {
+    const auto& tables = getSrgbTables();
+    for (size_t i = 0; i < count; i += kNumComponents) {
+      dst[i + 0] = tables.decode[src[i + 0]];
+      dst[i + 1] = tables.decode[src[i + 1]];
+      dst[i + 2] = tables.decode[src[i + 2]];
+      dst[i + 3] = static_cast<float>(src[i + 3]) * (1.0f / 255.0f);
+    }
+    break;
+  }
+  case PixelType::Half: {
+    const auto* halfs = reinterpret_cast<const uint16_t*>(src);
+    size_t i = 0;
+#if IGLU_MIPMAP_F16C
+    for (; i < count; i += kNumComponents) {
+      _mm_storeu_ps(dst + i,
+                    _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(halfs + i))));
+    }
+#endif
+    for (; i < count; ++i) {
+      dst[i] = halfToFloat(halfs[i]);
+    }
+    break;
+  }
+  case PixelType::Float:
+    std::memcpy(dst, src, count * sizeof(float));
+    break;
+  }
+}
+
+/// Converts one row of linear RGBA floats back into the destination pixel type.
+void encodeRow(PixelType type, const float* src, uint8_t* dst, size_t width) noexcept {
+  const size_t count = width * kNumComponents;
+  switch (type) {
+  case PixelType::UNorm8:
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = encodeUNorm8(src[i]);
+    }
+    break;
+  case PixelType::SRGB8: {
+    const auto& tables = getSrgbTables();
+    for (size_t i = 0; i < count; i += kNumComponents) {
+      dst[i + 0] = encodeSrgb8(tables, src[i + 0]);
+      dst[i + 1] = encodeSrgb8(tables, src[i + 1]);
+      dst[i + 2] = encodeSrgb8(tables, src[i + 2]);
+      dst[i + 3] = encodeUNorm8(src[i + 3]);
+    }
+    break;
+  }
+  case PixelType::Half: {
+    auto* halfs = reinterpret_cast<uint16_t*>(dst);
+    size_t i = 0;
+#if IGLU_MIPMAP_F16C
+    for (; i < count; i += kNumComponents) {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(halfs + i),
+                       _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+    for (; i < count; ++i) {
+      halfs[i] = floatToHalf(src[i]);
+    }
+    break;
+  }
+  case PixelType::Float:
+    std::memcpy(dst, src, count * sizeof(float));
+    break;
+  }
+}
+
+//
+// Box filter kernels
+//
+void boxRowUNorm8(const uint8_t* row0,
+                  const uint8_t* row1,
+                  uint8_t* dst,
+                  size_t srcWidth,
+                  size_t dstWidth) noexcept {
+  size_t x = 0;
+#if IGLU_MIPMAP_SSE2
+  // 4 source pixels from each row -> 2 destination pixels
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i two = _mm_set1_epi16(2);
+  for (; x + 2 <= dstWidth && 2 * x + 4 <= srcWidth; x += 2) {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x));
+    const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+    const __m128i sumLo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+    const __m128i sumHi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+    const __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(sumLo, sumHi), two), 2);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 4 * x), _mm_packus_epi16(sum, sum));
+  }
+#elif IGLU_MIPMAP_NEON
+  // 16 source pixels from each row -> 8 destination pixels
+  for (; x + 8 <= dstWidth && 2 * x + 16 <= srcWidth; x += 8) {
+    const uint8x16x4_t a = vld4q_u8(row0 + 8 * x);
+    const uint8x16x4_t b = vld4q_u8(row1 + 8 * x);
+    uint8x8x4_t result;
+    for (int c = 0; c < 4; ++c) {
+      result.val[c] = vrshrn_n_u16(vaddq_u16(vpaddlq_u8(a.val[c]), vpaddlq_u8(b.val[c])), 2);
+    }
+    vst4_u8(dst + 4 * x, result);
+  }
+#endif
+  for (; x < dstWidth; ++x) {
+    const size_t x0 = std::min(2 * x, srcWidth - 1) * kNumComponents;
+    const size_t x1 = std::min(2 * x + 1, srcWidth - 1) * kNumComponents;
+    for (size_t c = 0; c < kNumComponents; ++c) {
+      const uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+      dst[4 * x + c] = static_cast<uint8_t>((sum + 2) >> 2);
+    }
+  }
+}
+
+void boxRowFloat(const float* row0,
+                 const float* row1,
+                 float* dst,
+                 size_t srcWidth,
+                 size_t dstWidth) noexcept {
+  const Vec4 quarter = splat4(0.25f);
+  for (size_t x = 0; x < dstWidth; ++x) {
+    const size_t x0 = std::min(2 * x, srcWidth - 1) * kNumComponents;
+    const size_t x1 = std::min(2 * x + 1, srcWidth - 1) * kNumComponents;
+    const Vec4 sum = add4(add4(load4(row0 + x0), load4(row0 + x1)),
+                          add4(load4(row1 + x0), load4(row1 + x1)));
+    store4(dst + kNumComponents * x, mul4(sum, quarter));
+  }
+}
+
+//
+// Kaiser filter
+//
+struct FilterTaps {
+  size_t index[kKaiserNumTaps] = {};
+  float weight[kKaiserNumTaps] = {};
+};
+
+double besselI0(double x) noexcept {
+  double sum = 1.0;
+  double term = 1.0;
+  const double halfX = x * 0.5;
+  for (int k = 1; k < 32; ++k) {
+    term *= (halfX / k) * (halfX / k);
+    sum += term;
+    if (term < sum * 1e-12) {
+      break;
+    }
+  }
+  return sum;
+}
+
+std::vector<FilterTaps> computeKaiserTaps(size_t srcSize, size_t dstSize) {
+  constexpr double kPi = 3.14159265358979323846;
+  constexpr double kHalfWidth = kKaiserNumTaps / 4.0; // in destination pixels
+  const double scale = static_cast<double>(srcSize) / static_cast<double>(dstSize);
+  const double i0Alpha = besselI0(kKaiserAlpha);
+
+  std::vector<FilterTaps> taps(dstSize);
+  for (size_t x = 0; x < dstSize; ++x) {
+    const double center = (static_cast<double>(x) + 0.5) * scale;
+    const auto first = static_cast<int64_t>(std::ceil(center - kKaiserNumTaps / 2.0 - 0.5));
+    double total = 0.0;
+    double weights[kKaiserNumTaps] = {};
+    for (int t = 0; t < kKaiserNumTaps; ++t) {
+      const int64_t s = first + t;
+      const double u = (static_cast<double>(s) + 0.5 - center) / std::max(scale, 1.0);
+      const double sinc = u == 0.0 ? 1.0 : std::sin(kPi * u) / (kPi * u);
+      const double r = u / kHalfWidth;
+      const double window = r * r < 1.0 ? besselI0(kKaiserAlpha * std::sqrt(1.0 - r * r)) / i0Alpha
+                                        : 0.0;
+      weights[t] = sinc * window;
+      total += weights[t];
+      taps[x].index[t] = static_cast<size_t>(
+          std::clamp<int64_t>(s, 0, static_cast<int64_t>(srcSize) - 1));
+    }
+    for (int t = 0; t < kKaiserNumTaps; ++t) {
+      taps[x].weight[t] = static_cast<float>(total != 0.0 ? weights[t] / total : 0.0);
+    }
+  }
+  return taps;
+}
+
+inline Vec4 applyTaps(const FilterTaps& taps, const float* data, size_t stride) noexcept {
+  Vec4 acc = splat4(0.0f);
+  for (int t = 0; t < kKaiserNumTaps; ++t) {
+    acc = add4(acc, mul4(load4(data + taps.index[t] * stride), splat4(taps.weight[t])));
+  }
+  return acc;
+}
+
+//
+// Level processing
+//
+struct LevelJob {
+  PixelType type;
+  size_t srcWidth;
+  size_t srcHeight;
+  size_t dstWidth;
+  size_t dstHeight;
+  size_t srcImageBytes;
+  size_t dstImageBytes;
+  const uint8_t* src;
+  uint8_t* dst;
+  const std::vector<FilterTaps>* tapsX;
+  const std::vector<FilterTaps>* tapsY;
+};
+
+void boxBand(const LevelJob& job, size_t image, size_t y0, size_t y1) {
+  const size_t bpp = getBytesPerPixel(job.type);
+  const uint8_t* src = job.src + image * job.srcImageBytes;
+  uint8_t* dst = job.dst + image * job.dstImageBytes;
+  const size_t srcRowBytes = job.srcWidth * bpp;
+  const size_t dstRowBytes = job.dstWidth * bpp;
+
+  if (job.type == PixelType::UNorm8) {
+    for (size_t y = y0; y < y1; ++y) {
+      boxRowUNorm8(src + std::min(2 * y, job.srcHeight - 1) * srcRowBytes,
+                   src + std::min(2 * y + 1, job.srcHeight - 1) * srcRowBytes,
+                   dst + y * dstRowBytes,
+                   job.srcWidth,
+                   job.dstWidth);
+    }
+    return;
+  }
+
+  std::vector<float> row0(job.srcWidth * kNumComponents);
+  std::vector<float> row1(job.srcWidth * kNumComponents);
+  std::vector<float> out(job.dstWidth * kNumComponents);
+  for (size_t y = y0; y < y1; ++y) {
+    decodeRow(job.type,
+              src + std::min(2 * y, job.srcHeight - 1) * srcRowBytes,
+              row0.data(),
+              job.srcWidth);
+    decodeRow(job.type,
+              src + std::min(2 * y + 1, job.srcHeight - 1) * srcRowBytes,
+              row1.data(),
+              job.srcWidth);
+    boxRowFloat(row0.data(), row1.data(), out.data(), job.srcWidth, job.dstWidth);
+    encodeRow(job.type, out.data(), dst + y * dstRowBytes, job.dstWidth);
+  }
+}
+
+void kaiserBand(const LevelJob& job, size_t image, size_t y0, size_t y1) {
+  const size_t bpp = getBytesPerPixel(job.type);
+  const uint8_t* src = job.src + image * job.srcImageBytes;
+  uint8_t* dst = job.dst + image * job.dstImageBytes;
+  const auto& tapsX = *job.tapsX;
+  const auto& tapsY = *job.tapsY;
+
+  // Source rows touched by this band
+  size_t firstRow = job.srcHeight;
+  size_t lastRow = 0;
+  for (size_t y = y0; y < y1; ++y) {
+    for (int t = 0; t < kKaiserNumTaps; ++t) {
+      firstRow = std::min(firstRow, tapsY[y].index[t]);
+      lastRow = std::max(lastRow, tapsY[y].index[t]);
+    }
+  }
+
+  // Horizontal pass
+  const size_t dstRowFloats = job.dstWidth * kNumComponents;
+  std::vector<float> decoded(job.srcWidth * kNumComponents);
+  std::vector<float> filtered((lastRow - firstRow + 1) * dstRowFloats);
+  for (size_t row = firstRow; row <= lastRow; ++row) {
+    decodeRow(job.type, src + row * job.srcWidth * bpp, decoded.data(), job.srcWidth);
+    float* out = filtered.data() + (row - firstRow) * dstRowFloats;
+    for (size_t x = 0; x < job.dstWidth; ++x) {
+      store4(out + x * kNumComponents, applyTaps(tapsX[x], decoded.data(), kNumComponents));
+    }
+  }
+
+  // Vertical pass
+  std::vector<float> out(dstRowFloats);
+  for (size_t y = y0; y < y1; ++y) {
+    FilterTaps taps = tapsY[y];
+    for (auto& index : taps.index) {
+      index -= firstRow;
+    }
+    for (size_t x = 0; x < job.dstWidth; ++x) {
+      store4(out.data() + x * kNumComponents,
+             applyTaps(taps, filtered.data() + x * kNumComponents, dstRowFloats));
+    }
+    encodeRow(job.type, out.data(), dst + y * job.dstWidth * bpp, job.dstWidth);
+  }
+}
+
+size_t getNumFaces(const igl::TextureDesc& desc) noexcept {
+  return desc.type == igl::TextureType::Cube ? 6 : 1;
+}
+
+} // namespace
+
+// Runs one parallel loop at a time on the calling thread and a set of worker threads kept alive
+// between calls, so generating many small mip chains does not pay for thread creation every time.
+class MipmapGenerator::ThreadPool {
+ public:
+  explicit ThreadPool(size_t maxWorkers) noexcept : maxWorkers_(maxWorkers) {}
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      isStopping_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /// Calls fn(i) for every i in [0, count) on at most numThreads threads, including the caller.
+  void parallelFor(size_t count, size_t numThreads, const std::function<void(size_t)>& fn) {
+    numThreads = std::min(numThreads, count);
+    if (numThreads <= 1) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    std::lock_guard<std::mutex> runLock(runMutex_);
+    const size_t numHelpers = std::min(numThreads - 1, maxWorkers_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (workers_.size() < numHelpers) {
+        workers_.emplace_back([this]() { workerLoop(); });
+      }
+      fn_ = &fn;
+      count_ = count;
+      next_ = 0;
+      numOpenSlots_ = numHelpers;
+      numBusy_ = numHelpers;
+    }
+    condition_.notify_all();
+
+    runItems(fn, count);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // every item is taken; helpers that have not joined yet have nothing left to do
+    numBusy_ -= numOpenSlots_;
+    numOpenSlots_ = 0;
+    doneCondition_.wait(lock, [this]() { return numBusy_ == 0; });
+    fn_ = nullptr;
+  }
+
+ private:
+  void runItems(const std::function<void(size_t)>& fn, size_t count) {
+    for (size_t i = next_++; i < count; i = next_++) {
+      fn(i);
+    }
+  }
+
+  void workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      condition_.wait(lock, [this]() { return isStopping_ || numOpenSlots_ > 0; });
+      if (isStopping_) {
+        return;
+      }
+      numOpenSlots_--;
+      const std::function<void(size_t)>& fn = *fn_;
+      const size_t count = count_;
+      lock.unlock();
+      runItems(fn, count);
+      lock.lock();
+      if (--numBusy_ == 0) {
+        doneCondition_.notify_one();
+      }
+    }
+  }
+
+  const size_t maxWorkers_;
+  // serializes parallelFor() calls made on the same generator from different threads
+  std::mutex runMutex_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::condition_variable doneCondition_;
+  const std::function<void(size_t)>* fn_ = nullptr;
+  size_t count_ = 0;
+  std::atomic<size_t> next_{0};
+  // number of helpers that may still join the current loop, and of those that have not finished
+  size_t numOpenSlots_ = 0;
+  size_t numBusy_ = 0;
+  bool isStopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+MipmapGenerator::MipmapGenerator(MipmapFilter filter, uint32_t numThreads) noexcept :
+  filter_(filter),
+  numThreads_(numThreads != 0 ? numThreads
+                              : std::max(1u, std::thread::hardware_concurrency())),
+  threadPool_(std::make_unique<ThreadPool>(numThreads_ - 1)) {}
+
+MipmapGenerator::~MipmapGenerator() = default;
+
+bool MipmapGenerator::isFormatSupported(igl::TextureFormat format) noexcept {
+  PixelType type = PixelType::UNorm8;
+  return toPixelType(format, type);
+}
+
+size_t MipmapGenerator::getBytesForMipChain(const igl::TextureDesc& desc) noexcept {
+  PixelType type = PixelType::UNorm8;
+  if (!toPixelType(desc.format, type)) {
+    return 0;
+  }
+  const size_t numImages = desc.numLayers * getNumFaces(desc);
+  size_t bytes = 0;
+  for (uint32_t level = 0; level < desc.numMipLevels; ++level) {
+    const size_t width = std::max<size_t>(desc.width >> level, 1);
+    const size_t height = std::max<size_t>(desc.height >> level, 1);
+    bytes += width * height * numImages * getBytesPerPixel(type);
+  }
+  return bytes;
+}
+
+void MipmapGenerator::generateInPlace(const igl::TextureDesc& desc,
+                                      uint8_t* IGL_NONNULL data,
+                                      igl::Result* IGL_NULLABLE outResult) const noexcept {
+  PixelType type = PixelType::UNorm8;
+  if (!toPixelType(desc.format, type)) {
+    igl::Result::setResult(outResult, igl::Result::Code::Unsupported, "Unsupported format.");
+    return;
+  }
+  if (desc.type != igl::TextureType::TwoD && desc.type != igl::TextureType::TwoDArray &&
+      desc.type != igl::TextureType::Cube) {
+    igl::Result::setResult(outResult, igl::Result::Code::Unsupported, "Unsupported type.");
+    return;
+  }
+  if (desc.width == 0 || desc.height == 0 || desc.numLayers == 0 || desc.numMipLevels == 0 ||
+      desc.numMipLevels > igl::TextureDesc::calcNumMipLevels(desc.width, desc.height)) {
+    igl::Result::setResult(
+        outResult, igl::Result::Code::ArgumentInvalid, "Invalid texture dimensions.");
+    return;
+  }
+
+  const size_t bpp = getBytesPerPixel(type);
+  const size_t numImages = desc.numLayers * getNumFaces(desc);
+
+  const uint8_t* src = data;
+  for (uint32_t level = 1; level < desc.numMipLevels; ++level) {
+    LevelJob job{};
+    job.type = type;
+    job.srcWidth = std::max<size_t>(desc.width >> (level - 1), 1);
+    job.srcHeight = std::max<size_t>(desc.height >> (level - 1), 1);
+    job.dstWidth = std::max<size_t>(desc.width >> level, 1);
+    job.dstHeight = std::max<size_t>(desc.height >> level, 1);
+    job.srcImageBytes = job.srcWidth * job.srcHeight * bpp;
+    job.dstImageBytes = job.dstWidth * job.dstHeight * bpp;
+    job.src = src;
+    job.dst = const_cast<uint8_t*>(src) + job.srcImageBytes * numImages;
+
+    std::vector<FilterTaps> tapsX;
+    std::vector<FilterTaps> tapsY;
+    if (filter_ == MipmapFilter::Kaiser) {
+      tapsX = computeKaiserTaps(job.srcWidth, job.dstWidth);
+      tapsY = computeKaiserTaps(job.srcHeight, job.dstHeight);
+      job.tapsX = &tapsX;
+      job.tapsY = &tapsY;
+    }
+
+    // Split each image into horizontal bands so a single large image still uses all threads.
+    const size_t numPixels = job.dstWidth * job.dstHeight * numImages;
+    const size_t numThreads = std::min<size_t>(
+        numThreads_, std::max<size_t>(numPixels / kMinPixelsPerThread, 1));
+    const size_t bandsPerImage = std::min(
+        job.dstHeight, std::max<size_t>(1, (2 * numThreads + numImages - 1) / numImages));
+    const size_t rowsPerBand = (job.dstHeight + bandsPerImage - 1) / bandsPerImage;
+
+    threadPool_->parallelFor(numImages * bandsPerImage, numThreads, [&](size_t item) {
+      const size_t image = item / bandsPerImage;
+      const size_t y0 = (item % bandsPerImage) * rowsPerBand;
+      const size_t y1 = std::min(y0 + rowsPerBand, job.dstHeight);
+      if (y0 >= y1) {
+        return;
+      }
+      if (filter_ == MipmapFilter::Kaiser) {
+        kaiserBand(job, image, y0, y1);
+      } else {
+        boxBand(job, image, y0, y1);
+      }
+    });
+
+    src = job.dst;
+  }
+
+  igl::Result::setOk(outResult);
+}
+
+std::unique_ptr<IData> MipmapGenerator::generate(const igl::TextureDesc& desc,
+                                                 const uint8_t* IGL_NONNULL level0Data,
+                                                 igl::Result* IGL_NULLABLE
+                                                     outResult) const noexcept {
+  const size_t length = getBytesForMipChain(desc);
+  if (length == 0) {
+    igl::Result::setResult(outResult, igl::Result::Code::Unsupported, "Unsupported format.");
+    return nullptr;
+  }
+  if (length > std::numeric_limits<uint32_t>::max()) {
+    igl::Result::setResult(outResult, igl::Result::Code::ArgumentOutOfRange, "Texture too large.");
+    return nullptr;
+  }
+
+  PixelType type = PixelType::UNorm8;
+  toPixelType(desc.format, type);
+  const size_t level0Length = desc.width * desc.height * desc.numLayers * getNumFaces(desc) *
+                              getBytesPerPixel(type);
+
+  auto data = std::make_unique<uint8_t[]>(length);
+  checked_memcpy(data.get(), length, level0Data, level0Length);
+
+  igl::Result result;
+  generateInPlace(desc, data.get(), &result);
+  if (!result.isOk()) {
+    igl::Result::setResult(outResult, std::move(result));
+    return nullptr;
+  }
+
+  return IData::tryCreate(std::move(data), static_cast<uint32_t>(length), outResult);
+}
+
+void MipmapGenerator::upload(igl::ITexture& texture,
+                             const uint8_t* IGL_NONNULL level0Data,
+                             igl::Result* IGL_NULLABLE outResult) const noexcept {
+  const auto dimensions = texture.getDimensions();
+  igl::TextureDesc desc;
+  desc.format = texture.getFormat();
+  desc.type = texture.getType();
+  desc.width = dimensions.width;
+  desc.height = dimensions.height;
+  desc.depth = dimensions.depth;
+  desc.numLayers = texture.getNumLayers();
+  desc.numMipLevels = texture.getNumMipLevels();
+
+  auto data = generate(desc, level0Data, outResult);
+  if (!data) {
+    return;
+  }
+
+  auto result = texture.upload(texture.getFullMipRange(), data->data());
+  igl::Result::setResult(outResult, std::move(result));
+}
+
+} // namespace iglu::textureloader
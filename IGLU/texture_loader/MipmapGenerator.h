@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <IGLU/texture_loader/IData.h>
+#include <igl/Texture.h>
+#include <memory>
+
+namespace iglu::textureloader {
+
+/// Downsampling filter used by MipmapGenerator.
+enum class MipmapFilter : uint8_t {
+  /// 2x2 average. Fastest; matches what GPU blits produce for power-of-two textures.
+  Box,
+  /// Separable Kaiser-windowed sinc with a 6-tap footprint. Sharper, less aliasing.
+  Kaiser,
+};
+
+/// Generates mip chains on the CPU for textures whose format cannot be filtered by the GPU
+/// (e.g. formats without linear blit support on Vulkan) or for data that is compressed after
+/// mipmap generation.
+///
+/// Supported formats are RGBA_UNorm8, RGBA_SRGB, RGBA_F16 and RGBA_F32. sRGB data is filtered in
+/// linear space. 2D, 2D array and cube textures are supported; work is spread across layers, faces
+/// and rows on up to numThreads threads. The worker threads are started on first use and reused by
+/// every later call; concurrent calls on the same generator take turns.
+///
+/// The generated data uses the same hierarchy as ITexture::upload():
+///   mip level
+///     array layer
+///       cube face
+///         row
+class MipmapGenerator {
+ public:
+  /// @param numThreads Maximum number of threads to use. 0 means std::thread::hardware_concurrency.
+  explicit MipmapGenerator(MipmapFilter filter = MipmapFilter::Box,
+                           uint32_t numThreads = 0) noexcept;
+  ~MipmapGenerator();
+
+  [[nodiscard]] static bool isFormatSupported(igl::TextureFormat format) noexcept;
+
+  /// Returns the number of bytes required to hold desc.numMipLevels mip levels.
+  [[nodiscard]] static size_t getBytesForMipChain(const igl::TextureDesc& desc) noexcept;
+
+  /// Fills mip levels 1..desc.numMipLevels-1 in data, which must hold getBytesForMipChain(desc)
+  /// bytes and contain tightly packed mip level 0.
+  void generateInPlace(const igl::TextureDesc& desc,
+                       uint8_t* IGL_NONNULL data,
+                       igl::Result* IGL_NULLABLE outResult) const noexcept;
+
+  /// Returns a new buffer containing a copy of level0Data followed by the generated mip levels.
+  [[nodiscard]] std::unique_ptr<IData> generate(const igl::TextureDesc& desc,
+                                                const uint8_t* IGL_NONNULL level0Data,
+                                                igl::Result* IGL_NULLABLE outResult) const noexcept;
+
+  /// Generates the full mip chain for texture from level0Data and uploads all mip levels.
+  void upload(igl::ITexture& texture,
+              const uint8_t* IGL_NONNULL level0Data,
+              igl::Result* IGL_NULLABLE outResult) const noexcept;
+
+ private:
+  class ThreadPool;
+
+  MipmapFilter filter_;
+  uint32_t numThreads_;
+  std::unique_ptr<ThreadPool> threadPool_;
+};
+
+} // namespace iglu::textureloader
@@ -87,10 +87,9 @@ void Encoder::operator()(igl::IRenderCommandEncoder& encoder,
 #else
     IGL_ASSERT_NOT_REACHED();
 #endif
-  } else if (backendType_ == igl::BackendType::Metal) {
+  } else if (backendType_ == igl::BackendType::Metal ||
+             backendType_ == igl::BackendType::Vulkan) {
     encodeRenderUniform(encoder, bufferIndex, bindTarget, uniform, Alignment::Aligned);
-  } else if (backendType_ == igl::BackendType::Vulkan) {
-    IGL_ASSERT_NOT_IMPLEMENTED();
   // @fb-only
     // @fb-only
   } else {
@@ -111,10 +110,9 @@ void Encoder::operator()(igl::IComputeCommandEncoder& encoder,
 #else
     IGL_ASSERT_NOT_REACHED();
 #endif
-  } else if (backendType_ == igl::BackendType::Metal) {
+  } else if (backendType_ == igl::BackendType::Metal ||
+             backendType_ == igl::BackendType::Vulkan) {
     encodeAlignedCompute(encoder, bufferIndex, uniform);
-  } else if (backendType_ == igl::BackendType::Vulkan) {
-    IGL_ASSERT_NOT_IMPLEMENTED();
   // @fb-only
     // @fb-only
   }
@@ -24,7 +24,7 @@ struct Descriptor;
 // Encoder submits an uniform described by Descriptor.
 //
 // It handles backend-specific details:
-// * For Metal, it calls igl::IRenderCommandEncoder::bindBytes() or
+// * For Metal and Vulkan, it calls igl::IRenderCommandEncoder::bindBytes() or
 // igl::IComputeCommandEncoder::bindBytes()
 // * For OpenGL, it calls igl::RenderCommandEncoder::bindUniform() or
 // igl::IComputeCommandEncoder::bindUniform()
@@ -18,6 +18,7 @@
 #define _USE_MATH_DEFINES
 #endif // _USE_MATH_DEFINES
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <filesystem>
@@ -37,7 +38,6 @@
 #include <ktx.h>
 
 #include <Compress.h>
-#include <meshoptimizer.h>
 #include <shared/Camera.h>
 #include <shared/UtilsCubemap.h>
 #include <stb/stb_image.h>
@@ -131,6 +131,11 @@
 #include <IGLU/imgui/Session.h>
 #endif // IGL_WITH_IGLU
 
+#include <IGLU/cluster_culling/ClusterCuller.h>
+#include <IGLU/mesh_cache/MeshBuilder.h>
+#include <IGLU/mesh_cache/MeshCacheReader.h>
+#include <IGLU/mesh_cache/MeshCacheWriter.h>
+
 #if USE_TEXTURE_LOADER
 #include <IGLU/texture_loader/ktx1/TextureLoaderFactory.h>
 #include <IGLU/texture_loader/ktx2/TextureLoaderFactory.h>
@@ -140,7 +145,8 @@ static_assert(IGL_WITH_IGLU != 0,
 
 namespace {
 
-constexpr uint32_t kMeshCacheVersion = 0xC0DE0009;
+// bump the last character when CachedMaterial changes
+constexpr uint32_t kMeshCacheChunkMaterials = iglu::meshcache::makeChunkId('M', 'T', 'L', '0');
 constexpr int kNumSamplesMSAA = 8;
 #if USE_OPENGL_BACKEND
 constexpr bool kEnableCompression = false;
@@ -704,9 +710,11 @@ struct VertexData {
   uint32_t mtlIndex;
 };
 
-std::vector<VertexData> vertexData_;
-std::vector<uint32_t> indexData_;
-std::vector<uint32_t> shapeVertexCnt_;
+std::unique_ptr<iglu::meshcache::MeshCacheReader> meshCache_;
+std::vector<iglu::meshcache::Shape> shapes_;
+size_t numIndices_ = 0;
+// draws the main pass as GPU-culled meshlets when available
+std::unique_ptr<iglu::clusterculling::ClusterCuller> clusterCuller_;
 
 struct UniformsPerFrame {
   mat4 proj;
@@ -1167,6 +1175,45 @@ void normalizeName(std::string& name) {
 }
 } // namespace
 
+bool loadFromCache(const char* cacheFileName) {
+  const auto start = std::chrono::steady_clock::now();
+
+  Result result;
+  meshCache_ = iglu::meshcache::MeshCacheReader::tryOpen(cacheFileName, &result);
+  if (!meshCache_) {
+    IGL_LOG_INFO("Cannot open mesh cache: %s\n", result.message.c_str());
+    return false;
+  }
+
+  using iglu::meshcache::ChunkId;
+  size_t numVertices = 0;
+  size_t numShapes = 0;
+  size_t numMaterials = 0;
+  const auto* vertices = meshCache_->getChunk<VertexData>(ChunkId::Vertices, numVertices, &result);
+  const auto* indices = meshCache_->getChunk<uint32_t>(ChunkId::Indices, numIndices_, &result);
+  const auto* shapes =
+      meshCache_->getChunk<iglu::meshcache::Shape>(ChunkId::Shapes, numShapes, &result);
+  const auto* materials =
+      meshCache_->getChunk<CachedMaterial>(kMeshCacheChunkMaterials, numMaterials, &result);
+  if (!vertices || !indices || !shapes || !materials ||
+      !meshCache_->findChunk(ChunkId::MeshletBounds)) {
+    IGL_LOG_INFO("Cache file has incompatible contents\n");
+    meshCache_ = nullptr;
+    return false;
+  }
+  shapes_.assign(shapes, shapes + numShapes);
+  cachedMaterials_.assign(materials, materials + numMaterials);
+
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  IGL_LOG_INFO("Mesh cache mapped in %.2f ms: %u vertices, %u indices, %u shapes\n",
+               elapsed.count(),
+               (uint32_t)numVertices,
+               (uint32_t)numIndices_,
+               (uint32_t)numShapes);
+  return true;
+}
+
 bool loadAndCache(const char* cacheFileName) {
   // load 3D model and cache it
   IGL_LOG_INFO("Loading `exterior.obj`... It can take a while in debug builds...\n");
@@ -1232,10 +1279,6 @@ bool loadAndCache(const char* cacheFileName) {
           shapeData.clear();
           prevIndex = mtlIndex;
         }
-        vertexData_.push_back({pos,
-                               glm::packSnorm3x10_1x2(vec4(normal, 0)),
-                               glm::packHalf2x16(uv),
-                               (uint32_t)mtlIndex});
         shapeData.push_back({pos,
                              glm::packSnorm3x10_1x2(vec4(normal, 0)),
                              glm::packHalf2x16(uv),
@@ -1247,44 +1290,24 @@ bool loadAndCache(const char* cacheFileName) {
   resplitShapes[prevIndex].insert(
       resplitShapes[prevIndex].end(), shapeData.begin(), shapeData.end());
   shapeData.clear();
-  for (auto shape : resplitShapes) {
-    shapeData.insert(shapeData.end(), shape.begin(), shape.end());
-    shapeVertexCnt_.emplace_back((uint32_t)shape.size());
-  }
 
-  // repack the mesh as described in https://github.com/zeux/meshoptimizer
-  {
-    // 1. Generate an index buffer
-    const size_t indexCount = vertexData_.size();
-    std::vector<uint32_t> remap(indexCount);
-    const size_t vertexCount = meshopt_generateVertexRemap(
-        remap.data(), nullptr, indexCount, vertexData_.data(), indexCount, sizeof(VertexData));
-    // 2. Remap vertices
-    std::vector<VertexData> remappedVertices;
-    indexData_.resize(indexCount);
-    remappedVertices.resize(vertexCount);
-    meshopt_remapIndexBuffer(indexData_.data(), nullptr, indexCount, &remap[0]);
-    meshopt_remapVertexBuffer(
-        remappedVertices.data(), vertexData_.data(), indexCount, sizeof(VertexData), remap.data());
-    vertexData_ = remappedVertices;
-    // 3. Optimize for the GPU vertex cache reuse and overdraw
-    meshopt_optimizeVertexCache(indexData_.data(), indexData_.data(), indexCount, vertexCount);
-    meshopt_optimizeOverdraw(indexData_.data(),
-                             indexData_.data(),
-                             indexCount,
-                             &vertexData_[0].position.x,
-                             vertexCount,
-                             sizeof(VertexData),
-                             1.05f);
-    meshopt_optimizeVertexFetch(vertexData_.data(),
-                                indexData_.data(),
-                                indexCount,
-                                vertexData_.data(),
-                                vertexCount,
-                                sizeof(VertexData));
+  // one shape per material; the mesh cache welds and optimizes each of them as described in
+  // https://github.com/zeux/meshoptimizer
+  iglu::meshcache::MeshDesc mesh;
+  for (uint32_t mtlIndex = 0; mtlIndex != resplitShapes.size(); mtlIndex++) {
+    const auto& shape = resplitShapes[mtlIndex];
+    if (!shape.empty()) {
+      mesh.shapes.push_back({(uint32_t)shapeData.size(), (uint32_t)shape.size(), mtlIndex});
+      shapeData.insert(shapeData.end(), shape.begin(), shape.end());
+    }
   }
+  mesh.vertices = shapeData.data();
+  mesh.numVertices = shapeData.size();
+  mesh.vertexSize = sizeof(VertexData);
+  mesh.positionOffset = offsetof(VertexData, position);
 
   // loop over materials
+  std::vector<CachedMaterial> cachedMaterials;
   for (auto& m : materials) {
     CachedMaterial mtl;
     mtl.ambient = vec3(m.ambient[0], m.ambient[1], m.ambient[2]);
@@ -1300,85 +1323,24 @@ bool loadAndCache(const char* cacheFileName) {
     strcat(mtl.ambient_texname, m.ambient_texname.c_str());
     strcat(mtl.diffuse_texname, m.diffuse_texname.c_str());
     strcat(mtl.alpha_texname, m.alpha_texname.c_str());
-    cachedMaterials_.push_back(mtl);
+    cachedMaterials.push_back(mtl);
   }
 
   IGL_LOG_INFO("Caching mesh...\n");
 
-  FILE* cacheFile = fopen(cacheFileName, "wb");
-  if (!cacheFile) {
+  iglu::meshcache::MeshCacheWriter writer;
+  Result result;
+  iglu::meshcache::MeshBuildOptions options;
+  options.buildMeshlets = true;
+  if (!iglu::meshcache::buildMeshCache(mesh, options, writer, &result) ||
+      !writer.addChunk(
+          kMeshCacheChunkMaterials, cachedMaterials, iglu::meshcache::Encoding::Raw, &result) ||
+      !writer.writeToFile(cacheFileName, &result)) {
+    IGL_LOG_ERROR("Cannot cache mesh: %s\n", result.message.c_str());
     return false;
   }
-  const uint32_t numMaterials = (uint32_t)cachedMaterials_.size();
-  const uint32_t numVertices = (uint32_t)vertexData_.size();
-  const uint32_t numIndices = (uint32_t)indexData_.size();
-  fwrite(&kMeshCacheVersion, sizeof(kMeshCacheVersion), 1, cacheFile);
-  fwrite(&numMaterials, sizeof(numMaterials), 1, cacheFile);
-  fwrite(&numVertices, sizeof(numVertices), 1, cacheFile);
-  fwrite(&numIndices, sizeof(numIndices), 1, cacheFile);
-  fwrite(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile);
-  fwrite(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile);
-  fwrite(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile);
-  const uint32_t numShapes = (uint32_t)shapeData.size();
-  fwrite(&numShapes, sizeof(numShapes), 1, cacheFile);
-  fwrite(shapeData.data(), sizeof(VertexData), numShapes, cacheFile);
-  const uint32_t numShapeVertices = (uint32_t)shapeVertexCnt_.size();
-  fwrite(&numShapeVertices, sizeof(numShapeVertices), 1, cacheFile);
-  fwrite(shapeVertexCnt_.data(), sizeof(uint32_t), numShapeVertices, cacheFile);
-#if USE_OPENGL_BACKEND
-  vertexData_.clear();
-  vertexData_.assign(shapeData.begin(), shapeData.end());
-#endif
-  return fclose(cacheFile) == 0;
-}
 
-bool loadFromCache(const char* cacheFileName) {
-  FILE* cacheFile = fopen(cacheFileName, "rb");
-  IGL_SCOPE_EXIT {
-    if (cacheFile) {
-      fclose(cacheFile);
-    }
-  };
-  if (!cacheFile) {
-    return false;
-  }
-#define CHECK_READ(expected, read) \
-  if ((read) != (expected)) {      \
-    return false;                  \
-  }
-  uint32_t versionProbe = 0;
-  CHECK_READ(1, fread(&versionProbe, sizeof(versionProbe), 1, cacheFile));
-  if (versionProbe != kMeshCacheVersion) {
-    IGL_LOG_INFO("Cache file has wrong version id\n");
-    return false;
-  }
-  uint32_t numMaterials = 0;
-  uint32_t numVertices = 0;
-  uint32_t numIndices = 0;
-  CHECK_READ(1, fread(&numMaterials, sizeof(numMaterials), 1, cacheFile));
-  CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
-  CHECK_READ(1, fread(&numIndices, sizeof(numIndices), 1, cacheFile));
-  cachedMaterials_.resize(numMaterials);
-  vertexData_.resize(numVertices);
-  indexData_.resize(numIndices);
-  CHECK_READ(numMaterials,
-             fread(cachedMaterials_.data(), sizeof(CachedMaterial), numMaterials, cacheFile));
-#if !USE_OPENGL_BACKEND
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  CHECK_READ(numIndices, fread(indexData_.data(), sizeof(uint32_t), numIndices, cacheFile));
-#else
-  fseek(cacheFile, sizeof(VertexData) * numVertices + sizeof(uint32_t) * numIndices, SEEK_CUR);
-  CHECK_READ(1, fread(&numVertices, sizeof(numVertices), 1, cacheFile));
-  vertexData_.resize(numVertices);
-  CHECK_READ(numVertices, fread(vertexData_.data(), sizeof(VertexData), numVertices, cacheFile));
-  uint32_t numShapeVertices = 0;
-  CHECK_READ(1, fread(&numShapeVertices, sizeof(numShapeVertices), 1, cacheFile));
-  shapeVertexCnt_.resize(numShapeVertices);
-  CHECK_READ(numShapeVertices,
-             fread(shapeVertexCnt_.data(), sizeof(uint32_t), numShapeVertices, cacheFile));
-#endif
-#undef CHECK_READ
-  return true;
+  return loadFromCache(cacheFileName);
 }
 
 void initModel() {
@@ -1414,20 +1376,17 @@ void initModel() {
                                                   "Buffer: materials"),
                                        nullptr);
 
-  vb0_ = device_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
-                                          vertexData_.data(),
-                                          sizeof(VertexData) * vertexData_.size(),
-                                          ResourceStorage::Private,
-                                          hint,
-                                          "Buffer: vertex"),
-                               nullptr);
-  ib0_ = device_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Index,
-                                          indexData_.data(),
-                                          sizeof(uint32_t) * indexData_.size(),
-                                          ResourceStorage::Private,
-                                          hint,
-                                          "Buffer: index"),
-                               nullptr);
+  // upload straight from the memory-mapped cache file
+  vb0_ = meshCache_->createBuffer(
+      *device_, iglu::meshcache::ChunkId::Vertices, BufferDesc::BufferTypeBits::Vertex, nullptr);
+  ib0_ = meshCache_->createBuffer(
+      *device_, iglu::meshcache::ChunkId::Indices, BufferDesc::BufferTypeBits::Index, nullptr);
+  Result result;
+  clusterCuller_ = iglu::clusterculling::ClusterCuller::create(*device_, *meshCache_, &result);
+  if (!clusterCuller_) {
+    IGL_LOG_INFO("Cluster culling is disabled: %s\n", result.message.c_str());
+  }
+  meshCache_ = nullptr;
 }
 
 void createComputePipeline() {
@@ -1807,9 +1766,11 @@ void createOffscreenFramebuffer() {
                                       "Offscreen framebuffer (d)");
   descDepth.numMipLevels = TextureDesc::calcNumMipLevels(w, h);
   if (kNumSamplesMSAA > 1) {
+    // multisampled attachments are resolved inside the render pass and never stored
     descDepth.usage = TextureDesc::TextureUsageBits::Attachment;
     descDepth.numSamples = kNumSamplesMSAA;
     descDepth.numMipLevels = 1;
+    descDepth.storage = ResourceStorage::Memoryless;
   }
   std::shared_ptr<ITexture> texDepth = device_->createTexture(descDepth, &ret);
   IGL_ASSERT(ret.isOk());
@@ -1827,6 +1788,7 @@ void createOffscreenFramebuffer() {
     descColor.usage = TextureDesc::TextureUsageBits::Attachment;
     descColor.numSamples = kNumSamplesMSAA;
     descColor.numMipLevels = 1;
+    descColor.storage = ResourceStorage::Memoryless;
   }
   std::shared_ptr<ITexture> texColor = device_->createTexture(descColor, &ret);
   IGL_ASSERT(ret.isOk());
@@ -1917,16 +1879,9 @@ void render(const std::shared_ptr<ITexture>& nativeDrawable, uint32_t frameIndex
         ubPerFrameShadowIdx, BindTarget::kAllGraphics, ubPerFrameShadow_[frameIndex], 0);
     commands->bindBuffer(ubPerObjectIdx, BindTarget::kAllGraphics, ubPerObject_[frameIndex], 0);
 
-#if USE_OPENGL_BACKEND
-    int start = 0;
-    for (auto numVertices : shapeVertexCnt_) {
-      commands->draw(PrimitiveType::Triangle, start, numVertices);
-      start += numVertices;
-    }
-#else
+    // shapes are contiguous in the index buffer, so the shadow pass needs no per-material draws
     commands->drawIndexed(
-        PrimitiveType::Triangle, indexData_.size(), igl::IndexFormat::UInt32, *ib0_.get(), 0);
-#endif
+        PrimitiveType::Triangle, numIndices_, igl::IndexFormat::UInt32, *ib0_.get(), 0);
     commands->popDebugGroupLabel();
     commands->endEncoding();
 
@@ -1944,8 +1899,37 @@ void render(const std::shared_ptr<ITexture>& nativeDrawable, uint32_t frameIndex
     std::shared_ptr<ICommandBuffer> buffer =
         commandQueue_->createCommandBuffer(CommandBufferDesc(), nullptr);
 
+    igl::Dependencies dependencies;
+    if (clusterCuller_) {
+      // the meshlet bounds are in model space
+      iglu::clusterculling::CullingParams params;
+      const mat4 viewProjModel = perFrame_.proj * perFrame_.view * perObject.model;
+      iglu::clusterculling::extractFrustumPlanes(
+          glm::value_ptr(viewProjModel), false, params.frustumPlanes);
+      const vec4 cameraPos = glm::inverse(perObject.model) * vec4(camera_.getPosition(), 1.0f);
+      std::copy(&cameraPos.x, &cameraPos.x + 4, params.cameraPosition);
+      clusterCuller_->cull(*buffer, params);
+      dependencies = clusterCuller_->getDependencies();
+    }
+    // draws all meshlets of shapes [firstShape, firstShape + numShapes)
+    auto drawShapes = [&](IRenderCommandEncoder& encoder, size_t firstShape, size_t numShapes) {
+      const auto& first = shapes_[firstShape];
+      const auto& last = shapes_[firstShape + numShapes - 1];
+      if (clusterCuller_) {
+        clusterCuller_->draw(
+            encoder, first.firstMeshlet, last.firstMeshlet + last.numMeshlets - first.firstMeshlet);
+      } else {
+        encoder.drawIndexed(PrimitiveType::Triangle,
+                            last.firstIndex + last.numIndices - first.firstIndex,
+                            igl::IndexFormat::UInt32,
+                            *ib0_.get(),
+                            first.firstIndex * sizeof(uint32_t));
+      }
+    };
+
     // This will clear the framebuffer
-    auto commands = buffer->createRenderCommandEncoder(renderPassOffscreen_, fbOffscreen_);
+    auto commands = buffer->createRenderCommandEncoder(
+        renderPassOffscreen_, fbOffscreen_, dependencies, nullptr);
     // Scene
     commands->bindRenderPipelineState(renderPipelineState_Mesh_);
     commands->pushDebugGroupLabel("Render Mesh", igl::Color(1, 0, 0));
@@ -1981,9 +1965,8 @@ void render(const std::shared_ptr<ITexture>& nativeDrawable, uint32_t frameIndex
 
 #if USE_OPENGL_BACKEND
     commands->bindVertexBuffer(0, vb0_);
-    int shapeStart = 0;
-    for (auto numVertices : shapeVertexCnt_) {
-      const uint32_t imageIdx = (uint32_t)vertexData_[shapeStart].mtlIndex;
+    for (size_t i = 0; i != shapes_.size(); i++) {
+      const uint32_t imageIdx = shapes_[i].materialIndex;
       const auto ambientTextureReference =
           strstr(cachedMaterials_[imageIdx].name, "MASTER_Glass_") ? textureDummyWhite_
           : textures_[imageIdx].ambient                            ? textures_[imageIdx].ambient
@@ -2000,30 +1983,26 @@ void render(const std::shared_ptr<ITexture>& nativeDrawable, uint32_t frameIndex
       commands->bindTexture(1, igl::BindTarget::kFragment, ambientTextureReference.get());
       commands->bindTexture(2, igl::BindTarget::kFragment, diffuseTextureReference.get());
       commands->bindTexture(3, igl::BindTarget::kFragment, alphaTextureReference.get());
-      commands->draw(PrimitiveType::Triangle, shapeStart, numVertices);
+      drawShapes(*commands, i, 1);
       if (enableWireframe_) {
         commands->bindRenderPipelineState(renderPipelineState_MeshWireframe_);
         commands->bindVertexBuffer(0, vb0_);
-        commands->draw(PrimitiveType::Triangle, shapeStart, numVertices);
+        drawShapes(*commands, i, 1);
 
         // Bind the non-wireframe pipeline and the vertex buffer
         commands->bindRenderPipelineState(renderPipelineState_Mesh_);
         commands->bindVertexBuffer(0, vb0_);
       }
-
-      shapeStart += numVertices;
     }
 #else
     commands->bindTexture(0, igl::BindTarget::kFragment, fbShadowMap_->getDepthAttachment().get());
     commands->bindTexture(1, igl::BindTarget::kFragment, skyboxTextureIrradiance_.get());
     commands->bindSamplerState(0, igl::BindTarget::kFragment, samplerShadow_.get());
     commands->bindSamplerState(1, igl::BindTarget::kFragment, sampler_.get());
-    commands->drawIndexed(
-        PrimitiveType::Triangle, indexData_.size(), igl::IndexFormat::UInt32, *ib0_.get(), 0);
+    drawShapes(*commands, 0, shapes_.size());
     if (enableWireframe_) {
       commands->bindRenderPipelineState(renderPipelineState_MeshWireframe_);
-      commands->drawIndexed(
-          PrimitiveType::Triangle, indexData_.size(), igl::IndexFormat::UInt32, *ib0_.get(), 0);
+      drawShapes(*commands, 0, shapes_.size());
     }
 #endif
     commands->popDebugGroupLabel();
@@ -2693,6 +2672,7 @@ int main(int argc, char* argv[]) {
   // destroy all the Vulkan stuff before closing the window
   vb0_ = nullptr;
   ib0_ = nullptr;
+  clusterCuller_ = nullptr;
   sbMaterials_ = nullptr;
   ubPerFrame_.clear();
   ubPerFrameShadow_.clear();
@@ -227,6 +227,15 @@ class IRenderPipelineState {
     return desc_;
   }
 
+  /**
+   * @brief Returns false while the backend is still compiling the pipeline in the background.
+   * Binding a pipeline that is not ready waits for it, so renderers can poll this to skip or
+   * substitute pipelines instead of stalling.
+   */
+  virtual bool isReady() {
+    return true;
+  }
+
  protected:
   const RenderPipelineDesc desc_{};
 };
@@ -9,9 +9,23 @@
 
 #include <cmath>
 #include <cstddef>
+#include <cstring>
 #include <igl/IGLSafeC.h>
+#include <memory>
 #include <utility>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IGL_TEXTURE_REPACK_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#define IGL_TEXTURE_REPACK_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IGL_TEXTURE_REPACK_NEON 1
+#include <arm_neon.h>
+#endif
+
 size_t std::hash<igl::TextureFormat>::operator()(igl::TextureFormat const& key) const {
   return std::hash<size_t>()(static_cast<size_t>(key));
 }
@@ -613,13 +627,135 @@ TextureRangeDesc ITexture::getLayerRange(size_t layer,
   return getFullRange(mipLevel, numMipLevels).atLayer(layer);
 }
 
+namespace {
+
+// Repacks at least this large are written with non-temporal stores so they don't evict the
+// working set from the CPU caches.
+constexpr size_t kNonTemporalCopyThreshold = 1024 * 1024;
+
+// ITexture::upload() repacks into a per-thread scratch buffer; anything larger than this is
+// allocated per call so a single huge upload doesn't pin memory for the lifetime of the thread.
+constexpr size_t kMaxRepackScratchBytes = 16 * 1024 * 1024;
+
+void copyBytes(uint8_t* IGL_NONNULL dst,
+               const uint8_t* IGL_NONNULL src,
+               size_t numBytes,
+               bool nonTemporal) {
+#if IGL_TEXTURE_REPACK_SSE2
+  if (nonTemporal && numBytes >= 128) {
+    const size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+    std::memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    numBytes -= head;
+    for (; numBytes >= 64; numBytes -= 64, dst += 64, src += 64) {
+      const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+      const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+      const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+    }
+  }
+#else
+  (void)nonTemporal;
+#endif
+  std::memcpy(dst, src, numBytes);
+}
+
+void swapRedBlue(uint8_t* IGL_NONNULL dst, const uint8_t* IGL_NONNULL src, size_t numPixels) {
+  size_t i = 0;
+#if IGL_TEXTURE_REPACK_SSE2
+  const __m128i maskGA = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+  const __m128i maskLow = _mm_set1_epi32(0x000000FF);
+  for (; i + 4 <= numPixels; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+    const __m128i ga = _mm_and_si128(v, maskGA);
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(v, maskLow), 16);
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(v, 16), maskLow);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                     _mm_or_si128(ga, _mm_or_si128(r, b)));
+  }
+#elif IGL_TEXTURE_REPACK_NEON
+  for (; i + 16 <= numPixels; i += 16) {
+    uint8x16x4_t v = vld4q_u8(src + 4 * i);
+    const uint8x16_t r = v.val[0];
+    v.val[0] = v.val[2];
+    v.val[2] = r;
+    vst4q_u8(dst + 4 * i, v);
+  }
+#endif
+  for (; i < numPixels; ++i) {
+    const uint8_t r = src[4 * i + 0];
+    dst[4 * i + 0] = src[4 * i + 2];
+    dst[4 * i + 1] = src[4 * i + 1];
+    dst[4 * i + 2] = r;
+    dst[4 * i + 3] = src[4 * i + 3];
+  }
+}
+
+void expandRGBToRGBA(uint8_t* IGL_NONNULL dst, const uint8_t* IGL_NONNULL src, size_t numPixels) {
+  size_t i = 0;
+#if IGL_TEXTURE_REPACK_SSSE3
+  // Each iteration reads 16 bytes but only consumes 12, so stop 2 pixels early.
+  const __m128i shuffle =
+      _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  for (; i + 6 <= numPixels; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                     _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+  }
+#elif IGL_TEXTURE_REPACK_NEON
+  for (; i + 16 <= numPixels; i += 16) {
+    const uint8x16x3_t rgb = vld3q_u8(src + 3 * i);
+    uint8x16x4_t rgba;
+    rgba.val[0] = rgb.val[0];
+    rgba.val[1] = rgb.val[1];
+    rgba.val[2] = rgb.val[2];
+    rgba.val[3] = vdupq_n_u8(0xFF);
+    vst4q_u8(dst + 4 * i, rgba);
+  }
+#endif
+  for (; i < numPixels; ++i) {
+    dst[4 * i + 0] = src[3 * i + 0];
+    dst[4 * i + 1] = src[3 * i + 1];
+    dst[4 * i + 2] = src[3 * i + 2];
+    dst[4 * i + 3] = 0xFF;
+  }
+}
+
+void repackRow(uint8_t* IGL_NONNULL dst,
+               const uint8_t* IGL_NONNULL src,
+               size_t numBytes,
+               size_t numPixels,
+               ITexture::RepackConversion conversion,
+               bool nonTemporal) {
+  switch (conversion) {
+  case ITexture::RepackConversion::None:
+    copyBytes(dst, src, numBytes, nonTemporal);
+    break;
+  case ITexture::RepackConversion::SwapRedBlue:
+    swapRedBlue(dst, src, numPixels);
+    break;
+  case ITexture::RepackConversion::RGBToRGBA:
+    expandRGBToRGBA(dst, src, numPixels);
+    break;
+  }
+}
+
+} // namespace
+
 void ITexture::repackData(const TextureFormatProperties& properties,
                           const TextureRangeDesc& range,
                           const uint8_t* IGL_NONNULL originalData,
                           size_t originalDataBytesPerRow,
                           uint8_t* IGL_NONNULL repackedData,
                           size_t repackedBytesPerRow,
-                          bool flipVertical) {
+                          bool flipVertical,
+                          RepackConversion conversion) {
   if (IGL_UNEXPECTED(originalData == nullptr || repackedData == nullptr)) {
     return;
   }
@@ -627,24 +763,45 @@ void ITexture::repackData(const TextureFormatProperties& properties,
                      (originalDataBytesPerRow > 0 || repackedBytesPerRow > 0))) {
     return;
   }
+  if (conversion != RepackConversion::None &&
+      IGL_UNEXPECTED(properties.isCompressed() || properties.bytesPerBlock != 4)) {
+    return;
+  }
+  const bool isExpandingRGB = conversion == RepackConversion::RGBToRGBA;
   const auto fullRangeBytesPerRow = properties.getBytesPerRow(range);
+  const auto originalFullRangeBytesPerRow = isExpandingRGB ? range.width * 3
+                                                           : fullRangeBytesPerRow;
   if (originalDataBytesPerRow > 0 &&
-      IGL_UNEXPECTED(originalDataBytesPerRow < fullRangeBytesPerRow)) {
+      IGL_UNEXPECTED(originalDataBytesPerRow < originalFullRangeBytesPerRow)) {
     return;
   }
   if (repackedBytesPerRow > 0 && IGL_UNEXPECTED(repackedBytesPerRow < fullRangeBytesPerRow)) {
     return;
   }
 
+  const bool nonTemporal = properties.getBytesPerRange(range) >= kNonTemporalCopyThreshold;
+
   for (size_t mipLevel = range.mipLevel; mipLevel < range.mipLevel + range.numMipLevels;
        ++mipLevel) {
     const auto mipRange = range.atMipLevel(mipLevel);
     const auto rangeBytesPerRow = properties.getBytesPerRow(mipRange);
-    const auto originalDataIncrement = originalDataBytesPerRow == 0 ? rangeBytesPerRow
+    const auto originalRangeBytesPerRow = isExpandingRGB ? mipRange.width * 3 : rangeBytesPerRow;
+    const auto originalDataIncrement = originalDataBytesPerRow == 0 ? originalRangeBytesPerRow
                                                                     : originalDataBytesPerRow;
     const auto repackedDataIncrement = repackedBytesPerRow == 0 ? rangeBytesPerRow
                                                                 : repackedBytesPerRow;
     const auto totalNumLayers = mipRange.numLayers * mipRange.numFaces * mipRange.depth;
+
+    // Both sides tightly packed: the whole mip level is one contiguous copy
+    if (!flipVertical && conversion == RepackConversion::None &&
+        originalDataIncrement == rangeBytesPerRow && repackedDataIncrement == rangeBytesPerRow) {
+      const size_t numBytes = rangeBytesPerRow * mipRange.height * totalNumLayers;
+      copyBytes(repackedData, originalData, numBytes, nonTemporal);
+      originalData += numBytes;
+      repackedData += numBytes;
+      continue;
+    }
+
     for (size_t layer = 0; layer < totalNumLayers; ++layer) {
       uint8_t* repackedDataPtr = repackedData;
       const std::ptrdiff_t increment = flipVertical ? -repackedDataIncrement
@@ -654,17 +811,25 @@ void ITexture::repackData(const TextureFormatProperties& properties,
         repackedDataPtr += repackedDataIncrement * (mipRange.height - 1);
       }
       for (size_t y = 0; y < mipRange.height; ++y) {
-        checked_memcpy_robust(repackedDataPtr,
-                              repackedDataIncrement,
-                              originalData,
-                              originalDataIncrement,
-                              rangeBytesPerRow);
+        repackRow(repackedDataPtr,
+                  originalData,
+                  rangeBytesPerRow,
+                  mipRange.width,
+                  conversion,
+                  nonTemporal);
         repackedDataPtr += increment;
         originalData += originalDataIncrement;
       }
       repackedData += repackedDataIncrement * mipRange.height;
     }
   }
+
+#if IGL_TEXTURE_REPACK_SSE2
+  if (nonTemporal) {
+    // Make the streamed stores visible before the data is handed to the driver
+    _mm_sfence();
+  }
+#endif
 }
 
 const void* IGL_NULLABLE ITexture::getSubRangeStart(const void* IGL_NONNULL data,
@@ -718,11 +883,29 @@ Result ITexture::upload(const TextureRangeDesc& range,
 
   // Repack data if necessary for upload
   if (data != nullptr && needsRepacking(range, bytesPerRow)) {
-    repackedData = std::make_unique<uint8_t[]>(properties_.getBytesPerRange(range));
+    struct ScratchBuffer {
+      std::unique_ptr<uint8_t[]> data;
+      size_t size = 0;
+    };
+    thread_local ScratchBuffer scratch;
+
+    const size_t repackedSize = properties_.getBytesPerRange(range);
+    uint8_t* repackedPtr = nullptr;
+    if (repackedSize <= kMaxRepackScratchBytes) {
+      if (scratch.size < repackedSize) {
+        // No need to zero-initialize, every byte is overwritten by repackData()
+        scratch.data.reset(new uint8_t[repackedSize]);
+        scratch.size = repackedSize;
+      }
+      repackedPtr = scratch.data.get();
+    } else {
+      repackedData.reset(new uint8_t[repackedSize]);
+      repackedPtr = repackedData.get();
+    }
     ITexture::repackData(
-        properties_, range, static_cast<const uint8_t*>(data), bytesPerRow, repackedData.get(), 0);
+        properties_, range, static_cast<const uint8_t*>(data), bytesPerRow, repackedPtr, 0);
     bytesPerRow = 0;
-    data = repackedData.get();
+    data = repackedPtr;
   }
 
   return uploadInternal(type, range, data, bytesPerRow);
@@ -852,12 +852,28 @@ class ITexture : public ITrackedResource<ITexture> {
     return false;
   }
 
+  /**
+   * @brief Optional per-pixel conversion applied by repackData while copying rows.
+   *
+   *  None         - Rows are copied as-is
+   *  SwapRedBlue  - Swaps the 1st and 3rd byte of every 4 byte pixel (RGBA <-> BGRA)
+   *  RGBToRGBA    - Expands 3 byte RGB source pixels to 4 byte pixels with an opaque alpha. The
+   *                 properties and repackedBytesPerRow describe the 4 byte destination format;
+   *                 originalDataBytesPerRow describes the 3 byte source rows.
+   */
+  enum class RepackConversion : uint8_t {
+    None,
+    SwapRedBlue,
+    RGBToRGBA,
+  };
+
   /**
    * @brief Helper method to repack texture data to achieve a desired alignment.
    *
    * Copies data from originalData to repackedData, one row of data at a time. Each row of data will
    * be repackedBytesPerRow bytes long. If repackedBytesPerRow is less than originalDataBytesPerRow,
-   * data will NOT be 0 padded.
+   * data will NOT be 0 padded. Rows which are tightly packed on both sides are copied in a single
+   * pass, and large copies bypass the CPU caches where supported.
    *
    * Repacking only works correctly for 1 mip level.
    *
@@ -878,6 +894,8 @@ class ITexture : public ITrackedResource<ITexture> {
    * (i.e., the data should be packed).
    * @param flipVertical If true, the repacked data will be flipped vertically for each texture
    * layer, cube face, and Z slice.
+   * @param conversion Per-pixel conversion applied during the copy. Only valid for uncompressed
+   * formats with 4 bytes per pixel.
    */
   static void repackData(const TextureFormatProperties& properties,
                          const TextureRangeDesc& range,
@@ -885,7 +903,8 @@ class ITexture : public ITrackedResource<ITexture> {
                          size_t originalDataBytesPerRow,
                          uint8_t* IGL_NONNULL repackedData,
                          size_t repackedBytesPerRow,
-                         bool flipVertical = false);
+                         bool flipVertical = false,
+                         RepackConversion conversion = RepackConversion::None);
 
  protected:
   [[nodiscard]] const void* IGL_NONNULL getSubRangeStart(const void* IGL_NONNULL data,
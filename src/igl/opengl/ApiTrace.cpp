@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/ApiTrace.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace igl::opengl {
+
+namespace {
+
+void appendArg(std::string& str, ApiTrace::ArgType type, uint64_t bits) {
+  char buffer[32];
+  switch (type) {
+  case ApiTrace::ArgType::Int:
+    snprintf(buffer, sizeof(buffer), "%" PRId64, static_cast<int64_t>(bits));
+    break;
+  case ApiTrace::ArgType::Uint:
+    // GLenum and GLbitfield arguments are far more readable in hex
+    snprintf(buffer, sizeof(buffer), "0x%" PRIx64, bits);
+    break;
+  case ApiTrace::ArgType::Float: {
+    double d = 0.0;
+    std::memcpy(&d, &bits, sizeof(d));
+    snprintf(buffer, sizeof(buffer), "%g", d);
+    break;
+  }
+  case ApiTrace::ArgType::Pointer:
+    snprintf(buffer, sizeof(buffer), "ptr 0x%" PRIx64, bits);
+    break;
+  }
+  str += buffer;
+}
+
+std::string formatRecord(const ApiTrace::Record& record) {
+  std::string str = "#" + std::to_string(record.callIndex) + " " + record.name + "(";
+  const size_t numStoredArgs = std::min<size_t>(record.numArgs, ApiTrace::kMaxArgs);
+  for (size_t i = 0; i < numStoredArgs; ++i) {
+    if (i > 0) {
+      str += ", ";
+    }
+    appendArg(str, record.argTypes[i], record.args[i]);
+  }
+  if (record.numArgs > ApiTrace::kMaxArgs) {
+    str += ", ...";
+  }
+  str += ")\n";
+  return str;
+}
+
+} // namespace
+
+ApiTrace::ApiTrace(size_t capacity) : records_(capacity) {
+  IGL_ASSERT(capacity > 0);
+}
+
+const ApiTrace::Record& ApiTrace::getRecord(size_t index) const {
+  IGL_ASSERT(index < size_);
+  const size_t oldest = size_ < records_.size() ? 0 : next_;
+  return records_[(oldest + index) % records_.size()];
+}
+
+void ApiTrace::clear() {
+  next_ = 0;
+  size_ = 0;
+}
+
+std::string ApiTrace::toString() const {
+  std::string str;
+  for (size_t i = 0; i < size_; ++i) {
+    str += formatRecord(getRecord(i));
+  }
+  return str;
+}
+
+void ApiTrace::dump() const {
+  IGLLog(IGLLogLevel::LOG_INFO, "[IGL] Last %zu OpenGL calls:\n", size_);
+  // one message per call, the whole trace can be too long for a single log message
+  for (size_t i = 0; i < size_; ++i) {
+    IGLLog(IGLLogLevel::LOG_INFO, "%s", formatRecord(getRecord(i)).c_str());
+  }
+}
+
+} // namespace igl::opengl
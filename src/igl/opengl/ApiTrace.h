@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <igl/Common.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace igl::opengl {
+
+/// @brief Ring of the most recent GL calls made through an IContext.
+///
+/// Each call is stored as a fixed-size binary record: the name of the GL function, which serves as
+/// the opcode, the call count at the time of the call and the raw bits of its first kMaxArgs
+/// arguments. Nothing is formatted until toString() or dump() is called, so tracing stays cheap
+/// enough to leave enabled in release builds. Enable it with IContext::setApiTraceCapacity().
+class ApiTrace final {
+ public:
+  static constexpr size_t kMaxArgs = 6;
+
+  enum class ArgType : uint8_t { Int, Uint, Float, Pointer };
+
+  struct Record {
+    const char* name = nullptr;
+    uint32_t callIndex = 0;
+    // number of arguments passed, which may be more than the kMaxArgs stored
+    uint8_t numArgs = 0;
+    std::array<ArgType, kMaxArgs> argTypes{};
+    std::array<uint64_t, kMaxArgs> args{};
+  };
+
+  explicit ApiTrace(size_t capacity);
+
+  template<typename... Args>
+  void record(const char* name, uint32_t callIndex, const Args&... args) {
+    Record& record = records_[next_];
+    next_ = next_ + 1 == records_.size() ? 0 : next_ + 1;
+    size_ += size_ < records_.size() ? 1 : 0;
+
+    record.name = name;
+    record.callIndex = callIndex;
+    record.numArgs = static_cast<uint8_t>(sizeof...(Args));
+    size_t index = 0;
+    (storeArg(record, index++, args), ...);
+  }
+
+  /// @brief Returns the number of calls held, at most the capacity of the trace.
+  [[nodiscard]] size_t size() const {
+    return size_;
+  }
+
+  /// @brief Returns the `index`-th call held, oldest first.
+  [[nodiscard]] const Record& getRecord(size_t index) const;
+
+  void clear();
+
+  /// @brief Formats the calls held, oldest first, one per line.
+  [[nodiscard]] std::string toString() const;
+
+  /// @brief Logs the calls held, oldest first.
+  void dump() const;
+
+ private:
+  template<typename T>
+  static void storeArg(Record& record, size_t index, const T& value) {
+    if (index >= kMaxArgs) {
+      return;
+    }
+    uint64_t bits = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+      const double d = value;
+      std::memcpy(&bits, &d, sizeof(bits));
+      record.argTypes[index] = ArgType::Float;
+    } else if constexpr (std::is_null_pointer_v<T>) {
+      record.argTypes[index] = ArgType::Pointer;
+    } else if constexpr (std::is_pointer_v<T>) {
+      bits = reinterpret_cast<uintptr_t>(value);
+      record.argTypes[index] = ArgType::Pointer;
+    } else if constexpr (std::is_signed_v<T>) {
+      bits = static_cast<uint64_t>(static_cast<int64_t>(value));
+      record.argTypes[index] = ArgType::Int;
+    } else {
+      bits = static_cast<uint64_t>(value);
+      record.argTypes[index] = ArgType::Uint;
+    }
+    record.args[index] = bits;
+  }
+
+  std::vector<Record> records_;
+  size_t next_ = 0;
+  size_t size_ = 0;
+};
+
+/// @brief Calls `func`, first recording the call in `trace` unless it is null.
+template<typename Func>
+struct ApiTraceCall {
+  ApiTrace* trace;
+  const char* name;
+  uint32_t callIndex;
+  Func func;
+
+  template<typename... Args>
+  decltype(auto) operator()(Args&&... args) const {
+    if (trace != nullptr) {
+      trace->record(name, callIndex, args...);
+    }
+    return func(std::forward<Args>(args)...);
+  }
+};
+
+template<typename Func>
+ApiTraceCall<Func> traceApiCall(ApiTrace* trace, const char* name, uint32_t callIndex, Func func) {
+  return ApiTraceCall<Func>{trace, name, callIndex, func};
+}
+
+} // namespace igl::opengl
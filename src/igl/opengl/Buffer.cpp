@@ -7,6 +7,8 @@
 
 #include <igl/opengl/Buffer.h>
 
+#include <algorithm>
+#include <cstring>
 #include <igl/CommandBuffer.h>
 #include <igl/Device.h>
 #include <igl/opengl/Errors.h>
@@ -14,6 +16,33 @@
 namespace igl {
 namespace opengl {
 
+namespace {
+
+// Ring buffers start with a region per frame in flight and grow while the GPU is behind
+constexpr size_t kInitialRingRegions = 3;
+constexpr size_t kMaxRingRegions = 8;
+constexpr GLuint64 kRingWaitTimeoutNs = 1000000000;
+
+// Regions are read when a partial upload has to preserve the rest of the previous contents
+constexpr GLbitfield kRingMapFlags =
+    GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+// Large enough for a few frames worth of per-draw uniform blocks before the arena is orphaned
+constexpr size_t kUniformBlockArenaSize = 1024 * 1024;
+
+void setDebugLabel(IContext& context, GLuint id, const std::string& debugName) {
+  if (!debugName.empty() &&
+      context.deviceFeatures().hasInternalFeature(InternalFeatures::DebugLabel)) {
+    GLenum identifier = context.deviceFeatures().hasInternalRequirement(
+                            InternalRequirement::DebugLabelExtEnumsReq)
+                            ? GL_BUFFER_OBJECT_EXT
+                            : GL_BUFFER;
+    context.objectLabel(identifier, id, debugName.size(), debugName.c_str());
+  }
+}
+
+} // namespace
+
 // ********************************
 // ****  ArrayBuffer
 // ********************************
@@ -28,6 +57,17 @@ ArrayBuffer::ArrayBuffer(IContext& context,
 }
 
 ArrayBuffer::~ArrayBuffer() {
+  if (!ringRegions_.empty()) {
+    for (auto& region : ringRegions_) {
+      if (region.fence != nullptr && getContext().isDestructionAllowed()) {
+        getContext().deleteSync(region.fence);
+      }
+      getContext().deleteBuffers(1, &region.id);
+    }
+    ringRegions_.clear();
+    getContext().unbindBuffer(target_);
+    iD_ = 0;
+  }
   if (iD_ != 0) {
     getContext().deleteBuffers(1, &iD_);
     getContext().unbindBuffer(target_);
@@ -60,13 +100,18 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
     break;
   }
 
+  if (desc.hint & BufferDesc::BufferAPIHintBits::Ring) {
+    // ring buffers are meant to be rewritten all the time, whatever the requested storage is
+    usage = GL_STREAM_DRAW;
+    isDynamic_ = true;
+    isStreaming_ = true;
+  }
+
   if (!isDynamic_ && desc.data == nullptr) {
     Result::setResult(outResult, Result::Code::ArgumentNull, "data is null");
     return;
   }
 
-  getContext().genBuffers(1, &iD_);
-
   if (desc.type & BufferDesc::BufferTypeBits::Storage) {
     if (getContext().deviceFeatures().hasFeature(DeviceFeatures::Compute)) {
       target_ = GL_SHADER_STORAGE_BUFFER;
@@ -85,6 +130,15 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
 
   size_ = desc.length;
 
+  // compute dispatches do not count as draws, which ring regions rely on to detect reuse
+  if (isStreaming_ && size_ != 0 && target_ != GL_SHADER_STORAGE_BUFFER &&
+      getContext().deviceFeatures().hasInternalFeature(InternalFeatures::BufferStorage) &&
+      getContext().deviceFeatures().hasInternalFeature(InternalFeatures::Sync)) {
+    initializeRing(desc, outResult);
+    return;
+  }
+
+  getContext().genBuffers(1, &iD_);
   getContext().bindBuffer(target_, iD_);
   getContext().bufferData(target_, size_, desc.data, usage);
 
@@ -92,14 +146,7 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
   GLint bufferSize = 0;
   getContext().getBufferParameteriv(target_, GL_BUFFER_SIZE, &bufferSize);
 
-  if (!desc.debugName.empty() &&
-      getContext().deviceFeatures().hasInternalFeature(InternalFeatures::DebugLabel)) {
-    GLenum identifier = getContext().deviceFeatures().hasInternalRequirement(
-                            InternalRequirement::DebugLabelExtEnumsReq)
-                            ? GL_BUFFER_OBJECT_EXT
-                            : GL_BUFFER;
-    getContext().objectLabel(identifier, iD_, desc.debugName.size(), desc.debugName.c_str());
-  }
+  setDebugLabel(getContext(), iD_, desc.debugName);
 
   getContext().bindBuffer(target_, 0);
 
@@ -113,6 +160,103 @@ void ArrayBuffer::initialize(const BufferDesc& desc, Result* outResult) {
   Result::setOk(outResult);
 }
 
+void ArrayBuffer::initializeRing(const BufferDesc& desc, Result* outResult) {
+  for (size_t i = 0; i != kInitialRingRegions; i++) {
+    if (!addRingRegion(i)) {
+      Result::setResult(outResult, Result::Code::RuntimeError, "Could not map ring buffer");
+      return;
+    }
+    setDebugLabel(getContext(), ringRegions_[i].id, desc.debugName);
+  }
+
+  RingRegion& region = ringRegions_[0];
+  if (desc.data != nullptr) {
+    std::memcpy(region.data, desc.data, size_);
+  }
+  region.drawCount = getContext().getCurrentDrawCount();
+  currentRingRegion_ = 0;
+  iD_ = region.id;
+
+  Result::setOk(outResult);
+}
+
+bool ArrayBuffer::createRingRegion(RingRegion& region) {
+  getContext().genBuffers(1, &region.id);
+  getContext().bindBuffer(target_, region.id);
+  getContext().bufferStorage(target_, size_, nullptr, kRingMapFlags);
+  region.data =
+      static_cast<uint8_t*>(getContext().mapBufferRange(target_, 0, size_, kRingMapFlags));
+  getContext().bindBuffer(target_, 0);
+
+  if (region.data == nullptr) {
+    getContext().deleteBuffers(1, &region.id);
+    region.id = 0;
+    return false;
+  }
+  return true;
+}
+
+bool ArrayBuffer::addRingRegion(size_t position) {
+  RingRegion region;
+  if (!createRingRegion(region)) {
+    return false;
+  }
+  ringRegions_.insert(ringRegions_.begin() + position, region);
+  return true;
+}
+
+void ArrayBuffer::orphanRingRegion(RingRegion& region) {
+  RingRegion replacement;
+  if (!createRingRegion(replacement)) {
+    waitForRingRegion(region);
+    return;
+  }
+  // the storage of a deleted buffer outlives the draws still reading it, like orphaned storage
+  getContext().deleteSync(region.fence);
+  getContext().deleteBuffers(1, &region.id);
+  region = replacement;
+}
+
+void ArrayBuffer::waitForRingRegion(RingRegion& region) {
+  if (region.fence == nullptr) {
+    return;
+  }
+  // flush on the first wait only, otherwise the fence may never be submitted
+  GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+  GLenum status = GL_TIMEOUT_EXPIRED;
+  while (status == GL_TIMEOUT_EXPIRED) {
+    status = getContext().clientWaitSync(region.fence, flags, kRingWaitTimeoutNs);
+    flags = 0;
+  }
+  IGL_ASSERT_MSG(status != GL_WAIT_FAILED, "glClientWaitSync failed");
+  getContext().deleteSync(region.fence);
+  region.fence = nullptr;
+}
+
+void ArrayBuffer::advanceRing() {
+  // every command that may read the current region has already been issued
+  ringRegions_[currentRingRegion_].fence =
+      getContext().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  size_t next = (currentRingRegion_ + 1) % ringRegions_.size();
+  const GLsync nextFence = ringRegions_[next].fence;
+  if (nextFence != nullptr &&
+      getContext().clientWaitSync(nextFence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+    // the GPU still reads the oldest region; a new region avoids stalling on it, and once the ring
+    // is full, the oldest region gets new storage instead
+    if (ringRegions_.size() < kMaxRingRegions && addRingRegion(currentRingRegion_ + 1)) {
+      next = currentRingRegion_ + 1;
+    } else {
+      orphanRingRegion(ringRegions_[next]);
+    }
+  }
+  // only releases the fence by now, the GPU is done with the region
+  waitForRingRegion(ringRegions_[next]);
+
+  currentRingRegion_ = next;
+  iD_ = ringRegions_[next].id;
+}
+
 // upload data to the buffer at the given offset with the given size
 Result ArrayBuffer::upload(const void* data, const BufferRange& range) {
   // static buffers can only upload data once during creation
@@ -120,9 +264,36 @@ Result ArrayBuffer::upload(const void* data, const BufferRange& range) {
     return Result(Result::Code::InvalidOperation, "Can't upload to static buffers");
   }
 
+  const bool isFullUpload = range.offset == 0 && range.size == size_;
+
+  if (!ringRegions_.empty()) {
+    if (range.offset + range.size > size_) {
+      return Result(Result::Code::ArgumentOutOfRange,
+                    "upload() size + offset must be <= buffer size");
+    }
+    const unsigned int drawCount = getContext().getCurrentDrawCount();
+    if (ringRegions_[currentRingRegion_].drawCount != drawCount) {
+      // draws issued since the last upload may read the current region, so move to the next one
+      const size_t previous = currentRingRegion_;
+      advanceRing();
+      if (!isFullUpload) {
+        std::memcpy(ringRegions_[currentRingRegion_].data, ringRegions_[previous].data, size_);
+      }
+    }
+    RingRegion& region = ringRegions_[currentRingRegion_];
+    std::memcpy(region.data + range.offset, data, range.size);
+    region.drawCount = drawCount;
+    return Result();
+  }
+
   getContext().bindBuffer(target_, iD_);
 
-  getContext().bufferSubData(target_, range.offset, range.size, data);
+  if (isStreaming_ && isFullUpload) {
+    // respecifying the whole buffer orphans the storage draws in flight are reading
+    getContext().bufferData(target_, size_, data, GL_STREAM_DRAW);
+  } else {
+    getContext().bufferSubData(target_, range.offset, range.size, data);
+  }
 
   getContext().bindBuffer(target_, 0);
 
@@ -130,6 +301,11 @@ Result ArrayBuffer::upload(const void* data, const BufferRange& range) {
 }
 
 void* ArrayBuffer::map(const BufferRange& range, Result* outResult) {
+  if (!ringRegions_.empty()) {
+    IGL_ASSERT_MSG(0, "map() operation not supported for ring buffers");
+    Result::setResult(outResult, Result::Code::Unsupported);
+    return nullptr;
+  }
   if ((range.size + range.offset) > getSizeInBytes()) {
     Result::setResult(
         outResult, Result::Code::ArgumentOutOfRange, "map() size + offset must be <= buffer size");
@@ -151,6 +327,10 @@ void* ArrayBuffer::map(const BufferRange& range, Result* outResult) {
 }
 
 void ArrayBuffer::unmap() {
+  if (!ringRegions_.empty()) {
+    IGL_ASSERT_MSG(0, "unmap() operation not supported for ring buffers");
+    return;
+  }
   bind();
   getContext().unmapBuffer(target_);
 }
@@ -222,5 +402,112 @@ void UniformBlockBuffer::bindRange(size_t index, size_t offset, Result* outResul
   }
 }
 
+// ********************************
+// ****  UniformBlockArena
+// ********************************
+UniformBlockArena::UniformBlockArena(IContext& context) :
+  UniformBlockBuffer(context,
+                     BufferDesc::BufferAPIHintBits::UniformBlock,
+                     BufferDesc::BufferTypeBits::Uniform) {}
+
+bool UniformBlockArena::isSupported(const IContext& context) {
+  return context.deviceFeatures().hasFeature(DeviceFeatures::UniformBlocks);
+}
+
+void UniformBlockArena::initialize(const BufferDesc& desc, Result* outResult) {
+  GLint alignment = 0;
+  getContext().getIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  alignment_ = static_cast<size_t>(std::max(alignment, 1));
+
+  BufferDesc arenaDesc = desc;
+  arenaDesc.type = BufferDesc::BufferTypeBits::Uniform;
+  arenaDesc.storage = ResourceStorage::Shared;
+  arenaDesc.hint = BufferDesc::BufferAPIHintBits::UniformBlock;
+  if (arenaDesc.length == 0) {
+    arenaDesc.length = kUniformBlockArenaSize;
+  }
+  UniformBlockBuffer::initialize(arenaDesc, outResult);
+  limit_ = getSizeInBytes();
+  shadow_.resize(limit_);
+}
+
+size_t UniformBlockArena::alignUp(size_t size) const {
+  // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT is not guaranteed to be a power of two
+  return (size + alignment_ - 1) / alignment_ * alignment_;
+}
+
+void UniformBlockArena::orphan() {
+  // draws that still read from the storage keep it alive in the driver
+  getContext().bufferData(
+      target_, static_cast<GLsizeiptr>(getSizeInBytes()), nullptr, GL_STREAM_DRAW);
+  head_ = 0;
+  limit_ = getSizeInBytes();
+}
+
+bool UniformBlockArena::wrap(size_t size) {
+  const size_t drawEnd = head_;
+  if (drawStart_ == drawEnd) {
+    orphan();
+    drawStart_ = 0;
+    return true;
+  }
+  if (drawWrapped_ || size > drawStart_) {
+    // the blocks of the current draw would have to move, but they are already bound
+    return false;
+  }
+  // Keep the blocks of the current draw at their offsets in the new storage and write the next
+  // ones in front of them. The range after them stays in use until the storage is orphaned again.
+  orphan();
+  getContext().bufferSubData(target_,
+                             static_cast<GLintptr>(drawStart_),
+                             static_cast<GLsizeiptr>(drawEnd - drawStart_),
+                             shadow_.data() + drawStart_);
+  limit_ = drawStart_;
+  drawWrapped_ = true;
+  return true;
+}
+
+bool UniformBlockArena::write(const void* data, size_t size, size_t& outOffset) {
+  IGL_ASSERT(data != nullptr && size > 0);
+  const size_t capacity = getSizeInBytes();
+  if (iD_ == 0 || size > capacity) {
+    return false;
+  }
+  getContext().bindBuffer(target_, iD_);
+
+  size_t offset = alignUp(head_);
+  if (offset + size > limit_) {
+    if (!wrap(size)) {
+      getContext().bindBuffer(target_, 0);
+      IGL_LOG_ERROR_ONCE("[IGL][Error] Uniform blocks of one draw do not fit in the arena\n");
+      return false;
+    }
+    offset = 0;
+  }
+
+  void* dst = nullptr;
+  if (getContext().deviceFeatures().hasFeature(DeviceFeatures::MapBufferRange)) {
+    // no draw reads this range of the current storage yet, so there is nothing to wait for
+    dst = getContext().mapBufferRange(
+        target_,
+        static_cast<GLintptr>(offset),
+        static_cast<GLsizeiptr>(size),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  }
+  if (dst != nullptr) {
+    std::memcpy(dst, data, size);
+    getContext().unmapBuffer(target_);
+  } else {
+    getContext().bufferSubData(
+        target_, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+  }
+  getContext().bindBuffer(target_, 0);
+  std::memcpy(shadow_.data() + offset, data, size);
+
+  outOffset = offset;
+  head_ = offset + size;
+  return true;
+}
+
 } // namespace opengl
 } // namespace igl
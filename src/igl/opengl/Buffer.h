@@ -12,6 +12,7 @@
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/WithContext.h>
+#include <vector>
 
 namespace igl {
 class ICommandBuffer;
@@ -46,6 +47,13 @@ class Buffer : public WithContext, public IBuffer {
   BufferDesc::BufferType bufferType_ = 0;
 };
 
+/// Buffers created with BufferDesc::BufferAPIHintBits::Ring are streaming buffers: when
+/// glBufferStorage is available, they are backed by a ring of persistently mapped GL buffers and
+/// upload() copies straight into mapped memory. An upload after draws that may read the current
+/// region moves to the next region. If the GPU still reads that region, the ring grows, and once
+/// it cannot grow anymore, the region gets new storage rather than waiting on the GPU. getId()
+/// changes in that case; render command encoders rebind the buffer when it does. Without
+/// glBufferStorage, full uploads orphan the buffer storage instead.
 class ArrayBuffer : public Buffer {
  public:
   ArrayBuffer(IContext& context,
@@ -59,13 +67,18 @@ class ArrayBuffer : public Buffer {
   void unmap() override;
 
   BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
-    return 0;
+    return ringRegions_.empty() ? 0 : BufferDesc::BufferAPIHintBits::Ring;
   }
 
   ResourceStorage storage() const noexcept override {
     return ResourceStorage::Managed;
   }
 
+  /// Returns the number of GL buffers backing a ring buffer, or 0 for other buffers.
+  [[nodiscard]] size_t getNumRingRegions() const noexcept {
+    return ringRegions_.size();
+  }
+
   size_t getSizeInBytes() const override {
     return size_;
   }
@@ -100,9 +113,29 @@ class ArrayBuffer : public Buffer {
   GLenum target_;
 
  private:
+  struct RingRegion {
+    GLuint id = 0;
+    uint8_t* data = nullptr;
+    // signaled once the GPU is done with draws issued before the region was left
+    GLsync fence = nullptr;
+    // IContext::getCurrentDrawCount() when the region was last written to
+    unsigned int drawCount = 0;
+  };
+
+  void initializeRing(const BufferDesc& desc, Result* outResult);
+  bool createRingRegion(RingRegion& region);
+  bool addRingRegion(size_t position);
+  void orphanRingRegion(RingRegion& region);
+  void advanceRing();
+  void waitForRingRegion(RingRegion& region);
+
   size_t size_;
 
   bool isDynamic_;
+  bool isStreaming_ = false;
+
+  std::vector<RingRegion> ringRegions_;
+  size_t currentRingRegion_ = 0;
 };
 
 class UniformBlockBuffer : public ArrayBuffer {
@@ -121,9 +154,62 @@ class UniformBlockBuffer : public ArrayBuffer {
   void bindRange(size_t index, size_t offset, Result* outResult);
 
   BufferDesc::BufferAPIHint acceptedApiHints() const noexcept override {
-    return BufferDesc::BufferAPIHintBits::UniformBlock;
+    return BufferDesc::BufferAPIHintBits::UniformBlock | ArrayBuffer::acceptedApiHints();
   }
 };
 
+/// @brief One large uniform buffer that per-draw uniform block data is suballocated from.
+///
+/// write() hands out space linearly, at offsets aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+/// and bind the arena at the returned offset with IRenderCommandEncoder::bindBuffer(). Writes are
+/// unsynchronized; when the arena is full its storage is orphaned, so draws still in flight keep
+/// reading the old storage. Blocks are only bound when the draw is issued, so the blocks written
+/// since the last endDraw() are written again into the new storage, at the same offsets. Get the
+/// shared instance with IContext::getUniformBlockArena().
+class UniformBlockArena final : public UniformBlockBuffer {
+ public:
+  explicit UniformBlockArena(IContext& context);
+
+  /// @brief Returns false if the context has no uniform blocks.
+  static bool isSupported(const IContext& context);
+
+  void initialize(const BufferDesc& desc, Result* outResult) override;
+
+  /// @brief Copies `size` bytes into the arena. Returns false if they do not fit in the arena.
+  /// Blocks written since the last endDraw() keep their offsets and contents when the storage is
+  /// orphaned, since they are only bound when the draw is issued.
+  bool write(const void* data, size_t size, size_t& outOffset);
+
+  /// @brief Called by the render command encoder after each draw: blocks written before it may be
+  /// orphaned from now on.
+  void endDraw() {
+    drawStart_ = head_;
+    drawWrapped_ = false;
+  }
+
+  [[nodiscard]] size_t getAlignment() const {
+    return alignment_;
+  }
+
+  /// @brief Rounds `size` up to a multiple of the offset alignment.
+  [[nodiscard]] size_t alignUp(size_t size) const;
+
+ private:
+  void orphan();
+  /// Orphans the storage to make room for a block of `size` bytes. Returns false if the block
+  /// cannot be placed without moving the blocks of the current draw.
+  bool wrap(size_t size);
+
+  size_t alignment_ = 1;
+  size_t head_ = 0;
+  // end of the range of the current storage that can be written without synchronization
+  size_t limit_ = 0;
+  // blocks of the current draw start at drawStart_; if drawWrapped_, they continue at offset 0
+  size_t drawStart_ = 0;
+  bool drawWrapped_ = false;
+  // copy of the storage, to write the blocks of the current draw again after orphaning
+  std::vector<uint8_t> shadow_;
+};
+
 } // namespace opengl
 } // namespace igl
@@ -123,7 +123,9 @@ void ComputeCommandAdapter::willDispatch() {
   }
 
   // Bind uniforms to be used for compute
-  uniformAdapter_.bindToPipeline(getContext());
+  uniformAdapter_.bindToPipeline(
+      getContext(),
+      getContext().shouldSkipRedundantUniforms() ? &pipelineState->getUniformShadow() : nullptr);
 
   for (size_t index = 0; index < textureStates_.size(); index++) {
     if (!IS_DIRTY(textureStatesDirty_, index)) {
@@ -153,8 +155,10 @@ void ComputeCommandAdapter::didDispatch() {
     return;
   }
   if (pipelineState->getIsUsingShaderStorageBuffers()) {
+    // GL_COMMAND_BARRIER_BIT covers indirect draw arguments written by the compute shader
     getContext().memoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT |
-                               GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+                               GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT |
+                               GL_COMMAND_BARRIER_BIT);
   }
 }
 
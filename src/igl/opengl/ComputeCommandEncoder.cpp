@@ -43,6 +43,7 @@ void ComputeCommandEncoder::endEncoding() {
   if (IGL_VERIFY(adapter_)) {
     adapter_->endEncoding();
     getContext().getComputeAdapterPool().push_back(std::move(adapter_));
+    getContext().checkForEncoderErrors(__FUNCTION__);
   }
 }
 
@@ -43,6 +43,10 @@ class ComputePipelineState final : public WithContext, public IComputePipelineSt
     return usingShaderStorageBuffers_;
   }
 
+  UniformShadow& getUniformShadow() {
+    return shaderStages_->getUniformShadow();
+  }
+
  private:
   using ComputePipelineReflection = RenderPipelineReflection;
 
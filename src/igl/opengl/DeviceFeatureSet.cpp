@@ -168,6 +168,10 @@ bool DeviceFeatureSet::isExtensionSupported(Extensions extension) const {
     return hasESExtension(*this, "GL_EXT_multisampled_render_to_texture");
   case Extensions::MultiSampleImg:
     return hasESExtension(*this, "GL_IMG_multisampled_render_to_texture");
+  case Extensions::ParallelShaderCompileArb:
+    return hasDesktopExtension(*this, "GL_ARB_parallel_shader_compile");
+  case Extensions::ParallelShaderCompileKhr:
+    return hasDesktopOrESExtension(*this, "GL_KHR_parallel_shader_compile");
   case Extensions::RequiredInternalFormat:
     return hasESExtension(*this, "GL_OES_required_internalformat");
   case Extensions::ShaderImageLoadStore:
@@ -380,6 +384,10 @@ bool DeviceFeatureSet::isFeatureSupported(DeviceFeatures feature) const {
 
 bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) const {
   switch (feature) {
+  case InternalFeatures::BufferStorage:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v4_4, "GL_ARB_buffer_storage") ||
+           hasESExtension(*this, "GL_EXT_buffer_storage");
+
   case InternalFeatures::ClearDepthf:
     return hasDesktopOrESVersion(*this, GLVersion::v4_1, GLVersion::v2_0_ES);
 
@@ -416,6 +424,17 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
   case InternalFeatures::MapBuffer:
     return hasDesktopVersion(*this, GLVersion::v2_0) || hasExtension(Extensions::MapBuffer);
 
+  case InternalFeatures::MultiBind:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v4_4, "GL_ARB_multi_bind");
+
+  case InternalFeatures::MultiDrawIndirect:
+    return hasDesktopVersionOrExtension(*this, GLVersion::v4_3, "GL_ARB_multi_draw_indirect") ||
+           hasESExtension(*this, "GL_EXT_multi_draw_indirect");
+
+  case InternalFeatures::ParallelShaderCompile:
+    return hasExtension(Extensions::ParallelShaderCompileArb) ||
+           hasExtension(Extensions::ParallelShaderCompileKhr);
+
   case InternalFeatures::PixelBufferObject:
     return hasDesktopOrESVersionOrExtension(*this,
                                             GLVersion::v2_1,
@@ -426,10 +445,21 @@ bool DeviceFeatureSet::isInternalFeatureSupported(InternalFeatures feature) cons
   case InternalFeatures::PolygonFillMode:
     return hasDesktopVersion(*this, GLVersion::v2_0);
 
+  case InternalFeatures::ProgramBinary:
+    return hasDesktopOrESVersionOrExtension(*this,
+                                            GLVersion::v4_1,
+                                            GLVersion::v3_0_ES,
+                                            "GL_ARB_get_program_binary",
+                                            "GL_OES_get_program_binary");
+
   case InternalFeatures::ProgramInterfaceQuery:
     return hasDesktopOrESVersion(*this, GLVersion::v4_3, GLVersion::v3_1_ES) ||
            hasDesktopExtension(*this, "GL_ARB_program_interface_query");
 
+  case InternalFeatures::SamplerObjects:
+    return hasDesktopOrESVersion(*this, GLVersion::v3_3, GLVersion::v3_0_ES) ||
+           hasDesktopExtension(*this, "GL_ARB_sampler_objects");
+
   case InternalFeatures::SeamlessCubeMap:
     return hasDesktopVersionOrExtension(*this, GLVersion::v3_2, "GL_ARB_seamless_cube_map");
 
@@ -873,6 +903,10 @@ bool DeviceFeatureSet::hasRequirement(DeviceRequirement requirement) const {
 
 bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) const {
   switch (requirement) {
+  case InternalRequirement::BufferStorageExtReq:
+    // OpenGL ES only has GL_EXT_buffer_storage
+    return usesOpenGLES();
+
   case InternalRequirement::ColorTexImageRgb5A1Unsized:
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
@@ -928,6 +962,10 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
     // OpenGL ES 2 does not include MapBufferRange
     return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
 
+  case InternalRequirement::MultiDrawIndirectExtReq:
+    // OpenGL ES only has GL_EXT_multi_draw_indirect
+    return usesOpenGLES();
+
   case InternalRequirement::MultiSampleExtReq:
     // OpenGL ES has various extensions before 3.0 that are required, and
     // GL_IMG_multisampled_render_to_texture uses different enum values than later standard
@@ -936,6 +974,10 @@ bool DeviceFeatureSet::hasInternalRequirement(InternalRequirement requirement) c
              hasExtension(Extensions::FramebufferObject) ||
              hasESVersion(*this, GLVersion::v3_0_ES));
 
+  case InternalRequirement::ProgramBinaryExtReq:
+    // OpenGL ES 2 only has GL_OES_get_program_binary
+    return usesOpenGLES() && !hasESVersion(*this, GLVersion::v3_0_ES);
+
   case InternalRequirement::ShaderImageLoadStoreExtReq:
     return !usesOpenGLES() && !hasDesktopVersion(*this, GLVersion::v4_2);
 
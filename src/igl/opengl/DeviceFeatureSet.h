@@ -40,6 +40,8 @@ enum class Extensions {
   MultiSampleApple,           // GL_APPLE_framebuffer_multisample is supported
   MultiSampleExt,             // GL_EXT_multisampled_render_to_texture is supported
   MultiSampleImg,             // GL_IMG_multisampled_render_to_texture is supported
+  ParallelShaderCompileArb,   // GL_ARB_parallel_shader_compile is supported
+  ParallelShaderCompileKhr,   // GL_KHR_parallel_shader_compile is supported
   RequiredInternalFormat,     // GL_OES_required_internalformat is supported
   ShaderImageLoadStore,       // GL_EXT_shader_image_load_store is supported
   Srgb,                       // GL_EXT_sRGB is supported
@@ -62,6 +64,7 @@ enum class Extensions {
 
 // clang-format off
 enum class InternalFeatures {
+  BufferStorage,             // glBufferStorage is supported
   ClearDepthf,               // glClearDepthf is supported
   DebugLabel,                // Debug labels on objects are supported
   DebugMessage,              // Debug messages and group markers are supported
@@ -71,9 +74,14 @@ enum class InternalFeatures {
   GetStringi,                // GetStringi is supported
   InvalidateFramebuffer,     // glInvalidateFramebuffer is supported
   MapBuffer,                 // glMapBuffer is supported
+  MultiBind,                 // glBindTextures and glBindSamplers are supported
+  MultiDrawIndirect,         // glMultiDrawElementsIndirect is supported
+  ParallelShaderCompile,     // GL_COMPLETION_STATUS_KHR can be queried without blocking
   PixelBufferObject,         // PBOs are available
   PolygonFillMode,           // glPolygonFillMode is supported
+  ProgramBinary,             // glGetProgramBinary and glProgramBinary are supported
   ProgramInterfaceQuery,     // Querying info about shader program interfaces is supported
+  SamplerObjects,            // Sampler objects are supported
   SeamlessCubeMap,           // GL_TEXTURE_CUBE_MAP_SEAMLESS is supported
   ShaderImageLoadStore,      // Shader image load/store is supported
   Sync,                      // Sync objects are supported
@@ -152,6 +160,7 @@ enum class TextureFeatures {
 // clang-format on
 
 enum class InternalRequirement {
+  BufferStorageExtReq,
   ColorTexImageRgb10A2Unsized,
   ColorTexImageRgb5A1Unsized,
   ColorTexImageRgba4Unsized,
@@ -167,7 +176,9 @@ enum class InternalRequirement {
   InvalidateFramebufferExtReq,
   MapBufferExtReq,
   MapBufferRangeExtReq,
+  MultiDrawIndirectExtReq,
   MultiSampleExtReq,
+  ProgramBinaryExtReq,
   ShaderImageLoadStoreExtReq,
   SyncExtReq,
   SwizzleAlphaTexturesReq,
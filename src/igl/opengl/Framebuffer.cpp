@@ -13,6 +13,7 @@
 #include <igl/opengl/Device.h>
 #include <igl/opengl/DummyTexture.h>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/PixelBuffer.h>
 
 #include <algorithm>
 #if !IGL_PLATFORM_ANDROID
@@ -202,10 +203,51 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* unused */,
                                            void* pixelBytes,
                                            const TextureRangeDesc& range,
                                            size_t bytesPerRow) const {
+  readPixelsColorAttachment(index, pixelBytes, range, bytesPerRow);
+}
+
+std::unique_ptr<PixelPackBufferReadback> Framebuffer::copyBytesColorAttachmentAsync(
+    size_t index,
+    const TextureRangeDesc& range,
+    size_t bytesPerRow,
+    Result* outResult) const {
+  if (!getContext().deviceFeatures().hasInternalFeature(InternalFeatures::PixelBufferObject) ||
+      !getContext().deviceFeatures().hasFeature(DeviceFeatures::MapBufferRange)) {
+    Result::setResult(outResult, Result::Code::Unsupported, "Pixel buffer objects not supported");
+    return nullptr;
+  }
+  auto itexture = getColorAttachment(index);
+  if (index != 0 || itexture == nullptr) {
+    Result::setResult(outResult, Result::Code::ArgumentInvalid, "Invalid color attachment index");
+    return nullptr;
+  }
+  if (bytesPerRow == 0) {
+    bytesPerRow = itexture->getProperties().getBytesPerRow(range);
+  }
+
+  // binds the new buffer to GL_PIXEL_PACK_BUFFER, which turns pixelBytes into an offset
+  std::unique_ptr<PixelPackBufferReadback> readback(new PixelPackBufferReadback(
+      getContext(), itexture->getProperties().getBytesPerRange(range, bytesPerRow)));
+  const Result result = readPixelsColorAttachment(index, nullptr, range, bytesPerRow);
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  if (!result.isOk()) {
+    Result::setResult(outResult, result);
+    return nullptr;
+  }
+  readback->insertFence();
+
+  Result::setResult(outResult, Result::Code::Ok);
+  return readback;
+}
+
+Result Framebuffer::readPixelsColorAttachment(size_t index,
+                                              void* pixelBytes,
+                                              const TextureRangeDesc& range,
+                                              size_t bytesPerRow) const {
   // Only support attachment 0 because that's what glReadPixels supports
   if (index != 0) {
     IGL_ASSERT_MSG(0, "Invalid index: %d", index);
-    return;
+    return Result{Result::Code::ArgumentInvalid, "Invalid index"};
   }
   IGL_ASSERT_MSG(range.numFaces == 1, "range.numFaces MUST be 1");
   IGL_ASSERT_MSG(range.numLayers == 1, "range.numLayers MUST be 1");
@@ -214,7 +256,7 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* unused */,
   auto itexture = getColorAttachment(index);
   if (itexture == nullptr) {
     IGL_ASSERT_MSG(0, "The framebuffer does not have any color attachment at index %d", index);
-    return;
+    return Result{Result::Code::ArgumentInvalid, "No color attachment"};
   }
 
   FramebufferBindingGuard const guard(getContext());
@@ -322,6 +364,7 @@ void Framebuffer::copyBytesColorAttachment(ICommandQueue& /* unused */,
   getContext().checkForErrors(nullptr, 0);
   auto error = getContext().getLastError();
   IGL_ASSERT_MSG(error.isOk(), error.message.c_str());
+  return error;
 }
 
 void Framebuffer::copyBytesDepthAttachment(ICommandQueue& /* unused */,
@@ -16,6 +16,7 @@
 namespace igl {
 class ICommandBuffer;
 namespace opengl {
+class PixelPackBufferReadback;
 
 ///--------------------------------------
 /// MARK: - FramebufferBindingGuard
@@ -49,6 +50,15 @@ class Framebuffer : public WithContext, public IFramebuffer {
                                 const TextureRangeDesc& range,
                                 size_t bytesPerRow = 0) const override;
 
+  /// Like copyBytesColorAttachment(), but glReadPixels writes into a pixel buffer object and the
+  /// call returns without waiting for the GPU. Returns nullptr if pixel buffer objects are not
+  /// supported.
+  std::unique_ptr<PixelPackBufferReadback> copyBytesColorAttachmentAsync(
+      size_t index,
+      const TextureRangeDesc& range,
+      size_t bytesPerRow = 0,
+      Result* outResult = nullptr) const;
+
   void copyBytesDepthAttachment(ICommandQueue& /* unused */,
                                 void* pixelBytes,
                                 const TextureRangeDesc& range,
@@ -79,6 +89,11 @@ class Framebuffer : public WithContext, public IFramebuffer {
                      const Texture::AttachmentParams& params) const;
   void attachAsDepth(igl::ITexture& texture, const Texture::AttachmentParams& params) const;
   void attachAsStencil(igl::ITexture& texture, const Texture::AttachmentParams& params) const;
+  // pixelBytes is an offset if a GL_PIXEL_PACK_BUFFER is bound
+  Result readPixelsColorAttachment(size_t index,
+                                   void* pixelBytes,
+                                   const TextureRangeDesc& range,
+                                   size_t bytesPerRow) const;
   // NOLINTNEXTLINE(misc-non-private-member-variables-in-classes)
   GLuint frameBufferID_ = 0;
 
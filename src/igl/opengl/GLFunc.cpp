@@ -412,15 +412,27 @@ void iglRenderbufferStorageMultisampleAPPLE(GLenum target,
 /// MARK: - GL_APPLE_sync
 
 #if defined(GL_APPLE_sync)
+#define CAN_CALL_glClientWaitSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glDeleteSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glFenceSyncAPPLE CAN_CALL_OPENGL_ES
 #define CAN_CALL_glGetSyncivAPPLE CAN_CALL_OPENGL_ES
 #else
+#define CAN_CALL_glClientWaitSyncAPPLE 0
 #define CAN_CALL_glDeleteSyncAPPLE 0
 #define CAN_CALL_glFenceSyncAPPLE 0
 #define CAN_CALL_glGetSyncivAPPLE 0
 #endif
 
+GLenum iglClientWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glClientWaitSyncAPPLE,
+                                      glClientWaitSyncAPPLE,
+                                      PFNIGLCLIENTWAITSYNCPROC,
+                                      GL_WAIT_FAILED,
+                                      sync,
+                                      flags,
+                                      timeout);
+}
+
 void iglDeleteSyncAPPLE(GLsync sync) {
   GLEXTENSION_METHOD_BODY(
       CAN_CALL_glDeleteSyncAPPLE, glDeleteSyncAPPLE, PFNIGLDELETESYNCPROC, sync);
@@ -477,6 +489,25 @@ void iglMakeTextureHandleNonResidentARB(GLuint64 handle) {
                           handle);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_buffer_storage
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+#define CAN_CALL_glBufferStorage CAN_CALL
+#else
+#define CAN_CALL_glBufferStorage 0
+#endif
+
+void iglBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBufferStorage,
+                          glBufferStorage,
+                          PFNIGLBUFFERSTORAGEPROC,
+                          target,
+                          size,
+                          data,
+                          flags);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_compute_shader
 
@@ -798,6 +829,103 @@ void* iglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbit
                                       access);
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_get_program_binary
+
+#if defined(GL_VERSION_4_1) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_get_program_binary)
+#define CAN_CALL_glGetProgramBinary CAN_CALL
+#define CAN_CALL_glProgramBinary CAN_CALL
+#else
+#define CAN_CALL_glGetProgramBinary 0
+#define CAN_CALL_glProgramBinary 0
+#endif
+
+void iglGetProgramBinary(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLenum* binaryFormat,
+                         void* binary) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetProgramBinary,
+                          glGetProgramBinary,
+                          PFNIGLGETPROGRAMBINARYPROC,
+                          program,
+                          bufSize,
+                          length,
+                          binaryFormat,
+                          binary);
+}
+
+void iglProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glProgramBinary,
+                          glProgramBinary,
+                          PFNIGLPROGRAMBINARYPROC,
+                          program,
+                          binaryFormat,
+                          binary,
+                          length);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_multi_bind
+
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_multi_bind)
+#define CAN_CALL_glBindSamplers CAN_CALL
+#define CAN_CALL_glBindTextures CAN_CALL
+#else
+#define CAN_CALL_glBindSamplers 0
+#define CAN_CALL_glBindTextures 0
+#endif
+
+void iglBindSamplers(GLuint first, GLsizei count, const GLuint* samplers) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glBindSamplers, glBindSamplers, PFNIGLBINDSAMPLERSPROC, first, count, samplers);
+}
+
+void iglBindTextures(GLuint first, GLsizei count, const GLuint* textures) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glBindTextures, glBindTextures, PFNIGLBINDTEXTURESPROC, first, count, textures);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_multi_draw_indirect
+
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+#define CAN_CALL_glMultiDrawElementsIndirect CAN_CALL
+#else
+#define CAN_CALL_glMultiDrawElementsIndirect 0
+#endif
+
+void iglMultiDrawElementsIndirect(GLenum mode,
+                                  GLenum type,
+                                  const GLvoid* indirect,
+                                  GLsizei drawcount,
+                                  GLsizei stride) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMultiDrawElementsIndirect,
+                          glMultiDrawElementsIndirect,
+                          PFNIGLMULTIDRAWELEMENTSINDIRECTPROC,
+                          mode,
+                          type,
+                          indirect,
+                          drawcount,
+                          stride);
+}
+
+///--------------------------------------
+/// MARK: - GL_ARB_parallel_shader_compile
+
+#if defined(GL_ARB_parallel_shader_compile)
+#define CAN_CALL_glMaxShaderCompilerThreadsARB CAN_CALL
+#else
+#define CAN_CALL_glMaxShaderCompilerThreadsARB 0
+#endif
+
+void iglMaxShaderCompilerThreadsARB(GLuint count) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMaxShaderCompilerThreadsARB,
+                          glMaxShaderCompilerThreadsARB,
+                          PFNIGLMAXSHADERCOMPILERTHREADSPROC,
+                          count);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_program_interface_query
 
@@ -874,6 +1002,56 @@ void iglGetProgramResourceName(GLuint program,
                           name)
 }
 
+///--------------------------------------
+/// MARK: - GL_ARB_sampler_objects
+
+#if defined(GL_VERSION_3_3) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_sampler_objects)
+#define CAN_CALL_glBindSampler CAN_CALL
+#define CAN_CALL_glDeleteSamplers CAN_CALL
+#define CAN_CALL_glGenSamplers CAN_CALL
+#define CAN_CALL_glSamplerParameterf CAN_CALL
+#define CAN_CALL_glSamplerParameteri CAN_CALL
+#else
+#define CAN_CALL_glBindSampler 0
+#define CAN_CALL_glDeleteSamplers 0
+#define CAN_CALL_glGenSamplers 0
+#define CAN_CALL_glSamplerParameterf 0
+#define CAN_CALL_glSamplerParameteri 0
+#endif
+
+void iglBindSampler(GLuint unit, GLuint sampler) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glBindSampler, glBindSampler, PFNIGLBINDSAMPLERPROC, unit, sampler);
+}
+
+void iglDeleteSamplers(GLsizei n, const GLuint* samplers) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glDeleteSamplers, glDeleteSamplers, PFNIGLDELETESAMPLERSPROC, n, samplers);
+}
+
+void iglGenSamplers(GLsizei n, GLuint* samplers) {
+  GLEXTENSION_METHOD_BODY(
+      CAN_CALL_glGenSamplers, glGenSamplers, PFNIGLGENSAMPLERSPROC, n, samplers);
+}
+
+void iglSamplerParameterf(GLuint sampler, GLenum pname, GLfloat param) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glSamplerParameterf,
+                          glSamplerParameterf,
+                          PFNIGLSAMPLERPARAMETERFPROC,
+                          sampler,
+                          pname,
+                          param);
+}
+
+void iglSamplerParameteri(GLuint sampler, GLenum pname, GLint param) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glSamplerParameteri,
+                          glSamplerParameteri,
+                          PFNIGLSAMPLERPARAMETERIPROC,
+                          sampler,
+                          pname,
+                          param);
+}
+
 ///--------------------------------------
 /// MARK: - GL_ARB_shader_image_load_store
 
@@ -913,15 +1091,27 @@ void iglMemoryBarrier(GLbitfield barriers) {
 /// MARK: - GL_ARB_sync
 
 #if defined(GL_VERSION_3_2) || defined(GL_ES_VERSION_3_0) || defined(GL_ARB_sync)
+#define CAN_CALL_glClientWaitSync CAN_CALL
 #define CAN_CALL_glDeleteSync CAN_CALL
 #define CAN_CALL_glFenceSync CAN_CALL
 #define CAN_CALL_glGetSynciv CAN_CALL
 #else
+#define CAN_CALL_glClientWaitSync 0
 #define CAN_CALL_glDeleteSync 0
 #define CAN_CALL_glFenceSync 0
 #define CAN_CALL_glGetSynciv 0
 #endif
 
+GLenum iglClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  GLEXTENSION_METHOD_BODY_WITH_RETURN(CAN_CALL_glClientWaitSync,
+                                      glClientWaitSync,
+                                      PFNIGLCLIENTWAITSYNCPROC,
+                                      GL_WAIT_FAILED,
+                                      sync,
+                                      flags,
+                                      timeout);
+}
+
 void iglDeleteSync(GLsync sync) {
   GLEXTENSION_METHOD_BODY(CAN_CALL_glDeleteSync, glDeleteSync, PFNIGLDELETESYNCPROC, sync);
 }
@@ -1125,6 +1315,25 @@ void iglGenVertexArrays(GLsizei n, GLuint* vertexArrays) {
       CAN_CALL_glGenVertexArrays, glGenVertexArrays, PFNIGLGENVERTEXARRAYSPROC, n, vertexArrays);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_buffer_storage
+
+#if defined(GL_EXT_buffer_storage)
+#define CAN_CALL_glBufferStorageEXT CAN_CALL
+#else
+#define CAN_CALL_glBufferStorageEXT 0
+#endif
+
+void iglBufferStorageEXT(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glBufferStorageEXT,
+                          glBufferStorageEXT,
+                          PFNIGLBUFFERSTORAGEPROC,
+                          target,
+                          size,
+                          data,
+                          flags);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_debug_label
 
@@ -1362,6 +1571,30 @@ void iglImportMemoryFdEXT(GLuint memory, GLuint64 size, GLenum handleType, GLint
                           fd);
 }
 
+///--------------------------------------
+/// MARK: - GL_EXT_multi_draw_indirect
+
+#if defined(GL_EXT_multi_draw_indirect)
+#define CAN_CALL_glMultiDrawElementsIndirectEXT CAN_CALL
+#else
+#define CAN_CALL_glMultiDrawElementsIndirectEXT 0
+#endif
+
+void iglMultiDrawElementsIndirectEXT(GLenum mode,
+                                     GLenum type,
+                                     const GLvoid* indirect,
+                                     GLsizei drawcount,
+                                     GLsizei stride) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMultiDrawElementsIndirectEXT,
+                          glMultiDrawElementsIndirectEXT,
+                          PFNIGLMULTIDRAWELEMENTSINDIRECTPROC,
+                          mode,
+                          type,
+                          indirect,
+                          drawcount,
+                          stride);
+}
+
 ///--------------------------------------
 /// MARK: - GL_EXT_multisampled_render_to_texture
 
@@ -1647,6 +1880,22 @@ void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar
                           message);
 }
 
+///--------------------------------------
+/// MARK: - GL_KHR_parallel_shader_compile
+
+#if defined(GL_KHR_parallel_shader_compile)
+#define CAN_CALL_glMaxShaderCompilerThreadsKHR CAN_CALL
+#else
+#define CAN_CALL_glMaxShaderCompilerThreadsKHR 0
+#endif
+
+void iglMaxShaderCompilerThreadsKHR(GLuint count) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glMaxShaderCompilerThreadsKHR,
+                          glMaxShaderCompilerThreadsKHR,
+                          PFNIGLMAXSHADERCOMPILERTHREADSPROC,
+                          count);
+}
+
 ///--------------------------------------
 /// MARK: - GL_NV_bindless_texture
 
@@ -1774,6 +2023,42 @@ void iglUnmapBufferOES(GLenum target) {
       CAN_CALL_glUnmapBufferOES, glUnmapBufferOES, PFNIGLUNMAPBUFFERPROC, target);
 }
 
+///--------------------------------------
+/// MARK: - GL_OES_get_program_binary
+
+#if defined(GL_OES_get_program_binary)
+#define CAN_CALL_glGetProgramBinaryOES CAN_CALL_OPENGL_ES
+#define CAN_CALL_glProgramBinaryOES CAN_CALL_OPENGL_ES
+#else
+#define CAN_CALL_glGetProgramBinaryOES 0
+#define CAN_CALL_glProgramBinaryOES 0
+#endif
+
+void iglGetProgramBinaryOES(GLuint program,
+                            GLsizei bufSize,
+                            GLsizei* length,
+                            GLenum* binaryFormat,
+                            void* binary) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glGetProgramBinaryOES,
+                          glGetProgramBinaryOES,
+                          PFNIGLGETPROGRAMBINARYPROC,
+                          program,
+                          bufSize,
+                          length,
+                          binaryFormat,
+                          binary);
+}
+
+void iglProgramBinaryOES(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) {
+  GLEXTENSION_METHOD_BODY(CAN_CALL_glProgramBinaryOES,
+                          glProgramBinaryOES,
+                          PFNIGLPROGRAMBINARYPROC,
+                          program,
+                          binaryFormat,
+                          binary,
+                          length);
+}
+
 ///--------------------------------------
 /// MARK: - GL_OES_texture_3D
 
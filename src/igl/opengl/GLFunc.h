@@ -42,6 +42,9 @@ using PFNIGLBINDIMAGETEXTUREPROC = void (*)(GLuint unit,
                                             GLint layer,
                                             GLenum access,
                                             GLenum format);
+using PFNIGLBINDSAMPLERPROC = void (*)(GLuint unit, GLuint sampler);
+using PFNIGLBINDSAMPLERSPROC = void (*)(GLuint first, GLsizei count, const GLuint* samplers);
+using PFNIGLBINDTEXTURESPROC = void (*)(GLuint first, GLsizei count, const GLuint* textures);
 using PFNIGLBINDRENDERBUFFERPROC = void (*)(GLenum target, GLuint renderbuffer);
 using PFNIGLBINDVERTEXARRAYPROC = void (*)(GLuint vao);
 using PFNIGLBLITFRAMEBUFFERPROC = void (*)(GLint srcX0,
@@ -54,9 +57,14 @@ using PFNIGLBLITFRAMEBUFFERPROC = void (*)(GLint srcX0,
                                            GLint dstY1,
                                            GLbitfield mask,
                                            GLenum filter);
+using PFNIGLBUFFERSTORAGEPROC = void (*)(GLenum target,
+                                         GLsizeiptr size,
+                                         const void* data,
+                                         GLbitfield flags);
 using PFNIGLCHECKFRAMEBUFFERSTATUSPROC = GLenum (*)(GLenum target);
 using PFNIGLCLEARDEPTHPROC = void (*)(GLdouble depth);
 using PFNIGLCLEARDEPTHFPROC = void (*)(GLfloat depth);
+using PFNIGLCLIENTWAITSYNCPROC = GLenum (*)(GLsync sync, GLbitfield flags, GLuint64 timeout);
 using PFNIGLCOMPRESSEDTEXIMAGE3DPROC = void (*)(GLenum target,
                                                 GLint level,
                                                 GLenum internalformat,
@@ -95,6 +103,7 @@ using PFNIGLDEBUGMESSAGEINSERTPROC = void (*)(GLenum source,
 using PFNIGLDELETEFRAMEBUFFERSPROC = void (*)(GLsizei n, const GLuint* framebuffers);
 using PFNIGLDELETEMEMORYOBJECTSPROC = void (*)(GLsizei n, const GLuint* memoryObjects);
 using PFNIGLDELETERENDERBUFFERSPROC = void (*)(GLsizei n, const GLuint* renderbuffers);
+using PFNIGLDELETESAMPLERSPROC = void (*)(GLsizei n, const GLuint* samplers);
 using PFNIGLDELETESYNCPROC = void (*)(GLsync sync);
 using PFNIGLDELETEVERTEXARRAYSPROC = void (*)(GLsizei n, const GLuint* vertexArrays);
 using PFNIGLDISCARDFRAMEBUFFERPROC = void (*)(GLenum target,
@@ -136,6 +145,7 @@ using PFNIGLFRAMEBUFFERTEXTUREMULTIVIEWPROC = void (*)(GLenum target,
 using PFNIGLGENERATEMIPMAPPROC = void (*)(GLenum target);
 using PFNIGLGENFRAMEBUFFERSPROC = void (*)(GLsizei n, GLuint* framebuffers);
 using PFNIGLGENRENDERBUFFERSPROC = void (*)(GLsizei n, GLuint* renderbuffers);
+using PFNIGLGENSAMPLERSPROC = void (*)(GLsizei n, GLuint* samplers);
 using PFNIGLGENVERTEXARRAYSPROC = void (*)(GLsizei n, GLuint* vertexArrays);
 using PFNIGLGETACTIVEUNIFORMSIVPROC = void (*)(GLuint program,
                                                GLsizei uniformCount,
@@ -163,6 +173,11 @@ using PFNIGLGETFRAMEBUFFERATTACHMENTPARAMETERIVPROC = void (*)(GLenum target,
                                                                GLenum attachment,
                                                                GLenum pname,
                                                                GLint* params);
+using PFNIGLGETPROGRAMBINARYPROC = void (*)(GLuint program,
+                                            GLsizei bufSize,
+                                            GLsizei* length,
+                                            GLenum* binaryFormat,
+                                            void* binary);
 using PFNIGLGETPROGRAMINTERFACEIVPROC = void (*)(GLuint program,
                                                  GLenum programInterface,
                                                  GLenum pname,
@@ -207,11 +222,18 @@ using PFNIGLMAPBUFFERRANGEPROC = void* (*)(GLenum target,
                                            GLintptr offset,
                                            GLsizeiptr length,
                                            GLbitfield access);
+using PFNIGLMAXSHADERCOMPILERTHREADSPROC = void (*)(GLuint count);
 using PFNIGLMEMORYBARRIERPROC = void (*)(GLbitfield barriers);
+using PFNIGLMULTIDRAWELEMENTSINDIRECTPROC =
+    void (*)(GLenum mode, GLenum type, const GLvoid* indirect, GLsizei drawcount, GLsizei stride);
 using PFNIGLOBJECTLABELPROC = void (*)(GLenum identifier,
                                        GLuint name,
                                        GLsizei length,
                                        const char* label);
+using PFNIGLPROGRAMBINARYPROC = void (*)(GLuint program,
+                                         GLenum binaryFormat,
+                                         const void* binary,
+                                         GLsizei length);
 using PFNIGLPOPDEBUGGROUPPROC = void (*)();
 using PFNIGLPOPGROUPMARKERPROC = void (*)();
 using PFNIGLPUSHDEBUGGROUPPROC = void (*)(GLenum source,
@@ -225,6 +247,8 @@ using PFNIGLRENDERBUFFERSTORAGEPROC = void (*)(GLenum target,
                                                GLsizei height);
 using PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC =
     void (*)(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
+using PFNIGLSAMPLERPARAMETERFPROC = void (*)(GLuint sampler, GLenum pname, GLfloat param);
+using PFNIGLSAMPLERPARAMETERIPROC = void (*)(GLuint sampler, GLenum pname, GLint param);
 using PFNIGLTEXIMAGE3DPROC = void (*)(GLenum target,
                                       GLint level,
                                       GLint internalformat,
@@ -361,6 +385,7 @@ void iglRenderbufferStorageMultisampleAPPLE(GLenum target,
 ///--------------------------------------
 /// MARK: - GL_APPLE_sync
 
+GLenum iglClientWaitSyncAPPLE(GLsync sync, GLbitfield flags, GLuint64 timeout);
 void iglDeleteSyncAPPLE(GLsync sync);
 GLsync iglFenceSyncAPPLE(GLenum condition, GLbitfield flags);
 void iglGetSyncivAPPLE(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
@@ -372,6 +397,11 @@ GLuint64 iglGetTextureHandleARB(GLuint texture);
 void iglMakeTextureHandleResidentARB(GLuint64 handle);
 void iglMakeTextureHandleNonResidentARB(GLuint64 handle);
 
+///--------------------------------------
+/// MARK: - GL_ARB_buffer_storage
+
+void iglBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_compute_shader
 
@@ -446,6 +476,36 @@ void iglInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenu
 
 void* iglMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
 
+///--------------------------------------
+/// MARK: - GL_ARB_get_program_binary
+
+void iglGetProgramBinary(GLuint program,
+                         GLsizei bufSize,
+                         GLsizei* length,
+                         GLenum* binaryFormat,
+                         void* binary);
+void iglProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
+///--------------------------------------
+/// MARK: - GL_ARB_multi_bind
+
+void iglBindSamplers(GLuint first, GLsizei count, const GLuint* samplers);
+void iglBindTextures(GLuint first, GLsizei count, const GLuint* textures);
+
+///--------------------------------------
+/// MARK: - GL_ARB_multi_draw_indirect
+
+void iglMultiDrawElementsIndirect(GLenum mode,
+                                  GLenum type,
+                                  const GLvoid* indirect,
+                                  GLsizei drawcount,
+                                  GLsizei stride);
+
+///--------------------------------------
+/// MARK: - GL_ARB_parallel_shader_compile
+
+void iglMaxShaderCompilerThreadsARB(GLuint count);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_program_interface_query
 
@@ -466,6 +526,15 @@ void iglGetProgramResourceName(GLuint program,
                                GLsizei* length,
                                char* name);
 
+///--------------------------------------
+/// MARK: - GL_ARB_sampler_objects
+
+void iglBindSampler(GLuint unit, GLuint sampler);
+void iglDeleteSamplers(GLsizei n, const GLuint* samplers);
+void iglGenSamplers(GLsizei n, GLuint* samplers);
+void iglSamplerParameterf(GLuint sampler, GLenum pname, GLfloat param);
+void iglSamplerParameteri(GLuint sampler, GLenum pname, GLint param);
+
 ///--------------------------------------
 /// MARK: - GL_ARB_shader_image_load_store
 
@@ -481,6 +550,7 @@ void iglMemoryBarrier(GLbitfield barriers);
 ///--------------------------------------
 /// MARK: - GL_ARB_sync
 
+GLenum iglClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
 void iglDeleteSync(GLsync sync);
 GLsync iglFenceSync(GLenum condition, GLbitfield flags);
 void iglGetSynciv(GLsync sync, GLenum pname, GLsizei bufSize, GLsizei* length, GLint* values);
@@ -531,6 +601,11 @@ void iglBindVertexArray(GLuint vao);
 void iglDeleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
 void iglGenVertexArrays(GLsizei n, GLuint* vertexArrays);
 
+///--------------------------------------
+/// MARK: - GL_EXT_buffer_storage
+
+void iglBufferStorageEXT(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_debug_label
 
@@ -606,6 +681,15 @@ void iglTexStorageMem3DEXT(GLenum target,
 
 void iglImportMemoryFdEXT(GLuint memory, GLuint64 size, GLenum handleType, GLint fd);
 
+///--------------------------------------
+/// MARK: - GL_EXT_multi_draw_indirect
+
+void iglMultiDrawElementsIndirectEXT(GLenum mode,
+                                     GLenum type,
+                                     const GLvoid* indirect,
+                                     GLsizei drawcount,
+                                     GLsizei stride);
+
 ///--------------------------------------
 /// MARK: - GL_EXT_multisampled_render_to_texture
 
@@ -686,6 +770,11 @@ void iglObjectLabelKHR(GLenum identifier, GLuint name, GLsizei length, const cha
 void iglPopDebugGroupKHR();
 void iglPushDebugGroupKHR(GLenum source, GLuint id, GLsizei length, const GLchar* message);
 
+///--------------------------------------
+/// MARK: - GL_KHR_parallel_shader_compile
+
+void iglMaxShaderCompilerThreadsKHR(GLuint count);
+
 ///--------------------------------------
 /// MARK: - GL_NV_bindless_texture
 
@@ -724,6 +813,16 @@ void iglFramebufferTextureMultisampleMultiviewOVR(GLenum target,
 void* iglMapBufferOES(GLenum target, GLbitfield access);
 void iglUnmapBufferOES(GLenum target);
 
+///--------------------------------------
+/// MARK: - GL_OES_get_program_binary
+
+void iglGetProgramBinaryOES(GLuint program,
+                            GLsizei bufSize,
+                            GLsizei* length,
+                            GLenum* binaryFormat,
+                            void* binary);
+void iglProgramBinaryOES(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+
 ///--------------------------------------
 /// MARK: - GL_OES_texture_3D
 
@@ -100,6 +100,9 @@
 #ifndef GL_ALPHA_BITS
 #define GL_ALPHA_BITS 0xd55
 #endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911a
+#endif
 #ifndef GL_ALPHA8
 #define GL_ALPHA8 0x803C
 #endif
@@ -133,9 +136,15 @@
 #ifndef GL_COLOR_ATTACHMENT1
 #define GL_COLOR_ATTACHMENT1 0x8ce1
 #endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
 #ifndef GL_COMPARE_REF_TO_TEXTURE
 #define GL_COMPARE_REF_TO_TEXTURE 0x884e
 #endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91b1
+#endif
 #ifndef GL_COMPRESSED_R11_EAC
 #define GL_COMPRESSED_R11_EAC 0x9270
 #endif
@@ -271,6 +280,9 @@
 #ifndef GL_COMPUTE_SHADER
 #define GL_COMPUTE_SHADER 0x91B9
 #endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911c
+#endif
 #ifndef GL_COPY_READ_BUFFER
 #define GL_COPY_READ_BUFFER 0x8f36
 #endif
@@ -373,6 +385,9 @@
 #ifndef GL_DYNAMIC_READ
 #define GL_DYNAMIC_READ 0x88e9
 #endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x100
+#endif
 #ifndef GL_ELEMENT_ARRAY_BARRIER_BIT
 #define GL_ELEMENT_ARRAY_BARRIER_BIT 0x2
 #endif
@@ -490,9 +505,24 @@
 #ifndef GL_LUMINANCE8_ALPHA8
 #define GL_LUMINANCE8_ALPHA8 0x8045
 #endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x80
+#endif
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+#define GL_MAP_INVALIDATE_RANGE_BIT 0x4
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x40
+#endif
 #ifndef GL_MAP_READ_BIT
 #define GL_MAP_READ_BIT 0x1
 #endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+#define GL_MAP_UNSYNCHRONIZED_BIT 0x20
+#endif
+#ifndef GL_MAP_WRITE_BIT
+#define GL_MAP_WRITE_BIT 0x2
+#endif
 #ifndef GL_MAX
 #define GL_MAX 0x8008
 #endif
@@ -532,6 +562,9 @@
 #ifndef GL_NUM_EXTENSIONS
 #define GL_NUM_EXTENSIONS 0x821d
 #endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87fe
+#endif
 #ifndef GL_PIXEL_PACK_BUFFER
 #define GL_PIXEL_PACK_BUFFER 0x88eb
 #endif
@@ -541,6 +574,12 @@
 #ifndef GL_PROGRAM
 #define GL_PROGRAM 0x82e2
 #endif
+#ifndef GL_PROGRAM_BINARY_FORMATS
+#define GL_PROGRAM_BINARY_FORMATS 0x87ff
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
 #ifndef GL_PROGRAM_OBJECT_EXT
 #define GL_PROGRAM_OBJECT_EXT 0x8B40
 #endif
@@ -697,9 +736,15 @@
 #ifndef GL_STREAM_COPY
 #define GL_STREAM_COPY 0x88e2
 #endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88e0
+#endif
 #ifndef GL_STREAM_READ
 #define GL_STREAM_READ 0x88e1
 #endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x1
+#endif
 #ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
 #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
 #endif
@@ -772,9 +817,15 @@
 #ifndef GL_TEXTURE_WRAP_R
 #define GL_TEXTURE_WRAP_R 0x8072
 #endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911b
+#endif
 #ifndef GL_TRANSFORM_FEEDBACK_BUFFER
 #define GL_TRANSFORM_FEEDBACK_BUFFER 0x8c8e
 #endif
+#ifndef GL_UNIFORM_ARRAY_STRIDE
+#define GL_UNIFORM_ARRAY_STRIDE 0x8a3c
+#endif
 #ifndef GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES
 #define GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES 0x8a43
 #endif
@@ -790,12 +841,21 @@
 #ifndef GL_UNIFORM_BUFFER
 #define GL_UNIFORM_BUFFER 0x8a11
 #endif
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8a34
+#endif
+#ifndef GL_UNIFORM_MATRIX_STRIDE
+#define GL_UNIFORM_MATRIX_STRIDE 0x8a3d
+#endif
 #ifndef GL_UNIFORM_OFFSET
 #define GL_UNIFORM_OFFSET 0x8a3b
 #endif
 #ifndef GL_UNPACK_ROW_LENGTH
 #define GL_UNPACK_ROW_LENGTH 0x0cf2
 #endif
+#ifndef GL_UNSIGNALED
+#define GL_UNSIGNALED 0x9118
+#endif
 #ifndef GL_UNSIGNED_INT_10F_11F_11F_REV
 #define GL_UNSIGNED_INT_10F_11F_11F_REV 0x8c3b
 #endif
@@ -832,3 +892,6 @@
 #ifndef GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
 #define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x1
 #endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911d
+#endif
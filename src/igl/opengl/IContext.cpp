@@ -8,12 +8,16 @@
 #include <igl/DeviceFeatures.h>
 #include <igl/opengl/IContext.h>
 
+#include <algorithm>
 #include <cstring>
 #include <igl/Assert.h>
+#include <igl/opengl/ApiTrace.h>
+#include <igl/opengl/Buffer.h>
 #include <igl/opengl/Errors.h>
 #include <igl/opengl/GLFunc.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/Macros.h>
+#include <igl/opengl/PixelBuffer.h>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -85,46 +89,48 @@ void logSource(const int count, const char** string, const int* length) {
 #define GLCALL(funcName)                                         \
   IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
   callCounter_++;                                                \
-  gl##funcName
+  traceApiCall(apiTrace_.get(), "gl" #funcName, callCounter_, gl##funcName)
 
 #define IGLCALL(funcName)                                        \
   IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
   callCounter_++;                                                \
-  igl##funcName
+  traceApiCall(apiTrace_.get(), "gl" #funcName, callCounter_, igl##funcName)
 
 #define GLCALL_WITH_RETURN(ret, funcName)                        \
   IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
   callCounter_++;                                                \
-  ret = gl##funcName
+  ret = traceApiCall(apiTrace_.get(), "gl" #funcName, callCounter_, gl##funcName)
 
 #define IGLCALL_WITH_RETURN(ret, funcName)                       \
   IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
   callCounter_++;                                                \
-  ret = igl##funcName
+  ret = traceApiCall(apiTrace_.get(), "gl" #funcName, callCounter_, igl##funcName)
 
-#define GLCALL_PROC(funcPtr, ...)                                \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup()); \
-  if (IGL_VERIFY(funcPtr)) {                                     \
-    callCounter_++;                                              \
-    (*funcPtr)(__VA_ARGS__);                                     \
+#define GLCALL_PROC(funcPtr, ...)                                                 \
+  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup());                  \
+  if (IGL_VERIFY(funcPtr)) {                                                      \
+    callCounter_++;                                                               \
+    traceApiCall(apiTrace_.get(), #funcPtr, callCounter_, *funcPtr)(__VA_ARGS__); \
   }
 
-#define GLCALL_PROC_WITH_RETURN(ret, funcPtr, returnOnError, ...) \
-  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup());  \
-  if (IGL_VERIFY(funcPtr)) {                                      \
-    callCounter_++;                                               \
-    ret = (*funcPtr)(__VA_ARGS__);                                \
-  } else {                                                        \
-    ret = returnOnError;                                          \
+#define GLCALL_PROC_WITH_RETURN(ret, funcPtr, returnOnError, ...)                       \
+  IGL_REPORT_ERROR(isCurrentContext() || isCurrentSharegroup());                        \
+  if (IGL_VERIFY(funcPtr)) {                                                            \
+    callCounter_++;                                                                     \
+    ret = traceApiCall(apiTrace_.get(), #funcPtr, callCounter_, *funcPtr)(__VA_ARGS__); \
+  } else {                                                                              \
+    ret = returnOnError;                                                                \
   }
 
-#if IGL_DEBUG
-#define GLCHECK_ERRORS()                      \
-  do {                                        \
-    if (alwaysCheckError_) {                  \
-      checkForErrors(__FUNCTION__, __LINE__); \
-    }                                         \
+// Counts down the GL calls left until the next automatic error check
+#define GLCHECK_ERRORS()                                            \
+  do {                                                              \
+    if (errorCheckCountdown_ != 0 && --errorCheckCountdown_ == 0) { \
+      checkForErrorsAutomatically(__FUNCTION__, __LINE__);          \
+    }                                                               \
   } while (false)
+
+#if IGL_DEBUG
 #define GL_ASSERT_ERROR(condition, callerName, lineNum, errorCode) \
   IGL_ASSERT_MSG((condition),                                      \
                  "[IGL] OpenGL error [%s:%zu] 0x%04X: %s\n",       \
@@ -133,7 +139,6 @@ void logSource(const int count, const char** string, const int* length) {
                  errorCode,                                        \
                  GL_ERROR_TO_STRING(errorCode))
 #else
-#define GLCHECK_ERRORS() static_cast<void>(0)
 #define GL_ASSERT_ERROR(condition, callerName, lineNum, errorCode) static_cast<void>(0)
 #endif // IGL_DEBUG
 
@@ -540,11 +545,13 @@ std::string GLenumToString(GLenum code) {
     RESULT_CASE(GL_TRIANGLE_FAN)
     RESULT_CASE(GL_TRIANGLE_STRIP)
     RESULT_CASE(GL_TRANSFORM_FEEDBACK_BUFFER)
+    RESULT_CASE(GL_UNIFORM_ARRAY_STRIDE)
     RESULT_CASE(GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES)
     RESULT_CASE(GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS)
     RESULT_CASE(GL_UNIFORM_BLOCK_BINDING)
     RESULT_CASE(GL_UNIFORM_BLOCK_DATA_SIZE)
     RESULT_CASE(GL_UNIFORM_BUFFER)
+    RESULT_CASE(GL_UNIFORM_MATRIX_STRIDE)
     RESULT_CASE(GL_UNIFORM_OFFSET)
     RESULT_CASE(GL_UNPACK_ALIGNMENT)
     RESULT_CASE(GL_UNPACK_ROW_LENGTH)
@@ -703,7 +710,7 @@ Result::Code GLerrorToCode(GLenum error) {
 IContext::IContext() : deviceFeatureSet_(*this) {
 #if IGL_DEBUG
   // In debug mode, we default to always checking errors after each OGL call
-  alwaysCheckError_ = true;
+  setErrorCheckMode(ErrorCheckMode::EveryCall);
 #endif
 #if defined(IGL_VALIDATE_SHADERS)
   shouldValidateShaders_ = true;
@@ -748,6 +755,15 @@ void IContext::willDestroy(void* glContext) {
   // Clear pool explicitly, since it might have reference back to IContext.
   getAdapterPool().clear();
   getComputeAdapterPool().clear();
+  pixelUnpackBufferRing_ = nullptr;
+  uniformBlockArena_ = nullptr;
+  for (const auto& [desc, sampler] : samplerObjects_) {
+    deleteSamplers(1, &sampler);
+  }
+  samplerObjects_.clear();
+  if (isCurrentContext() || isCurrentSharegroup()) {
+    deletionQueues_.flushDeletionQueue(*this, true);
+  }
   // Unregister context
   if (glContext != nullptr) {
     IContext::unregisterContext((void*)glContext);
@@ -764,6 +780,18 @@ void IContext::flushDeletionQueue() {
   deletionQueues_.flushDeletionQueue(*this);
 }
 
+void IContext::setDeletionQueueFlushBudget(std::chrono::microseconds budget) {
+  deletionQueues_.flushBudget = budget;
+}
+
+void IContext::setShouldDeferDeletionsUntilGpuIsDone(bool shouldDefer) {
+  deletionQueues_.deferUntilGpuIsDone = shouldDefer;
+}
+
+size_t IContext::getPendingDeletionCount() const {
+  return deletionQueues_.getPendingCount();
+}
+
 bool IContext::shouldQueueAPI() const {
   return !isCurrentContext() && !isCurrentSharegroup();
 }
@@ -820,12 +848,48 @@ void IContext::bindRenderbuffer(GLenum target, GLuint renderbuffer) {
   GLCHECK_ERRORS();
 }
 
+void IContext::bindSampler(GLuint unit, GLuint sampler) {
+  if (bindSamplerProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SamplerObjects)) {
+      bindSamplerProc_ = iglBindSampler;
+    }
+    IGL_ASSERT_MSG(bindSamplerProc_, "No supported function for glBindSampler\n");
+  }
+  GLCALL_PROC(bindSamplerProc_, unit, sampler);
+  APILOG("glBindSampler(%u, %u)\n", unit, sampler);
+  GLCHECK_ERRORS();
+}
+
+void IContext::bindSamplers(GLuint first, GLsizei count, const GLuint* samplers) {
+  if (bindSamplersProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::MultiBind)) {
+      bindSamplersProc_ = iglBindSamplers;
+    }
+    IGL_ASSERT_MSG(bindSamplersProc_, "No supported function for glBindSamplers\n");
+  }
+  GLCALL_PROC(bindSamplersProc_, first, count, samplers);
+  APILOG("glBindSamplers(%u, %d, %p)\n", first, count, samplers);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bindTexture(GLenum target, GLuint texture) {
   GLCALL(BindTexture)(target, texture);
   APILOG("glBindTexture(%s, %u)\n", GL_ENUM_TO_STRING(target), texture);
   GLCHECK_ERRORS();
 }
 
+void IContext::bindTextures(GLuint first, GLsizei count, const GLuint* textures) {
+  if (bindTexturesProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::MultiBind)) {
+      bindTexturesProc_ = iglBindTextures;
+    }
+    IGL_ASSERT_MSG(bindTexturesProc_, "No supported function for glBindTextures\n");
+  }
+  GLCALL_PROC(bindTexturesProc_, first, count, textures);
+  APILOG("glBindTextures(%u, %d, %p)\n", first, count, textures);
+  GLCHECK_ERRORS();
+}
+
 void IContext::bindImageTexture(GLuint unit,
                                 GLuint texture,
                                 GLint level,
@@ -959,6 +1023,26 @@ void IContext::bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, co
   GLCHECK_ERRORS();
 }
 
+void IContext::bufferStorage(GLenum target,
+                             GLsizeiptr size,
+                             const GLvoid* data,
+                             GLbitfield flags) {
+  if (bufferStorageProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::BufferStorageExtReq)) {
+      if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::BufferStorage)) {
+        bufferStorageProc_ = iglBufferStorageEXT;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::BufferStorage)) {
+      bufferStorageProc_ = iglBufferStorage;
+    }
+    IGL_ASSERT_MSG(bufferStorageProc_, "No supported function for glBufferStorage\n");
+  }
+
+  GLCALL_PROC(bufferStorageProc_, target, size, data, flags);
+  APILOG("glBufferStorage(%s, %zu, %p, 0x%x)\n", GL_ENUM_TO_STRING(target), size, data, flags);
+  GLCHECK_ERRORS();
+}
+
 GLenum IContext::checkFramebufferStatus(GLenum target) {
   GLenum ret;
 
@@ -1004,6 +1088,29 @@ void IContext::clearStencil(GLint s) {
   GLCHECK_ERRORS();
 }
 
+GLenum IContext::clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  if (clientWaitSyncProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::SyncExtReq)) {
+      if (deviceFeatureSet_.hasExtension(Extensions::Sync)) {
+        clientWaitSyncProc_ = iglClientWaitSyncAPPLE;
+      }
+    } else if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::Sync)) {
+      clientWaitSyncProc_ = iglClientWaitSync;
+    }
+    IGL_ASSERT_MSG(clientWaitSyncProc_, "No supported function for glClientWaitSync\n");
+  }
+
+  GLenum ret;
+  GLCALL_PROC_WITH_RETURN(ret, clientWaitSyncProc_, GL_WAIT_FAILED, sync, flags, timeout);
+  APILOG("glClientWaitSync(%p, %u, %llu) = %s\n",
+         sync,
+         flags,
+         static_cast<unsigned long long>(timeout),
+         GL_ENUM_TO_STRING(ret));
+  GLCHECK_ERRORS();
+  return ret;
+}
+
 void IContext::colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
   GLCALL(ColorMask)(red, green, blue, alpha);
   APILOG("glColorMask(%s, %s, %s, %s)\n",
@@ -1395,6 +1502,20 @@ void IContext::deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
   }
 }
 
+void IContext::deleteSamplers(GLsizei n, const GLuint* samplers) {
+  if (deleteSamplersProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SamplerObjects)) {
+      deleteSamplersProc_ = iglDeleteSamplers;
+    }
+    IGL_ASSERT_MSG(deleteSamplersProc_, "No supported function for glDeleteSamplers\n");
+  }
+  if (isDestructionAllowed() && IGL_VERIFY(samplers != nullptr)) {
+    GLCALL_PROC(deleteSamplersProc_, n, samplers);
+    APILOG("glDeleteSamplers(%u, %p)\n", n, samplers);
+    GLCHECK_ERRORS();
+  }
+}
+
 void IContext::deleteVertexArrays(GLsizei n, const GLuint* vertexArrays) {
   if (deleteVertexArraysProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::VertexArrayObjectExtReq)) {
@@ -1679,7 +1800,7 @@ void IContext::framebufferTexture2DMultisample(GLenum target,
       deviceFeatureSet_.hasExtension(Extensions::MultiSampleExt)) {
     // Repeat again, now using explicitly GL_FRAMEBUFFER not GL_DRAW/GL_READ.
     framebufferTexture2DMultisample(GL_FRAMEBUFFER, attachment, textarget, texture, level, samples);
-  } else if (alwaysCheckError_) {
+  } else if (errorCheckMode_ != ErrorCheckMode::Disabled) {
     lastError_ = error;
     GL_ASSERT_ERROR(lastError_ == GL_NO_ERROR, __FUNCTION__, __LINE__, error);
   }
@@ -1746,6 +1867,18 @@ void IContext::genRenderbuffers(GLsizei n, GLuint* renderbuffers) {
   GLCHECK_ERRORS();
 }
 
+void IContext::genSamplers(GLsizei n, GLuint* samplers) {
+  if (genSamplersProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SamplerObjects)) {
+      genSamplersProc_ = iglGenSamplers;
+    }
+    IGL_ASSERT_MSG(genSamplersProc_, "No supported function for glGenSamplers\n");
+  }
+  GLCALL_PROC(genSamplersProc_, n, samplers);
+  APILOG("glGenSamplers(%u, %p) = %u\n", n, samplers, samplers == nullptr ? 0 : *samplers);
+  GLCHECK_ERRORS();
+}
+
 void IContext::genTextures(GLsizei n, GLuint* textures) {
   GLCALL(GenTextures)(n, textures);
   APILOG("glGenTextures(%u, %p) = %u\n", n, textures, textures == nullptr ? 0 : *textures);
@@ -2014,6 +2147,32 @@ void IContext::getProgramInterfaceiv(GLuint program,
   GLCHECK_ERRORS();
 }
 
+void IContext::getProgramBinary(GLuint program,
+                                GLsizei bufSize,
+                                GLsizei* length,
+                                GLenum* binaryFormat,
+                                void* binary) const {
+  if (getProgramBinaryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ProgramBinary)) {
+      if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::ProgramBinaryExtReq)) {
+        getProgramBinaryProc_ = iglGetProgramBinaryOES;
+      } else {
+        getProgramBinaryProc_ = iglGetProgramBinary;
+      }
+    }
+    IGL_ASSERT_MSG(getProgramBinaryProc_, "No supported function for glGetProgramBinary\n");
+  }
+  GLCALL_PROC(getProgramBinaryProc_, program, bufSize, length, binaryFormat, binary);
+  APILOG("glGetProgramBinary(%u, %d, %p, %p, %p) = %d\n",
+         program,
+         bufSize,
+         length,
+         binaryFormat,
+         binary,
+         length == nullptr ? 0 : *length);
+  GLCHECK_ERRORS();
+}
+
 void IContext::getProgramInfoLog(GLuint program,
                                  GLsizei bufsize,
                                  GLsizei* length,
@@ -2452,6 +2611,38 @@ void* IContext::mapBufferRange(GLenum target,
   return ret;
 }
 
+void IContext::multiDrawElementsIndirect(GLenum mode,
+                                         GLenum type,
+                                         const GLvoid* indirect,
+                                         GLsizei drawcount,
+                                         GLsizei stride) {
+  if (multiDrawElementsIndirectProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::MultiDrawIndirect)) {
+      if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::MultiDrawIndirectExtReq)) {
+        multiDrawElementsIndirectProc_ = iglMultiDrawElementsIndirectEXT;
+      } else {
+        multiDrawElementsIndirectProc_ = iglMultiDrawElementsIndirect;
+      }
+    }
+    IGL_ASSERT_MSG(multiDrawElementsIndirectProc_,
+                   "No supported function for glMultiDrawElementsIndirect\n");
+  }
+
+  drawCallCount_++;
+
+  IGL_PROFILER_ZONE_GPU_COLOR_OGL("multiDrawElementsIndirect()", IGL_PROFILER_COLOR_DRAW);
+
+  GLCALL_PROC(multiDrawElementsIndirectProc_, mode, type, indirect, drawcount, stride);
+  APILOG("glMultiDrawElementsIndirect(%s, %s, %p, %d, %d)\n",
+         GL_ENUM_TO_STRING(mode),
+         GL_ENUM_TO_STRING(type),
+         indirect,
+         drawcount,
+         stride);
+  GLCHECK_ERRORS();
+  APILOG_DEC_DRAW_COUNT();
+}
+
 void IContext::objectLabel(GLenum identifier, GLuint name, GLsizei length, const char* label) {
   if (objectLabelProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::DebugLabelExtReq)) {
@@ -2541,6 +2732,25 @@ void IContext::popDebugGroup() {
   }
 }
 
+void IContext::programBinary(GLuint program,
+                             GLenum binaryFormat,
+                             const void* binary,
+                             GLsizei length) {
+  if (programBinaryProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::ProgramBinary)) {
+      if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::ProgramBinaryExtReq)) {
+        programBinaryProc_ = iglProgramBinaryOES;
+      } else {
+        programBinaryProc_ = iglProgramBinary;
+      }
+    }
+    IGL_ASSERT_MSG(programBinaryProc_, "No supported function for glProgramBinary\n");
+  }
+  GLCALL_PROC(programBinaryProc_, program, binaryFormat, binary, length);
+  APILOG("glProgramBinary(%u, 0x%x, %p, %d)\n", program, binaryFormat, binary, length);
+  GLCHECK_ERRORS();
+}
+
 void IContext::readPixels(GLint x,
                           GLint y,
                           GLsizei width,
@@ -2656,6 +2866,33 @@ void IContext::sampleCoverage(GLfloat value, GLboolean invert) {
   GLCHECK_ERRORS();
 }
 
+void IContext::samplerParameterf(GLuint sampler, GLenum pname, GLfloat param) {
+  if (samplerParameterfProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SamplerObjects)) {
+      samplerParameterfProc_ = iglSamplerParameterf;
+    }
+    IGL_ASSERT_MSG(samplerParameterfProc_, "No supported function for glSamplerParameterf\n");
+  }
+  GLCALL_PROC(samplerParameterfProc_, sampler, pname, param);
+  APILOG("glSamplerParameterf(%u, %s, %f)\n", sampler, GL_ENUM_TO_STRING(pname), param);
+  GLCHECK_ERRORS();
+}
+
+void IContext::samplerParameteri(GLuint sampler, GLenum pname, GLint param) {
+  if (samplerParameteriProc_ == nullptr) {
+    if (deviceFeatureSet_.hasInternalFeature(InternalFeatures::SamplerObjects)) {
+      samplerParameteriProc_ = iglSamplerParameteri;
+    }
+    IGL_ASSERT_MSG(samplerParameteriProc_, "No supported function for glSamplerParameteri\n");
+  }
+  GLCALL_PROC(samplerParameteriProc_, sampler, pname, param);
+  APILOG("glSamplerParameteri(%u, %s, %s)\n",
+         sampler,
+         GL_ENUM_TO_STRING(pname),
+         GL_ENUM_TO_STRING(param));
+  GLCHECK_ERRORS();
+}
+
 void IContext::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
   GLCALL(Scissor)(x, y, width, height);
   APILOG("glScissor(%d, %d, %u, %u)\n", x, y, width, height);
@@ -3451,6 +3688,21 @@ void IContext::dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint
   GLCHECK_ERRORS();
 }
 
+void IContext::maxShaderCompilerThreads(GLuint count) {
+  if (maxShaderCompilerThreadsProc_ == nullptr) {
+    if (deviceFeatureSet_.hasExtension(Extensions::ParallelShaderCompileKhr)) {
+      maxShaderCompilerThreadsProc_ = iglMaxShaderCompilerThreadsKHR;
+    } else if (deviceFeatureSet_.hasExtension(Extensions::ParallelShaderCompileArb)) {
+      maxShaderCompilerThreadsProc_ = iglMaxShaderCompilerThreadsARB;
+    }
+    IGL_ASSERT_MSG(maxShaderCompilerThreadsProc_,
+                   "No supported function for glMaxShaderCompilerThreads\n");
+  }
+  GLCALL_PROC(maxShaderCompilerThreadsProc_, count);
+  APILOG("glMaxShaderCompilerThreads(%u)\n", count);
+  GLCHECK_ERRORS();
+}
+
 void IContext::memoryBarrier(GLbitfield barriers) {
   if (memoryBarrierProc_ == nullptr) {
     if (deviceFeatureSet_.hasInternalRequirement(InternalRequirement::ShaderImageLoadStoreExtReq)) {
@@ -3535,19 +3787,82 @@ GLenum IContext::checkForErrors(IGL_MAYBE_UNUSED const char* callerName,
   }
 #endif //  IGL_DEBUG && !defined(IGL_API_LOG)
 
+  if (lastError_ != GL_NO_ERROR && apiTrace_ != nullptr) {
+    apiTrace_->dump();
+  }
   GL_ASSERT_ERROR(lastError_ == GL_NO_ERROR, callerName, lineNum, lastError_);
 
   return lastError_;
 }
 
+void IContext::checkForErrorsAutomatically(const char* callerName, size_t lineNum) const {
+  // GL calls made to read the debug message log must not check for errors again
+  errorCheckCountdown_ = 0;
+  const GLenum error = checkForErrors(callerName, lineNum);
+  errorCheckCountdown_ = errorCheckInterval_;
+  if (error != GL_NO_ERROR) {
+#if !IGL_DEBUG
+    // checkForErrors() only asserts in debug builds
+    IGLLog(IGLLogLevel::LOG_ERROR,
+           "[IGL] OpenGL error [%s:%zu] 0x%04X: %s\n",
+           callerName,
+           lineNum,
+           error,
+           GL_ERROR_TO_STRING(error));
+#endif
+  }
+}
+
+void IContext::checkForEncoderErrors(const char* encoderName) const {
+  if (errorCheckMode_ == ErrorCheckMode::EncoderBoundaries) {
+    checkForErrorsAutomatically(encoderName, 0);
+  }
+}
+
+void IContext::setErrorCheckMode(ErrorCheckMode mode, uint32_t interval) {
+  IGL_ASSERT(mode != ErrorCheckMode::Sampled || interval > 0);
+  errorCheckMode_ = mode;
+  switch (mode) {
+  case ErrorCheckMode::EveryCall:
+    errorCheckInterval_ = 1;
+    break;
+  case ErrorCheckMode::Sampled:
+    errorCheckInterval_ = std::max(interval, 1u);
+    break;
+  case ErrorCheckMode::Disabled:
+  case ErrorCheckMode::EncoderBoundaries:
+    errorCheckInterval_ = 0;
+    break;
+  }
+  errorCheckCountdown_ = errorCheckInterval_;
+}
+
+IContext::ErrorCheckMode IContext::getErrorCheckMode() const {
+  return errorCheckMode_;
+}
+
 // This function has no effect in release mode because the current thinking
 // is there will be no need to call glGetError() after each GL call
 void IContext::enableAutomaticErrorCheck(bool enable) {
 #if IGL_DEBUG
-  alwaysCheckError_ = enable;
+  setErrorCheckMode(enable ? ErrorCheckMode::EveryCall : ErrorCheckMode::Disabled);
 #endif
 }
 
+void IContext::setApiTraceCapacity(size_t capacity) {
+  apiTrace_ = capacity > 0 ? std::make_unique<ApiTrace>(capacity) : nullptr;
+}
+
+const ApiTrace* IContext::getApiTrace() const {
+  return apiTrace_.get();
+}
+
+void IContext::dumpApiTrace() const {
+  if (apiTrace_ != nullptr) {
+    apiTrace_->dump();
+  }
+}
+
 /** Returns current `callCounter_` value. Exposed for testing only. */
 unsigned int IContext::getCallCount() const {
   return callCounter_;
@@ -3688,6 +4003,55 @@ void IContext::apiLogEnd() {
   apiLogEnabled_ = false;
 }
 
+void IContext::setProgramBinaryCache(std::shared_ptr<ProgramBinaryCache> cache) {
+  programBinaryCache_ = std::move(cache);
+}
+
+ProgramBinaryCache* IContext::getProgramBinaryCache() const {
+  return programBinaryCache_.get();
+}
+
+PixelUnpackBufferRing* IContext::getPixelUnpackBufferRing() {
+  if (pixelUnpackBufferRing_ == nullptr && PixelUnpackBufferRing::isSupported(*this)) {
+    pixelUnpackBufferRing_ = std::make_unique<PixelUnpackBufferRing>(*this);
+  }
+  return pixelUnpackBufferRing_.get();
+}
+
+std::shared_ptr<UniformBlockArena> IContext::getUniformBlockArena() {
+  if (uniformBlockArena_ == nullptr && UniformBlockArena::isSupported(*this)) {
+    auto arena = std::make_shared<UniformBlockArena>(*this);
+    Result result;
+    arena->initialize(BufferDesc(), &result);
+    if (result.isOk()) {
+      uniformBlockArena_ = std::move(arena);
+    }
+  }
+  return uniformBlockArena_;
+}
+
+void IContext::setShouldCompileShadersAsync(bool shouldCompileShadersAsync) {
+  shouldCompileShadersAsync_ =
+      shouldCompileShadersAsync &&
+      deviceFeatureSet_.hasInternalFeature(InternalFeatures::ParallelShaderCompile);
+  if (shouldCompileShadersAsync_) {
+    // some drivers only compile in parallel after the application asks for it
+    maxShaderCompilerThreads(0xffffffff);
+  }
+}
+
+bool IContext::shouldCompileShadersAsync() const {
+  return shouldCompileShadersAsync_;
+}
+
+void IContext::setShouldSkipRedundantUniforms(bool shouldSkipRedundantUniforms) {
+  shouldSkipRedundantUniforms_ = shouldSkipRedundantUniforms;
+}
+
+bool IContext::shouldSkipRedundantUniforms() const {
+  return shouldSkipRedundantUniforms_;
+}
+
 void IContext::setShouldValidateShaders(bool shouldValidateShaders) {
   shouldValidateShaders_ = shouldValidateShaders;
 }
@@ -3696,118 +4060,181 @@ bool IContext::shouldValidateShaders() const {
   return shouldValidateShaders_;
 }
 
-void IContext::SynchronizedDeletionQueues::flushDeletionQueue(IContext& context) {
-  if (IGL_VERIFY(context.isCurrentContext() || context.isCurrentSharegroup())) {
-    swapScratchDeletionQueues();
+namespace {
+// Names deleted per GL call by flushes with a budget, so that the budget is checked often enough
+constexpr size_t kDeletionChunkSize = 64;
+} // namespace
 
-    if (!scratchBuffersQueue_.empty()) {
-      context.deleteBuffers(static_cast<GLsizei>(scratchBuffersQueue_.size()),
-                            scratchBuffersQueue_.data());
-      scratchBuffersQueue_.clear();
-    }
+IContext::SynchronizedDeletionQueues::~SynchronizedDeletionQueues() {
+  // frees the batches no flush picked up
+  takeQueuedBatches();
+}
 
-    for (auto i : scratchUnbindBuffersQueue_) {
-      context.bindBuffer(i, 0);
-    }
-    scratchUnbindBuffersQueue_.clear();
+void IContext::SynchronizedDeletionQueues::flushDeletionQueue(IContext& context,
+                                                              bool ignoreBudgetAndFences) {
+  if (!IGL_VERIFY(context.isCurrentContext() || context.isCurrentSharegroup())) {
+    return;
+  }
 
-    if (!scratchFramebuffersQueue_.empty()) {
-      context.deleteFramebuffers(static_cast<GLsizei>(scratchFramebuffersQueue_.size()),
-                                 scratchFramebuffersQueue_.data());
-      scratchFramebuffersQueue_.clear();
+  const bool useFences = deferUntilGpuIsDone && !ignoreBudgetAndFences &&
+                         context.deviceFeatures().hasInternalFeature(InternalFeatures::Sync);
+  // Batches picked up by previous flushes first, so that new ones wait for at least one flush
+  retireGenerations(context, !useFences);
+
+  Generation generation;
+  for (auto& batch : takeQueuedBatches()) {
+    if (batch->kind == Kind::UnbindBuffer) {
+      // unbinding only affects the state of this context, there is nothing to wait for
+      context.bindBuffer(batch->names[0], 0);
+    } else if (useFences) {
+      generation.batches.push_back(std::move(batch));
+    } else {
+      readyBatches_.push_back(std::move(batch));
     }
+  }
+  if (!generation.batches.empty()) {
+    generation.fence = context.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    generations_.push_back(std::move(generation));
+  }
 
-    if (!scratchRenderbuffersQueue_.empty()) {
-      context.deleteRenderbuffers(static_cast<GLsizei>(scratchRenderbuffersQueue_.size()),
-                                  scratchRenderbuffersQueue_.data());
-      scratchRenderbuffersQueue_.clear();
+  const bool hasBudget = !ignoreBudgetAndFences && flushBudget.count() > 0;
+  const auto deadline = std::chrono::steady_clock::now() + flushBudget;
+  while (!readyBatches_.empty()) {
+    Batch& batch = *readyBatches_.front();
+    const size_t numLeft = batch.names.size() - batch.numDeleted;
+    deleteNames(context, batch, hasBudget ? std::min(numLeft, kDeletionChunkSize) : numLeft);
+    if (batch.numDeleted == batch.names.size()) {
+      readyBatches_.pop_front();
     }
-
-    if (!scratchVertexArraysQueue_.empty()) {
-      context.deleteVertexArrays(static_cast<GLsizei>(scratchVertexArraysQueue_.size()),
-                                 scratchVertexArraysQueue_.data());
-      scratchVertexArraysQueue_.clear();
+    if (hasBudget && std::chrono::steady_clock::now() >= deadline) {
+      break;
     }
+  }
+}
 
-    for (auto i : scratchProgramQueue_) {
-      context.deleteProgram(i);
+std::vector<std::unique_ptr<IContext::SynchronizedDeletionQueues::Batch>>
+IContext::SynchronizedDeletionQueues::takeQueuedBatches() {
+  std::vector<std::unique_ptr<Batch>> batches;
+  for (Batch* batch = queuedBatches_.exchange(nullptr, std::memory_order_acquire);
+       batch != nullptr;
+       batch = batch->next) {
+    batches.emplace_back(batch);
+  }
+  // the stack holds the most recently queued batch first
+  std::reverse(batches.begin(), batches.end());
+  return batches;
+}
+
+void IContext::SynchronizedDeletionQueues::retireGenerations(IContext& context,
+                                                             bool ignoreFences) {
+  while (!generations_.empty()) {
+    Generation& generation = generations_.front();
+    if (generation.fence != nullptr) {
+      if (!ignoreFences) {
+        GLint status = GL_UNSIGNALED;
+        context.getSynciv(generation.fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) {
+          break;
+        }
+      }
+      context.deleteSync(generation.fence);
     }
-    scratchProgramQueue_.clear();
-
-    for (auto i : scratchShaderQueue_) {
-      context.deleteShader(i);
+    for (auto& batch : generation.batches) {
+      readyBatches_.push_back(std::move(batch));
     }
-    scratchShaderQueue_.clear();
+    generations_.pop_front();
+  }
+}
 
-    if (!scratchTexturesQueue_.empty()) {
-      context.deleteTextures(scratchTexturesQueue_);
-      scratchTexturesQueue_.clear();
+void IContext::SynchronizedDeletionQueues::deleteNames(IContext& context,
+                                                       Batch& batch,
+                                                       size_t count) {
+  const GLuint* names = batch.names.data() + batch.numDeleted;
+  switch (batch.kind) {
+  case Kind::Buffers:
+    context.deleteBuffers(static_cast<GLsizei>(count), names);
+    break;
+  case Kind::Framebuffers:
+    context.deleteFramebuffers(static_cast<GLsizei>(count), names);
+    break;
+  case Kind::Renderbuffers:
+    context.deleteRenderbuffers(static_cast<GLsizei>(count), names);
+    break;
+  case Kind::VertexArrays:
+    context.deleteVertexArrays(static_cast<GLsizei>(count), names);
+    break;
+  case Kind::Program:
+    for (size_t i = 0; i < count; ++i) {
+      context.deleteProgram(names[i]);
+    }
+    break;
+  case Kind::Shader:
+    for (size_t i = 0; i < count; ++i) {
+      context.deleteShader(names[i]);
+    }
+    break;
+  case Kind::Textures:
+    if (count == batch.names.size()) {
+      context.deleteTextures(batch.names);
+    } else {
+      context.deleteTextures(std::vector<GLuint>(names, names + count));
     }
+    break;
+  case Kind::UnbindBuffer:
+    IGL_ASSERT_NOT_REACHED();
+    break;
   }
+  batch.numDeleted += count;
+  pendingCount_.fetch_sub(count, std::memory_order_relaxed);
 }
 
-void IContext::SynchronizedDeletionQueues::swapScratchDeletionQueues() {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-
-  std::swap(scratchBuffersQueue_, buffersQueue_);
-  std::swap(scratchUnbindBuffersQueue_, unbindBuffersQueue_);
-  std::swap(scratchFramebuffersQueue_, framebuffersQueue_);
-  std::swap(scratchRenderbuffersQueue_, renderbuffersQueue_);
-  std::swap(scratchVertexArraysQueue_, vertexArraysQueue_);
-  std::swap(scratchProgramQueue_, programQueue_);
-  std::swap(scratchShaderQueue_, shaderQueue_);
-  std::swap(scratchTexturesQueue_, texturesQueue_);
+void IContext::SynchronizedDeletionQueues::queue(Kind kind, std::vector<GLuint> names) {
+  if (names.empty()) {
+    return;
+  }
+  if (kind != Kind::UnbindBuffer) {
+    pendingCount_.fetch_add(names.size(), std::memory_order_relaxed);
+  }
+  auto* batch = new Batch{kind, std::move(names)};
+  batch->next = queuedBatches_.load(std::memory_order_relaxed);
+  while (!queuedBatches_.compare_exchange_weak(
+      batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {
+  }
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteBuffers(GLsizei n, const GLuint* buffers) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    buffersQueue_.push_back(buffers[i]);
-  }
+  queue(Kind::Buffers, std::vector<GLuint>(buffers, buffers + n));
 }
 
 void IContext::SynchronizedDeletionQueues::queueUnbindBuffer(GLenum target) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  unbindBuffersQueue_.insert(target);
+  queue(Kind::UnbindBuffer, {target});
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteFramebuffers(GLsizei n,
                                                                    const GLuint* framebuffers) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    framebuffersQueue_.push_back(framebuffers[i]);
-  }
+  queue(Kind::Framebuffers, std::vector<GLuint>(framebuffers, framebuffers + n));
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteRenderbuffers(GLsizei n,
                                                                     const GLuint* renderbuffers) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    renderbuffersQueue_.push_back(renderbuffers[i]);
-  }
+  queue(Kind::Renderbuffers, std::vector<GLuint>(renderbuffers, renderbuffers + n));
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteVertexArrays(GLsizei n,
                                                                    const GLuint* vertexArrays) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  for (GLsizei i = 0; i < n; ++i) {
-    vertexArraysQueue_.push_back(vertexArrays[i]);
-  }
+  queue(Kind::VertexArrays, std::vector<GLuint>(vertexArrays, vertexArrays + n));
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteProgram(GLuint program) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  programQueue_.push_back(program);
+  queue(Kind::Program, {program});
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteShader(GLuint shaderId) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  shaderQueue_.push_back(shaderId);
+  queue(Kind::Shader, {shaderId});
 }
 
 void IContext::SynchronizedDeletionQueues::queueDeleteTextures(
     const std::vector<GLuint>& textures) {
-  std::lock_guard<std::mutex> guard(deletionQueueMutex_);
-  texturesQueue_.insert(std::end(texturesQueue_), std::begin(textures), std::end(textures));
+  queue(Kind::Textures, textures);
 }
 } // namespace igl::opengl
@@ -10,6 +10,7 @@
 #include <igl/Common.h>
 #include <igl/DeviceFeatures.h>
 #include <igl/PlatformDevice.h>
+#include <igl/SamplerState.h>
 #include <igl/opengl/ComputeCommandAdapter.h>
 #include <igl/opengl/DeviceFeatureSet.h>
 #include <igl/opengl/GLFunc.h>
@@ -18,8 +19,10 @@
 #include <igl/opengl/UnbindPolicy.h>
 #include <igl/opengl/Version.h>
 #include <igl/opengl/WithContext.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
-#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -30,6 +33,11 @@ class ITexture;
 
 namespace igl::opengl {
 
+class ApiTrace;
+class PixelUnpackBufferRing;
+class ProgramBinaryCache;
+class UniformBlockArena;
+
 // We might extend this to other enums presenting API versions on desktops, etc.
 // For the time being, we only need to differentiate gles2 and gles3
 enum class RenderingAPI { GLES2, GLES3, GL };
@@ -54,6 +62,19 @@ class IContext {
 
   void flushDeletionQueue();
 
+  /// Limits how long each flushDeletionQueue() call spends deleting objects queued while the
+  /// context was not current. Objects left over are deleted by the next flushes. Zero, the
+  /// default, deletes everything queued.
+  void setDeletionQueueFlushBudget(std::chrono::microseconds budget);
+
+  /// When enabled and fences are supported, objects queued while the context was not current are
+  /// only deleted once the GPU has finished the commands submitted before the flush that picked
+  /// them up, so the driver never has to defer their destruction itself.
+  void setShouldDeferDeletionsUntilGpuIsDone(bool shouldDefer);
+
+  /// Returns the number of objects queued for deletion that have not been deleted yet.
+  [[nodiscard]] size_t getPendingDeletionCount() const;
+
  protected:
   bool shouldQueueAPI() const;
 
@@ -72,7 +93,10 @@ class IContext {
                        GLsizeiptr size);
   void bindFramebuffer(GLenum target, GLuint framebuffer);
   void bindRenderbuffer(GLenum target, GLuint renderbuffer);
+  void bindSampler(GLuint unit, GLuint sampler);
+  void bindSamplers(GLuint first, GLsizei count, const GLuint* samplers);
   void bindTexture(GLenum target, GLuint texture);
+  void bindTextures(GLuint first, GLsizei count, const GLuint* textures);
   void bindImageTexture(GLuint unit,
                         GLuint texture,
                         GLint level,
@@ -98,11 +122,13 @@ class IContext {
                        GLenum filter);
   void bufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
   void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data);
+  void bufferStorage(GLenum target, GLsizeiptr size, const GLvoid* data, GLbitfield flags);
   virtual GLenum checkFramebufferStatus(GLenum target);
   void clear(GLbitfield mask);
   void clearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
   void clearDepthf(GLfloat depth);
   void clearStencil(GLint s);
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
   void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
   void compileShader(GLuint shader);
   void compressedTexImage1D(GLenum target,
@@ -187,6 +213,7 @@ class IContext {
   void deleteFramebuffers(GLsizei n, const GLuint* framebuffers);
   void deleteMemoryObjects(GLsizei n, const GLuint* objects);
   void deleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+  void deleteSamplers(GLsizei n, const GLuint* samplers);
   void deleteVertexArrays(GLsizei n, const GLuint* vertexArrays);
   void deleteProgram(GLuint program);
   void deleteShader(GLuint shaderId);
@@ -233,6 +260,7 @@ class IContext {
   void genBuffers(GLsizei n, GLuint* buffers);
   void genFramebuffers(GLsizei n, GLuint* framebuffers);
   void genRenderbuffers(GLsizei n, GLuint* renderbuffers);
+  void genSamplers(GLsizei n, GLuint* samplers);
   void genTextures(GLsizei n, GLuint* textures);
   void genVertexArrays(GLsizei n, GLuint* vertexArrays);
   void getActiveAttrib(GLuint program,
@@ -281,6 +309,11 @@ class IContext {
                                            GLint* params) const;
   void getIntegerv(GLenum pname, GLint* params) const;
   void getProgramiv(GLuint program, GLenum pname, GLint* params) const;
+  void getProgramBinary(GLuint program,
+                        GLsizei bufSize,
+                        GLsizei* length,
+                        GLenum* binaryFormat,
+                        void* binary) const;
   void getProgramInterfaceiv(GLuint program,
                              GLenum programInterface,
                              GLenum pname,
@@ -334,10 +367,16 @@ class IContext {
   void linkProgram(GLuint program);
   void* mapBuffer(GLenum target, GLbitfield access);
   void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+  void multiDrawElementsIndirect(GLenum mode,
+                                 GLenum type,
+                                 const GLvoid* indirect,
+                                 GLsizei drawcount,
+                                 GLsizei stride);
   void objectLabel(GLenum identifier, GLuint name, GLsizei length, const char* label);
   void pixelStorei(GLenum pname, GLint param);
   void polygonOffset(GLfloat factor, GLfloat units);
   void popDebugGroup();
+  void programBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
   void pushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar* message);
   void readPixels(GLint x,
                   GLint y,
@@ -367,6 +406,8 @@ class IContext {
                                               GLint baseViewIndex,
                                               GLsizei numViews);
   void sampleCoverage(GLfloat value, GLboolean invert);
+  void samplerParameterf(GLuint sampler, GLenum pname, GLfloat param);
+  void samplerParameteri(GLuint sampler, GLenum pname, GLint param);
   void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
   virtual void setEnabled(bool shouldEnable, GLenum cap);
   void shaderBinary(GLsizei n,
@@ -509,6 +550,7 @@ class IContext {
   void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
   void dispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z);
+  void maxShaderCompilerThreads(GLuint count);
   void memoryBarrier(GLbitfield barriers);
   GLuint64 getTextureHandle(GLuint texture);
   void makeTextureHandleResident(GLuint64 handle);
@@ -533,6 +575,42 @@ class IContext {
 
   void setShouldValidateShaders(bool shouldValidateShaders);
   bool shouldValidateShaders() const;
+
+  /// When enabled and GL_KHR_parallel_shader_compile is available, shader modules and render
+  /// shader stages do not wait for compiling and linking to finish. Errors are reported when the
+  /// program is first used and IRenderPipelineState::isReady() polls for completion. Must be
+  /// called with this context current.
+  void setShouldCompileShadersAsync(bool shouldCompileShadersAsync);
+  bool shouldCompileShadersAsync() const;
+
+  /// When enabled, render and compute adapters remember the values each program's uniforms were
+  /// last set to and skip glUniform* calls that would not change them. Only enable this if
+  /// uniforms of IGL programs are never set outside of IGL.
+  void setShouldSkipRedundantUniforms(bool shouldSkipRedundantUniforms);
+  bool shouldSkipRedundantUniforms() const;
+
+  /// Sets the cache ShaderStages uses to skip linking programs whose binaries were stored by a
+  /// previous run. Pass nullptr to disable it.
+  void setProgramBinaryCache(std::shared_ptr<ProgramBinaryCache> cache);
+  [[nodiscard]] ProgramBinaryCache* getProgramBinaryCache() const;
+
+  /// Returns the ring texture uploads are staged in, or nullptr if pixel buffer objects cannot be
+  /// used. Must be called with this context current.
+  PixelUnpackBufferRing* getPixelUnpackBufferRing();
+
+  /// Returns the arena uniform block data is suballocated from, or nullptr if uniform blocks are
+  /// not supported. Must be called with this context current.
+  std::shared_ptr<UniformBlockArena> getUniformBlockArena();
+  [[nodiscard]] bool hasUniformBlockArena() const {
+    return uniformBlockArena_ != nullptr;
+  }
+
+  /// Returns the sampler objects created for sampler states, keyed by their SamplerStateDesc, so
+  /// that equal sampler states share one. They are deleted with the context.
+  std::unordered_map<SamplerStateDesc, GLuint>& getSamplerObjects() {
+    return samplerObjects_;
+  }
+
   inline bool isDestructionAllowed() const {
     return lockCount_ == 0;
   }
@@ -581,6 +659,35 @@ class IContext {
    */
   void enableAutomaticErrorCheck(bool enable);
 
+  /// When getError() is called automatically. Errors found are asserted in debug builds and logged
+  /// in release builds, which default to Disabled.
+  enum class ErrorCheckMode : uint8_t {
+    /// Only checkForErrors() calls getError().
+    Disabled,
+    /// After every GL call. The default in debug builds.
+    EveryCall,
+    /// After every `interval` GL calls. An error is reported by the call that checked for it, so
+    /// use the API trace to see the calls that led to it.
+    Sampled,
+    /// When a render or compute command encoder ends.
+    EncoderBoundaries,
+  };
+
+  /// Unlike enableAutomaticErrorCheck(), this works in release builds too. `interval` is only used
+  /// by ErrorCheckMode::Sampled.
+  void setErrorCheckMode(ErrorCheckMode mode, uint32_t interval = 1);
+  [[nodiscard]] ErrorCheckMode getErrorCheckMode() const;
+
+  /// Called by command encoders when they end, to check for errors in
+  /// ErrorCheckMode::EncoderBoundaries mode.
+  void checkForEncoderErrors(const char* encoderName) const;
+
+  /// Records the last `capacity` GL calls made through this context in a binary ring. The trace is
+  /// dumped when an error is found, or on demand with dumpApiTrace(). Pass 0 to stop tracing.
+  void setApiTraceCapacity(size_t capacity);
+  [[nodiscard]] const ApiTrace* getApiTrace() const;
+  void dumpApiTrace() const;
+
   // Manages an adapter pool as recreating this every frame causes unwanted memory allocations.
   // @fb-only
   // @fb-only
@@ -604,45 +711,70 @@ class IContext {
   void willDestroy(void* glContext);
 
  private:
-  bool alwaysCheckError_ = false; // TRUE to check error after each OGL call
+  void checkForErrorsAutomatically(const char* callerName, size_t lineNum) const;
+
+  ErrorCheckMode errorCheckMode_ = ErrorCheckMode::Disabled;
+  // GL calls between automatic error checks, 0 if they do not depend on calls
+  uint32_t errorCheckInterval_ = 0;
+  mutable uint32_t errorCheckCountdown_ = 0;
+  std::unique_ptr<ApiTrace> apiTrace_;
   mutable GLenum lastError_ = GL_NO_ERROR;
   mutable unsigned int callCounter_ = 0;
   unsigned int drawCallCount_ = 0;
   int lockCount_ = 0; // used by DestructionGuard
   int refCount_ = 0; // used by addRef/releaseRef
   bool shouldValidateShaders_ = false;
+  bool shouldCompileShadersAsync_ = false;
+  bool shouldSkipRedundantUniforms_ = false;
+  std::shared_ptr<ProgramBinaryCache> programBinaryCache_;
+  std::unique_ptr<PixelUnpackBufferRing> pixelUnpackBufferRing_;
+  std::shared_ptr<UniformBlockArena> uniformBlockArena_;
+  std::unordered_map<SamplerStateDesc, GLuint> samplerObjects_;
 
   // API Logging
   unsigned int apiLogDrawsLeft_ = 0;
   bool apiLogEnabled_ = false;
 
   PFNIGLBINDIMAGETEXTUREPROC bindImageTexturerProc_ = nullptr;
+  PFNIGLBINDSAMPLERPROC bindSamplerProc_ = nullptr;
+  PFNIGLBINDSAMPLERSPROC bindSamplersProc_ = nullptr;
+  PFNIGLBINDTEXTURESPROC bindTexturesProc_ = nullptr;
   PFNIGLBINDVERTEXARRAYPROC bindVertexArrayProc_ = nullptr;
   PFNIGLBLITFRAMEBUFFERPROC blitFramebufferProc_ = nullptr;
+  PFNIGLBUFFERSTORAGEPROC bufferStorageProc_ = nullptr;
   PFNIGLCLEARDEPTHFPROC clearDepthfProc_ = nullptr;
+  PFNIGLCLIENTWAITSYNCPROC clientWaitSyncProc_ = nullptr;
   PFNIGLCOMPRESSEDTEXIMAGE3DPROC compressedTexImage3DProc_ = nullptr;
   PFNIGLCOMPRESSEDTEXSUBIMAGE3DPROC compressedTexSubImage3DProc_ = nullptr;
   PFNIGLDEBUGMESSAGECALLBACKPROC debugMessageCallbackProc_ = nullptr;
   PFNIGLDEBUGMESSAGEINSERTPROC debugMessageInsertProc_ = nullptr;
+  PFNIGLDELETESAMPLERSPROC deleteSamplersProc_ = nullptr;
   PFNIGLDELETESYNCPROC deleteSyncProc_ = nullptr;
   PFNIGLDELETEVERTEXARRAYSPROC deleteVertexArraysProc_ = nullptr;
   PFNIGLDRAWBUFFERSPROC drawBuffersProc_ = nullptr;
   PFNIGLFENCESYNCPROC fenceSyncProc_ = nullptr;
   PFNIGLFRAMEBUFFERTEXTURE2DMULTISAMPLEPROC framebufferTexture2DMultisampleProc_ = nullptr;
   PFNIGLINVALIDATEFRAMEBUFFERPROC invalidateFramebufferProc_ = nullptr;
+  PFNIGLGENSAMPLERSPROC genSamplersProc_ = nullptr;
   PFNIGLGENVERTEXARRAYSPROC genVertexArraysProc_ = nullptr;
   mutable PFNIGLGETDEBUGMESSAGELOGPROC getDebugMessageLogProc_ = nullptr;
+  mutable PFNIGLGETPROGRAMBINARYPROC getProgramBinaryProc_ = nullptr;
   mutable PFNIGLGETSYNCIVPROC getSyncivProc_ = nullptr;
   PFNIGLGETTEXTUREHANDLEPROC getTextureHandleProc_ = nullptr;
   PFNIGLMAKETEXTUREHANDLERESIDENTPROC makeTextureHandleResidentProc_ = nullptr;
   PFNIGLMAKETEXTUREHANDLENONRESIDENTPROC makeTextureHandleNonResidentProc_ = nullptr;
   PFNIGLMAPBUFFERPROC mapBufferProc_ = nullptr;
   PFNIGLMAPBUFFERRANGEPROC mapBufferRangeProc_ = nullptr;
+  PFNIGLMAXSHADERCOMPILERTHREADSPROC maxShaderCompilerThreadsProc_ = nullptr;
   PFNIGLMEMORYBARRIERPROC memoryBarrierProc_ = nullptr;
+  PFNIGLMULTIDRAWELEMENTSINDIRECTPROC multiDrawElementsIndirectProc_ = nullptr;
   PFNIGLOBJECTLABELPROC objectLabelProc_ = nullptr;
   PFNIGLPOPDEBUGGROUPPROC popDebugGroupProc_ = nullptr;
+  PFNIGLPROGRAMBINARYPROC programBinaryProc_ = nullptr;
   PFNIGLPUSHDEBUGGROUPPROC pushDebugGroupProc_ = nullptr;
   PFNIGLRENDERBUFFERSTORAGEMULTISAMPLEPROC renderbufferStorageMultisampleProc_ = nullptr;
+  PFNIGLSAMPLERPARAMETERFPROC samplerParameterfProc_ = nullptr;
+  PFNIGLSAMPLERPARAMETERIPROC samplerParameteriProc_ = nullptr;
   PFNIGLTEXIMAGE3DPROC texImage3DProc_ = nullptr;
   PFNIGLTEXSTORAGE1DPROC texStorage1DProc_ = nullptr;
   PFNIGLTEXSTORAGE2DPROC texStorage2DProc_ = nullptr;
@@ -652,10 +784,17 @@ class IContext {
   PFNIGLVERTEXATTRIBDIVISORPROC vertexAttribDivisorProc_ = nullptr;
 
   /// Responsible for holding onto operations queued for deletion when not in context.
-  /// All operations to non-scratch queues are suyncronized by one mutex
+  /// Queueing is lock-free: each call pushes one batch onto an atomic stack, which
+  /// flushDeletionQueue takes over as a whole. Everything else is only accessed by
+  /// flushDeletionQueue, with the context current.
   struct SynchronizedDeletionQueues {
    public:
-    void flushDeletionQueue(IContext& context);
+    ~SynchronizedDeletionQueues();
+
+    /// Deletes queued objects, spending at most `flushBudget` on it unless it is zero. Objects
+    /// left over are deleted by the next flushes. With `deferUntilGpuIsDone`, objects are held
+    /// until a fence inserted by the flush that picked them up has signaled.
+    void flushDeletionQueue(IContext& context, bool ignoreBudgetAndFences = false);
 
     void queueDeleteBuffers(GLsizei n, const GLuint* buffers);
     void queueUnbindBuffer(GLenum target);
@@ -666,34 +805,52 @@ class IContext {
     void queueDeleteShader(GLuint shaderId);
     void queueDeleteTextures(const std::vector<GLuint>& textures);
 
+    /// Returns the number of queued objects that have not been deleted yet.
+    [[nodiscard]] size_t getPendingCount() const {
+      return pendingCount_.load(std::memory_order_relaxed);
+    }
+
+    std::chrono::microseconds flushBudget{0};
+    bool deferUntilGpuIsDone = false;
+
    private:
-    /// This is called by flushDeletionQueue to swap fooQueue w/ scratchFooQueue
-    void swapScratchDeletionQueues();
-
-    // These are swapped with the main queues then read to perform operations. They can be read from
-    // flushDeletionQueue w/o synchronization.
-    std::vector<GLuint> scratchBuffersQueue_;
-    std::unordered_set<GLenum> scratchUnbindBuffersQueue_;
-    std::vector<GLuint> scratchFramebuffersQueue_;
-    std::vector<GLuint> scratchRenderbuffersQueue_;
-    std::vector<GLuint> scratchVertexArraysQueue_;
-    std::vector<GLuint> scratchProgramQueue_;
-    std::vector<GLuint> scratchShaderQueue_;
-    std::vector<GLuint> scratchTexturesQueue_;
-
-    // Guards all the non-scratch queues.
-    std::mutex deletionQueueMutex_;
-
-    // Resources queued for deletion
-    std::vector<GLuint> buffersQueue_;
-    // These are the targets for the buffers that we enqueued for deletion that we need to unbind
-    std::unordered_set<GLenum> unbindBuffersQueue_;
-    std::vector<GLuint> framebuffersQueue_;
-    std::vector<GLuint> renderbuffersQueue_;
-    std::vector<GLuint> vertexArraysQueue_;
-    std::vector<GLuint> programQueue_;
-    std::vector<GLuint> shaderQueue_;
-    std::vector<GLuint> texturesQueue_;
+    enum class Kind : uint8_t {
+      Buffers,
+      UnbindBuffer,
+      Framebuffers,
+      Renderbuffers,
+      VertexArrays,
+      Program,
+      Shader,
+      Textures,
+    };
+
+    struct Batch {
+      Kind kind = Kind::Buffers;
+      // For Kind::UnbindBuffer, the buffer target
+      std::vector<GLuint> names;
+      // Number of names already deleted by a flush that ran out of budget
+      size_t numDeleted = 0;
+      Batch* next = nullptr;
+    };
+
+    // Batches picked up by one flush, waiting for the GPU to finish with them
+    struct Generation {
+      GLsync fence = nullptr;
+      std::vector<std::unique_ptr<Batch>> batches;
+    };
+
+    void queue(Kind kind, std::vector<GLuint> names);
+    /// Returns the batches queued since the last call, oldest first.
+    std::vector<std::unique_ptr<Batch>> takeQueuedBatches();
+    /// Makes the batches of generations whose fence has signaled ready for deletion.
+    void retireGenerations(IContext& context, bool ignoreFences);
+    void deleteNames(IContext& context, Batch& batch, size_t count);
+
+    std::atomic<Batch*> queuedBatches_{nullptr};
+    std::atomic<size_t> pendingCount_{0};
+    std::deque<Generation> generations_;
+    std::deque<std::unique_ptr<Batch>> readyBatches_;
   };
 
   SynchronizedDeletionQueues deletionQueues_;
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/PixelBuffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <igl/opengl/IContext.h>
+
+namespace igl::opengl {
+
+namespace {
+
+constexpr size_t kUnpackRingMinCapacity = 4 * 1024 * 1024;
+// glTexSubImage* requires the offset to be a multiple of the size of the pixel type
+constexpr size_t kUnpackRingAlignment = 16;
+constexpr GLuint64 kReadbackWaitTimeoutNs = 1000000000;
+
+} // namespace
+
+PixelUnpackBufferRing::PixelUnpackBufferRing(IContext& context) : context_(context) {}
+
+PixelUnpackBufferRing::~PixelUnpackBufferRing() {
+  if (id_ != 0) {
+    context_.deleteBuffers(1, &id_);
+  }
+}
+
+bool PixelUnpackBufferRing::isSupported(const IContext& context) {
+  return context.deviceFeatures().hasInternalFeature(InternalFeatures::PixelBufferObject) &&
+         context.deviceFeatures().hasFeature(DeviceFeatures::MapBufferRange);
+}
+
+bool PixelUnpackBufferRing::write(const void* data, size_t size, size_t& outOffset) {
+  IGL_ASSERT(data != nullptr && size > 0);
+
+  if (id_ == 0) {
+    context_.genBuffers(1, &id_);
+  }
+  context_.bindBuffer(GL_PIXEL_UNPACK_BUFFER, id_);
+
+  const size_t offset = (head_ + kUnpackRingAlignment - 1) & ~(kUnpackRingAlignment - 1);
+  if (size > capacity_ || offset + size > capacity_) {
+    // orphan the storage; uploads that still read from it keep it alive in the driver
+    capacity_ = std::max({capacity_, size, kUnpackRingMinCapacity});
+    context_.bufferData(
+        GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(capacity_), nullptr, GL_STREAM_DRAW);
+    head_ = 0;
+  } else {
+    head_ = offset;
+  }
+
+  // no upload reads this range of the current storage yet, so there is nothing to wait for
+  void* dst = context_.mapBufferRange(
+      GL_PIXEL_UNPACK_BUFFER,
+      static_cast<GLintptr>(head_),
+      static_cast<GLsizeiptr>(size),
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if (dst == nullptr) {
+    unbind();
+    return false;
+  }
+  memcpy(dst, data, size);
+  context_.unmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+  outOffset = head_;
+  head_ += size;
+  return true;
+}
+
+void PixelUnpackBufferRing::unbind() {
+  context_.bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+PixelPackBufferReadback::PixelPackBufferReadback(IContext& context, size_t size) :
+  WithContext(context), size_(size) {
+  getContext().genBuffers(1, &id_);
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, id_);
+  getContext().bufferData(
+      GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size_), nullptr, GL_STREAM_READ);
+}
+
+PixelPackBufferReadback::~PixelPackBufferReadback() {
+  if (fence_ != nullptr) {
+    getContext().deleteSync(fence_);
+  }
+  getContext().deleteBuffers(1, &id_);
+}
+
+void PixelPackBufferReadback::insertFence() {
+  if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::Sync)) {
+    fence_ = getContext().fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+  // make sure the read is submitted, otherwise polling may never see it finish
+  getContext().flush();
+}
+
+bool PixelPackBufferReadback::isReady() const {
+  if (fence_ == nullptr) {
+    // without fences the only way to know is to map the buffer
+    return true;
+  }
+  GLint status = GL_UNSIGNALED;
+  getContext().getSynciv(fence_, GL_SYNC_STATUS, 1, nullptr, &status);
+  return status == GL_SIGNALED;
+}
+
+Result PixelPackBufferReadback::copyBytes(void* IGL_NONNULL pixelBytes) const {
+  if (fence_ != nullptr) {
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (status == GL_TIMEOUT_EXPIRED) {
+      status =
+          getContext().clientWaitSync(fence_, GL_SYNC_FLUSH_COMMANDS_BIT, kReadbackWaitTimeoutNs);
+    }
+    getContext().deleteSync(fence_);
+    fence_ = nullptr;
+    if (status == GL_WAIT_FAILED) {
+      return Result{Result::Code::RuntimeError, "glClientWaitSync failed"};
+    }
+  }
+
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, id_);
+  const void* src = getContext().mapBufferRange(
+      GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size_), GL_MAP_READ_BIT);
+  Result result;
+  if (src != nullptr) {
+    memcpy(pixelBytes, src, size_);
+    getContext().unmapBuffer(GL_PIXEL_PACK_BUFFER);
+  } else {
+    result = Result{Result::Code::RuntimeError, "Cannot map the pixel pack buffer"};
+  }
+  getContext().bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  return result;
+}
+
+} // namespace igl::opengl
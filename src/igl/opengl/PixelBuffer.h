@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <igl/Common.h>
+#include <igl/opengl/GLIncludes.h>
+#include <igl/opengl/WithContext.h>
+
+namespace igl::opengl {
+
+class IContext;
+
+/// @brief Streams texture uploads through a GL_PIXEL_UNPACK_BUFFER.
+///
+/// Pixels are copied into the buffer and glTexSubImage* then sources them from there, so the call
+/// returns without waiting for the driver to consume client memory. Space is handed out linearly
+/// and written unsynchronized; when the buffer is full its storage is orphaned, so uploads still
+/// in flight keep reading the old storage.
+class PixelUnpackBufferRing final {
+ public:
+  explicit PixelUnpackBufferRing(IContext& context);
+  ~PixelUnpackBufferRing();
+
+  PixelUnpackBufferRing(const PixelUnpackBufferRing&) = delete;
+  PixelUnpackBufferRing& operator=(const PixelUnpackBufferRing&) = delete;
+
+  /// @brief Returns false if the context has no pixel buffer objects or glMapBufferRange.
+  static bool isSupported(const IContext& context);
+
+  /// @brief Copies `size` bytes into the ring and leaves it bound to GL_PIXEL_UNPACK_BUFFER.
+  /// While it is bound, glTexSubImage* takes `outOffset` in place of the pixel pointer. Returns
+  /// false, with nothing bound, if the buffer could not be mapped.
+  bool write(const void* data, size_t size, size_t& outOffset);
+
+  void unbind();
+
+ private:
+  IContext& context_;
+  GLuint id_ = 0;
+  size_t capacity_ = 0;
+  size_t head_ = 0;
+};
+
+/// @brief Color attachment pixels read into a GL_PIXEL_PACK_BUFFER.
+///
+/// glReadPixels returns as soon as the read is queued. isReady() polls the fence inserted after it,
+/// and copyBytes() maps the buffer, waiting for the GPU only if the read has not finished yet.
+/// Create instances with Framebuffer::copyBytesColorAttachmentAsync().
+class PixelPackBufferReadback final : public WithContext {
+ public:
+  ~PixelPackBufferReadback() override;
+
+  /// @brief Returns true once the pixels can be copied without waiting.
+  [[nodiscard]] bool isReady() const;
+
+  /// @brief Copies getSizeInBytes() bytes into `pixelBytes`, laid out like the output of
+  /// IFramebuffer::copyBytesColorAttachment().
+  Result copyBytes(void* IGL_NONNULL pixelBytes) const;
+
+  [[nodiscard]] size_t getSizeInBytes() const {
+    return size_;
+  }
+
+  [[nodiscard]] GLuint getId() const {
+    return id_;
+  }
+
+ private:
+  friend class Framebuffer;
+
+  PixelPackBufferReadback(IContext& context, size_t size);
+  void insertFence();
+
+  GLuint id_ = 0;
+  size_t size_ = 0;
+  mutable GLsync fence_ = nullptr;
+};
+
+} // namespace igl::opengl
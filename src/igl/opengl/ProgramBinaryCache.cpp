@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/opengl/ProgramBinaryCache.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <igl/opengl/IContext.h>
+
+namespace igl::opengl {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x42504749; // "IGPB"
+constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint64_t key = 0;
+  uint64_t driverHash = 0;
+  uint32_t binaryFormat = 0;
+  uint32_t size = 0;
+  uint64_t checksum = 0;
+};
+
+static_assert(sizeof(FileHeader) == 40, "FileHeader must not have padding");
+
+// 64-bit FNV-1a
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i != size; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint64_t hashString(const GLubyte* str, uint64_t hash) {
+  if (str == nullptr) {
+    return hash;
+  }
+  const auto* chars = reinterpret_cast<const char*>(str);
+  // include the terminator so "ab"+"c" and "a"+"bc" hash differently
+  return hashBytes(chars, std::char_traits<char>::length(chars) + 1, hash);
+}
+
+} // namespace
+
+ProgramBinaryCache::ProgramBinaryCache(std::string directory) : directory_(std::move(directory)) {}
+
+void ProgramBinaryCache::initialize(IContext& context) {
+  if (initialized_) {
+    return;
+  }
+  initialized_ = true;
+
+  if (!context.deviceFeatures().hasInternalFeature(InternalFeatures::ProgramBinary)) {
+    return;
+  }
+
+  GLint numFormats = 0;
+  context.getIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  if (numFormats <= 0) {
+    return;
+  }
+  binaryFormats_.resize(numFormats);
+  context.getIntegerv(GL_PROGRAM_BINARY_FORMATS, binaryFormats_.data());
+
+  uint64_t hash = hashBytes(nullptr, 0);
+  hash = hashString(context.getString(GL_VENDOR), hash);
+  hash = hashString(context.getString(GL_RENDERER), hash);
+  hash = hashString(context.getString(GL_VERSION), hash);
+  driverHash_ = hash;
+}
+
+bool ProgramBinaryCache::isSupported(IContext& context) {
+  initialize(context);
+  return !binaryFormats_.empty();
+}
+
+std::string ProgramBinaryCache::getPath(uint64_t key) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016" PRIx64 ".bin", key);
+  return directory_ + "/" + name;
+}
+
+bool ProgramBinaryCache::load(IContext& context, uint64_t key, GLuint program) {
+  if (!isSupported(context)) {
+    return false;
+  }
+
+  const std::string path = getPath(key);
+
+  std::ifstream file(path, std::ios::binary);
+  FileHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != kMagic ||
+      header.version != kVersion || header.key != key || header.driverHash != driverHash_ ||
+      header.size == 0) {
+    stats_.numMisses++;
+    return false;
+  }
+
+  std::vector<char> binary(header.size);
+  if (!file.read(binary.data(), binary.size()) ||
+      hashBytes(binary.data(), binary.size()) != header.checksum) {
+    IGL_LOG_INFO("ProgramBinaryCache: ignoring corrupted file %s\n", path.c_str());
+    stats_.numMisses++;
+    return false;
+  }
+  file.close();
+
+  // passing an unknown format to glProgramBinary is a GL error
+  if (std::find(binaryFormats_.begin(),
+                binaryFormats_.end(),
+                static_cast<GLint>(header.binaryFormat)) == binaryFormats_.end()) {
+    stats_.numMisses++;
+    return false;
+  }
+
+  context.programBinary(
+      program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+  GLint status = GL_FALSE;
+  context.getProgramiv(program, GL_LINK_STATUS, &status);
+  if (status == GL_FALSE) {
+    // the driver may refuse binaries at any time, e.g. after an update that kept the version string
+    stats_.numRejected++;
+    std::remove(path.c_str());
+    return false;
+  }
+
+  stats_.numHits++;
+  return true;
+}
+
+void ProgramBinaryCache::store(IContext& context, uint64_t key, GLuint program) {
+  if (!isSupported(context)) {
+    return;
+  }
+
+  GLint size = 0;
+  context.getProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+  if (size <= 0) {
+    return;
+  }
+
+  std::vector<char> binary(size);
+  GLsizei length = 0;
+  GLenum binaryFormat = 0;
+  context.getProgramBinary(program, size, &length, &binaryFormat, binary.data());
+  if (length <= 0) {
+    return;
+  }
+  binary.resize(length);
+
+  FileHeader header;
+  header.key = key;
+  header.driverHash = driverHash_;
+  header.binaryFormat = binaryFormat;
+  header.size = static_cast<uint32_t>(binary.size());
+  header.checksum = hashBytes(binary.data(), binary.size());
+
+  // write to a temporary file first so a crash cannot leave a truncated file under the real name
+  const std::string path = getPath(key);
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+        !file.write(binary.data(), binary.size())) {
+      IGL_LOG_ERROR("ProgramBinaryCache: cannot write %s\n", tmpPath.c_str());
+      file.close();
+      std::remove(tmpPath.c_str());
+      return;
+    }
+  }
+  std::remove(path.c_str());
+  if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    return;
+  }
+
+  stats_.numStored++;
+}
+
+} // namespace igl::opengl
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <igl/opengl/GLIncludes.h>
+#include <string>
+#include <vector>
+
+namespace igl::opengl {
+
+class IContext;
+
+/// @brief Persists linked program binaries (glGetProgramBinary) in a directory so later runs can
+/// restore programs with glProgramBinary instead of linking them from source.
+///
+/// Every file starts with a header holding the program key, a hash of the GL vendor, renderer and
+/// version strings, the binary format and a checksum of the binary. Files that fail any of these
+/// checks are ignored, and so are binaries the driver rejects; the caller then links from source
+/// and stores a fresh binary.
+class ProgramBinaryCache final {
+ public:
+  struct Stats {
+    uint32_t numHits = 0;
+    uint32_t numMisses = 0;
+    uint32_t numRejected = 0; // valid files the driver refused to load
+    uint32_t numStored = 0;
+  };
+
+  /// @param directory An existing directory the cache files are written to.
+  explicit ProgramBinaryCache(std::string directory);
+
+  /// @brief Tries to restore `program` from the binary stored under `key`. Returns true if
+  /// `program` is linked and ready to use.
+  bool load(IContext& context, uint64_t key, GLuint program);
+
+  /// @brief Stores the binary of the successfully linked `program` under `key`.
+  void store(IContext& context, uint64_t key, GLuint program);
+
+  /// @brief Returns false if the driver does not support any program binary formats.
+  bool isSupported(IContext& context);
+
+  [[nodiscard]] const Stats& getStats() const {
+    return stats_;
+  }
+
+  [[nodiscard]] std::string getPath(uint64_t key) const;
+
+ private:
+  void initialize(IContext& context);
+
+  std::string directory_;
+  bool initialized_ = false;
+  uint64_t driverHash_ = 0;
+  std::vector<GLint> binaryFormats_;
+  Stats stats_;
+};
+
+} // namespace igl::opengl
@@ -126,6 +126,9 @@ void RenderCommandAdapter::setDepthBias(float depthBias, float slopeScale) {
 
 void RenderCommandAdapter::clearVertexBuffers() {
   vertexBuffersDirty_.reset();
+  ringVertexBuffers_.reset();
+  // cached vertex arrays are looked up by all buffers, so forget the unused ones too
+  vertexBuffers_ = BufferStates();
 }
 
 void RenderCommandAdapter::setVertexBuffer(std::shared_ptr<Buffer> buffer,
@@ -136,8 +139,11 @@ void RenderCommandAdapter::setVertexBuffer(std::shared_ptr<Buffer> buffer,
   IGL_ASSERT_MSG(index < IGL_VERTEX_BUFFER_MAX,
                  "Buffer index is beyond max, may want to increase limit");
   if (index >= 0 && index < IGL_VERTEX_BUFFER_MAX && buffer) {
-    vertexBuffers_[index] = {std::move(buffer), offset};
+    const bool isRing = buffer->acceptedApiHints() & BufferDesc::BufferAPIHintBits::Ring;
+    const GLuint id = static_cast<ArrayBuffer&>(*buffer).getId();
+    vertexBuffers_[index] = {std::move(buffer), offset, id};
     SET_DIRTY(vertexBuffersDirty_, index);
+    ringVertexBuffers_.set(index, isRing);
     Result::setOk(outResult);
   } else {
     Result::setResult(outResult, Result::Code::ArgumentInvalid);
@@ -289,6 +295,36 @@ void RenderCommandAdapter::drawElementsIndirect(GLenum mode,
   didDraw();
 }
 
+void RenderCommandAdapter::multiDrawElementsIndirect(GLenum mode,
+                                                     GLenum indexType,
+                                                     Buffer& indexBuffer,
+                                                     Buffer& indirectBuffer,
+                                                     size_t indirectBufferOffset,
+                                                     uint32_t drawCount,
+                                                     size_t stride) {
+  willDraw();
+  bindBufferWithShaderStorageBufferOverride(indexBuffer, GL_ELEMENT_ARRAY_BUFFER);
+  if (getContext().deviceFeatures().hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    bindBufferWithShaderStorageBufferOverride(indirectBuffer, GL_DRAW_INDIRECT_BUFFER);
+    if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::MultiDrawIndirect)) {
+      getContext().multiDrawElementsIndirect(toMockWireframeMode(mode),
+                                             indexType,
+                                             reinterpret_cast<const GLvoid*>(indirectBufferOffset),
+                                             static_cast<GLsizei>(drawCount),
+                                             static_cast<GLsizei>(stride));
+    } else {
+      // All draws share the state flushed by willDraw(), so only the draw calls are repeated
+      for (uint32_t i = 0; i != drawCount; i++) {
+        const auto offset = reinterpret_cast<const GLvoid*>(indirectBufferOffset + i * stride);
+        getContext().drawElementsIndirect(toMockWireframeMode(mode), indexType, offset);
+      }
+    }
+  } else {
+    IGL_ASSERT_NOT_IMPLEMENTED();
+  }
+  didDraw();
+}
+
 void RenderCommandAdapter::endEncoding() {
   // Some minimal cleanup needs to occur in order. Otherwise, OpenGL can end in a bad state
   // with complex rendering.
@@ -304,18 +340,47 @@ void RenderCommandAdapter::endEncoding() {
   vertexTextureStates_ = TextureStates();
   fragmentTextureStates_ = TextureStates();
 
-  vertexBuffersDirty_.reset();
+  clearVertexBuffers();
   vertexTextureStatesDirty_.reset();
   fragmentTextureStatesDirty_.reset();
+  unbindSamplerObjects();
   dirtyStateBits_ = EnumToValue(StateMask::NONE);
+
+  if (activeVAO_) {
+    // keep buffer bindings made outside of render passes from modifying cached vertex arrays
+    activeVAO_->bind();
+  }
 }
 
 void RenderCommandAdapter::willDraw() {
-  Result ret;
   auto pipelineState = static_cast<RenderPipelineState*>(pipelineState_.get());
 
+  if (ringVertexBuffers_.any()) {
+    // uploads move ring buffers to another GL buffer, which has to be bound again
+    for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
+      if (ringVertexBuffers_[bufferIndex]) {
+        auto& bufferState = vertexBuffers_[bufferIndex];
+        const GLuint id = static_cast<ArrayBuffer&>(*bufferState.resource).getId();
+        if (bufferState.id != id) {
+          bufferState.id = id;
+          SET_DIRTY(vertexBuffersDirty_, bufferIndex);
+        }
+      }
+    }
+  }
+
   // Vertex Buffers must be bound before pipelineState->bind()
-  if (pipelineState) {
+  if (pipelineState && useVAO_) {
+    // the pipeline caches a vertex array object per set of vertex buffers
+    if (vertexBuffersDirty_.any() || isDirty(StateMask::PIPELINE)) {
+      pipelineState->bindVertexArray(vertexBuffers_);
+      vertexBuffersDirty_.reset();
+    }
+    if (isDirty(StateMask::PIPELINE)) {
+      pipelineState->bind();
+      clearDirty(StateMask::PIPELINE);
+    }
+  } else if (pipelineState) {
     for (size_t bufferIndex = 0; bufferIndex < IGL_VERTEX_BUFFER_MAX; ++bufferIndex) {
       if (IS_DIRTY(vertexBuffersDirty_, bufferIndex)) {
         auto& bufferState = vertexBuffers_[bufferIndex];
@@ -351,53 +416,159 @@ void RenderCommandAdapter::willDraw() {
   //
   // These should be considered client bugs, so an assert fires in local dev builds.
 
-  // this is actually compile time defined and doesn't change, cached these statically.
-  static size_t kVertexTextureStatesSize = vertexTextureStates_.size();
-  static size_t kFragmentTextureStatesSize = fragmentTextureStates_.size();
   if (pipelineState) {
     // Bind uniforms to be used for render
-    uniformAdapter_.bindToPipeline(getContext());
-    for (size_t index = 0; index < kVertexTextureStatesSize; index++) {
-      if (!IS_DIRTY(vertexTextureStatesDirty_, index)) {
+    uniformAdapter_.bindToPipeline(
+        getContext(),
+        getContext().shouldSkipRedundantUniforms() ? &pipelineState->getUniformShadow() : nullptr,
+        pipelineState->getPackedUniformBlock());
+    if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::MultiBind)) {
+      bindTextureStatesMulti(*pipelineState);
+    } else {
+      bindTextureStates(*pipelineState,
+                        vertexTextureStates_,
+                        vertexTextureStatesDirty_,
+                        igl::BindTarget::kVertex);
+      bindTextureStates(*pipelineState,
+                        fragmentTextureStates_,
+                        fragmentTextureStatesDirty_,
+                        igl::BindTarget::kFragment);
+    }
+  }
+}
+
+void RenderCommandAdapter::bindTextureStates(RenderPipelineState& pipelineState,
+                                             TextureStates& states,
+                                             std::bitset<IGL_TEXTURE_SAMPLERS_MAX>& dirtyFlags,
+                                             uint8_t bindTarget) {
+  for (size_t index = 0; index < IGL_TEXTURE_SAMPLERS_MAX; index++) {
+    if (!IS_DIRTY(dirtyFlags, index)) {
+      continue;
+    }
+    auto& textureState = states[index];
+    if (auto* texture = static_cast<Texture*>(textureState.first)) {
+      const Result ret = pipelineState.bindTextureUnit(index, bindTarget);
+
+      if (!ret.isOk()) {
+        IGL_LOG_INFO_ONCE(ret.message.c_str());
         continue;
       }
-      auto& textureState = vertexTextureStates_[index];
-      if (auto* texture = static_cast<Texture*>(textureState.first)) {
-        ret = pipelineState->bindTextureUnit(index, igl::BindTarget::kVertex);
-
-        if (!ret.isOk()) {
-          IGL_LOG_INFO_ONCE(ret.message.c_str());
-          continue;
-        }
 
-        texture->bind();
+      texture->bind();
 
-        if (auto* samplerState = static_cast<SamplerState*>(textureState.second)) {
+      GLuint samplerObject = 0;
+      if (auto* samplerState = static_cast<SamplerState*>(textureState.second)) {
+        samplerObject = samplerState->getSamplerObject(texture);
+        if (samplerObject == 0) {
           samplerState->bind(texture);
         }
-        CLEAR_DIRTY(vertexTextureStatesDirty_, index);
       }
+      bindSamplerObject(index, samplerObject);
+      CLEAR_DIRTY(dirtyFlags, index);
     }
-    for (size_t index = 0; index < kFragmentTextureStatesSize; index++) {
-      if (!IS_DIRTY(fragmentTextureStatesDirty_, index)) {
+  }
+}
+
+// Binds the dirty texture units with one glBindTextures and at most one glBindSamplers call per
+// run of consecutive units. Textures without a texture object, such as renderbuffer-backed ones,
+// are left to bindTextureStates().
+void RenderCommandAdapter::bindTextureStatesMulti(RenderPipelineState& pipelineState) {
+  std::array<GLuint, IGL_TEXTURE_SAMPLERS_MAX> textures{};
+  std::array<GLuint, IGL_TEXTURE_SAMPLERS_MAX> samplerObjects = samplerObjects_;
+  std::bitset<IGL_TEXTURE_SAMPLERS_MAX> units;
+
+  // vertex and fragment textures share texture units; fragment ones win, as with bindTextureUnit()
+  auto gather = [&](TextureStates& states,
+                    std::bitset<IGL_TEXTURE_SAMPLERS_MAX>& dirtyFlags,
+                    uint8_t bindTarget) {
+    for (size_t index = 0; index < IGL_TEXTURE_SAMPLERS_MAX; index++) {
+      if (!IS_DIRTY(dirtyFlags, index)) {
+        continue;
+      }
+      auto& textureState = states[index];
+      auto* texture = static_cast<Texture*>(textureState.first);
+      if (texture == nullptr || !texture->hasTextureObject()) {
+        continue;
+      }
+      const Result ret = pipelineState.setTextureUnit(index, bindTarget);
+      if (!ret.isOk()) {
+        IGL_LOG_INFO_ONCE(ret.message.c_str());
         continue;
       }
-      auto& textureState = fragmentTextureStates_[index];
-      if (auto* texture = static_cast<Texture*>(textureState.first)) {
-        ret = pipelineState->bindTextureUnit(index, igl::BindTarget::kFragment);
-
-        if (!ret.isOk()) {
-          IGL_LOG_INFO_ONCE(ret.message.c_str());
-          continue;
-        }
-        texture->bind();
 
-        if (auto* samplerState = static_cast<SamplerState*>(textureState.second)) {
+      GLuint samplerObject = 0;
+      if (auto* samplerState = static_cast<SamplerState*>(textureState.second)) {
+        samplerObject = samplerState->getSamplerObject(texture);
+        if (samplerObject == 0) {
+          // this sampler state lives in the texture parameters, which need the texture bound
+          getContext().activeTexture(static_cast<GLenum>(GL_TEXTURE0 + index));
+          texture->bind();
           samplerState->bind(texture);
         }
-        CLEAR_DIRTY(fragmentTextureStatesDirty_, index);
       }
+      textures[index] = texture->getId();
+      samplerObjects[index] = samplerObject;
+      units.set(index);
+      CLEAR_DIRTY(dirtyFlags, index);
+    }
+  };
+  gather(vertexTextureStates_, vertexTextureStatesDirty_, igl::BindTarget::kVertex);
+  gather(fragmentTextureStates_, fragmentTextureStatesDirty_, igl::BindTarget::kFragment);
+  // a vertex texture bound below must not replace a fragment texture gathered for the same unit
+  vertexTextureStatesDirty_ &= ~units;
+
+  size_t first = 0;
+  while (first < IGL_TEXTURE_SAMPLERS_MAX) {
+    if (!units.test(first)) {
+      first++;
+      continue;
+    }
+    size_t last = first + 1;
+    bool samplersChanged = samplerObjects[first] != samplerObjects_[first];
+    while (last < IGL_TEXTURE_SAMPLERS_MAX && units.test(last)) {
+      samplersChanged |= samplerObjects[last] != samplerObjects_[last];
+      last++;
+    }
+    const auto count = static_cast<GLsizei>(last - first);
+    getContext().bindTextures(static_cast<GLuint>(first), count, &textures[first]);
+    if (samplersChanged) {
+      getContext().bindSamplers(static_cast<GLuint>(first), count, &samplerObjects[first]);
+      std::copy(samplerObjects.begin() + first,
+                samplerObjects.begin() + last,
+                samplerObjects_.begin() + first);
     }
+    first = last;
+  }
+
+  bindTextureStates(
+      pipelineState, vertexTextureStates_, vertexTextureStatesDirty_, igl::BindTarget::kVertex);
+  bindTextureStates(pipelineState,
+                    fragmentTextureStates_,
+                    fragmentTextureStatesDirty_,
+                    igl::BindTarget::kFragment);
+}
+
+void RenderCommandAdapter::bindSamplerObject(size_t textureUnit, GLuint samplerObject) {
+  if (samplerObjects_[textureUnit] != samplerObject) {
+    getContext().bindSampler(static_cast<GLuint>(textureUnit), samplerObject);
+    samplerObjects_[textureUnit] = samplerObject;
+  }
+}
+
+// Sampler objects override the parameters of any texture sampled from their unit, so they must not
+// outlive the encoder.
+void RenderCommandAdapter::unbindSamplerObjects() {
+  if (getContext().deviceFeatures().hasInternalFeature(InternalFeatures::MultiBind)) {
+    if (std::any_of(samplerObjects_.begin(), samplerObjects_.end(), [](GLuint samplerObject) {
+          return samplerObject != 0;
+        })) {
+      getContext().bindSamplers(0, IGL_TEXTURE_SAMPLERS_MAX, nullptr);
+      samplerObjects_.fill(0);
+    }
+    return;
+  }
+  for (size_t unit = 0; unit < IGL_TEXTURE_SAMPLERS_MAX; unit++) {
+    bindSamplerObject(unit, 0);
   }
 }
 
@@ -432,7 +603,10 @@ GLenum RenderCommandAdapter::toMockWireframeMode(GLenum mode) const {
 }
 
 void RenderCommandAdapter::didDraw() {
-  // Placeholder stub in case we want to add something later
+  if (getContext().hasUniformBlockArena()) {
+    // the uniform blocks of this draw are bound, later blocks may orphan the arena storage
+    getContext().getUniformBlockArena()->endDraw();
+  }
 }
 
 void RenderCommandAdapter::unbindVertexAttributes() {
@@ -445,6 +619,7 @@ void RenderCommandAdapter::unbindVertexAttributes() {
 void RenderCommandAdapter::unbindResources() {
   unbindTextures(getContext(), fragmentTextureStates_, fragmentTextureStatesDirty_);
   unbindTextures(getContext(), vertexTextureStates_, vertexTextureStatesDirty_);
+  unbindSamplerObjects();
 
   // Restore to default active texture
   getContext().activeTexture(GL_TEXTURE0);
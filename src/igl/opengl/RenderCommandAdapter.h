@@ -27,6 +27,7 @@ class IRenderPipelineState;
 
 namespace opengl {
 class Buffer;
+class RenderPipelineState;
 class VertexArrayObject;
 
 class RenderCommandAdapter final : public WithContext {
@@ -34,11 +35,15 @@ class RenderCommandAdapter final : public WithContext {
   using StateBits = uint32_t;
   enum class StateMask : StateBits { NONE = 0, PIPELINE = 1 << 1, DEPTH_STENCIL = 1 << 2 };
 
- private:
   struct BufferState {
     std::shared_ptr<Buffer> resource;
-    size_t offset;
+    size_t offset = 0;
+    // GL name of the resource when it was last bound, which uploads to ring buffers change
+    GLuint id = 0;
   };
+  using BufferStates = std::array<BufferState, IGL_VERTEX_BUFFER_MAX>;
+
+ private:
 
   using TextureState = std::pair<ITexture*, ISamplerState*>;
   using TextureStates = std::array<TextureState, IGL_TEXTURE_SAMPLERS_MAX>;
@@ -101,6 +106,13 @@ class RenderCommandAdapter final : public WithContext {
                             Buffer& indexBuffer,
                             Buffer& indirectBuffer,
                             const GLvoid* indirectBufferOffset);
+  void multiDrawElementsIndirect(GLenum mode,
+                                 GLenum indexType,
+                                 Buffer& indexBuffer,
+                                 Buffer& indirectBuffer,
+                                 size_t indirectBufferOffset,
+                                 uint32_t drawCount,
+                                 size_t stride);
 
   void endEncoding();
 
@@ -121,6 +133,14 @@ class RenderCommandAdapter final : public WithContext {
   void bindBufferWithShaderStorageBufferOverride(Buffer& buffer,
                                                  GLenum overrideTargetForShaderStorageBuffer);
 
+  void bindTextureStates(RenderPipelineState& pipelineState,
+                         TextureStates& states,
+                         std::bitset<IGL_TEXTURE_SAMPLERS_MAX>& dirtyFlags,
+                         uint8_t bindTarget);
+  void bindTextureStatesMulti(RenderPipelineState& pipelineState);
+  void bindSamplerObject(size_t textureUnit, GLuint samplerObject);
+  void unbindSamplerObjects();
+
   static void unbindTexture(IContext& context, size_t textureUnit, TextureState& textureState);
   static void unbindTextures(IContext& context,
                              TextureStates& states,
@@ -141,12 +161,15 @@ class RenderCommandAdapter final : public WithContext {
   GLenum toMockWireframeMode(GLenum mode) const;
 
  private:
-  std::array<BufferState, IGL_VERTEX_BUFFER_MAX> vertexBuffers_;
+  BufferStates vertexBuffers_;
   std::bitset<IGL_VERTEX_BUFFER_MAX> vertexBuffersDirty_;
+  std::bitset<IGL_VERTEX_BUFFER_MAX> ringVertexBuffers_;
   std::bitset<IGL_TEXTURE_SAMPLERS_MAX> vertexTextureStatesDirty_;
   std::bitset<IGL_TEXTURE_SAMPLERS_MAX> fragmentTextureStatesDirty_;
   TextureStates vertexTextureStates_;
   TextureStates fragmentTextureStates_;
+  // sampler objects bound to each texture unit since the encoder started, 0 if none
+  std::array<GLuint, IGL_TEXTURE_SAMPLERS_MAX> samplerObjects_{};
   UniformAdapter uniformAdapter_;
   StateBits dirtyStateBits_ = EnumToValue(StateMask::NONE);
   std::shared_ptr<IRenderPipelineState> pipelineState_;
@@ -151,6 +151,7 @@ void RenderCommandEncoder::endEncoding() {
         IGL_ASSERT_NOT_REACHED();
       }
     }
+    getContext().checkForEncoderErrors(__FUNCTION__);
   }
 }
 
@@ -399,14 +400,26 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType /*primitiveType*/,
   IGL_ASSERT_NOT_IMPLEMENTED();
 }
 
-void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType /*primitiveType*/,
-                                                    IndexFormat /*indexFormat*/,
-                                                    IBuffer& /*indexBuffer*/,
-                                                    IBuffer& /*indirectBuffer*/,
-                                                    size_t /*indirectBufferOffset*/,
-                                                    uint32_t /*drawCount*/,
-                                                    uint32_t /*stride*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
+                                                    IndexFormat indexFormat,
+                                                    IBuffer& indexBuffer,
+                                                    IBuffer& indirectBuffer,
+                                                    size_t indirectBufferOffset,
+                                                    uint32_t drawCount,
+                                                    uint32_t stride) {
+  if (IGL_VERIFY(adapter_)) {
+    getCommandBuffer().incrementCurrentDrawCount();
+    auto mode = toGlPrimitive(primitiveType);
+    auto type = toGlType(indexFormat);
+    // DrawElementsIndirectCommand: count, instanceCount, firstIndex, baseVertex, baseInstance
+    adapter_->multiDrawElementsIndirect(mode,
+                                        type,
+                                        (Buffer&)indexBuffer,
+                                        (Buffer&)indirectBuffer,
+                                        indirectBufferOffset,
+                                        drawCount,
+                                        stride ? stride : 5 * sizeof(uint32_t));
+  }
 }
 
 void RenderCommandEncoder::setStencilReferenceValue(uint32_t value) {
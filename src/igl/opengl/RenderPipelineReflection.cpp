@@ -7,6 +7,7 @@
 
 #include "RenderPipelineReflection.h"
 
+#include <algorithm>
 #include <cstring>
 #include <igl/opengl/GLIncludes.h>
 
@@ -85,6 +86,7 @@ RenderPipelineReflection::RenderPipelineReflection(IContext& context, const Shad
     generateUniformBlocksDictionary(context, stages.getProgramID());
   }
   generateUniformDictionary(context, stages.getProgramID());
+  generatePackedUniformDictionary();
   generateAttributeDictionary(context, stages.getProgramID());
   generateShaderStorageBufferObjectDictionary(context, stages.getProgramID());
   cacheDescriptors();
@@ -188,6 +190,9 @@ void RenderPipelineReflection::generateUniformBlocksDictionary(IContext& context
                                &memberDesc.type,
                                nameData.data());
       context.getActiveUniformsiv(pid, 1, &index, GL_UNIFORM_OFFSET, &memberDesc.offset);
+      context.getActiveUniformsiv(pid, 1, &index, GL_UNIFORM_ARRAY_STRIDE, &memberDesc.arrayStride);
+      context.getActiveUniformsiv(
+          pid, 1, &index, GL_UNIFORM_MATRIX_STRIDE, &memberDesc.matrixStride);
 
       // Fix the name by removing [0] suffix for arrays
       // and by stripping the block name from the uniform name
@@ -211,6 +216,24 @@ void RenderPipelineReflection::generateUniformBlocksDictionary(IContext& context
   }
 }
 
+void RenderPipelineReflection::generatePackedUniformDictionary() {
+  packedUniformDictionary_.clear();
+
+  const auto blockIt = uniformBlocksDictionary_.find(igl::genNameHandle(kPackedUniformBlockName));
+  if (blockIt == uniformBlocksDictionary_.end()) {
+    return;
+  }
+
+  // every element of a default block array has its own location
+  int location = 0;
+  for (const auto& [name, uniformDesc] : uniformDictionary_) {
+    location = std::max(location, uniformDesc.location + std::max(uniformDesc.size, 1));
+  }
+  for (const auto& [name, memberDesc] : blockIt->second.members) {
+    packedUniformDictionary_[name] = location++;
+  }
+}
+
 void RenderPipelineReflection::generateAttributeDictionary(IContext& context, GLuint pid) {
   IGL_ASSERT(pid != 0);
 
@@ -269,6 +292,11 @@ int RenderPipelineReflection::getIndexByName(const NameHandle& name) const {
     return uniformEntry->second.location;
   }
 
+  const auto packedUniformEntry = packedUniformDictionary_.find(name);
+  if (packedUniformEntry != packedUniformDictionary_.end()) {
+    return packedUniformEntry->second;
+  }
+
   // search through the list of uniform blocks
   const auto uniformBlockEntry = uniformBlocksDictionary_.find(name);
   if (uniformBlockEntry != uniformBlocksDictionary_.end()) {
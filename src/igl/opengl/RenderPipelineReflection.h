@@ -18,6 +18,10 @@ namespace opengl {
 
 class RenderPipelineReflection final : public IRenderPipelineReflection {
  public:
+  /// Members of a uniform block with this name are set like loose uniforms; see
+  /// PackedUniformBlock.
+  static constexpr const char* kPackedUniformBlockName = "IGLPackedUniforms";
+
   struct UniformDesc {
     GLsizei size;
     GLint location;
@@ -31,6 +35,8 @@ class RenderPipelineReflection final : public IRenderPipelineReflection {
       GLsizei size = 0;
       GLenum type = GL_NONE;
       GLint offset = 0;
+      GLint arrayStride = 0;
+      GLint matrixStride = 0;
     };
 
     GLint size;
@@ -57,6 +63,12 @@ class RenderPipelineReflection final : public IRenderPipelineReflection {
     return uniformBlocksDictionary_;
   }
 
+  /// Locations handed out to the members of the kPackedUniformBlockName block. They follow the
+  /// locations of the default uniform block.
+  const std::unordered_map<NameHandle, int>& getPackedUniformDictionary() const {
+    return packedUniformDictionary_;
+  }
+
   const std::unordered_map<std::string, int>& getAttributeDictionary() const {
     return attributeDictionary_;
   }
@@ -71,11 +83,13 @@ class RenderPipelineReflection final : public IRenderPipelineReflection {
  private:
   std::unordered_map<NameHandle, UniformDesc> uniformDictionary_;
   std::unordered_map<NameHandle, UniformBlockDesc> uniformBlocksDictionary_;
+  std::unordered_map<NameHandle, int> packedUniformDictionary_;
   std::unordered_map<std::string, int> attributeDictionary_;
   std::unordered_map<NameHandle, int> shaderStorageBufferObjectDictionary_;
 
   void generateUniformDictionary(IContext& context, GLuint pid);
   void generateUniformBlocksDictionary(IContext& context, GLuint pid);
+  void generatePackedUniformDictionary();
   void generateShaderStorageBufferObjectDictionary(IContext& context, GLuint pid);
   void generateAttributeDictionary(IContext& context, GLuint pid);
 
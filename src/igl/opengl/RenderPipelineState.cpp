@@ -7,14 +7,35 @@
 
 #include <igl/opengl/RenderPipelineState.h>
 
+#include <algorithm>
+#include <bitset>
 #include <igl/RenderCommandEncoder.h> // for igl::BindTarget
+#include <igl/opengl/Buffer.h>
+#include <igl/opengl/VertexArrayObject.h>
 #include <igl/opengl/VertexInputState.h>
+#include <limits>
 
 namespace igl {
 namespace opengl {
 
 namespace {
 
+// Vertex arrays referencing buffers that are still alive are only evicted past this limit
+constexpr size_t kMaxCachedVertexArrays = 16;
+
+bool isSameBuffer(const std::weak_ptr<Buffer>& a, const std::shared_ptr<Buffer>& b) {
+  return !a.owner_before(b) && !b.owner_before(a);
+}
+
+GLuint getBufferId(Buffer& buffer) {
+  return static_cast<ArrayBuffer&>(buffer).getId();
+}
+
+bool isDestroyed(const std::weak_ptr<Buffer>& buffer) {
+  // an empty weak_ptr stands for a buffer index without a bound buffer
+  return buffer.expired() && !isSameBuffer(buffer, nullptr);
+}
+
 void logBlendFactorError(IGL_MAYBE_UNUSED const char* value) {
   IGL_LOG_ERROR("[IGL] OpenGL does not support blend mode:  %s, setting to GL_ONE instead\n",
                 value);
@@ -120,9 +141,52 @@ Result RenderPipelineState::create() {
     return Result(Result::Code::ArgumentInvalid, "Missing required shader module(s).");
   }
 
+  const auto& mFramebufferDesc = desc_.targetDesc;
+
+  if (shaderStages->isReady()) {
+    auto result = reflectProgram();
+    if (!result.isOk()) {
+      return result;
+    }
+  }
+
+  if (!mFramebufferDesc.colorAttachments.empty()) {
+    ColorWriteMask const colorWriteMask = mFramebufferDesc.colorAttachments[0].colorWriteMask;
+    colorMask_[0] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsRed) != 0);
+    colorMask_[1] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsGreen) != 0);
+    colorMask_[2] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsBlue) != 0);
+    colorMask_[3] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsAlpha) != 0);
+  }
+
+  if (!mFramebufferDesc.colorAttachments.empty() &&
+      mFramebufferDesc.colorAttachments[0].blendEnabled) {
+    blendEnabled_ = true;
+    // GL equation sets blending equation for both RGB and alpha
+    blendMode_ = {convertBlendOp(mFramebufferDesc.colorAttachments[0].rgbBlendOp),
+                  convertBlendOp(mFramebufferDesc.colorAttachments[0].alphaBlendOp),
+                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].srcRGBBlendFactor),
+                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].dstRGBBlendFactor),
+                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].srcAlphaBlendFactor),
+                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].dstAlphaBlendFactor)};
+  } else {
+    blendEnabled_ = false;
+  }
+
+  return Result();
+}
+
+Result RenderPipelineState::reflectProgram() {
+  IGL_ASSERT(!ready_);
+  ready_ = true;
+
+  const auto& shaderStages = std::static_pointer_cast<ShaderStages>(desc_.shaderStages);
+  if (shaderStages->getProgramID() == 0) {
+    // linking failed, which ShaderStages has already logged
+    return Result(Result::Code::RuntimeError, "Shader stages failed to link");
+  }
+
   reflection_ = std::make_shared<RenderPipelineReflection>(getContext(), *shaderStages);
 
-  const auto& mFramebufferDesc = desc_.targetDesc;
   // Get and cache all attribute locations, since this won't change throughout
   // the lifetime of this RenderPipelineState
   const auto& vertexInputState = std::static_pointer_cast<VertexInputState>(desc_.vertexInputState);
@@ -141,6 +205,9 @@ Result RenderPipelineState::create() {
           bufferAttribLocations_[index].push_back(loc);
         }
       }
+      if (index < IGL_VERTEX_BUFFER_MAX && !attribList.empty()) {
+        vertexBufferIndices_.push_back(index);
+      }
     }
   }
 
@@ -195,32 +262,81 @@ Result RenderPipelineState::create() {
     unitSamplerLocationMap_[realTextureUnit] = loc;
   }
 
-  if (!mFramebufferDesc.colorAttachments.empty()) {
-    ColorWriteMask const colorWriteMask = mFramebufferDesc.colorAttachments[0].colorWriteMask;
-    colorMask_[0] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsRed) != 0);
-    colorMask_[1] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsGreen) != 0);
-    colorMask_[2] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsBlue) != 0);
-    colorMask_[3] = static_cast<GLboolean>((colorWriteMask & ColorWriteBitsAlpha) != 0);
+  createPackedUniformBlock();
+
+  return Result();
+}
+
+void RenderPipelineState::createPackedUniformBlock() {
+  const auto& uniformBlockDict = reflection_->getUniformBlocksDictionary();
+  const auto blockIt = uniformBlockDict.find(
+      igl::genNameHandle(RenderPipelineReflection::kPackedUniformBlockName));
+  if (blockIt == uniformBlockDict.end()) {
+    return;
+  }
+  const auto& blockDesc = blockIt->second;
+
+  GLint bindingIndex = blockDesc.bindingIndex;
+  if (bindingIndex <= 0) {
+    // take the last binding point that neither the pipeline nor the shaders use
+    std::bitset<IGL_UNIFORM_BLOCKS_BINDING_MAX> used;
+    for (const auto& [blockIndex, index] : uniformBlockBindingMap_) {
+      used.set(index);
+    }
+    for (const auto& [name, desc] : uniformBlockDict) {
+      if (desc.bindingIndex >= 0 && desc.bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX) {
+        used.set(desc.bindingIndex);
+      }
+    }
+    bindingIndex = IGL_UNIFORM_BLOCKS_BINDING_MAX - 1;
+    while (bindingIndex >= 0 && used.test(bindingIndex)) {
+      bindingIndex--;
+    }
+    if (bindingIndex < 0) {
+      IGL_LOG_ERROR("No uniform block binding point left for %s\n",
+                    RenderPipelineReflection::kPackedUniformBlockName);
+      return;
+    }
+    uniformBlockBindingMap_[blockDesc.blockIndex] = bindingIndex;
   }
 
-  if (!mFramebufferDesc.colorAttachments.empty() &&
-      mFramebufferDesc.colorAttachments[0].blendEnabled) {
-    blendEnabled_ = true;
-    // GL equation sets blending equation for both RGB and alpha
-    blendMode_ = {convertBlendOp(mFramebufferDesc.colorAttachments[0].rgbBlendOp),
-                  convertBlendOp(mFramebufferDesc.colorAttachments[0].alphaBlendOp),
-                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].srcRGBBlendFactor),
-                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].dstRGBBlendFactor),
-                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].srcAlphaBlendFactor),
-                  convertBlendFactor(mFramebufferDesc.colorAttachments[0].dstAlphaBlendFactor)};
-  } else {
-    blendEnabled_ = false;
+  const auto& locations = reflection_->getPackedUniformDictionary();
+  int firstLocation = std::numeric_limits<int>::max();
+  for (const auto& [name, location] : locations) {
+    firstLocation = std::min(firstLocation, location);
+  }
+  packedUniformBlock_ = std::make_unique<PackedUniformBlock>(
+      getContext(), blockDesc.size, firstLocation, static_cast<GLuint>(bindingIndex));
+  for (const auto& [name, memberDesc] : blockDesc.members) {
+    packedUniformBlock_->addMember(locations.at(name),
+                                   memberDesc.offset,
+                                   std::max(memberDesc.size, 1),
+                                   memberDesc.arrayStride,
+                                   memberDesc.matrixStride);
   }
+}
 
-  return Result();
+bool RenderPipelineState::isReady() {
+  if (!ready_ && !std::static_pointer_cast<ShaderStages>(desc_.shaderStages)->isReady()) {
+    return false;
+  }
+  waitUntilReady();
+  return true;
+}
+
+void RenderPipelineState::waitUntilReady() {
+  if (ready_) {
+    return;
+  }
+  std::static_pointer_cast<ShaderStages>(desc_.shaderStages)->waitUntilReady();
+  const auto result = reflectProgram();
+  if (!result.isOk()) {
+    IGL_LOG_ERROR("Failed to create pipeline state: %s\n", result.message.c_str());
+  }
 }
 
 void RenderPipelineState::bind() {
+  waitUntilReady();
   if (desc_.shaderStages) {
     const auto& shaderStages = std::static_pointer_cast<ShaderStages>(desc_.shaderStages);
     shaderStages->bind();
@@ -276,6 +392,12 @@ void RenderPipelineState::bindVertexAttributes(size_t bufferIndex, size_t buffer
   }
 #endif
 
+  waitUntilReady();
+  if (reflection_ == nullptr) {
+    // the program failed to link
+    return;
+  }
+
   const auto& attribList = std::static_pointer_cast<VertexInputState>(desc_.vertexInputState)
                                ->getAssociatedAttributes(bufferIndex);
   auto& locations = bufferAttribLocations_[bufferIndex];
@@ -308,6 +430,60 @@ void RenderPipelineState::bindVertexAttributes(size_t bufferIndex, size_t buffer
   }
 }
 
+void RenderPipelineState::bindVertexArray(
+    const RenderCommandAdapter::BufferStates& vertexBuffers) {
+  waitUntilReady();
+
+  auto matches = [this, &vertexBuffers](const CachedVertexArray& cached) {
+    for (size_t i = 0; i != vertexBufferIndices_.size(); i++) {
+      const auto& state = vertexBuffers[vertexBufferIndices_[i]];
+      if (!isSameBuffer(cached.buffers[i], state.resource) ||
+          (state.resource && (cached.offsets[i] != state.offset ||
+                              cached.ids[i] != getBufferId(*state.resource)))) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (const auto& cached : vertexArrays_) {
+    if (matches(cached)) {
+      cached.vertexArray->bind();
+      return;
+    }
+  }
+
+  // evict vertex arrays that reference destroyed buffers before adding a new one
+  auto referencesDestroyedBuffer = [](const CachedVertexArray& cached) {
+    return std::any_of(cached.buffers.begin(), cached.buffers.end(), isDestroyed);
+  };
+  vertexArrays_.erase(
+      std::remove_if(vertexArrays_.begin(), vertexArrays_.end(), referencesDestroyedBuffer),
+      vertexArrays_.end());
+  if (vertexArrays_.size() >= kMaxCachedVertexArrays) {
+    vertexArrays_.erase(vertexArrays_.begin());
+  }
+
+  CachedVertexArray cached;
+  cached.vertexArray = std::make_unique<VertexArrayObject>(getContext());
+  cached.vertexArray->create();
+  cached.vertexArray->bind();
+  for (const size_t bufferIndex : vertexBufferIndices_) {
+    const auto& state = vertexBuffers[bufferIndex];
+    cached.buffers.emplace_back(state.resource);
+    cached.ids.push_back(state.resource ? getBufferId(*state.resource) : 0);
+    cached.offsets.push_back(state.offset);
+    if (state.resource) {
+      static_cast<ArrayBuffer&>(*state.resource).bindForTarget(GL_ARRAY_BUFFER);
+      bindVertexAttributes(bufferIndex, state.offset);
+    }
+  }
+  // the attributes belong to the cached vertex array now and are never disabled
+  activeAttributesLocations_.clear();
+
+  vertexArrays_.push_back(std::move(cached));
+}
+
 void RenderPipelineState::unbindVertexAttributes() {
   for (const auto& l : activeAttributesLocations_) {
     getContext().disableVertexAttribArray(l);
@@ -320,6 +496,14 @@ void RenderPipelineState::unbindVertexAttributes() {
 //
 // Prerequisite: The shader program has to be loaded
 Result RenderPipelineState::bindTextureUnit(const size_t unit, uint8_t bindTarget) {
+  Result result = setTextureUnit(unit, bindTarget);
+  if (result.isOk()) {
+    getContext().activeTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
+  }
+  return result;
+}
+
+Result RenderPipelineState::setTextureUnit(const size_t unit, uint8_t bindTarget) {
   if (!desc_.shaderStages) {
     return Result{Result::Code::InvalidOperation, "No shader set\n"};
   }
@@ -328,6 +512,8 @@ Result RenderPipelineState::bindTextureUnit(const size_t unit, uint8_t bindTarge
     return Result{Result::Code::ArgumentInvalid, "Unit specified greater than maximum\n"};
   }
 
+  waitUntilReady();
+
   GLint samplerLocation = -1;
   if (bindTarget == igl::BindTarget::kVertex) {
     auto it = vertexTextureUnitRemap.find(unit);
@@ -344,8 +530,13 @@ Result RenderPipelineState::bindTextureUnit(const size_t unit, uint8_t bindTarge
     return Result{Result::Code::RuntimeError, "Unable to find sampler location\n"};
   }
 
-  getContext().uniform1i(samplerLocation, static_cast<GLint>(unit));
-  getContext().activeTexture(static_cast<GLenum>(GL_TEXTURE0 + unit));
+  const auto value = static_cast<GLint>(unit);
+  if (getContext().shouldSkipRedundantUniforms() &&
+      !getUniformShadow().update(
+          samplerLocation, reinterpret_cast<const uint8_t*>(&value), sizeof(value))) {
+    return Result();
+  }
+  getContext().uniform1i(samplerLocation, value);
 
   return Result();
 }
@@ -360,17 +551,16 @@ bool RenderPipelineState::matchesVertexInputState(const RenderPipelineState& rhs
 }
 
 int RenderPipelineState::getIndexByName(const NameHandle& name, ShaderStage /*stage*/) const {
+  // callers cache the returned index, so block until the program has linked and been reflected
+  const_cast<RenderPipelineState*>(this)->waitUntilReady();
   if (reflection_ == nullptr) {
     return -1;
   }
   return reflection_->getIndexByName(name);
 }
 
-int RenderPipelineState::getIndexByName(const std::string& name, ShaderStage /*stage*/) const {
-  if (reflection_ == nullptr) {
-    return -1;
-  }
-  return reflection_->getIndexByName(igl::genNameHandle(name));
+int RenderPipelineState::getIndexByName(const std::string& name, ShaderStage stage) const {
+  return getIndexByName(igl::genNameHandle(name), stage);
 }
 
 int RenderPipelineState::getUniformBlockBindingPoint(const NameHandle& uniformBlockName) const {
@@ -378,6 +568,7 @@ int RenderPipelineState::getUniformBlockBindingPoint(const NameHandle& uniformBl
 }
 
 std::shared_ptr<IRenderPipelineReflection> RenderPipelineState::renderPipelineReflection() {
+  waitUntilReady();
   return reflection_;
 }
 
@@ -28,11 +28,16 @@ struct BlendMode {
 };
 
 class Device;
+class VertexArrayObject;
 
 class RenderPipelineState final : public WithContext, public IRenderPipelineState {
   friend class Device;
 
   Result create();
+  /// Queries attribute, sampler and uniform block locations of the linked program.
+  Result reflectProgram();
+  void createPackedUniformBlock();
+  void waitUntilReady();
 
  public:
   explicit RenderPipelineState(IContext& context,
@@ -40,13 +45,38 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
                                Result* outResult);
   ~RenderPipelineState() override;
 
+  /// Returns false while the shader stages are still linking; see
+  /// IContext::setShouldCompileShadersAsync().
+  bool isReady() override;
+
   void bind();
   void unbind();
   Result bindTextureUnit(const size_t unit, uint8_t bindTarget);
+  /// Same as bindTextureUnit() without making `unit` the active texture unit, for callers that
+  /// bind textures with glBindTextures.
+  Result setTextureUnit(const size_t unit, uint8_t bindTarget);
 
   void bindVertexAttributes(size_t bufferIndex, size_t offset);
   void unbindVertexAttributes();
 
+  /// Binds a vertex array object holding the vertex attributes of this pipeline sourced from
+  /// `vertexBuffers`. Vertex array objects are cached per combination of vertex buffers and
+  /// offsets, so drawing again with the same buffers only calls glBindVertexArray.
+  void bindVertexArray(const RenderCommandAdapter::BufferStates& vertexBuffers);
+  [[nodiscard]] size_t getNumCachedVertexArrays() const {
+    return vertexArrays_.size();
+  }
+
+  UniformShadow& getUniformShadow() {
+    return static_cast<ShaderStages&>(*desc_.shaderStages).getUniformShadow();
+  }
+
+  /// Returns null unless the shaders declare a RenderPipelineReflection::kPackedUniformBlockName
+  /// uniform block.
+  PackedUniformBlock* getPackedUniformBlock() {
+    return packedUniformBlock_.get();
+  }
+
   bool matchesShaderProgram(const RenderPipelineState& rhs) const;
   bool matchesVertexInputState(const RenderPipelineState& rhs) const;
 
@@ -73,17 +103,32 @@ class RenderPipelineState final : public WithContext, public IRenderPipelineStat
   std::unordered_map<int, size_t>& uniformBlockBindingMap();
 
  private:
+  struct CachedVertexArray {
+    // one entry per index in vertexBufferIndices_; weak_ptr ownership is compared so a buffer
+    // allocated at the address of a destroyed one does not match
+    std::vector<std::weak_ptr<Buffer>> buffers;
+    // GL names are compared too because ring buffers switch names on upload
+    std::vector<GLuint> ids;
+    std::vector<size_t> offsets;
+    std::unique_ptr<VertexArrayObject> vertexArray;
+  };
+
   // Tracks a list of attribute locations associated with a bufferIndex
   std::vector<int> bufferAttribLocations_[IGL_VERTEX_BUFFER_MAX];
+  // Buffer indices with at least one attribute
+  std::vector<size_t> vertexBufferIndices_;
+  std::vector<CachedVertexArray> vertexArrays_;
 
   std::shared_ptr<RenderPipelineReflection> reflection_;
   std::unordered_map<size_t, size_t> vertexTextureUnitRemap;
   std::array<GLint, IGL_TEXTURE_SAMPLERS_MAX> unitSamplerLocationMap_;
   std::unordered_map<int, size_t> uniformBlockBindingMap_;
+  std::unique_ptr<PackedUniformBlock> packedUniformBlock_;
   std::array<GLboolean, 4> colorMask_ = {GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE};
   std::vector<int> activeAttributesLocations_;
   BlendMode blendMode_ = {GL_FUNC_ADD, GL_FUNC_ADD, GL_ONE, GL_ZERO, GL_ONE, GL_ZERO};
   bool blendEnabled_ = false;
+  bool ready_ = false; // true once the program is linked and reflected
 };
 
 } // namespace opengl
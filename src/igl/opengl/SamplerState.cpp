@@ -23,6 +23,7 @@ bool isPowerOfTwo(size_t number) {
 
 SamplerState::SamplerState(IContext& context, const SamplerStateDesc& desc) :
   WithContext(context),
+  desc_(desc),
   minMipFilter_(convertMinMipFilter(desc.minFilter, desc.mipFilter)),
   magFilter_(convertMagFilter(desc.magFilter)),
   mipLodMin_(desc.mipLodMin),
@@ -131,6 +132,38 @@ void SamplerState::bind(ITexture* t) {
   }
 }
 
+GLuint SamplerState::getSamplerObject(ITexture* t) {
+  if (IGL_UNEXPECTED(t == nullptr) ||
+      !getContext().deviceFeatures().hasInternalFeature(InternalFeatures::SamplerObjects)) {
+    return 0;
+  }
+  // depth textures and external images rely on the per-texture fallbacks of bind()
+  if (t->getProperties().isDepthOrDepthStencil() || t->getType() == TextureType::ExternalImage) {
+    return 0;
+  }
+  if (samplerObject_ != 0) {
+    return samplerObject_;
+  }
+
+  auto& samplerObjects = getContext().getSamplerObjects();
+  auto it = samplerObjects.find(desc_);
+  if (it != samplerObjects.end()) {
+    samplerObject_ = it->second;
+    return samplerObject_;
+  }
+
+  getContext().genSamplers(1, &samplerObject_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_MIN_FILTER, minMipFilter_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_MAG_FILTER, magFilter_);
+  getContext().samplerParameterf(samplerObject_, GL_TEXTURE_MIN_LOD, mipLodMin_);
+  getContext().samplerParameterf(samplerObject_, GL_TEXTURE_MAX_LOD, mipLodMax_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_WRAP_S, addressU_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_WRAP_T, addressV_);
+  getContext().samplerParameteri(samplerObject_, GL_TEXTURE_WRAP_R, addressW_);
+  samplerObjects.emplace(desc_, samplerObject_);
+  return samplerObject_;
+}
+
 // utility functions for converting from IGL sampler state enums to GL enums
 GLint SamplerState::convertMinMipFilter(SamplerMinMagFilter minFilter, SamplerMipFilter mipFilter) {
   GLint glMinFilter;
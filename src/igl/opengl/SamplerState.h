@@ -20,6 +20,10 @@ class SamplerState final : public WithContext, public ISamplerState {
   SamplerState(IContext& context, const SamplerStateDesc& desc);
   void bind(ITexture* texture);
 
+  /// Returns a sampler object with this state to bind along with `texture`, or 0 if sampler objects
+  /// are not supported or the state has to be applied to the texture parameters with bind().
+  GLuint getSamplerObject(ITexture* texture);
+
   static GLint convertMinMipFilter(SamplerMinMagFilter minFilter, SamplerMipFilter mipFilter);
   static GLint convertMagFilter(SamplerMinMagFilter magFilter);
   static GLint convertAddressMode(SamplerAddressMode addressMode);
@@ -29,6 +33,7 @@ class SamplerState final : public WithContext, public ISamplerState {
   static SamplerMipFilter convertGLMipFilter(GLint minFilter);
 
  private:
+  SamplerStateDesc desc_;
   size_t hash_ = std::numeric_limits<size_t>::max();
   GLint minMipFilter_;
   GLint magFilter_;
@@ -42,6 +47,9 @@ class SamplerState final : public WithContext, public ISamplerState {
 
   GLint depthCompareFunction_;
   bool depthCompareEnabled_;
+
+  // shared with the other sampler states of the context that have the same desc
+  GLuint samplerObject_ = 0;
 };
 
 } // namespace opengl
@@ -12,6 +12,7 @@
 #include <igl/opengl/CommandBuffer.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/ProgramBinaryCache.h>
 #include <string>
 
 #if IGL_SHADER_DUMP
@@ -22,10 +23,25 @@
 namespace igl {
 namespace opengl {
 
+namespace {
+
+uint64_t getProgramBinaryKey(ShaderStagesType type, size_t hash0, size_t hash1 = 0) {
+  uint64_t key = static_cast<uint64_t>(type) + 1;
+  key = (key * 0x100000001b3ull) ^ hash0;
+  key = (key * 0x100000001b3ull) ^ hash1;
+  return key;
+}
+
+} // namespace
+
 ShaderStages::ShaderStages(const ShaderStagesDesc& desc, IContext& context) :
   IShaderStages(desc), WithContext(context), programID_(0) {}
 
 ShaderStages::~ShaderStages() {
+  if (pendingProgramID_ != 0) {
+    getContext().deleteProgram(pendingProgramID_);
+    pendingProgramID_ = 0;
+  }
   if (programID_ != 0) {
     getContext().deleteProgram(programID_);
     programID_ = 0;
@@ -67,6 +83,15 @@ void ShaderStages::createRenderProgram(Result* result) {
     return;
   }
 
+  ProgramBinaryCache* cache = getContext().getProgramBinaryCache();
+  const uint64_t cacheKey = getProgramBinaryKey(
+      ShaderStagesType::Render, vertexShader.getHash(), fragmentShader.getHash());
+  if (cache && cache->load(getContext(), cacheKey, programID)) {
+    setProgram(programID);
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+
   // attach the shaders and link them
   getContext().attachShader(programID, vertexShaderID);
   getContext().attachShader(programID, fragmentShaderID);
@@ -76,6 +101,18 @@ void ShaderStages::createRenderProgram(Result* result) {
   getContext().detachShader(programID, vertexShaderID);
   getContext().detachShader(programID, fragmentShaderID);
 
+  if (getContext().shouldCompileShadersAsync()) {
+    // querying the link status would wait for the driver; check it once linking is complete
+    pendingProgramID_ = programID;
+    pendingCacheKey_ = cacheKey;
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+
+  finishRenderProgram(programID, cacheKey, result);
+}
+
+void ShaderStages::finishRenderProgram(GLuint programID, uint64_t cacheKey, Result* result) {
   // check to see if the linking succeeded
   GLint status;
   getContext().getProgramiv(programID, GL_LINK_STATUS, &status);
@@ -89,7 +126,12 @@ void ShaderStages::createRenderProgram(Result* result) {
     getContext().getProgramInfoLog(programID, logSize, nullptr, log.data());
 
     // Create actual string from it
-    const std::string errorLog(log.begin(), log.end());
+    std::string errorLog(log.begin(), log.end());
+    if (getContext().shouldCompileShadersAsync()) {
+      // shader modules did not check their compile status
+      errorLog = static_cast<ShaderModule&>(*getVertexModule()).getCompileErrors() +
+                 static_cast<ShaderModule&>(*getFragmentModule()).getCompileErrors() + errorLog;
+    }
     IGL_LOG_ERROR("failed to link shaders:\n%s\n", errorLog.c_str());
 
     getContext().deleteProgram(programID);
@@ -97,15 +139,38 @@ void ShaderStages::createRenderProgram(Result* result) {
     return;
   }
 
-  // now that the program successfully linked, set the program
-  if (programID_ != 0) {
-    getContext().deleteProgram(programID_);
+  ProgramBinaryCache* cache = getContext().getProgramBinaryCache();
+  if (cache) {
+    cache->store(getContext(), cacheKey, programID);
   }
-  programID_ = programID;
+
+  setProgram(programID);
 
   Result::setResult(result, Result::Code::Ok);
 }
 
+bool ShaderStages::isReady() {
+  if (pendingProgramID_ == 0) {
+    return true;
+  }
+  GLint completed = GL_FALSE;
+  getContext().getProgramiv(pendingProgramID_, GL_COMPLETION_STATUS_KHR, &completed);
+  if (completed == GL_FALSE) {
+    return false;
+  }
+  waitUntilReady();
+  return true;
+}
+
+Result ShaderStages::waitUntilReady() {
+  if (pendingProgramID_ != 0) {
+    const GLuint programID = pendingProgramID_;
+    pendingProgramID_ = 0;
+    finishRenderProgram(programID, pendingCacheKey_, &pendingResult_);
+  }
+  return pendingResult_;
+}
+
 void ShaderStages::createComputeProgram(Result* result) {
   if (!IGL_VERIFY(getComputeModule())) {
     // we need a vertex shader and a fragment shader in order to link the program
@@ -132,6 +197,14 @@ void ShaderStages::createComputeProgram(Result* result) {
     return;
   }
 
+  ProgramBinaryCache* cache = getContext().getProgramBinaryCache();
+  const uint64_t cacheKey = getProgramBinaryKey(ShaderStagesType::Compute, shader.getHash());
+  if (cache && cache->load(getContext(), cacheKey, programID)) {
+    setProgram(programID);
+    Result::setResult(result, Result::Code::Ok);
+    return;
+  }
+
   // attach the shaders and link them
   getContext().attachShader(programID, shaderID);
   getContext().linkProgram(programID);
@@ -151,13 +224,22 @@ void ShaderStages::createComputeProgram(Result* result) {
     return;
   }
 
+  if (cache) {
+    cache->store(getContext(), cacheKey, programID);
+  }
+
+  setProgram(programID);
+
+  Result::setResult(result, Result::Code::Ok);
+}
+
+void ShaderStages::setProgram(GLuint programID) {
   // now that the program successfully linked, set the program
   if (programID_ != 0) {
     getContext().deleteProgram(programID_);
   }
   programID_ = programID;
-
-  Result::setResult(result, Result::Code::Ok);
+  uniformShadow_.clear();
 }
 
 // link the given shaders into this shader program
@@ -188,6 +270,9 @@ Result ShaderStages::validate() {
 }
 
 void ShaderStages::bind() {
+  if (pendingProgramID_ != 0) {
+    waitUntilReady();
+  }
   if (getContext().shouldValidateShaders()) {
     const auto result = validate();
     IGL_ASSERT_MSG(result.isOk(), result.message.c_str());
@@ -290,8 +375,12 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   getContext().compileShader(shaderID);
 
   // see if the compilation succeeded
-  GLint status;
-  getContext().getShaderiv(shaderID, GL_COMPILE_STATUS, &status);
+  // querying the status would wait for the driver, so in async mode errors are reported by
+  // ShaderStages when linking
+  GLint status = GL_TRUE;
+  if (!getContext().shouldCompileShadersAsync()) {
+    getContext().getShaderiv(shaderID, GL_COMPILE_STATUS, &status);
+  }
   if (status == GL_FALSE) {
     // Get the size of log
     GLsizei logSize = 0;
@@ -327,6 +416,20 @@ Result ShaderModule::create(const ShaderModuleDesc& desc) {
   return Result();
 }
 
+std::string ShaderModule::getCompileErrors() const {
+  GLint status = GL_FALSE;
+  getContext().getShaderiv(shaderID_, GL_COMPILE_STATUS, &status);
+  if (status == GL_TRUE) {
+    return {};
+  }
+
+  GLsizei logSize = 0;
+  getContext().getShaderiv(shaderID_, GL_INFO_LOG_LENGTH, &logSize);
+  std::vector<GLchar> log(logSize);
+  getContext().getShaderInfoLog(shaderID_, logSize, nullptr, log.data());
+  return std::string(log.begin(), log.end());
+}
+
 std::string ShaderStages::getProgramInfoLog(GLuint programID) {
   // Get the size of log
   GLsizei logSize = 0;
@@ -14,6 +14,7 @@
 #include <igl/Shader.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
+#include <igl/opengl/UniformAdapter.h>
 #include <unordered_map>
 
 namespace igl {
@@ -39,6 +40,9 @@ class ShaderModule : public WithContext, public IShaderModule {
     return hash_;
   }
 
+  /// Returns the compile log if compiling this shader failed. Waits for the driver to finish.
+  std::string getCompileErrors() const;
+
   ShaderModule(IContext& context, ShaderModuleInfo info);
 
  private:
@@ -65,17 +69,38 @@ class ShaderStages final : public IShaderStages, public WithContext {
   void bind();
   void unbind();
 
+  /// Returns false while the driver is still linking the render program in the background; see
+  /// IContext::setShouldCompileShadersAsync(). Link errors are logged once linking is complete.
+  bool isReady();
+  /// Waits for a pending link to complete and returns its result.
+  Result waitUntilReady();
+
   GLuint getProgramID() const {
-    return programID_;
+    return pendingProgramID_ != 0 ? pendingProgramID_ : programID_;
+  }
+
+  /// Values last uploaded to the uniforms of the program; see
+  /// IContext::setShouldSkipRedundantUniforms().
+  UniformShadow& getUniformShadow() {
+    return uniformShadow_;
   }
 
  private:
   void createRenderProgram(Result* result);
+  void finishRenderProgram(GLuint programID, uint64_t cacheKey, Result* result);
   void createComputeProgram(Result* result);
+  void setProgram(GLuint programID);
   std::string getProgramInfoLog(GLuint programID);
 
   // the GL shader program ID
   GLuint programID_;
+
+  // the program that is still being linked in async mode
+  GLuint pendingProgramID_ = 0;
+  uint64_t pendingCacheKey_ = 0;
+  Result pendingResult_;
+
+  UniformShadow uniformShadow_;
 };
 
 } // namespace opengl
@@ -130,6 +130,10 @@ bool Texture::isImplicitStorage() const {
   return false;
 }
 
+bool Texture::hasTextureObject() const {
+  return false;
+}
+
 GLenum Texture::toGLTarget(TextureType type) const {
   switch (type) {
   case TextureType::TwoD:
@@ -60,6 +60,9 @@ class Texture : public WithContext, public ITexture {
 
   virtual bool isImplicitStorage() const;
 
+  /// Returns true if getId() names a GL texture object, which can be bound with glBindTextures().
+  [[nodiscard]] virtual bool hasTextureObject() const;
+
   [[nodiscard]] GLenum toGLTarget(TextureType type) const;
   static TextureFormat glInternalFormatToTextureFormat(GLuint glTexInternalFormat,
                                                        GLuint glTexFormat,
@@ -9,6 +9,7 @@
 
 #include <array>
 #include <igl/opengl/Errors.h>
+#include <igl/opengl/PixelBuffer.h>
 #include <utility>
 
 namespace igl {
@@ -23,6 +24,8 @@ constexpr std::array<GLenum, 6> kCubeFaceTargets = {GL_TEXTURE_CUBE_MAP_POSITIVE
                                                     GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
                                                     GL_TEXTURE_CUBE_MAP_POSITIVE_Z,
                                                     GL_TEXTURE_CUBE_MAP_NEGATIVE_Z};
+// smaller uploads are cheaper to hand to glTexSubImage* directly than to stage in a buffer
+constexpr size_t kMinPixelUnpackBufferUploadBytes = 64 * 1024;
 void swapTextureChannelsForFormat(igl::opengl::IContext& context,
                                   GLuint target,
                                   igl::TextureFormat iglFormat) {
@@ -430,7 +433,26 @@ Result TextureBuffer::uploadInternal(TextureType /*type*/,
   }
   getContext().bindTexture(target, getId());
 
-  auto result = uploadInternal(target, range, data, bytesPerRow);
+  // GL reads the last row without its padding
+  const size_t numBytes =
+      getProperties().getBytesPerRange(range, bytesPerRow) -
+      (bytesPerRow == 0 ? 0 : bytesPerRow - getProperties().getBytesPerRow(range));
+  PixelUnpackBufferRing* ring =
+      !getProperties().isCompressed() && numBytes >= kMinPixelUnpackBufferUploadBytes
+          ? getContext().getPixelUnpackBufferRing()
+          : nullptr;
+  size_t offset = 0;
+  Result result;
+  if (ring != nullptr && ring->write(data, numBytes, offset)) {
+    result = uploadInternal(target,
+                            range,
+                            reinterpret_cast<const void*>(offset),
+                            bytesPerRow,
+                            /* fromPixelBuffer */ true);
+    ring->unbind();
+  } else {
+    result = uploadInternal(target, range, data, bytesPerRow);
+  }
 
   getContext().bindTexture(getTarget(), 0);
   return result;
@@ -439,7 +461,8 @@ Result TextureBuffer::uploadInternal(TextureType /*type*/,
 Result TextureBuffer::uploadInternal(GLenum target,
                                      const TextureRangeDesc& range,
                                      const void* IGL_NULLABLE data,
-                                     size_t bytesPerRow) const {
+                                     size_t bytesPerRow,
+                                     bool fromPixelBuffer) const {
   // Use TexImage when range covers full texture AND texture was not initialized with TexStorage
   const auto texImage = isValidForTexImage(range) && !supportsTexStorage();
 
@@ -465,8 +488,15 @@ Result TextureBuffer::uploadInternal(GLenum target,
     const auto mipRange = range.atMipLevel(mipLevel);
     for (auto face = range.face; face < range.face + range.numFaces; ++face) {
       const auto faceRange = mipRange.atFace(face);
-      const auto* faceData =
-          data == nullptr ? nullptr : getSubRangeStart(data, range, faceRange, bytesPerRow);
+      const void* faceData = nullptr;
+      if (fromPixelBuffer) {
+        // data is an offset into GL_PIXEL_UNPACK_BUFFER and may be 0
+        faceData = reinterpret_cast<const void*>(
+            reinterpret_cast<uintptr_t>(data) +
+            getProperties().getSubRangeByteOffset(range, faceRange, bytesPerRow));
+      } else if (data != nullptr) {
+        faceData = getSubRangeStart(data, range, faceRange, bytesPerRow);
+      }
       switch (type_) {
       case TextureType::TwoD:
         result = upload2D(target, faceRange, texImage, faceData);
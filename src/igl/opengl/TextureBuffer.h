@@ -33,10 +33,12 @@ class TextureBuffer : public TextureBufferBase {
                         const TextureRangeDesc& range,
                         const void* IGL_NULLABLE data,
                         size_t bytesPerRow) const override;
+  // If fromPixelBuffer is true, data is an offset into the bound GL_PIXEL_UNPACK_BUFFER.
   Result uploadInternal(GLenum target,
                         const TextureRangeDesc& range,
                         const void* IGL_NULLABLE data,
-                        size_t bytesPerRow = 0) const;
+                        size_t bytesPerRow = 0,
+                        bool fromPixelBuffer = false) const;
   Result upload2D(GLenum target,
                   const TextureRangeDesc& range,
                   bool texImage,
@@ -40,6 +40,10 @@ class TextureBufferBase : public Texture {
     return textureID_;
   }
 
+  [[nodiscard]] bool hasTextureObject() const override {
+    return true;
+  }
+
   GLuint getTarget() const {
     return target_;
   }
@@ -9,9 +9,141 @@
 #include <igl/opengl/UniformAdapter.h>
 #include <igl/opengl/UniformBuffer.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace igl {
 namespace opengl {
 
+bool UniformShadow::update(int location, const uint8_t* data, size_t length) {
+  IGL_ASSERT(length > 0);
+  if (!IGL_VERIFY(location >= 0)) {
+    // nothing is known about invalid locations, so never skip them
+    return true;
+  }
+  if (static_cast<size_t>(location) >= entries_.size()) {
+    entries_.resize(static_cast<size_t>(location) + 1);
+  }
+  Entry& entry = entries_[location];
+  if (entry.length == length && memcmp(values_.data() + entry.offset, data, length) == 0) {
+    return false;
+  }
+  if (entry.capacity < length) {
+    entry.offset = static_cast<uint32_t>(values_.size());
+    entry.capacity = static_cast<uint32_t>(length);
+    values_.resize(values_.size() + length);
+  }
+  entry.length = static_cast<uint32_t>(length);
+  memcpy(values_.data() + entry.offset, data, length);
+  return true;
+}
+
+void UniformShadow::invalidate(int location, size_t count) {
+  if (!IGL_VERIFY(location >= 0)) {
+    return;
+  }
+  const size_t end = std::min(static_cast<size_t>(location) + count, entries_.size());
+  for (size_t i = location; i < end; i++) {
+    entries_[i].length = 0;
+  }
+}
+
+void UniformShadow::clear() {
+  entries_.clear();
+  values_.clear();
+}
+
+PackedUniformBlock::PackedUniformBlock(IContext& context,
+                                       size_t size,
+                                       int firstLocation,
+                                       GLuint bindingIndex) :
+  firstLocation_(firstLocation),
+  data_(size),
+  buffer_(std::make_unique<UniformBlockBuffer>(
+      context,
+      BufferDesc::BufferAPIHintBits::UniformBlock | BufferDesc::BufferAPIHintBits::Ring,
+      BufferDesc::BufferTypeBits::Uniform)),
+  bindingIndex_(bindingIndex) {
+  Result result;
+  buffer_->initialize(BufferDesc(BufferDesc::BufferTypeBits::Uniform,
+                                 nullptr,
+                                 size,
+                                 ResourceStorage::Shared,
+                                 BufferDesc::BufferAPIHintBits::UniformBlock |
+                                     BufferDesc::BufferAPIHintBits::Ring,
+                                 "PackedUniformBlock"),
+                      &result);
+  IGL_ASSERT_MSG(result.isOk(), result.message.c_str());
+}
+
+PackedUniformBlock::~PackedUniformBlock() = default;
+
+void PackedUniformBlock::addMember(int location,
+                                   size_t offset,
+                                   size_t count,
+                                   size_t arrayStride,
+                                   size_t matrixStride) {
+  IGL_ASSERT(location >= firstLocation_ && count > 0);
+  const size_t index = static_cast<size_t>(location - firstLocation_);
+  if (index >= members_.size()) {
+    members_.resize(index + 1);
+  }
+  members_[index] = {offset, count, arrayStride, matrixStride};
+}
+
+bool PackedUniformBlock::write(const UniformDesc& uniformDesc, const uint8_t* data) {
+  const int index = uniformDesc.location - firstLocation_;
+  if (index < 0 || static_cast<size_t>(index) >= members_.size() || members_[index].count == 0) {
+    return false;
+  }
+  const Member& member = members_[index];
+
+  size_t columns = 1;
+  switch (uniformDesc.type) {
+  case UniformType::Mat2x2:
+    columns = 2;
+    break;
+  case UniformType::Mat3x3:
+    columns = 3;
+    break;
+  case UniformType::Mat4x4:
+    columns = 4;
+    break;
+  default:
+    break;
+  }
+
+  const size_t size = igl::sizeForUniformType(uniformDesc.type);
+  const size_t stride = uniformDesc.elementStride != 0 ? uniformDesc.elementStride : size;
+  const size_t count = std::min(uniformDesc.numElements, member.count);
+  for (size_t i = 0; i < count; i++) {
+    const uint8_t* src = data + i * stride;
+    uint8_t* dst = data_.data() + member.offset + i * member.arrayStride;
+    if (uniformDesc.type == UniformType::Boolean) {
+      // std140 booleans take 4 bytes
+      const GLint value = *src ? 1 : 0;
+      memcpy(dst, &value, sizeof(value));
+    } else if (columns > 1) {
+      // std140 matrix columns are matrixStride apart, e.g. 16 bytes for the columns of a mat3
+      for (size_t c = 0; c < columns; c++) {
+        memcpy(dst + c * member.matrixStride, src + c * (stride / columns), size / columns);
+      }
+    } else {
+      memcpy(dst, src, size);
+    }
+  }
+  dirty_ = true;
+  return true;
+}
+
+void PackedUniformBlock::bind() {
+  if (dirty_) {
+    buffer_->upload(data_.data(), BufferRange(data_.size(), 0));
+    dirty_ = false;
+  }
+  buffer_->bindBase(bindingIndex_, nullptr);
+}
+
 UniformAdapter::UniformAdapter(const IContext& context, PipelineType type) : pipelineType_(type) {
   const auto& deviceFeatures = context.deviceFeatures();
   maxUniforms_ = deviceFeatures.getMaxComputeUniforms();
@@ -48,13 +180,17 @@ void UniformAdapter::shrinkUniformUsage() {
 }
 
 void UniformAdapter::clearUniformBuffers() {
+#if IGL_DEBUG
+  // only the locations in uniforms_ can be dirty
+  for (const auto& uniform : uniforms_) {
+    uniformsDirty_[uniform.desc.location] = false;
+  }
+#endif
+
   usedUniformDataBytes_ = 0;
   uniforms_.clear();
   uniformBuffersDirtyMask_ = 0;
-
-#if IGL_DEBUG
-  std::fill(uniformsDirty_.begin(), uniformsDirty_.end(), false);
-#endif
+  ringUniformBuffersMask_ = 0;
 }
 
 void UniformAdapter::setUniform(const UniformDesc& uniformDesc,
@@ -138,19 +274,46 @@ void UniformAdapter::setUniformBuffer(const std::shared_ptr<IBuffer>& buffer,
   if (bindingIndex >= 0 && bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX && buffer) {
     uniformBufferBindingMap_[bindingIndex] = {buffer, offset};
     uniformBuffersDirtyMask_ |= 1 << bindingIndex;
+    uniformBufferIds_[bindingIndex] = static_cast<ArrayBuffer&>(*buffer).getId();
+    if (buffer->acceptedApiHints() & BufferDesc::BufferAPIHintBits::Ring) {
+      ringUniformBuffersMask_ |= 1 << bindingIndex;
+    } else {
+      ringUniformBuffersMask_ &= ~(1 << bindingIndex);
+    }
     Result::setOk(outResult);
   } else {
     Result::setResult(outResult, Result::Code::ArgumentInvalid);
   }
 }
 
-void UniformAdapter::bindToPipeline(IContext& context) {
+void UniformAdapter::bindToPipeline(IContext& context,
+                                    UniformShadow* shadow,
+                                    PackedUniformBlock* packedBlock) {
   // bind uniforms
   for (const auto& uniform : uniforms_) {
     const auto& uniformDesc = uniform.desc;
     IGL_ASSERT(uniformDesc.location >= 0);
     IGL_ASSERT_MSG(uniformData_.data(), "Uniform data must be non-null");
     auto start = uniformData_.data() + uniform.dataOffset;
+#if IGL_DEBUG
+    uniformsDirty_[uniformDesc.location] = false;
+#endif
+    if (packedBlock != nullptr && packedBlock->write(uniformDesc, start)) {
+      continue;
+    }
+    if (shadow != nullptr) {
+      if (uniformDesc.numElements != 1) {
+        // arrays are not shadowed, but they overwrite the values of the locations they span
+        shadow->invalidate(uniformDesc.location, uniformDesc.numElements);
+      } else {
+        const size_t length = uniformDesc.elementStride != 0
+                                  ? uniformDesc.elementStride
+                                  : igl::sizeForUniformType(uniformDesc.type);
+        if (!shadow->update(uniformDesc.location, start, length)) {
+          continue;
+        }
+      }
+    }
     if (uniformDesc.numElements > 1 || uniformDesc.type == UniformType::Mat3x3) {
       IGL_ASSERT_MSG(uniformDesc.elementStride > 0,
                      "stride has to be larger than 0 for uniform at offset %zu",
@@ -166,9 +329,24 @@ void UniformAdapter::bindToPipeline(IContext& context) {
     }
   }
   uniforms_.clear();
-#if IGL_DEBUG
-  std::fill(uniformsDirty_.begin(), uniformsDirty_.end(), false);
-#endif
+
+  if (packedBlock != nullptr) {
+    packedBlock->bind();
+  }
+
+  if (ringUniformBuffersMask_ != 0) {
+    // uploads move ring buffers to another GL buffer, which has to be bound again
+    for (size_t bindingIndex = 0; bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX; ++bindingIndex) {
+      if (ringUniformBuffersMask_ & (1 << bindingIndex)) {
+        const auto& buffer = uniformBufferBindingMap_.at(bindingIndex).first;
+        const GLuint id = static_cast<ArrayBuffer&>(*buffer).getId();
+        if (uniformBufferIds_[bindingIndex] != id) {
+          uniformBufferIds_[bindingIndex] = id;
+          uniformBuffersDirtyMask_ |= 1 << bindingIndex;
+        }
+      }
+    }
+  }
 
   // bind uniform block buffers
   for (size_t bindingIndex = 0; bindingIndex < IGL_UNIFORM_BLOCKS_BINDING_MAX; ++bindingIndex) {
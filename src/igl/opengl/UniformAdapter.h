@@ -9,14 +9,84 @@
 
 #include <igl/Buffer.h>
 #include <igl/Uniform.h>
+#include <igl/opengl/GLIncludes.h>
 
 #include <array>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
 namespace igl {
 namespace opengl {
 class IContext;
+class UniformBlockBuffer;
+
+/// Values last uploaded to the default uniform block of one program. Uniform values are program
+/// state, so a glUniform* call that would upload the value the program already holds can be
+/// skipped; see IContext::setShouldSkipRedundantUniforms().
+class UniformShadow {
+ public:
+  /// Returns false if `location` already holds `data`. Otherwise records `data` and returns true.
+  bool update(int location, const uint8_t* data, size_t length);
+  /// Forgets `count` consecutive locations starting at `location`.
+  void invalidate(int location, size_t count);
+  void clear();
+
+ private:
+  struct Entry {
+    uint32_t offset = 0;
+    uint32_t length = 0; // 0 if the value is unknown
+    uint32_t capacity = 0;
+  };
+  std::vector<Entry> entries_; // indexed by location
+  std::vector<uint8_t> values_;
+};
+
+/// std140 copy of the uniforms that the shaders of a render pipeline declare in the uniform block
+/// named RenderPipelineReflection::kPackedUniformBlockName. Clients set them like loose uniforms,
+/// at the locations returned by getIndexByName(); UniformAdapter writes them here instead of
+/// calling glUniform*, and bind() uploads the whole block with one buffer write per draw. Values
+/// persist across draws like those of the default uniform block, but per pipeline, not per program.
+class PackedUniformBlock {
+ public:
+  /// `size` is the GL_UNIFORM_BLOCK_DATA_SIZE of the block, which the pipeline binds at
+  /// `bindingIndex`. The locations of its members start at `firstLocation`.
+  PackedUniformBlock(IContext& context, size_t size, int firstLocation, GLuint bindingIndex);
+  ~PackedUniformBlock();
+
+  /// Places the member at `offset` of the block at `location`. The strides are the
+  /// GL_UNIFORM_ARRAY_STRIDE and GL_UNIFORM_MATRIX_STRIDE of the member.
+  void addMember(int location,
+                 size_t offset,
+                 size_t count,
+                 size_t arrayStride,
+                 size_t matrixStride);
+
+  /// Copies the uniform into the block with std140 layout. Returns false if its location is not a
+  /// member of the block.
+  bool write(const UniformDesc& uniformDesc, const uint8_t* data);
+
+  /// Uploads the block if it changed since the last call, and binds it.
+  void bind();
+
+  [[nodiscard]] GLuint getBindingIndex() const {
+    return bindingIndex_;
+  }
+
+ private:
+  struct Member {
+    size_t offset = 0;
+    size_t count = 0; // 0 if no member is at this location
+    size_t arrayStride = 0;
+    size_t matrixStride = 0;
+  };
+  std::vector<Member> members_; // indexed by location - firstLocation_
+  int firstLocation_ = 0;
+  std::vector<uint8_t> data_;
+  std::unique_ptr<UniformBlockBuffer> buffer_;
+  GLuint bindingIndex_ = 0;
+  bool dirty_ = true;
+};
 
 class UniformAdapter {
  public:
@@ -39,7 +109,12 @@ class UniformAdapter {
     return maxUniforms_;
   }
 
-  void bindToPipeline(IContext& context);
+  /// Uploads the uniforms set since the last call to the bound program. If `shadow` is not null,
+  /// single uniforms whose values it already holds are skipped. Uniforms at the locations of
+  /// `packedBlock` members are written to it instead, and it is bound.
+  void bindToPipeline(IContext& context,
+                      UniformShadow* shadow = nullptr,
+                      PackedUniformBlock* packedBlock = nullptr);
 
  private:
   struct UniformState {
@@ -59,6 +134,9 @@ class UniformAdapter {
   uint32_t uniformBuffersDirtyMask_ = 0;
   static_assert(sizeof(uniformBuffersDirtyMask_) * 8 >= IGL_UNIFORM_BLOCKS_BINDING_MAX,
                 "uniformBuffersDirtyMask size is not enough to fit the flags");
+  // GL names of the bound buffers, which uploads to ring buffers change
+  std::array<GLuint, IGL_UNIFORM_BLOCKS_BINDING_MAX> uniformBufferIds_{};
+  uint32_t ringUniformBuffersMask_ = 0;
 
   // Store a copy of uniform data when setUniform is used to avoid the client from managing the
   // memory
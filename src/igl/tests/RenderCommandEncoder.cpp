@@ -22,6 +22,9 @@
 #include <igl/IGL.h>
 #include <igl/NameHandle.h>
 #include <igl/RenderPipelineState.h>
+#if IGL_BACKEND_OPENGL
+#include <igl/opengl/DeviceFeatureSet.h>
+#endif
 
 #define OFFSCREEN_RT_WIDTH 4
 #define OFFSCREEN_RT_HEIGHT 4
@@ -459,6 +462,64 @@ TEST_F(RenderCommandEncoderTest, shouldDrawTriangleStrip) {
   });
 }
 
+TEST_F(RenderCommandEncoderTest, shouldMultiDrawIndexedIndirect) {
+  if (!iglDev_->hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    GTEST_SKIP() << "Indirect draws are not supported";
+  }
+#if IGL_BACKEND_OPENGL
+  if (backend_ == util::BACKEND_OGL && opengl::DeviceFeatureSet::usesOpenGLES()) {
+    // OpenGL ES only draws indirectly from a vertex array object, which IGL does not use on ES
+    GTEST_SKIP() << "Indirect draws require vertex array objects";
+  }
+#endif
+
+  initializeBuffers(
+      // clang-format off
+      {
+        -1.0f,  1.0f, 0.0f, 1.0f,
+        -1.0f, -1.0f, 0.0f, 1.0f,
+         1.0f,  1.0f, 0.0f, 1.0f,
+         1.0f, -1.0f, 0.0f, 1.0f,
+      },
+      {
+        0.0, 1.0,
+        0.0, 0.0,
+        1.0, 1.0,
+        1.0, 0.0,
+      } // clang-format on
+  );
+
+  // one triangle per draw, the two of them cover the whole framebuffer
+  const uint32_t indices[] = {0, 1, 2, 2, 1, 3};
+  // indexCount, instanceCount, firstIndex, baseVertex, baseInstance
+  const uint32_t commands[] = {
+      3, 1, 0, 0, 0, //
+      3, 1, 3, 0, 0, //
+  };
+
+  Result ret;
+  auto ib = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Index, indices, sizeof(indices)), &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto indirectBuffer = iglDev_->createBuffer(
+      BufferDesc(BufferDesc::BufferTypeBits::Storage | BufferDesc::BufferTypeBits::Indirect,
+                 commands,
+                 sizeof(commands)),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  encodeAndSubmit([&](const std::unique_ptr<igl::IRenderCommandEncoder>& encoder) {
+    encoder->multiDrawIndexedIndirect(
+        PrimitiveType::Triangle, IndexFormat::UInt32, *ib, *indirectBuffer, 0, 2, 0);
+  });
+
+  verifyFrameBuffer([](const std::vector<uint32_t>& pixels) {
+    for (auto& pixel : pixels) {
+      ASSERT_EQ(pixel, data::texture::TEX_RGBA_GRAY_4x4[0]);
+    }
+  });
+}
+
 TEST_F(RenderCommandEncoderTest, shouldNotDraw) {
   initializeBuffers(
       // clang-format off
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <igl/Common.h>
+#include <igl/Texture.h>
+#include <vector>
+
+namespace igl::tests {
+
+namespace {
+
+std::vector<uint8_t> makePattern(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>((i * 7 + i / 251) & 0xFF);
+  }
+  return data;
+}
+
+} // namespace
+
+//
+// Test ITexture::repackData with RepackConversion::SwapRedBlue
+//
+TEST(TextureRepackTest, SwapRedBlue) {
+  constexpr size_t kWidth = 37;
+  constexpr size_t kHeight = 3;
+  constexpr size_t kSrcBytesPerRow = kWidth * 4 + 8;
+  const auto properties = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8);
+  const auto range = TextureRangeDesc::new2D(0, 0, kWidth, kHeight);
+
+  const auto src = makePattern(kSrcBytesPerRow * kHeight);
+  std::vector<uint8_t> dst(kWidth * kHeight * 4);
+  ITexture::repackData(properties,
+                       range,
+                       src.data(),
+                       kSrcBytesPerRow,
+                       dst.data(),
+                       0,
+                       false,
+                       ITexture::RepackConversion::SwapRedBlue);
+
+  for (size_t y = 0; y < kHeight; ++y) {
+    for (size_t x = 0; x < kWidth; ++x) {
+      const uint8_t* s = src.data() + y * kSrcBytesPerRow + x * 4;
+      const uint8_t* d = dst.data() + (y * kWidth + x) * 4;
+      ASSERT_EQ(d[0], s[2]);
+      ASSERT_EQ(d[1], s[1]);
+      ASSERT_EQ(d[2], s[0]);
+      ASSERT_EQ(d[3], s[3]);
+    }
+  }
+}
+
+//
+// Test ITexture::repackData with RepackConversion::RGBToRGBA and a vertical flip
+//
+TEST(TextureRepackTest, RGBToRGBAFlipped) {
+  constexpr size_t kWidth = 29;
+  constexpr size_t kHeight = 4;
+  constexpr size_t kDstBytesPerRow = kWidth * 4 + 12;
+  const auto properties = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8);
+  const auto range = TextureRangeDesc::new2D(0, 0, kWidth, kHeight);
+
+  const auto src = makePattern(kWidth * kHeight * 3);
+  std::vector<uint8_t> dst(kDstBytesPerRow * kHeight);
+  ITexture::repackData(properties,
+                       range,
+                       src.data(),
+                       0,
+                       dst.data(),
+                       kDstBytesPerRow,
+                       true,
+                       ITexture::RepackConversion::RGBToRGBA);
+
+  for (size_t y = 0; y < kHeight; ++y) {
+    for (size_t x = 0; x < kWidth; ++x) {
+      const uint8_t* s = src.data() + ((kHeight - 1 - y) * kWidth + x) * 3;
+      const uint8_t* d = dst.data() + y * kDstBytesPerRow + x * 4;
+      ASSERT_EQ(d[0], s[0]);
+      ASSERT_EQ(d[1], s[1]);
+      ASSERT_EQ(d[2], s[2]);
+      ASSERT_EQ(d[3], 0xFF);
+    }
+  }
+}
+
+//
+// Large ranges take the non-temporal copy path; make sure the result is unchanged
+//
+TEST(TextureRepackTest, LargeRoundTrip) {
+  constexpr size_t kWidth = 1023;
+  constexpr size_t kHeight = 300;
+  constexpr size_t kPaddedBytesPerRow = kWidth * 4 + 36;
+  const auto properties = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8);
+  const auto range = TextureRangeDesc::new2D(0, 0, kWidth, kHeight);
+
+  const auto packed = makePattern(kWidth * kHeight * 4);
+  std::vector<uint8_t> padded(kPaddedBytesPerRow * kHeight);
+  std::vector<uint8_t> repacked(packed.size());
+
+  ITexture::repackData(properties, range, packed.data(), 0, padded.data(), kPaddedBytesPerRow);
+  ITexture::repackData(properties, range, padded.data(), kPaddedBytesPerRow, repacked.data(), 0);
+  EXPECT_EQ(packed, repacked);
+
+  // Tightly packed on both sides is a single contiguous copy
+  std::fill(repacked.begin(), repacked.end(), 0);
+  ITexture::repackData(properties, range, packed.data(), 0, repacked.data(), 0);
+  EXPECT_EQ(packed, repacked);
+}
+
+//
+// Throughput of ITexture::repackData for the range shapes used by the texture tests.
+// Run with --gtest_also_run_disabled_tests.
+//
+TEST(TextureRepackTest, DISABLED_Benchmark) {
+  struct Shape {
+    const char* name;
+    TextureRangeDesc range;
+  };
+  const Shape shapes[] = {
+      {"2D 3x2", TextureRangeDesc::new2D(0, 0, 3, 2)},
+      {"2D 1024x1024", TextureRangeDesc::new2D(0, 0, 1024, 1024)},
+      {"2DArray 256x256x6", TextureRangeDesc::new2DArray(0, 0, 256, 256, 0, 6)},
+      {"Cube 512x512", TextureRangeDesc::newCube(0, 0, 512, 512)},
+      {"3D 64x64x64", TextureRangeDesc::new3D(0, 0, 0, 64, 64, 64)},
+  };
+  const auto properties = TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8);
+
+  for (const auto& shape : shapes) {
+    const size_t packedBytesPerRow = properties.getBytesPerRow(shape.range);
+    const size_t paddedBytesPerRow = packedBytesPerRow + 64;
+    const size_t numRows = shape.range.height * shape.range.depth * shape.range.numLayers *
+                           shape.range.numFaces;
+    const auto src = makePattern(paddedBytesPerRow * numRows);
+    std::vector<uint8_t> dst(packedBytesPerRow * numRows);
+
+    const size_t iterations = std::max<size_t>(1, (256u << 20) / dst.size());
+    for (const auto conversion : {ITexture::RepackConversion::None,
+                                  ITexture::RepackConversion::SwapRedBlue}) {
+      const auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        ITexture::repackData(properties,
+                             shape.range,
+                             src.data(),
+                             paddedBytesPerRow,
+                             dst.data(),
+                             0,
+                             false,
+                             conversion);
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      IGL_LOG_INFO("repackData %-18s %-11s %8.1f MB/s\n",
+                   shape.name,
+                   conversion == ITexture::RepackConversion::None ? "copy" : "swapRedBlue",
+                   static_cast<double>(dst.size() * iterations) / (1024.0 * 1024.0) /
+                       elapsed.count());
+    }
+  }
+}
+
+} // namespace igl::tests
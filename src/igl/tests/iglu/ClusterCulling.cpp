@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+
+#include <IGLU/cluster_culling/ClusterCuller.h>
+#include <IGLU/mesh_cache/MeshBuilder.h>
+#include <IGLU/mesh_cache/MeshCacheReader.h>
+#include <IGLU/mesh_cache/MeshCacheWriter.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl::tests {
+
+namespace {
+
+using namespace iglu::clusterculling;
+using namespace iglu::meshcache;
+
+// Orthographic projection of the [-1, 1] cube looking down -z, OpenGL depth range
+constexpr float kOrtho[16] = {
+    1, 0, 0, 0, //
+    0, 1, 0, 0, //
+    0, 0, -1, 0, //
+    0, 0, 0, 1, //
+};
+
+MeshletBounds makeBounds(float x, float y, float z, float radius) {
+  MeshletBounds bounds;
+  bounds.center[0] = x;
+  bounds.center[1] = y;
+  bounds.center[2] = z;
+  bounds.radius = radius;
+  return bounds;
+}
+
+} // namespace
+
+TEST(ClusterCullingTest, ExtractFrustumPlanes) {
+  float planes[6][4];
+  extractFrustumPlanes(kOrtho, false, planes);
+  // every plane is 1 unit away from the origin and points inwards
+  for (const auto& plane : planes) {
+    EXPECT_FLOAT_EQ(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2], 1.0f);
+    EXPECT_FLOAT_EQ(plane[3], 1.0f);
+  }
+  EXPECT_FLOAT_EQ(planes[0][0], 1.0f); // left
+  EXPECT_FLOAT_EQ(planes[1][0], -1.0f); // right
+  EXPECT_FLOAT_EQ(planes[4][2], -1.0f); // near
+
+  // with a [0, 1] depth range, the near plane passes through the origin
+  extractFrustumPlanes(kOrtho, true, planes);
+  EXPECT_FLOAT_EQ(planes[4][2], -1.0f);
+  EXPECT_FLOAT_EQ(planes[4][3], 0.0f);
+}
+
+TEST(ClusterCullingTest, FrustumCulling) {
+  CullingParams params;
+  params.coneCulling = 0;
+  extractFrustumPlanes(kOrtho, false, params.frustumPlanes);
+
+  EXPECT_TRUE(isClusterVisible(makeBounds(0, 0, 0, 0.1f), params));
+  EXPECT_TRUE(isClusterVisible(makeBounds(1.05f, 0, 0, 0.1f), params)); // intersects
+  EXPECT_FALSE(isClusterVisible(makeBounds(1.2f, 0, 0, 0.1f), params));
+  EXPECT_FALSE(isClusterVisible(makeBounds(0, -1.2f, 0, 0.1f), params));
+  EXPECT_FALSE(isClusterVisible(makeBounds(0, 0, 1.2f, 0.1f), params));
+}
+
+TEST(ClusterCullingTest, ConeCulling) {
+  CullingParams params;
+  extractFrustumPlanes(kOrtho, false, params.frustumPlanes);
+  params.cameraPosition[2] = 5.0f;
+
+  // all triangles face +z, towards the camera
+  MeshletBounds bounds = makeBounds(0, 0, 0, 0.5f);
+  bounds.coneAxis[2] = 1.0f;
+  bounds.coneCutoff = 0.5f;
+  EXPECT_TRUE(isClusterVisible(bounds, params));
+
+  // all triangles face -z, away from the camera
+  bounds.coneAxis[2] = -1.0f;
+  EXPECT_FALSE(isClusterVisible(bounds, params));
+  params.coneCulling = 0;
+  EXPECT_TRUE(isClusterVisible(bounds, params));
+
+  // degenerate cone is never culled
+  params.coneCulling = 1;
+  bounds.coneCutoff = 1.0f;
+  bounds.coneAxis[2] = 0.0f;
+  EXPECT_TRUE(isClusterVisible(bounds, params));
+}
+
+TEST(ClusterCullingTest, CreateFromMeshCache) {
+  std::shared_ptr<IDevice> device;
+  std::shared_ptr<ICommandQueue> queue;
+  util::createDeviceAndQueue(device, queue);
+  ASSERT_TRUE(device);
+  if (!device->hasFeature(DeviceFeatures::Compute) ||
+      !device->hasFeature(DeviceFeatures::DrawIndexedIndirect)) {
+    GTEST_SKIP() << "Compute and indirect draws are not supported";
+  }
+
+  // 8x8 grid of quads in the z = 0 plane
+  std::vector<float> positions;
+  std::vector<uint32_t> indices;
+  for (uint32_t y = 0; y <= 8; y++) {
+    for (uint32_t x = 0; x <= 8; x++) {
+      positions.insert(positions.end(), {float(x), float(y), 0.0f});
+    }
+  }
+  for (uint32_t y = 0; y < 8; y++) {
+    for (uint32_t x = 0; x < 8; x++) {
+      const uint32_t i = y * 9 + x;
+      indices.insert(indices.end(), {i, i + 1, i + 10, i, i + 10, i + 9});
+    }
+  }
+  MeshDesc desc;
+  desc.vertices = positions.data();
+  desc.numVertices = positions.size() / 3;
+  desc.vertexSize = 3 * sizeof(float);
+  desc.indices = indices.data();
+  desc.numIndices = indices.size();
+  MeshBuildOptions options;
+  options.buildMeshlets = true;
+  options.maxMeshletVertices = 16;
+  options.maxMeshletTriangles = 16;
+
+  MeshCacheWriter writer;
+  Result result;
+  ASSERT_TRUE(buildMeshCache(desc, options, writer, &result)) << result.message;
+  const std::vector<uint8_t> file = writer.serialize();
+  auto reader = MeshCacheReader::tryCreate(file.data(), file.size(), &result);
+  ASSERT_TRUE(reader) << result.message;
+
+  size_t numMeshlets = 0;
+  ASSERT_TRUE(reader->getChunk<Meshlet>(ChunkId::Meshlets, numMeshlets, &result));
+  auto culler = ClusterCuller::create(*device, *reader, &result);
+  ASSERT_TRUE(culler) << result.message;
+  EXPECT_EQ(culler->getNumClusters(), numMeshlets);
+  ASSERT_TRUE(culler->getIndexBuffer());
+  EXPECT_EQ(culler->getIndexBuffer()->getSizeInBytes(), indices.size() * sizeof(uint32_t));
+  ASSERT_TRUE(culler->getIndirectBuffer());
+  EXPECT_EQ(culler->getIndirectBuffer()->getSizeInBytes(),
+            numMeshlets * sizeof(DrawIndexedIndirectCommand));
+  EXPECT_EQ(culler->getDependencies().buffers[0], culler->getIndirectBuffer().get());
+
+  // a cache without meshlets is rejected
+  MeshCacheWriter plainWriter;
+  options.buildMeshlets = false;
+  ASSERT_TRUE(buildMeshCache(desc, options, plainWriter, &result));
+  const std::vector<uint8_t> plainFile = plainWriter.serialize();
+  reader = MeshCacheReader::tryCreate(plainFile.data(), plainFile.size(), &result);
+  ASSERT_TRUE(reader);
+  EXPECT_FALSE(ClusterCuller::create(*device, *reader, &result));
+  EXPECT_FALSE(result.isOk());
+}
+
+} // namespace igl::tests
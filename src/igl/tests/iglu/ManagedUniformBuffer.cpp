@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+
+#include <IGLU/managedUniformBuffer/ManagedUniformBuffer.h>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace igl::tests {
+
+namespace {
+
+struct Uniforms {
+  float color[4];
+  float scale;
+  int32_t layer;
+};
+
+iglu::ManagedUniformBufferInfo makeInfo(uint32_t numFramesInFlight) {
+  iglu::ManagedUniformBufferInfo info;
+  info.index = 1;
+  info.length = sizeof(Uniforms);
+  info.uniforms = {
+      {"color", -1, UniformType::Float4, 1, offsetof(Uniforms, color), 0},
+      {"scale", -1, UniformType::Float, 1, offsetof(Uniforms, scale), 0},
+      {"layer", -1, UniformType::Int, 1, offsetof(Uniforms, layer), 0},
+  };
+  info.numFramesInFlight = numFramesInFlight;
+  return info;
+}
+
+// Records the buffer bound by ManagedUniformBuffer::bind()
+class BufferBindingRecorder final : public IComputeCommandEncoder {
+ public:
+  void endEncoding() override {}
+  void pushDebugGroupLabel(const char* /*label*/, const Color& /*color*/) const override {}
+  void insertDebugEventLabel(const char* /*label*/, const Color& /*color*/) const override {}
+  void popDebugGroupLabel() const override {}
+  void bindUniform(const UniformDesc& /*uniformDesc*/, const void* /*data*/) override {}
+  void bindTexture(size_t /*index*/, ITexture* /*texture*/) override {}
+  void bindBuffer(size_t index, const std::shared_ptr<IBuffer>& buffer, size_t offset) override {
+    boundIndex = index;
+    boundBuffer = buffer;
+    boundOffset = offset;
+  }
+  void bindBytes(size_t /*index*/, const void* /*data*/, size_t /*length*/) override {}
+  void bindPushConstants(const void* /*data*/, size_t /*length*/, size_t /*offset*/) override {}
+  void bindComputePipelineState(
+      const std::shared_ptr<IComputePipelineState>& /*pipelineState*/) override {}
+  void dispatchThreadGroups(const Dimensions& /*threadgroupCount*/,
+                            const Dimensions& /*threadgroupSize*/,
+                            const Dependencies& /*dependencies*/) override {}
+
+  size_t boundIndex = 0;
+  std::shared_ptr<IBuffer> boundBuffer;
+  size_t boundOffset = 0;
+};
+
+Uniforms readUniforms(IBuffer& buffer, size_t offset) {
+  Uniforms uniforms{};
+  Result ret;
+  const void* data = buffer.map(BufferRange(sizeof(Uniforms), offset), &ret);
+  if (data != nullptr) {
+    std::memcpy(&uniforms, data, sizeof(Uniforms));
+    buffer.unmap();
+  }
+  return uniforms;
+}
+
+bool operator==(const Uniforms& a, const Uniforms& b) {
+  return std::memcmp(a.color, b.color, sizeof(a.color)) == 0 && a.scale == b.scale &&
+         a.layer == b.layer;
+}
+
+} // namespace
+
+class ManagedUniformBufferTest : public ::testing::TestWithParam<uint32_t> {
+ public:
+  void SetUp() override {
+    util::createDeviceAndQueue(device_, queue_);
+    ASSERT_TRUE(device_);
+  }
+
+ protected:
+  std::shared_ptr<IDevice> device_;
+  std::shared_ptr<ICommandQueue> queue_;
+};
+
+TEST_P(ManagedUniformBufferTest, UpdateByName) {
+  iglu::ManagedUniformBuffer mub(*device_, makeInfo(GetParam()));
+  ASSERT_TRUE(mub.result.isOk()) << mub.result.message;
+
+  const float color[4] = {1.0f, 0.5f, 0.25f, 1.0f};
+  const float scale = 2.0f;
+  const int32_t layer = 3;
+  EXPECT_TRUE(mub.updateData("color", color, sizeof(color)));
+  EXPECT_TRUE(mub.updateData(genNameHandle("scale"), &scale, sizeof(scale)));
+  // larger inputs are clamped to the size of the uniform
+  const int32_t layers[2] = {layer, 7};
+  EXPECT_TRUE(mub.updateData(genNameHandle("layer"), layers, sizeof(layers)));
+
+  const auto* data = static_cast<const Uniforms*>(mub.getData());
+  EXPECT_EQ(std::memcmp(data->color, color, sizeof(color)), 0);
+  EXPECT_EQ(data->scale, scale);
+  EXPECT_EQ(data->layer, layer);
+  EXPECT_EQ(mub.getUniformDataSize("color"), sizeof(color));
+  EXPECT_EQ(mub.getUniformDataSize("missing"), 0u);
+}
+
+TEST_F(ManagedUniformBufferTest, RingSlots) {
+  if (device_->getBackendType() == BackendType::OpenGL) {
+    GTEST_SKIP() << "The OpenGL backend binds individual uniforms";
+  }
+
+  auto info = makeInfo(2);
+  info.maxBindsPerFrame = 2;
+  const int32_t numSlots = 4;
+  iglu::ManagedUniformBuffer mub(*device_, info);
+  ASSERT_TRUE(mub.result.isOk()) << mub.result.message;
+
+  Uniforms expected = {{1.0f, 0.5f, 0.25f, 1.0f}, 2.0f, 0};
+  ASSERT_TRUE(mub.updateData("color", expected.color, sizeof(expected.color)));
+  ASSERT_TRUE(mub.updateData("scale", &expected.scale, sizeof(expected.scale)));
+  ASSERT_TRUE(mub.updateData("layer", &expected.layer, sizeof(expected.layer)));
+
+  BufferBindingRecorder encoder;
+  mub.bind(*device_, encoder);
+  ASSERT_TRUE(encoder.boundBuffer);
+  EXPECT_EQ(encoder.boundIndex, 1u);
+  const size_t firstOffset = encoder.boundOffset;
+  EXPECT_TRUE(readUniforms(*encoder.boundBuffer, firstOffset) == expected);
+
+  // without new data, the slot holding the latest data is bound again
+  mub.bind(*device_, encoder);
+  EXPECT_EQ(encoder.boundOffset, firstOffset);
+
+  // each update moves to the next slot of the frame, which only receives the bytes modified since
+  // its last use
+  std::vector<size_t> offsets = {firstOffset};
+  for (int32_t layer = 1; layer <= 2 * numSlots; ++layer) {
+    if (layer % 2 == 0) {
+      mub.beginFrame();
+    }
+    expected.layer = layer;
+    ASSERT_TRUE(mub.updateData("layer", &expected.layer, sizeof(expected.layer)));
+    if (layer == numSlots + 1) {
+      // a slot reused after a full turn of the ring also needs the older modifications
+      expected.scale = 3.0f;
+      ASSERT_TRUE(mub.updateData("scale", &expected.scale, sizeof(expected.scale)));
+    }
+    mub.bind(*device_, encoder);
+    EXPECT_TRUE(readUniforms(*encoder.boundBuffer, encoder.boundOffset) == expected)
+        << "layer " << layer;
+    offsets.push_back(encoder.boundOffset);
+  }
+
+  for (size_t i = 0; i != numSlots; ++i) {
+    EXPECT_EQ(offsets[i] % 16, 0u);
+    EXPECT_LE(offsets[i] + sizeof(Uniforms), encoder.boundBuffer->getSizeInBytes());
+    // the ring wraps around after numFramesInFlight frames
+    EXPECT_EQ(offsets[i + numSlots], offsets[i]);
+    for (size_t j = 0; j != i; ++j) {
+      EXPECT_NE(offsets[i], offsets[j]);
+    }
+  }
+}
+
+TEST_F(ManagedUniformBufferTest, RingSlotsPerFrame) {
+  if (device_->getBackendType() == BackendType::OpenGL) {
+    GTEST_SKIP() << "The OpenGL backend binds individual uniforms";
+  }
+
+  auto info = makeInfo(2);
+  info.maxBindsPerFrame = 2;
+  iglu::ManagedUniformBuffer mub(*device_, info);
+  ASSERT_TRUE(mub.result.isOk()) << mub.result.message;
+
+  BufferBindingRecorder encoder;
+  std::vector<std::pair<std::shared_ptr<IBuffer>, size_t>> frameBinds;
+  Uniforms expected = {{1.0f, 0.5f, 0.25f, 1.0f}, 2.0f, 0};
+  ASSERT_TRUE(mub.updateData("color", expected.color, sizeof(expected.color)));
+  ASSERT_TRUE(mub.updateData("scale", &expected.scale, sizeof(expected.scale)));
+
+  // more modified binds than maxBindsPerFrame in one frame grow the ring instead of overwriting
+  // slots bound earlier in the frame
+  for (int32_t layer = 0; layer != 5; ++layer) {
+    expected.layer = layer;
+    ASSERT_TRUE(mub.updateData("layer", &expected.layer, sizeof(expected.layer)));
+    mub.bind(*device_, encoder);
+    frameBinds.emplace_back(encoder.boundBuffer, encoder.boundOffset);
+  }
+  for (int32_t layer = 0; layer != 5; ++layer) {
+    expected.layer = layer;
+    EXPECT_TRUE(readUniforms(*frameBinds[layer].first, frameBinds[layer].second) == expected)
+        << "layer " << layer;
+  }
+
+  // an unmodified bind in a later frame does not reuse a slot that frame may overwrite
+  mub.beginFrame();
+  mub.beginFrame();
+  mub.bind(*device_, encoder);
+  const size_t unmodifiedOffset = encoder.boundOffset;
+  expected.layer = 5;
+  ASSERT_TRUE(mub.updateData("layer", &expected.layer, sizeof(expected.layer)));
+  mub.bind(*device_, encoder);
+  EXPECT_NE(encoder.boundOffset, unmodifiedOffset);
+  expected.layer = 4;
+  EXPECT_TRUE(readUniforms(*encoder.boundBuffer, unmodifiedOffset) == expected);
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes,
+                         ManagedUniformBufferTest,
+                         ::testing::Values(0u, 3u),
+                         [](const ::testing::TestParamInfo<uint32_t>& info) {
+                           return info.param ? "Ring" : "Default";
+                         });
+
+} // namespace igl::tests
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+
+#include <IGLU/mesh_cache/MeshBuilder.h>
+#include <IGLU/mesh_cache/MeshCacheReader.h>
+#include <IGLU/mesh_cache/MeshCacheWriter.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl::tests {
+
+namespace {
+
+using namespace iglu::meshcache;
+
+constexpr uint32_t kUserChunk = makeChunkId('U', 'S', 'R', '0');
+
+struct Vertex {
+  float position[3];
+  uint32_t normal;
+};
+
+std::vector<Vertex> makeGrid(uint32_t size, std::vector<uint32_t>& outIndices) {
+  std::vector<Vertex> vertices;
+  for (uint32_t y = 0; y <= size; y++) {
+    for (uint32_t x = 0; x <= size; x++) {
+      vertices.push_back({{float(x), float(y), 0.0f}, x ^ y});
+    }
+  }
+  for (uint32_t y = 0; y < size; y++) {
+    for (uint32_t x = 0; x < size; x++) {
+      const uint32_t i = y * (size + 1) + x;
+      outIndices.insert(outIndices.end(),
+                        {i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1});
+    }
+  }
+  return vertices;
+}
+
+using Triangle = std::array<float, 9>;
+
+// Returns the sorted list of triangles, each with its vertices rotated into a canonical order.
+std::vector<Triangle> getTriangles(const Vertex* vertices, const uint32_t* indices, size_t count) {
+  std::vector<Triangle> triangles;
+  for (size_t i = 0; i < count; i += 3) {
+    std::array<const Vertex*, 3> v = {
+        &vertices[indices[i]], &vertices[indices[i + 1]], &vertices[indices[i + 2]]};
+    const auto less = [](const Vertex* a, const Vertex* b) {
+      return std::lexicographical_compare(
+          a->position, a->position + 3, b->position, b->position + 3);
+    };
+    std::rotate(v.begin(), std::min_element(v.begin(), v.end(), less), v.end());
+    Triangle t;
+    for (size_t j = 0; j != 3; j++) {
+      std::copy(v[j]->position, v[j]->position + 3, t.begin() + j * 3);
+    }
+    triangles.push_back(t);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+} // namespace
+
+TEST(MeshCacheTest, RoundTrip) {
+  const std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+  const std::vector<uint8_t> user = {1, 2, 3};
+
+  MeshCacheWriter writer;
+  Result result;
+  ASSERT_TRUE(writer.addChunk(ChunkId::Indices, indices, Encoding::Raw, &result));
+  ASSERT_TRUE(writer.addChunk(kUserChunk, user, Encoding::Raw, &result));
+  EXPECT_FALSE(writer.addChunk(kUserChunk, user, Encoding::Raw, &result));
+  EXPECT_EQ(result.code, Result::Code::ArgumentInvalid);
+
+  const std::vector<uint8_t> file = writer.serialize();
+  const auto reader = MeshCacheReader::tryCreate(file.data(), file.size(), &result);
+  ASSERT_TRUE(reader) << result.message;
+  EXPECT_EQ(reader->header().numChunks, 2u);
+  EXPECT_EQ(reader->findChunk(ChunkId::Vertices), nullptr);
+
+  size_t count = 0;
+  const uint32_t* readIndices = reader->getChunk<uint32_t>(ChunkId::Indices, count, &result);
+  ASSERT_TRUE(readIndices) << result.message;
+  EXPECT_EQ(std::vector<uint32_t>(readIndices, readIndices + count), indices);
+  // raw chunks point into the file and are aligned for direct use
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(readIndices) - file.data(),
+            static_cast<ptrdiff_t>(reader->findChunk(ChunkId::Indices)->offset));
+  EXPECT_EQ(reader->findChunk(kUserChunk)->offset % kChunkAlignment, 0u);
+
+  EXPECT_FALSE(reader->getChunk<uint32_t>(kUserChunk, count, &result));
+  EXPECT_EQ(result.code, Result::Code::ArgumentInvalid);
+}
+
+TEST(MeshCacheTest, CompressedRoundTrip) {
+  std::vector<uint32_t> indices;
+  const std::vector<Vertex> vertices = makeGrid(16, indices);
+
+  MeshCacheWriter writer;
+  Result result;
+  ASSERT_TRUE(writer.addChunk(ChunkId::Vertices, vertices, Encoding::MeshoptVertex, &result));
+  ASSERT_TRUE(writer.addChunk(ChunkId::Indices, indices, Encoding::MeshoptIndex, &result));
+  const std::vector<uint8_t> file = writer.serialize();
+
+  const auto reader = MeshCacheReader::tryCreate(file.data(), file.size(), &result);
+  ASSERT_TRUE(reader) << result.message;
+  size_t numVertices = 0;
+  size_t numIndices = 0;
+  const Vertex* v = reader->getChunk<Vertex>(ChunkId::Vertices, numVertices, &result);
+  ASSERT_TRUE(v) << result.message;
+  const uint32_t* i = reader->getChunk<uint32_t>(ChunkId::Indices, numIndices, &result);
+  ASSERT_TRUE(i) << result.message;
+  ASSERT_EQ(numVertices, vertices.size());
+  ASSERT_EQ(numIndices, indices.size());
+  EXPECT_EQ(0, std::memcmp(v, vertices.data(), sizeof(Vertex) * numVertices));
+  // the index codec may rotate triangles but never changes them
+  EXPECT_EQ(getTriangles(vertices.data(), indices.data(), indices.size()),
+            getTriangles(v, i, numIndices));
+  // decoded chunks are cached
+  EXPECT_EQ(i, reader->getChunk<uint32_t>(ChunkId::Indices, numIndices, &result));
+}
+
+TEST(MeshCacheTest, RejectsCorruptFiles) {
+  MeshCacheWriter writer;
+  const std::vector<uint32_t> indices = {0, 1, 2};
+  ASSERT_TRUE(writer.addChunk(ChunkId::Indices, indices, Encoding::Raw, nullptr));
+  const std::vector<uint8_t> file = writer.serialize();
+
+  Result result;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(file.data(), sizeof(FileHeader) - 1, &result));
+  EXPECT_FALSE(MeshCacheReader::tryCreate(file.data(), file.size() - 1, &result));
+
+  auto corrupt = file;
+  corrupt[0] ^= 0xFF;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+
+  corrupt = file;
+  reinterpret_cast<FileHeader*>(corrupt.data())->version = kVersion + 1;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+  EXPECT_EQ(result.code, Result::Code::Unsupported);
+
+  corrupt = file;
+  reinterpret_cast<ChunkHeader*>(corrupt.data() + sizeof(FileHeader))->size = 1 << 20;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+
+  corrupt = file;
+  reinterpret_cast<ChunkHeader*>(corrupt.data() + sizeof(FileHeader))->count = 4;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+
+  EXPECT_TRUE(MeshCacheReader::tryCreate(file.data(), file.size(), &result));
+}
+
+TEST(MeshCacheTest, RejectsInvalidCompressedChunks) {
+  std::vector<uint32_t> indices;
+  const std::vector<Vertex> vertices = makeGrid(4, indices);
+
+  MeshCacheWriter writer;
+  ASSERT_TRUE(writer.addChunk(ChunkId::Vertices, vertices, Encoding::MeshoptVertex, nullptr));
+  ASSERT_TRUE(writer.addChunk(ChunkId::Indices, indices, Encoding::MeshoptIndex, nullptr));
+  const std::vector<uint8_t> file = writer.serialize();
+  const auto* header = reinterpret_cast<const ChunkHeader*>(file.data() + sizeof(FileHeader));
+  ASSERT_EQ(header[0].encoding, Encoding::MeshoptVertex);
+  ASSERT_EQ(header[1].encoding, Encoding::MeshoptIndex);
+
+  Result result;
+  auto corrupt = file;
+  auto* chunks = reinterpret_cast<ChunkHeader*>(corrupt.data() + sizeof(FileHeader));
+  chunks[0].elementSize = sizeof(Vertex) - 2;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+
+  corrupt = file;
+  chunks = reinterpret_cast<ChunkHeader*>(corrupt.data() + sizeof(FileHeader));
+  chunks[0].elementSize = 260;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+
+  corrupt = file;
+  chunks = reinterpret_cast<ChunkHeader*>(corrupt.data() + sizeof(FileHeader));
+  chunks[1].count -= 1;
+  EXPECT_FALSE(MeshCacheReader::tryCreate(corrupt.data(), corrupt.size(), &result));
+
+  EXPECT_TRUE(MeshCacheReader::tryCreate(file.data(), file.size(), &result));
+}
+
+TEST(MeshCacheTest, BuildPreservesShapes) {
+  std::vector<uint32_t> gridIndices;
+  const std::vector<Vertex> grid = makeGrid(8, gridIndices);
+  // unindexed input with every vertex duplicated per triangle
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> identity;
+  for (uint32_t index : gridIndices) {
+    identity.push_back(static_cast<uint32_t>(vertices.size()));
+    vertices.push_back(grid[index]);
+  }
+
+  MeshDesc desc;
+  desc.vertices = vertices.data();
+  desc.numVertices = vertices.size();
+  desc.vertexSize = sizeof(Vertex);
+  desc.shapes.push_back({0, 96, 7});
+  desc.shapes.push_back({96, static_cast<uint32_t>(vertices.size() - 96), 3});
+
+  MeshBuildOptions options;
+  options.buildMeshlets = true;
+  options.maxMeshletVertices = 16;
+  options.maxMeshletTriangles = 16;
+
+  MeshCacheWriter writer;
+  Result result;
+  ASSERT_TRUE(buildMeshCache(desc, options, writer, &result)) << result.message;
+  const std::vector<uint8_t> file = writer.serialize();
+  const auto reader = MeshCacheReader::tryCreate(file.data(), file.size(), &result);
+  ASSERT_TRUE(reader) << result.message;
+
+  size_t numVertices = 0;
+  size_t numIndices = 0;
+  size_t numShapes = 0;
+  size_t numMeshlets = 0;
+  size_t numMeshletTriangles = 0;
+  size_t numMeshletBounds = 0;
+  const auto* v = reader->getChunk<Vertex>(ChunkId::Vertices, numVertices, &result);
+  const auto* i = reader->getChunk<uint32_t>(ChunkId::Indices, numIndices, &result);
+  const auto* shapes = reader->getChunk<Shape>(ChunkId::Shapes, numShapes, &result);
+  const auto* meshlets = reader->getChunk<Meshlet>(ChunkId::Meshlets, numMeshlets, &result);
+  ASSERT_TRUE(reader->getChunk<uint8_t>(ChunkId::MeshletTriangles, numMeshletTriangles, &result));
+  const auto* bounds =
+      reader->getChunk<MeshletBounds>(ChunkId::MeshletBounds, numMeshletBounds, &result);
+  ASSERT_TRUE(v && i && shapes && meshlets && bounds);
+  EXPECT_EQ(numMeshletBounds, numMeshlets);
+
+  EXPECT_EQ(numVertices, grid.size());
+  EXPECT_EQ(numIndices, vertices.size());
+  ASSERT_EQ(numShapes, 2u);
+  for (size_t s = 0; s != numShapes; s++) {
+    const Shape& shape = shapes[s];
+    EXPECT_EQ(shape.firstIndex, desc.shapes[s].firstIndex);
+    EXPECT_EQ(shape.numIndices, desc.shapes[s].numIndices);
+    EXPECT_EQ(shape.materialIndex, desc.shapes[s].materialIndex);
+    EXPECT_EQ(getTriangles(v, i + shape.firstIndex, shape.numIndices),
+              getTriangles(vertices.data(), identity.data() + shape.firstIndex, shape.numIndices));
+
+    uint32_t numTriangles = 0;
+    for (uint32_t m = shape.firstMeshlet; m != shape.firstMeshlet + shape.numMeshlets; m++) {
+      ASSERT_LT(m, numMeshlets);
+      EXPECT_LE(meshlets[m].vertexCount, options.maxMeshletVertices);
+      EXPECT_LE(meshlets[m].triangleOffset + meshlets[m].triangleCount * 3, numMeshletTriangles);
+      numTriangles += meshlets[m].triangleCount;
+      // the grid lies in the z = 0 plane
+      EXPECT_GT(bounds[m].radius, 0.0f);
+      EXPECT_NEAR(bounds[m].center[2], 0.0f, 1e-5f);
+    }
+    EXPECT_EQ(numTriangles * 3, shape.numIndices);
+  }
+}
+
+TEST(MeshCacheTest, OpenAndUpload) {
+  std::vector<uint32_t> indices;
+  const std::vector<Vertex> vertices = makeGrid(4, indices);
+  MeshCacheWriter writer;
+  ASSERT_TRUE(writer.addChunk(ChunkId::Vertices, vertices, Encoding::Raw, nullptr));
+  ASSERT_TRUE(writer.addChunk(ChunkId::Indices, indices, Encoding::MeshoptIndex, nullptr));
+
+  const std::string path = ::testing::TempDir() + "iglu_mesh_cache_test.bin";
+  Result result;
+  ASSERT_TRUE(writer.writeToFile(path, &result)) << result.message;
+
+  auto reader = MeshCacheReader::tryOpen(path, &result);
+  ASSERT_TRUE(reader) << result.message;
+  EXPECT_FALSE(MeshCacheReader::tryOpen(path + ".missing", &result));
+
+  std::shared_ptr<IDevice> device;
+  std::shared_ptr<ICommandQueue> queue;
+  util::createDeviceAndQueue(device, queue);
+  ASSERT_TRUE(device);
+
+  const auto vb = reader->createBuffer(*device, ChunkId::Vertices, BufferDesc::Vertex, &result);
+  ASSERT_TRUE(vb) << result.message;
+  EXPECT_EQ(vb->getSizeInBytes(), sizeof(Vertex) * vertices.size());
+  const auto ib = reader->createBuffer(*device, ChunkId::Indices, BufferDesc::Index, &result);
+  ASSERT_TRUE(ib) << result.message;
+  EXPECT_EQ(ib->getSizeInBytes(), sizeof(uint32_t) * indices.size());
+
+  reader.reset();
+  std::remove(path.c_str());
+}
+
+// Load time of a cache the size of the Bistro exterior scene used by the Tiny_MeshLarge sample:
+// about 1M vertices and 2M triangles, stored raw and meshoptimizer-encoded.
+TEST(MeshCacheTest, DISABLED_LoadTimeBenchmark) {
+  constexpr uint32_t kIterations = 16;
+
+  std::vector<uint32_t> indices;
+  const std::vector<Vertex> vertices = makeGrid(1024, indices);
+
+  for (const bool compressed : {false, true}) {
+    MeshCacheWriter writer;
+    ASSERT_TRUE(writer.addChunk(ChunkId::Vertices,
+                                vertices,
+                                compressed ? Encoding::MeshoptVertex : Encoding::Raw,
+                                nullptr));
+    ASSERT_TRUE(writer.addChunk(ChunkId::Indices,
+                                indices,
+                                compressed ? Encoding::MeshoptIndex : Encoding::Raw,
+                                nullptr));
+    const std::string path = ::testing::TempDir() + "iglu_mesh_cache_benchmark.bin";
+    Result result;
+    ASSERT_TRUE(writer.writeToFile(path, &result)) << result.message;
+
+    const auto start = std::chrono::steady_clock::now();
+    uint32_t checksum = 0;
+    for (uint32_t iteration = 0; iteration != kIterations; iteration++) {
+      const auto reader = MeshCacheReader::tryOpen(path, &result);
+      ASSERT_TRUE(reader) << result.message;
+      size_t numVertices = 0;
+      size_t numIndices = 0;
+      const auto* v = reader->getChunk<Vertex>(ChunkId::Vertices, numVertices, &result);
+      const auto* i = reader->getChunk<uint32_t>(ChunkId::Indices, numIndices, &result);
+      ASSERT_TRUE(v && i);
+      ASSERT_EQ(numIndices, indices.size());
+      // touch every byte, as uploading to GPU buffers would, so raw chunks are paged in
+      for (size_t j = 0; j != numVertices; j++) {
+        checksum += v[j].normal;
+      }
+      for (size_t j = 0; j != numIndices; j++) {
+        checksum += i[j];
+      }
+    }
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    IGL_LOG_INFO("Mesh cache load %-10s %8.2f ms (%u vertices, %u indices)\n",
+                 compressed ? "meshopt" : "raw",
+                 elapsed.count() / kIterations,
+                 (uint32_t)vertices.size(),
+                 (uint32_t)indices.size());
+    EXPECT_NE(checksum, 0u);
+    std::remove(path.c_str());
+  }
+}
+
+} // namespace igl::tests
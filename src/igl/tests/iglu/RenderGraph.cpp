@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../util/Common.h"
+
+#include <IGLU/render_graph/RenderGraph.h>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+
+namespace igl::tests {
+
+namespace {
+
+using namespace iglu::rendergraph;
+
+constexpr uint32_t kSize = 2;
+
+TextureDesc makeDesc() {
+  return TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                            kSize,
+                            kSize,
+                            TextureDesc::TextureUsageBits::Attachment |
+                                TextureDesc::TextureUsageBits::Sampled);
+}
+
+AttachmentWrite write(ResourceHandle resource, bool clear) {
+  AttachmentWrite w;
+  w.resource = resource;
+  w.clear = clear;
+  return w;
+}
+
+PassDesc makePass(const char* name,
+                  std::vector<AttachmentWrite> colorAttachments,
+                  std::vector<ResourceHandle> reads = {}) {
+  PassDesc pass;
+  pass.name = name;
+  pass.colorAttachments = std::move(colorAttachments);
+  pass.reads = std::move(reads);
+  return pass;
+}
+
+} // namespace
+
+class RenderGraphTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    Result ret;
+    backbuffer_ = iglDev_->createTexture(makeDesc(), &ret);
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_TRUE(backbuffer_ != nullptr);
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<ITexture> backbuffer_;
+};
+
+TEST_F(RenderGraphTest, CullingAndLoadStoreInference) {
+  RenderGraph graph;
+  const auto unused = graph.createTexture(makeDesc(), "Unused");
+  const auto gbuffer = graph.createTexture(makeDesc(), "G-buffer");
+  const auto scratch = graph.createTexture(makeDesc(), "Scratch");
+  const auto backbuffer = graph.importTexture(backbuffer_, "Backbuffer");
+
+  const auto unusedPass = graph.addPass(makePass("Unused", {write(unused, true)}));
+  const auto geometryPass =
+      graph.addPass(makePass("Geometry", {write(gbuffer, true), write(scratch, true)}));
+  const auto decalsPass =
+      graph.addPass(makePass("Decals", {write(gbuffer, false), write(scratch, false)}));
+  const auto lightingPass =
+      graph.addPass(makePass("Lighting", {write(backbuffer, false)}, {gbuffer}));
+
+  ASSERT_TRUE(graph.compile(*iglDev_).isOk());
+
+  EXPECT_TRUE(graph.isPassCulled(unusedPass));
+  EXPECT_FALSE(graph.isPassCulled(geometryPass));
+  EXPECT_FALSE(graph.isPassCulled(decalsPass));
+  EXPECT_FALSE(graph.isPassCulled(lightingPass));
+  EXPECT_EQ(graph.getTexture(unused), nullptr);
+
+  const auto& geometry = graph.getRenderPass(geometryPass);
+  ASSERT_EQ(geometry.colorAttachments.size(), 2u);
+  EXPECT_EQ(geometry.colorAttachments[0].loadAction, LoadAction::Clear);
+  EXPECT_EQ(geometry.colorAttachments[0].storeAction, StoreAction::Store);
+  // loaded by the decals pass
+  EXPECT_EQ(geometry.colorAttachments[1].loadAction, LoadAction::Clear);
+  EXPECT_EQ(geometry.colorAttachments[1].storeAction, StoreAction::Store);
+
+  const auto& decals = graph.getRenderPass(decalsPass);
+  ASSERT_EQ(decals.colorAttachments.size(), 2u);
+  EXPECT_EQ(decals.colorAttachments[0].loadAction, LoadAction::Load);
+  EXPECT_EQ(decals.colorAttachments[0].storeAction, StoreAction::Store);
+  // nothing consumes the scratch texture after the decals pass
+  EXPECT_EQ(decals.colorAttachments[1].loadAction, LoadAction::Load);
+  EXPECT_EQ(decals.colorAttachments[1].storeAction, StoreAction::DontCare);
+
+  const auto& lighting = graph.getRenderPass(lightingPass);
+  ASSERT_EQ(lighting.colorAttachments.size(), 1u);
+  EXPECT_EQ(lighting.colorAttachments[0].loadAction, LoadAction::Load);
+  EXPECT_EQ(lighting.colorAttachments[0].storeAction, StoreAction::Store);
+
+  const auto& stats = graph.getStats();
+  EXPECT_EQ(stats.numPasses, 4u);
+  EXPECT_EQ(stats.numCulledPasses, 1u);
+  EXPECT_EQ(stats.numTransientTextures, 2u);
+  EXPECT_EQ(stats.numStoresAvoided, 1u);
+  EXPECT_EQ(stats.numLoadsAvoided, 0u);
+}
+
+TEST_F(RenderGraphTest, Aliasing) {
+  RenderGraph graph;
+
+  for (int frame = 0; frame != 2; frame++) {
+    graph.reset();
+    const auto a = graph.createTexture(makeDesc(), "A");
+    const auto b = graph.createTexture(makeDesc(), "B");
+    const auto c = graph.createTexture(makeDesc(), "C");
+    const auto backbuffer = graph.importTexture(backbuffer_, "Backbuffer");
+
+    graph.addPass(makePass("A", {write(a, true)}));
+    graph.addPass(makePass("B", {write(b, true)}, {a}));
+    graph.addPass(makePass("C", {write(c, true)}, {b}));
+    graph.addPass(makePass("Final", {write(backbuffer, true)}, {c}));
+
+    ASSERT_TRUE(graph.compile(*iglDev_).isOk());
+
+    // A is dead once C starts
+    EXPECT_EQ(graph.getTexture(a), graph.getTexture(c));
+    EXPECT_NE(graph.getTexture(a), graph.getTexture(b));
+    EXPECT_EQ(graph.getTexture(backbuffer), backbuffer_);
+    EXPECT_EQ(graph.getStats().numTransientTextures, 3u);
+    EXPECT_EQ(graph.getStats().numPhysicalTextures, 2u);
+  }
+
+  // exported textures keep their own physical texture
+  graph.reset();
+  const auto a = graph.createTexture(makeDesc(), "A");
+  const auto b = graph.createTexture(makeDesc(), "B");
+  graph.exportTexture(b);
+  graph.addPass(makePass("A", {write(a, true)}));
+  graph.addPass(makePass("B", {write(b, true)}));
+
+  ASSERT_TRUE(graph.compile(*iglDev_).isOk());
+
+  EXPECT_TRUE(graph.isPassCulled(0));
+  EXPECT_EQ(graph.getTexture(a), nullptr);
+  EXPECT_NE(graph.getTexture(b), nullptr);
+  EXPECT_EQ(graph.getStats().numPhysicalTextures, 1u);
+}
+
+TEST_F(RenderGraphTest, InvalidPasses) {
+  RenderGraph graph;
+  graph.addPass(makePass("Invalid", {write(42, true)}));
+  EXPECT_FALSE(graph.compile(*iglDev_).isOk());
+
+  Result ret;
+  auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(cmdBuf != nullptr);
+  EXPECT_EQ(graph.execute(*cmdBuf).code, Result::Code::InvalidOperation);
+}
+
+TEST_F(RenderGraphTest, Execute) {
+  RenderGraph graph;
+  const auto intermediate = graph.createTexture(makeDesc(), "Intermediate");
+  const auto backbuffer = graph.importTexture(backbuffer_, "Backbuffer");
+
+  uint32_t numExecuted = 0;
+
+  PassDesc clearPass = makePass("Clear", {write(intermediate, true)});
+  clearPass.colorAttachments[0].clearColor = {1.0f, 0.0f, 0.0f, 1.0f};
+  clearPass.execute = [&numExecuted](IRenderCommandEncoder& /*encoder*/) { numExecuted++; };
+  graph.addPass(std::move(clearPass));
+
+  PassDesc finalPass = makePass("Final", {write(backbuffer, true)}, {intermediate});
+  finalPass.colorAttachments[0].clearColor = {0.0f, 0.0f, 1.0f, 1.0f};
+  finalPass.execute = [&numExecuted](IRenderCommandEncoder& /*encoder*/) { numExecuted++; };
+  graph.addPass(std::move(finalPass));
+
+  ASSERT_TRUE(graph.compile(*iglDev_).isOk());
+
+  Result ret;
+  auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(cmdBuf != nullptr);
+  ASSERT_TRUE(graph.execute(*cmdBuf).isOk());
+  cmdQueue_->submit(*cmdBuf);
+  cmdBuf->waitUntilCompleted();
+
+  EXPECT_EQ(numExecuted, 2u);
+
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = backbuffer_;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(framebuffer != nullptr);
+
+  uint32_t pixels[kSize * kSize] = {};
+  framebuffer->copyBytesColorAttachment(*cmdQueue_, 0, pixels, backbuffer_->getFullRange());
+  for (const uint32_t pixel : pixels) {
+    EXPECT_EQ(pixel, 0xffff0000);
+  }
+}
+
+} // namespace igl::tests
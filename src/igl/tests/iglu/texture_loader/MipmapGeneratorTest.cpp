@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <IGLU/texture_loader/MipmapGenerator.h>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace igl::tests {
+
+namespace {
+
+TextureDesc makeDesc(TextureFormat format,
+                     size_t width,
+                     size_t height,
+                     TextureType type = TextureType::TwoD,
+                     size_t numLayers = 1) {
+  TextureDesc desc;
+  desc.format = format;
+  desc.type = type;
+  desc.width = width;
+  desc.height = height;
+  desc.numLayers = numLayers;
+  desc.numMipLevels = TextureDesc::calcNumMipLevels(width, height);
+  return desc;
+}
+
+std::vector<uint8_t> makeRandomRGBA8(size_t numBytes) {
+  std::vector<uint8_t> data(numBytes);
+  uint32_t state = 12345;
+  for (auto& byte : data) {
+    state = state * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  return data;
+}
+
+// Straightforward 2x2 reference used to validate the vectorized kernels.
+std::vector<uint8_t> referenceBoxLevel(const std::vector<uint8_t>& src,
+                                       size_t srcWidth,
+                                       size_t srcHeight) {
+  const size_t dstWidth = std::max<size_t>(srcWidth / 2, 1);
+  const size_t dstHeight = std::max<size_t>(srcHeight / 2, 1);
+  std::vector<uint8_t> dst(dstWidth * dstHeight * 4);
+  for (size_t y = 0; y < dstHeight; ++y) {
+    const size_t y0 = std::min(2 * y, srcHeight - 1);
+    const size_t y1 = std::min(2 * y + 1, srcHeight - 1);
+    for (size_t x = 0; x < dstWidth; ++x) {
+      const size_t x0 = std::min(2 * x, srcWidth - 1);
+      const size_t x1 = std::min(2 * x + 1, srcWidth - 1);
+      for (size_t c = 0; c < 4; ++c) {
+        const uint32_t sum =
+            src[(y0 * srcWidth + x0) * 4 + c] + src[(y0 * srcWidth + x1) * 4 + c] +
+            src[(y1 * srcWidth + x0) * 4 + c] + src[(y1 * srcWidth + x1) * 4 + c];
+        dst[(y * dstWidth + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+      }
+    }
+  }
+  return dst;
+}
+
+} // namespace
+
+TEST(MipmapGeneratorTest, SupportedFormats) {
+  using iglu::textureloader::MipmapGenerator;
+  EXPECT_TRUE(MipmapGenerator::isFormatSupported(TextureFormat::RGBA_UNorm8));
+  EXPECT_TRUE(MipmapGenerator::isFormatSupported(TextureFormat::RGBA_SRGB));
+  EXPECT_TRUE(MipmapGenerator::isFormatSupported(TextureFormat::RGBA_F16));
+  EXPECT_TRUE(MipmapGenerator::isFormatSupported(TextureFormat::RGBA_F32));
+  EXPECT_FALSE(MipmapGenerator::isFormatSupported(TextureFormat::R_UNorm8));
+  EXPECT_FALSE(MipmapGenerator::isFormatSupported(TextureFormat::RGBA_BC7_UNORM_4x4));
+}
+
+TEST(MipmapGeneratorTest, UnsupportedFormatFails) {
+  const iglu::textureloader::MipmapGenerator generator;
+  const auto desc = makeDesc(TextureFormat::R_UNorm8, 4, 4);
+  const std::vector<uint8_t> level0(16);
+  Result result;
+  EXPECT_EQ(generator.generate(desc, level0.data(), &result), nullptr);
+  EXPECT_EQ(result.code, Result::Code::Unsupported);
+}
+
+TEST(MipmapGeneratorTest, BoxRGBA8) {
+  const iglu::textureloader::MipmapGenerator generator;
+  const auto desc = makeDesc(TextureFormat::RGBA_UNorm8, 2, 2);
+  // clang-format off
+  const std::vector<uint8_t> level0 = {
+      0,   0,   0,   0,   255, 255, 255, 255,
+      100, 50,  10,  255, 60,  30,  20,  1,
+  };
+  // clang-format on
+  Result result;
+  const auto data = generator.generate(desc, level0.data(), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(data->length(), 20u);
+  EXPECT_EQ(0, std::memcmp(data->data(), level0.data(), level0.size()));
+  const uint8_t* level1 = data->data() + 16;
+  EXPECT_EQ(level1[0], 104); // (0 + 255 + 100 + 60 + 2) / 4
+  EXPECT_EQ(level1[1], 84);
+  EXPECT_EQ(level1[2], 71);
+  EXPECT_EQ(level1[3], 128);
+}
+
+TEST(MipmapGeneratorTest, BoxRGBA8MatchesReference) {
+  // Odd, non power-of-two dimensions exercise both the SIMD and scalar tails.
+  for (const uint32_t numThreads : {1u, 4u}) {
+    const iglu::textureloader::MipmapGenerator generator(iglu::textureloader::MipmapFilter::Box,
+                                                         numThreads);
+    const auto desc = makeDesc(TextureFormat::RGBA_UNorm8, 301, 157);
+    const auto level0 = makeRandomRGBA8(desc.width * desc.height * 4);
+
+    Result result;
+    const auto data = generator.generate(desc, level0.data(), &result);
+    ASSERT_TRUE(result.isOk()) << result.message;
+    ASSERT_EQ(data->length(), iglu::textureloader::MipmapGenerator::getBytesForMipChain(desc));
+
+    std::vector<uint8_t> expected = level0;
+    size_t width = desc.width;
+    size_t height = desc.height;
+    size_t offset = 0;
+    for (uint32_t level = 1; level < desc.numMipLevels; ++level) {
+      offset += width * height * 4;
+      expected = referenceBoxLevel(expected, width, height);
+      width = std::max<size_t>(width / 2, 1);
+      height = std::max<size_t>(height / 2, 1);
+      ASSERT_EQ(0, std::memcmp(data->data() + offset, expected.data(), expected.size()))
+          << "level " << level;
+    }
+  }
+}
+
+TEST(MipmapGeneratorTest, BoxSRGBFiltersInLinearSpace) {
+  const iglu::textureloader::MipmapGenerator generator;
+  const auto desc = makeDesc(TextureFormat::RGBA_SRGB, 2, 1);
+  const std::vector<uint8_t> level0 = {0, 0, 0, 0, 255, 255, 255, 255};
+  Result result;
+  const auto data = generator.generate(desc, level0.data(), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  const uint8_t* level1 = data->data() + 8;
+  // 50% linear is ~188 in sRGB, while alpha is filtered linearly.
+  EXPECT_NEAR(level1[0], 188, 1);
+  EXPECT_NEAR(level1[1], 188, 1);
+  EXPECT_NEAR(level1[2], 188, 1);
+  EXPECT_NEAR(level1[3], 128, 1);
+}
+
+TEST(MipmapGeneratorTest, BoxF32) {
+  const iglu::textureloader::MipmapGenerator generator;
+  const auto desc = makeDesc(TextureFormat::RGBA_F32, 2, 2);
+  // clang-format off
+  const std::vector<float> level0 = {
+      1.0f, 2.0f, 3.0f, 4.0f,   -1.0f, 0.0f, 1.0f, 2.0f,
+      4.0f, 4.0f, 4.0f, 4.0f,    0.0f, 2.0f, 0.0f, 6.0f,
+  };
+  // clang-format on
+  Result result;
+  const auto data = generator.generate(
+      desc, reinterpret_cast<const uint8_t*>(level0.data()), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  float level1[4] = {};
+  std::memcpy(level1, data->data() + sizeof(float) * level0.size(), sizeof(level1));
+  EXPECT_FLOAT_EQ(level1[0], 1.0f);
+  EXPECT_FLOAT_EQ(level1[1], 2.0f);
+  EXPECT_FLOAT_EQ(level1[2], 2.0f);
+  EXPECT_FLOAT_EQ(level1[3], 4.0f);
+}
+
+TEST(MipmapGeneratorTest, BoxF16) {
+  const iglu::textureloader::MipmapGenerator generator;
+  const auto desc = makeDesc(TextureFormat::RGBA_F16, 2, 1);
+  // 1.0, 2.0, 0.5, 0.0 and 3.0, 0.0, 0.5, 1.0
+  const std::vector<uint16_t> level0 = {
+      0x3c00, 0x4000, 0x3800, 0x0000, 0x4200, 0x0000, 0x3800, 0x3c00};
+  Result result;
+  const auto data = generator.generate(
+      desc, reinterpret_cast<const uint8_t*>(level0.data()), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  uint16_t level1[4] = {};
+  std::memcpy(level1, data->data() + sizeof(uint16_t) * level0.size(), sizeof(level1));
+  EXPECT_EQ(level1[0], 0x4000); // 2.0
+  EXPECT_EQ(level1[1], 0x3c00); // 1.0
+  EXPECT_EQ(level1[2], 0x3800); // 0.5
+  EXPECT_EQ(level1[3], 0x3800); // 0.5
+}
+
+TEST(MipmapGeneratorTest, KaiserPreservesConstantColor) {
+  const iglu::textureloader::MipmapGenerator generator(iglu::textureloader::MipmapFilter::Kaiser);
+  const auto desc = makeDesc(TextureFormat::RGBA_UNorm8, 64, 32);
+  std::vector<uint8_t> level0(desc.width * desc.height * 4);
+  for (size_t i = 0; i < level0.size(); i += 4) {
+    level0[i + 0] = 10;
+    level0[i + 1] = 20;
+    level0[i + 2] = 30;
+    level0[i + 3] = 40;
+  }
+  Result result;
+  const auto data = generator.generate(desc, level0.data(), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  for (uint32_t i = 0; i < data->length(); i += 4) {
+    ASSERT_EQ(data->data()[i + 0], 10);
+    ASSERT_EQ(data->data()[i + 1], 20);
+    ASSERT_EQ(data->data()[i + 2], 30);
+    ASSERT_EQ(data->data()[i + 3], 40);
+  }
+}
+
+TEST(MipmapGeneratorTest, LayersAndFacesAreIndependent) {
+  const iglu::textureloader::MipmapGenerator generator(iglu::textureloader::MipmapFilter::Box, 3);
+  const auto desc = makeDesc(TextureFormat::RGBA_UNorm8, 4, 4, TextureType::Cube);
+  std::vector<uint8_t> level0(desc.width * desc.height * 4 * 6);
+  for (size_t face = 0; face < 6; ++face) {
+    std::fill(level0.begin() + face * 64, level0.begin() + (face + 1) * 64, face * 40);
+  }
+  Result result;
+  const auto data = generator.generate(desc, level0.data(), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+  ASSERT_EQ(data->length(), (16u + 4u + 1u) * 4u * 6u);
+  // Level 1 is 2x2 per face, level 2 is 1x1 per face
+  for (size_t face = 0; face < 6; ++face) {
+    EXPECT_EQ(data->data()[6 * 64 + face * 16], face * 40);
+    EXPECT_EQ(data->data()[6 * 64 + 6 * 16 + face * 4], face * 40);
+  }
+}
+
+TEST(MipmapGeneratorTest, ThreadPoolIsReusedAcrossCalls) {
+  const auto desc = makeDesc(TextureFormat::RGBA_UNorm8, 512, 384);
+  const auto level0 = makeRandomRGBA8(desc.width * desc.height * 4);
+
+  Result result;
+  const iglu::textureloader::MipmapGenerator reference(iglu::textureloader::MipmapFilter::Box, 1);
+  const auto expected = reference.generate(desc, level0.data(), &result);
+  ASSERT_TRUE(result.isOk()) << result.message;
+
+  // the same workers serve repeated calls, including concurrent ones
+  const iglu::textureloader::MipmapGenerator generator(iglu::textureloader::MipmapFilter::Box, 4);
+  std::vector<std::unique_ptr<iglu::textureloader::IData>> outputs(8);
+  std::vector<std::thread> callers;
+  for (size_t i = 0; i < 2; ++i) {
+    callers.emplace_back([&, i]() {
+      for (size_t j = i; j < outputs.size(); j += 2) {
+        outputs[j] = generator.generate(desc, level0.data(), nullptr);
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (const auto& output : outputs) {
+    ASSERT_NE(output, nullptr);
+    ASSERT_EQ(output->length(), expected->length());
+    EXPECT_EQ(0, std::memcmp(output->data(), expected->data(), expected->length()));
+  }
+}
+
+} // namespace igl::tests
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../data/TextureData.h"
+#include "../data/VertexIndexData.h"
+#include "../util/Common.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/NameHandle.h>
+#include <igl/opengl/Buffer.h>
+#include <igl/opengl/Device.h>
+#include <vector>
+
+namespace igl::tests {
+
+#define OFFSCREEN_TEX_WIDTH 4
+#define OFFSCREEN_TEX_HEIGHT 4
+
+//
+// BufferOGLTest
+//
+// Renders a textured quad whose positions come from a ring buffer.
+//
+class BufferOGLTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+
+    Result ret;
+    TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                             OFFSCREEN_TEX_WIDTH,
+                                             OFFSCREEN_TEX_HEIGHT,
+                                             TextureDesc::TextureUsageBits::Sampled |
+                                                 TextureDesc::TextureUsageBits::Attachment);
+    auto offscreenTexture = iglDev_->createTexture(texDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = offscreenTexture;
+    framebuffer_ = iglDev_->createFramebuffer(framebufferDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    renderPass_.colorAttachments.resize(1);
+    renderPass_.colorAttachments[0].loadAction = LoadAction::Clear;
+    renderPass_.colorAttachments[0].storeAction = StoreAction::Store;
+    renderPass_.colorAttachments[0].clearColor = {0.0, 0.0, 0.0, 0.0};
+
+    texDesc.usage = TextureDesc::TextureUsageBits::Sampled;
+    texture_ = iglDev_->createTexture(texDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+    texture_->upload(TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT),
+                     data::texture::TEX_RGBA_GRAY_4x4);
+    samplerState_ = iglDev_->createSamplerState(SamplerStateDesc(), &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    VertexInputStateDesc inputDesc;
+    inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+    inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+    inputDesc.attributes[0].name = data::shader::simplePos;
+    inputDesc.attributes[0].location = 0;
+    inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+    inputDesc.attributes[1].format = VertexAttributeFormat::Float2;
+    inputDesc.attributes[1].bufferIndex = data::shader::simpleUvIndex;
+    inputDesc.attributes[1].name = data::shader::simpleUv;
+    inputDesc.attributes[1].location = 1;
+    inputDesc.inputBindings[1].stride = sizeof(float) * 2;
+    inputDesc.numAttributes = inputDesc.numInputBindings = 2;
+
+    std::unique_ptr<IShaderStages> stages;
+    util::createSimpleShaderStages(iglDev_, stages);
+
+    RenderPipelineDesc pipelineDesc;
+    pipelineDesc.vertexInputState = iglDev_->createVertexInputState(inputDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+    pipelineDesc.shaderStages = std::move(stages);
+    pipelineDesc.targetDesc.colorAttachments.resize(1);
+    pipelineDesc.targetDesc.colorAttachments[0].textureFormat = offscreenTexture->getFormat();
+    pipelineDesc.fragmentUnitSamplerMap[0] = IGL_NAMEHANDLE(data::shader::simpleSampler);
+    pipelineDesc.cullMode = CullMode::Disabled;
+    pipelineState_ = iglDev_->createRenderPipeline(pipelineDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    uv_ = iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                           data::vertex_index::QUAD_UV,
+                                           sizeof(data::vertex_index::QUAD_UV)),
+                                &ret);
+    ASSERT_TRUE(ret.isOk());
+    vb_ = iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                           data::vertex_index::QUAD_VERT,
+                                           sizeof(data::vertex_index::QUAD_VERT),
+                                           ResourceStorage::Shared,
+                                           BufferDesc::BufferAPIHintBits::Ring),
+                                &ret);
+    ASSERT_TRUE(ret.isOk());
+  }
+
+  void render() {
+    Result ret;
+    auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(cmdBuf != nullptr);
+    auto encoder = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_);
+    encoder->bindTexture(0, BindTarget::kFragment, texture_.get());
+    encoder->bindSamplerState(0, BindTarget::kFragment, samplerState_.get());
+    encoder->bindVertexBuffer(data::shader::simplePosIndex, vb_);
+    encoder->bindVertexBuffer(data::shader::simpleUvIndex, uv_);
+    encoder->bindRenderPipelineState(pipelineState_);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    encoder->endEncoding();
+    cmdQueue_->submit(*cmdBuf);
+  }
+
+  void verifyFramebuffer(uint32_t expectedPixel) {
+    std::vector<uint32_t> pixels(OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT);
+    framebuffer_->copyBytesColorAttachment(
+        *cmdQueue_,
+        0,
+        pixels.data(),
+        TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT));
+    for (const uint32_t pixel : pixels) {
+      ASSERT_EQ(pixel, expectedPixel);
+    }
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+  RenderPassDesc renderPass_;
+  std::shared_ptr<ITexture> texture_;
+  std::shared_ptr<ISamplerState> samplerState_;
+  std::shared_ptr<IRenderPipelineState> pipelineState_;
+  std::shared_ptr<IBuffer> vb_;
+  std::shared_ptr<IBuffer> uv_;
+};
+
+TEST_F(BufferOGLTest, RingBufferUpload) {
+  const auto& ringBuffer = static_cast<const opengl::ArrayBuffer&>(*vb_);
+  if (ringBuffer.getNumRingRegions() == 0) {
+    GTEST_SKIP() << "Ring buffers are not supported";
+  }
+  EXPECT_EQ(ringBuffer.acceptedApiHints(), BufferDesc::BufferAPIHintBits::Ring);
+
+  // no draws read the buffer yet, so it is written in place
+  const GLuint initialId = ringBuffer.getId();
+  ASSERT_TRUE(vb_->upload(data::vertex_index::QUAD_VERT, BufferRange(sizeof(float) * 4)).isOk());
+  EXPECT_EQ(ringBuffer.getId(), initialId);
+
+  render();
+  verifyFramebuffer(data::texture::TEX_RGBA_GRAY_4x4[0]);
+
+  // move the quad off screen
+  std::vector<float> offscreenQuad(std::begin(data::vertex_index::QUAD_VERT),
+                                   std::end(data::vertex_index::QUAD_VERT));
+  for (size_t i = 0; i < offscreenQuad.size(); i += 4) {
+    offscreenQuad[i] += 4.0f;
+  }
+  ASSERT_TRUE(vb_->upload(offscreenQuad.data(), BufferRange(vb_->getSizeInBytes())).isOk());
+  EXPECT_NE(ringBuffer.getId(), initialId);
+
+  render();
+  verifyFramebuffer(0u);
+
+  // a partial upload keeps the rest of the previous contents
+  const size_t lastVertexOffset = sizeof(float) * 12;
+  ASSERT_TRUE(vb_->upload(data::vertex_index::QUAD_VERT, BufferRange(lastVertexOffset)).isOk());
+  ASSERT_TRUE(vb_->upload(data::vertex_index::QUAD_VERT + 12,
+                          BufferRange(sizeof(float) * 4, lastVertexOffset))
+                  .isOk());
+  render();
+  verifyFramebuffer(data::texture::TEX_RGBA_GRAY_4x4[0]);
+
+  // collapse the second triangle by moving the last vertex onto the third one
+  ASSERT_TRUE(vb_->upload(data::vertex_index::QUAD_VERT + 8,
+                          BufferRange(sizeof(float) * 4, lastVertexOffset))
+                  .isOk());
+  render();
+  // half of the quad is still on screen
+  std::vector<uint32_t> pixels(OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT);
+  framebuffer_->copyBytesColorAttachment(
+      *cmdQueue_,
+      0,
+      pixels.data(),
+      TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT));
+  EXPECT_NE(std::count(pixels.begin(), pixels.end(), data::texture::TEX_RGBA_GRAY_4x4[0]), 0);
+  EXPECT_NE(std::count(pixels.begin(), pixels.end(), 0u), 0);
+
+  EXPECT_GE(ringBuffer.getNumRingRegions(), 3u);
+  EXPECT_LE(ringBuffer.getNumRingRegions(), 8u);
+}
+
+TEST_F(BufferOGLTest, RingBufferUploadBetweenDraws) {
+  const auto& ringBuffer = static_cast<const opengl::ArrayBuffer&>(*vb_);
+  if (ringBuffer.getNumRingRegions() == 0) {
+    GTEST_SKIP() << "Ring buffers are not supported";
+  }
+
+  std::vector<float> offscreenQuad(std::begin(data::vertex_index::QUAD_VERT),
+                                   std::end(data::vertex_index::QUAD_VERT));
+  for (size_t i = 0; i < offscreenQuad.size(); i += 4) {
+    offscreenQuad[i] += 4.0f;
+  }
+  ASSERT_TRUE(vb_->upload(offscreenQuad.data(), BufferRange(vb_->getSizeInBytes())).isOk());
+
+  Result ret;
+  auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+  ASSERT_TRUE(cmdBuf != nullptr);
+  auto encoder = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_);
+  encoder->bindTexture(0, BindTarget::kFragment, texture_.get());
+  encoder->bindSamplerState(0, BindTarget::kFragment, samplerState_.get());
+  encoder->bindVertexBuffer(data::shader::simplePosIndex, vb_);
+  encoder->bindVertexBuffer(data::shader::simpleUvIndex, uv_);
+  encoder->bindRenderPipelineState(pipelineState_);
+  // none of the fences are signaled before the commands are flushed, so the ring has to grow and
+  // then replace the storage of its regions instead of waiting on them
+  for (size_t i = 0; i != 20; i++) {
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    const float* vertices = i + 1 == 20 ? data::vertex_index::QUAD_VERT : offscreenQuad.data();
+    ASSERT_TRUE(vb_->upload(vertices, BufferRange(vb_->getSizeInBytes())).isOk());
+  }
+  // the vertex buffer is not bound again, the encoder notices it moved to another GL buffer
+  encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+  encoder->endEncoding();
+  cmdQueue_->submit(*cmdBuf);
+
+  verifyFramebuffer(data::texture::TEX_RGBA_GRAY_4x4[0]);
+  EXPECT_LE(ringBuffer.getNumRingRegions(), 8u);
+}
+
+TEST_F(BufferOGLTest, UniformBlockArenaWrite) {
+  auto& context = static_cast<opengl::Device&>(*iglDev_).getContext();
+  auto arena = context.getUniformBlockArena();
+  if (arena == nullptr) {
+    GTEST_SKIP() << "Uniform blocks are not supported";
+  }
+  EXPECT_EQ(arena->getType(), opengl::Buffer::Type::UniformBlock);
+  EXPECT_EQ(context.getUniformBlockArena(), arena);
+
+  const float block[5] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+  size_t firstOffset = 0;
+  size_t secondOffset = 0;
+  ASSERT_TRUE(arena->write(block, sizeof(block), firstOffset));
+  ASSERT_TRUE(arena->write(block, sizeof(block), secondOffset));
+  EXPECT_EQ(firstOffset % arena->getAlignment(), 0u);
+  EXPECT_EQ(secondOffset % arena->getAlignment(), 0u);
+  EXPECT_GE(secondOffset, firstOffset + sizeof(block));
+
+  Result ret;
+  const auto* data = static_cast<const float*>(
+      arena->map(BufferRange(sizeof(block), secondOffset), &ret));
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_TRUE(std::equal(std::begin(block), std::end(block), data));
+  arena->unmap();
+
+  // after the draw, a block that does not fit in the rest of the arena starts over in orphaned
+  // storage
+  arena->endDraw();
+  std::vector<uint8_t> largeBlock(arena->getSizeInBytes() - secondOffset, 0xff);
+  size_t largeOffset = 0;
+  ASSERT_TRUE(arena->write(largeBlock.data(), largeBlock.size(), largeOffset));
+  EXPECT_EQ(largeOffset, 0u);
+
+  largeBlock.resize(arena->getSizeInBytes() + 1);
+  EXPECT_FALSE(arena->write(largeBlock.data(), largeBlock.size(), largeOffset));
+}
+
+TEST_F(BufferOGLTest, UniformBlockArenaKeepsBlocksOfDraw) {
+  auto& context = static_cast<opengl::Device&>(*iglDev_).getContext();
+  auto arena = context.getUniformBlockArena();
+  if (arena == nullptr) {
+    GTEST_SKIP() << "Uniform blocks are not supported";
+  }
+
+  // leave room for the first block of a draw but not for the second one
+  const float blockA[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const float blockB[4] = {5.0f, 6.0f, 7.0f, 8.0f};
+  const size_t drawSize = arena->alignUp(sizeof(blockA)) + arena->alignUp(sizeof(blockB));
+  std::vector<uint8_t> filler(arena->getSizeInBytes() - drawSize + arena->getAlignment(), 0xff);
+  size_t offset = 0;
+  ASSERT_TRUE(arena->write(filler.data(), filler.size(), offset));
+  arena->endDraw();
+
+  // the storage is orphaned between the blocks of one draw, which keeps the first one in place
+  size_t offsetA = 0;
+  size_t offsetB = 0;
+  ASSERT_TRUE(arena->write(blockA, sizeof(blockA), offsetA));
+  ASSERT_TRUE(arena->write(blockB, sizeof(blockB), offsetB));
+  EXPECT_EQ(offsetA, arena->alignUp(filler.size()));
+  EXPECT_EQ(offsetB, 0u);
+
+  Result ret;
+  const auto* data = static_cast<const float*>(
+      arena->map(BufferRange(arena->getSizeInBytes(), 0), &ret));
+  ASSERT_TRUE(ret.isOk());
+  EXPECT_TRUE(std::equal(std::begin(blockA), std::end(blockA), data + offsetA / sizeof(float)));
+  EXPECT_TRUE(std::equal(std::begin(blockB), std::end(blockB), data + offsetB / sizeof(float)));
+  arena->unmap();
+
+  // the blocks of the next draw go between the two, block A is still in use
+  arena->endDraw();
+  ASSERT_TRUE(arena->write(blockB, sizeof(blockB), offset));
+  EXPECT_EQ(offset, arena->alignUp(sizeof(blockB)));
+  arena->endDraw();
+  // a block that does not fit in front of block A starts over in orphaned storage
+  std::vector<uint8_t> largeBlock(offsetA, 0xff);
+  ASSERT_TRUE(arena->write(largeBlock.data(), largeBlock.size(), offset));
+  EXPECT_EQ(offset, 0u);
+
+  // the blocks of one draw cannot move once written
+  largeBlock.resize(arena->getSizeInBytes() - arena->getAlignment());
+  EXPECT_FALSE(arena->write(largeBlock.data(), largeBlock.size(), offset));
+}
+
+} // namespace igl::tests
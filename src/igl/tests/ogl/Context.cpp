@@ -7,12 +7,15 @@
 
 #include "../util/TestDevice.h"
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <igl/Macros.h>
+#include <igl/opengl/ApiTrace.h>
 #include <igl/opengl/Device.h>
 #include <igl/opengl/GLIncludes.h>
 #include <igl/opengl/IContext.h>
 #include <igl/opengl/Texture.h>
+#include <vector>
 
 #define DUMMY_FILE_NAME "dummy_file_name"
 #define DUMMY_LINE_NUM 0
@@ -215,6 +218,52 @@ TEST_F(ContextOGLTest, CheckForErrorsInvalidEnum) {
   ASSERT_EQ(ret, GL_INVALID_ENUM);
 }
 
+/// With sampled error checks, an error is only found by the call that checks for it.
+TEST_F(ContextOGLTest, CheckForErrorsSampled) {
+  context_->setErrorCheckMode(opengl::IContext::ErrorCheckMode::Sampled, 3);
+  ASSERT_EQ(context_->getErrorCheckMode(), opengl::IContext::ErrorCheckMode::Sampled);
+
+  // GL_INVALID_ENUM
+  context_->activeTexture(GL_SRC_ALPHA);
+  context_->enable(GL_BLEND);
+  EXPECT_TRUE(context_->getLastError().isOk());
+  context_->disable(GL_BLEND);
+  EXPECT_EQ(context_->getLastError().code, Result::Code::ArgumentInvalid);
+
+  context_->setErrorCheckMode(opengl::IContext::ErrorCheckMode::EncoderBoundaries);
+  context_->activeTexture(GL_SRC_ALPHA);
+  context_->checkForEncoderErrors(DUMMY_FILE_NAME);
+  EXPECT_EQ(context_->getLastError().code, Result::Code::ArgumentInvalid);
+  context_->checkForEncoderErrors(DUMMY_FILE_NAME);
+  EXPECT_TRUE(context_->getLastError().isOk());
+}
+
+TEST_F(ContextOGLTest, ApiTrace) {
+  EXPECT_EQ(context_->getApiTrace(), nullptr);
+  context_->setApiTraceCapacity(2);
+  const opengl::ApiTrace* trace = context_->getApiTrace();
+  ASSERT_NE(trace, nullptr);
+
+  context_->enable(GL_BLEND);
+  context_->clearColor(0.5f, 0.0f, 0.0f, 1.0f);
+  context_->viewport(0, 0, 8, 4);
+
+  // only the last two calls are kept
+  ASSERT_EQ(trace->size(), 2u);
+  const opengl::ApiTrace::Record& clearColor = trace->getRecord(0);
+  EXPECT_STREQ(clearColor.name, "glClearColor");
+  EXPECT_EQ(clearColor.numArgs, 4u);
+  EXPECT_EQ(clearColor.argTypes[0], opengl::ApiTrace::ArgType::Float);
+  const opengl::ApiTrace::Record& viewport = trace->getRecord(1);
+  EXPECT_EQ(viewport.callIndex, clearColor.callIndex + 1);
+  EXPECT_EQ(trace->toString(),
+            "#" + std::to_string(clearColor.callIndex) + " glClearColor(0.5, 0, 0, 1)\n#" +
+                std::to_string(viewport.callIndex) + " glViewport(0, 0, 8, 4)\n");
+
+  context_->setApiTraceCapacity(0);
+  EXPECT_EQ(context_->getApiTrace(), nullptr);
+}
+
 #ifndef GL_UNSIGNED_SHORT_4_4_4_4
 #define GL_UNSIGNED_SHORT_4_4_4_4 0x8033
 #endif
@@ -312,6 +361,55 @@ TEST_F(ContextOGLTest, CheckForErrorsInvalidFrameBufferOperation) {
   context_->deleteFramebuffers(1, &frameBuffer);
 }
 
+/// Textures deleted while the context is not current are deleted when it becomes current again.
+TEST_F(ContextOGLTest, DeletionQueue) {
+  std::vector<GLuint> textures(200);
+  context_->genTextures(static_cast<GLsizei>(textures.size()), textures.data());
+  for (const GLuint texture : textures) {
+    context_->bindTexture(GL_TEXTURE_2D, texture);
+  }
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+
+  context_->setDeletionQueueFlushBudget(std::chrono::microseconds(1));
+  context_->clearCurrentContext();
+  context_->deleteTextures(textures);
+  EXPECT_EQ(context_->getPendingDeletionCount(), textures.size());
+
+  // the budget runs out before all the textures are deleted
+  context_->setCurrent();
+  EXPECT_GT(context_->getPendingDeletionCount(), 0u);
+  EXPECT_LT(context_->getPendingDeletionCount(), textures.size());
+  for (size_t i = 0; i < textures.size() && context_->getPendingDeletionCount() > 0; ++i) {
+    context_->flushDeletionQueue();
+  }
+  EXPECT_EQ(context_->getPendingDeletionCount(), 0u);
+  EXPECT_EQ(context_->isTexture(textures.back()), GL_FALSE);
+}
+
+TEST_F(ContextOGLTest, DeletionQueueDeferredUntilGpuIsDone) {
+  if (!context_->deviceFeatures().hasInternalFeature(opengl::InternalFeatures::Sync)) {
+    GTEST_SKIP() << "Fences are not supported";
+  }
+  GLuint texture = 0;
+  context_->genTextures(1, &texture);
+  context_->bindTexture(GL_TEXTURE_2D, texture);
+  context_->bindTexture(GL_TEXTURE_2D, 0);
+
+  context_->setShouldDeferDeletionsUntilGpuIsDone(true);
+  context_->clearCurrentContext();
+  context_->deleteTextures({texture});
+
+  // the flush that picks the texture up only inserts a fence
+  context_->setCurrent();
+  EXPECT_EQ(context_->getPendingDeletionCount(), 1u);
+  EXPECT_EQ(context_->isTexture(texture), GL_TRUE);
+
+  context_->finish();
+  context_->flushDeletionQueue();
+  EXPECT_EQ(context_->getPendingDeletionCount(), 0u);
+  EXPECT_EQ(context_->isTexture(texture), GL_FALSE);
+}
+
 /// Verify that an object is visible across contexts in the same sharegroup
 TEST_F(ContextOGLTest, BasicSharedContexts) {
 #if IGL_PLATFORM_WIN && !IGL_ANGLE
@@ -10,9 +10,12 @@
 #include "../util/Common.h"
 #include "../util/TestDevice.h"
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
+#include <igl/opengl/Device.h>
 #include <igl/opengl/RenderPipelineState.h>
+#include <thread>
 #include <utility>
 
 namespace igl {
@@ -112,7 +115,12 @@ class PipelineStateOGLTest : public ::testing::Test {
     renderPipelineDesc_.targetDesc.colorAttachments[0].blendEnabled = true;
   }
 
-  void TearDown() override {}
+  void TearDown() override {
+    if (iglDev_) {
+      // tests enabling async compilation must not leak it into other tests if an ASSERT fails
+      static_cast<opengl::Device&>(*iglDev_).getContext().setShouldCompileShadersAsync(false);
+    }
+  }
 
   // Member variables
  public:
@@ -170,6 +178,178 @@ TEST_F(PipelineStateOGLTest, GetIndexByName) {
   ASSERT_NE(idx, -1);
 }
 
+//
+// AsyncCompilation
+//
+// This test creates a pipeline without waiting for its program to link and polls isReady()
+// until the driver is done.
+//
+TEST_F(PipelineStateOGLTest, AsyncCompilation) {
+  auto& context = static_cast<opengl::Device&>(*iglDev_).getContext();
+  context.setShouldCompileShadersAsync(true);
+  if (!context.shouldCompileShadersAsync()) {
+    GTEST_SKIP() << "GL_KHR_parallel_shader_compile is not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  igl::tests::util::createSimpleShaderStages(iglDev_, stages);
+  shaderStages_ = std::move(stages);
+  renderPipelineDesc_.shaderStages = shaderStages_;
+
+  Result ret;
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  for (int i = 0; i != 1000 && !pipelineState->isReady(); i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(pipelineState->isReady());
+
+  EXPECT_NE(pipelineState->getIndexByName(igl::genNameHandle(data::shader::simplePos),
+                                          igl::ShaderStage::Fragment),
+            -1);
+  EXPECT_TRUE(static_cast<opengl::ShaderStages&>(*shaderStages_).waitUntilReady().isOk());
+}
+
+//
+// AsyncCompilationLookupBeforeReady
+//
+// Name lookups on a pipeline whose program is still linking wait for the link to finish instead
+// of returning -1.
+//
+TEST_F(PipelineStateOGLTest, AsyncCompilationLookupBeforeReady) {
+  auto& context = static_cast<opengl::Device&>(*iglDev_).getContext();
+  context.setShouldCompileShadersAsync(true);
+  if (!context.shouldCompileShadersAsync()) {
+    GTEST_SKIP() << "GL_KHR_parallel_shader_compile is not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  igl::tests::util::createSimpleShaderStages(iglDev_, stages);
+  shaderStages_ = std::move(stages);
+  renderPipelineDesc_.shaderStages = shaderStages_;
+
+  Result ret;
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  // no isReady() polling before the lookups
+  EXPECT_NE(pipelineState->getIndexByName(igl::genNameHandle(data::shader::simplePos),
+                                          igl::ShaderStage::Fragment),
+            -1);
+  EXPECT_NE(pipelineState->getIndexByName(std::string(data::shader::simpleSampler),
+                                          igl::ShaderStage::Fragment),
+            -1);
+  EXPECT_TRUE(pipelineState->isReady());
+}
+
+//
+// AsyncCompilationError
+//
+// Compile errors are not reported when creating shader modules and stages in async mode; they
+// surface once the program is linked.
+//
+TEST_F(PipelineStateOGLTest, AsyncCompilationError) {
+  auto& context = static_cast<opengl::Device&>(*iglDev_).getContext();
+  context.setShouldCompileShadersAsync(true);
+  if (!context.shouldCompileShadersAsync()) {
+    GTEST_SKIP() << "GL_KHR_parallel_shader_compile is not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  igl::tests::util::createShaderStages(iglDev_,
+                                       data::shader::OGL_SIMPLE_VERT_SHADER,
+                                       "vertexShader",
+                                       "void main() { syntax error }",
+                                       "fragmentShader",
+                                       stages);
+  ASSERT_TRUE(stages != nullptr);
+  shaderStages_ = std::move(stages);
+  renderPipelineDesc_.shaderStages = shaderStages_;
+
+  Result ret;
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  auto& glShaderStages = static_cast<opengl::ShaderStages&>(*shaderStages_);
+  if (!ret.isOk()) {
+    // the driver linked the program before the pipeline was created
+    EXPECT_FALSE(glShaderStages.waitUntilReady().isOk());
+  } else {
+    ASSERT_TRUE(pipelineState != nullptr);
+    EXPECT_FALSE(glShaderStages.waitUntilReady().isOk());
+    EXPECT_TRUE(pipelineState->isReady());
+    EXPECT_EQ(pipelineState->getIndexByName(igl::genNameHandle(data::shader::simplePos),
+                                            igl::ShaderStage::Fragment),
+              -1);
+  }
+  EXPECT_EQ(glShaderStages.getProgramID(), 0u);
+}
+
+//
+// VertexArrayCache
+//
+// This test checks that pipelines reuse vertex array objects for the same vertex buffers and
+// evict the ones referencing destroyed buffers.
+//
+TEST_F(PipelineStateOGLTest, VertexArrayCache) {
+  auto& context = static_cast<opengl::Device&>(*iglDev_).getContext();
+  if (!context.deviceFeatures().hasInternalFeature(opengl::InternalFeatures::VertexArrayObject)) {
+    GTEST_SKIP() << "Vertex array objects are not supported";
+  }
+
+  std::unique_ptr<IShaderStages> stages;
+  igl::tests::util::createSimpleShaderStages(iglDev_, stages);
+  shaderStages_ = std::move(stages);
+  renderPipelineDesc_.shaderStages = shaderStages_;
+  renderPipelineDesc_.targetDesc.colorAttachments[0].blendEnabled = false;
+
+  Result ret;
+  auto pipelineState = iglDev_->createRenderPipeline(renderPipelineDesc_, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  auto createBuffer = [this](const void* data, size_t length) {
+    Result ret;
+    std::shared_ptr<IBuffer> buffer =
+        iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex, data, length), &ret);
+    EXPECT_TRUE(ret.isOk());
+    return buffer;
+  };
+  auto vbA = createBuffer(data::vertex_index::QUAD_VERT, sizeof(data::vertex_index::QUAD_VERT));
+  auto vbB = createBuffer(data::vertex_index::QUAD_VERT, sizeof(data::vertex_index::QUAD_VERT));
+  auto uv = createBuffer(data::vertex_index::QUAD_UV, sizeof(data::vertex_index::QUAD_UV));
+  ASSERT_TRUE(vbA && vbB && uv);
+
+  auto draw = [&](const std::shared_ptr<IBuffer>& vb) {
+    Result ret;
+    auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+    ASSERT_TRUE(cmdBuf != nullptr);
+    auto encoder = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_);
+    encoder->bindVertexBuffer(data::shader::simplePosIndex, vb);
+    encoder->bindVertexBuffer(data::shader::simpleUvIndex, uv);
+    encoder->bindRenderPipelineState(pipelineState);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    encoder->endEncoding();
+    cmdQueue_->submit(*cmdBuf);
+  };
+
+  auto& glPipelineState = static_cast<opengl::RenderPipelineState&>(*pipelineState);
+
+  draw(vbA);
+  EXPECT_EQ(glPipelineState.getNumCachedVertexArrays(), 1u);
+  draw(vbB);
+  EXPECT_EQ(glPipelineState.getNumCachedVertexArrays(), 2u);
+  draw(vbA);
+  EXPECT_EQ(glPipelineState.getNumCachedVertexArrays(), 2u);
+
+  vbA.reset();
+  auto vbC = createBuffer(data::vertex_index::QUAD_VERT, sizeof(data::vertex_index::QUAD_VERT));
+  draw(vbC);
+  EXPECT_EQ(glPipelineState.getNumCachedVertexArrays(), 2u);
+}
+
 // Test static conversions from IGL ops to OGL ops
 TEST_F(PipelineStateOGLTest, ConvertOps) {
   //----------------
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../util/Common.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/opengl/Device.h>
+#include <igl/opengl/ProgramBinaryCache.h>
+#include <igl/opengl/Shader.h>
+
+namespace igl::tests {
+
+class ProgramBinaryCacheOGLTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    context_ = &static_cast<opengl::Device&>(*iglDev_).getContext();
+
+    directory_ = std::filesystem::temp_directory_path() / "igl_program_binary_cache_test";
+    std::filesystem::remove_all(directory_);
+    std::filesystem::create_directories(directory_);
+
+    cache_ = std::make_shared<opengl::ProgramBinaryCache>(directory_.string());
+    context_->setProgramBinaryCache(cache_);
+  }
+
+  void TearDown() override {
+    context_->setProgramBinaryCache(nullptr);
+    std::filesystem::remove_all(directory_);
+  }
+
+  GLuint createProgram() {
+    std::unique_ptr<IShaderStages> stages;
+    util::createShaderStages(iglDev_,
+                             data::shader::OGL_SIMPLE_VERT_SHADER,
+                             "vertexShader",
+                             data::shader::OGL_SIMPLE_FRAG_SHADER,
+                             "fragmentShader",
+                             stages);
+    if (stages == nullptr) {
+      return 0;
+    }
+    GLint status = GL_FALSE;
+    const GLuint programID = static_cast<opengl::ShaderStages&>(*stages).getProgramID();
+    context_->getProgramiv(programID, GL_LINK_STATUS, &status);
+    return status == GL_TRUE ? programID : 0;
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  opengl::IContext* context_ = nullptr;
+  std::filesystem::path directory_;
+  std::shared_ptr<opengl::ProgramBinaryCache> cache_;
+};
+
+TEST_F(ProgramBinaryCacheOGLTest, StoreAndLoad) {
+  if (!cache_->isSupported(*context_)) {
+    GTEST_SKIP() << "Program binaries are not supported";
+  }
+
+  ASSERT_NE(createProgram(), 0u);
+  EXPECT_EQ(cache_->getStats().numMisses, 1u);
+  EXPECT_EQ(cache_->getStats().numStored, 1u);
+
+  ASSERT_NE(createProgram(), 0u);
+  EXPECT_EQ(cache_->getStats().numHits, 1u);
+  EXPECT_EQ(cache_->getStats().numStored, 1u);
+}
+
+TEST_F(ProgramBinaryCacheOGLTest, CorruptedFileFallsBackToLinking) {
+  if (!cache_->isSupported(*context_)) {
+    GTEST_SKIP() << "Program binaries are not supported";
+  }
+
+  ASSERT_NE(createProgram(), 0u);
+  ASSERT_EQ(cache_->getStats().numStored, 1u);
+
+  // flip a byte of the binary after the header
+  for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+    std::fstream file(entry.path(), std::ios::binary | std::ios::in | std::ios::out);
+    file.seekg(-1, std::ios::end);
+    const char c = static_cast<char>(file.get() ^ 0xff);
+    file.seekp(-1, std::ios::end);
+    file.put(c);
+  }
+
+  ASSERT_NE(createProgram(), 0u);
+  EXPECT_EQ(cache_->getStats().numHits, 0u);
+  EXPECT_EQ(cache_->getStats().numMisses, 2u);
+  // the corrupted file is replaced
+  EXPECT_EQ(cache_->getStats().numStored, 2u);
+
+  ASSERT_NE(createProgram(), 0u);
+  EXPECT_EQ(cache_->getStats().numHits, 1u);
+}
+
+// Run with --gtest_also_run_disabled_tests.
+TEST_F(ProgramBinaryCacheOGLTest, DISABLED_Benchmark) {
+  constexpr int kNumIterations = 100;
+
+  auto measure = [this]() {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i != kNumIterations; i++) {
+      EXPECT_NE(createProgram(), 0u);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+               .count() /
+           kNumIterations;
+  };
+
+  context_->setProgramBinaryCache(nullptr);
+  const double msUncached = measure();
+
+  context_->setProgramBinaryCache(cache_);
+  ASSERT_NE(createProgram(), 0u);
+  const double msCached = measure();
+
+  IGL_LOG_INFO("Shader stages creation: %.3f ms without cache, %.3f ms with cache (%u hits)\n",
+               msUncached,
+               msCached,
+               cache_->getStats().numHits);
+}
+
+} // namespace igl::tests
@@ -32,12 +32,13 @@ class SamplerStateOGLTest : public ::testing::Test {
     // Turn off debug break so unit tests can run
     igl::setDebugBreakEnabled(false);
 
-    auto device = util::createTestDevice();
-    context_ = &static_cast<opengl::Device&>(*device).getContext();
+    device_ = util::createTestDevice();
+    context_ = &static_cast<opengl::Device&>(*device_).getContext();
 
     ASSERT_TRUE(context_ != nullptr);
   }
 
+  std::shared_ptr<IDevice> device_;
   opengl::IContext* context_;
 };
 
@@ -159,5 +160,40 @@ TEST_F(SamplerStateOGLTest, SamplerStateConvertAddressMode) {
             GL_MIRRORED_REPEAT);
 }
 
+//
+// getSamplerObject tests
+//
+// Sampler states with equal descriptors share one sampler object, except for depth textures whose
+// sampler state is applied to the texture parameters.
+//
+TEST_F(SamplerStateOGLTest, SamplerStateGetSamplerObject) {
+  if (!context_->deviceFeatures().hasInternalFeature(opengl::InternalFeatures::SamplerObjects)) {
+    GTEST_SKIP() << "Sampler objects are not supported";
+  }
+
+  Result ret;
+  auto texture = device_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8, 2, 2, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  opengl::SamplerState linear(*context_, SamplerStateDesc::newLinear());
+  opengl::SamplerState otherLinear(*context_, SamplerStateDesc::newLinear());
+  opengl::SamplerState nearest(*context_, SamplerStateDesc());
+
+  const GLuint samplerObject = linear.getSamplerObject(texture.get());
+  ASSERT_NE(samplerObject, 0u);
+  EXPECT_EQ(otherLinear.getSamplerObject(texture.get()), samplerObject);
+  EXPECT_NE(nearest.getSamplerObject(texture.get()), samplerObject);
+  EXPECT_EQ(context_->getSamplerObjects().size(), 2u);
+
+  auto depthTexture = device_->createTexture(
+      TextureDesc::new2D(TextureFormat::Z_UNorm16, 2, 2, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  if (ret.isOk()) {
+    EXPECT_EQ(linear.getSamplerObject(depthTexture.get()), 0u);
+  }
+}
+
 } // namespace tests
 } // namespace igl
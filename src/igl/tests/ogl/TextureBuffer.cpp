@@ -12,8 +12,11 @@
 #include <igl/IGL.h>
 #include <igl/opengl/CommandQueue.h>
 #include <igl/opengl/Device.h>
+#include <igl/opengl/Framebuffer.h>
+#include <igl/opengl/PixelBuffer.h>
 #include <igl/opengl/TextureBuffer.h>
 #include <string>
+#include <vector>
 
 namespace igl {
 namespace tests {
@@ -131,5 +134,74 @@ TEST_F(TextureBufferOGLTest, TextureMipmapGen) {
   ASSERT_EQ(textureBuffer_->getNumMipLevels(), targetlevel);
 }
 
+//
+// Pixel Buffer Upload and Readback Test
+//
+// Uploads large enough to go through the pixel unpack ring, including more uploads than fit into
+// the ring at once and one with padded rows, then reads them back through a pixel pack buffer.
+//
+TEST_F(TextureBufferOGLTest, PixelBufferUploadAndReadback) {
+  if (context_->getPixelUnpackBufferRing() == nullptr) {
+    GTEST_SKIP() << "Pixel buffer objects are not supported";
+  }
+
+  constexpr size_t kSize = 256;
+  Result ret;
+  auto texture = device_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kSize,
+                         kSize,
+                         TextureDesc::TextureUsageBits::Sampled |
+                             TextureDesc::TextureUsageBits::Attachment),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = device_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto range = TextureRangeDesc::new2D(0, 0, kSize, kSize);
+  std::vector<uint32_t> pixels(kSize * kSize);
+  for (uint32_t i = 0; i != 20; i++) {
+    for (size_t p = 0; p != pixels.size(); p++) {
+      pixels[p] = static_cast<uint32_t>(p) * 32 + i;
+    }
+    ASSERT_TRUE(texture->upload(range, pixels.data()).isOk());
+  }
+
+  // overwrite a sub-rect from rows with padding
+  constexpr size_t kSubSize = 192;
+  constexpr size_t kPaddedWidth = kSubSize + 8;
+  std::vector<uint32_t> subPixels(kPaddedWidth * kSubSize, 0xffffffff);
+  for (size_t y = 0; y != kSubSize; y++) {
+    for (size_t x = 0; x != kSubSize; x++) {
+      subPixels[y * kPaddedWidth + x] = static_cast<uint32_t>(y * kSubSize + x);
+      pixels[(y + 8) * kSize + x + 8] = static_cast<uint32_t>(y * kSubSize + x);
+    }
+  }
+  ASSERT_TRUE(texture
+                  ->upload(TextureRangeDesc::new2D(8, 8, kSubSize, kSubSize),
+                           subPixels.data(),
+                           kPaddedWidth * sizeof(uint32_t))
+                  .isOk());
+
+  auto readback = static_cast<opengl::Framebuffer&>(*framebuffer)
+                      .copyBytesColorAttachmentAsync(0, range, 0, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_TRUE(readback != nullptr);
+  ASSERT_EQ(readback->getSizeInBytes(), pixels.size() * sizeof(uint32_t));
+  std::vector<uint32_t> readPixels(pixels.size());
+  ASSERT_TRUE(readback->copyBytes(readPixels.data()).isOk());
+  EXPECT_TRUE(readback->isReady());
+  EXPECT_EQ(readPixels, pixels);
+
+  // the synchronous path reads the same pixels
+  std::fill(readPixels.begin(), readPixels.end(), 0);
+  auto queue = device_->createCommandQueue({}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  framebuffer->copyBytesColorAttachment(*queue, 0, readPixels.data(), range);
+  EXPECT_EQ(readPixels, pixels);
+}
+
 } // namespace tests
 } // namespace igl
@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "../data/ShaderData.h"
+#include "../data/VertexIndexData.h"
+#include "../util/Common.h"
+
+#include <gtest/gtest.h>
+#include <igl/IGL.h>
+#include <igl/opengl/Device.h>
+#include <igl/opengl/RenderPipelineState.h>
+#include <igl/opengl/UniformAdapter.h>
+#include <igl/opengl/Version.h>
+#include <vector>
+
+namespace igl::tests {
+
+#define OFFSCREEN_TEX_WIDTH 2
+#define OFFSCREEN_TEX_HEIGHT 2
+
+// clang-format off
+const char OGL_POSITION_VERT_SHADER[] =
+    IGL_TO_STRING(attribute vec4 position_in;
+                  void main() {
+                    gl_Position = position_in;
+                  });
+
+const char OGL_COLOR_FRAG_SHADER[] =
+    IGL_TO_STRING(PROLOG
+                  uniform vec4 color;
+                  void main() {
+                    gl_FragColor = color;
+                  });
+// clang-format on
+
+TEST(UniformShadowTest, Update) {
+  const float a[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  const float b[4] = {1.0f, 2.0f, 3.0f, 5.0f};
+  const auto* bytesA = reinterpret_cast<const uint8_t*>(a);
+  const auto* bytesB = reinterpret_cast<const uint8_t*>(b);
+
+  opengl::UniformShadow shadow;
+  EXPECT_TRUE(shadow.update(3, bytesA, sizeof(a)));
+  EXPECT_FALSE(shadow.update(3, bytesA, sizeof(a)));
+  EXPECT_TRUE(shadow.update(3, bytesB, sizeof(b)));
+  EXPECT_TRUE(shadow.update(3, bytesB, sizeof(float)));
+  EXPECT_TRUE(shadow.update(0, bytesB, sizeof(float)));
+  EXPECT_FALSE(shadow.update(3, bytesB, sizeof(float)));
+
+  shadow.invalidate(2, 2);
+  EXPECT_TRUE(shadow.update(3, bytesB, sizeof(float)));
+  EXPECT_FALSE(shadow.update(0, bytesB, sizeof(float)));
+
+  shadow.clear();
+  EXPECT_TRUE(shadow.update(0, bytesB, sizeof(float)));
+}
+
+TEST(UniformShadowTest, NegativeLocation) {
+  setDebugBreakEnabled(false);
+
+  const float a = 1.0f;
+  const auto* bytesA = reinterpret_cast<const uint8_t*>(&a);
+
+  // invalid locations are never recorded, so they are never skipped
+  opengl::UniformShadow shadow;
+  EXPECT_TRUE(shadow.update(-1, bytesA, sizeof(a)));
+  EXPECT_TRUE(shadow.update(-1, bytesA, sizeof(a)));
+  shadow.invalidate(-1, 2);
+  EXPECT_TRUE(shadow.update(0, bytesA, sizeof(a)));
+  EXPECT_FALSE(shadow.update(0, bytesA, sizeof(a)));
+}
+
+//
+// UniformAdapterOGLTest
+//
+// Draws a quad whose color comes from a single uniform with redundant uniforms skipped.
+//
+class UniformAdapterOGLTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    setDebugBreakEnabled(false);
+
+    util::createDeviceAndQueue(iglDev_, cmdQueue_);
+    ASSERT_TRUE(iglDev_ != nullptr);
+    ASSERT_TRUE(cmdQueue_ != nullptr);
+    context_ = &static_cast<opengl::Device&>(*iglDev_).getContext();
+
+    Result ret;
+    const TextureDesc texDesc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                                   OFFSCREEN_TEX_WIDTH,
+                                                   OFFSCREEN_TEX_HEIGHT,
+                                                   TextureDesc::TextureUsageBits::Sampled |
+                                                       TextureDesc::TextureUsageBits::Attachment);
+    auto offscreenTexture = iglDev_->createTexture(texDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    FramebufferDesc framebufferDesc;
+    framebufferDesc.colorAttachments[0].texture = offscreenTexture;
+    framebuffer_ = iglDev_->createFramebuffer(framebufferDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    renderPass_.colorAttachments.resize(1);
+    renderPass_.colorAttachments[0].loadAction = LoadAction::Clear;
+    renderPass_.colorAttachments[0].storeAction = StoreAction::Store;
+
+    VertexInputStateDesc inputDesc;
+    inputDesc.attributes[0].format = VertexAttributeFormat::Float4;
+    inputDesc.attributes[0].bufferIndex = data::shader::simplePosIndex;
+    inputDesc.attributes[0].name = data::shader::simplePos;
+    inputDesc.attributes[0].location = 0;
+    inputDesc.inputBindings[0].stride = sizeof(float) * 4;
+    inputDesc.numAttributes = inputDesc.numInputBindings = 1;
+    vertexInputState_ = iglDev_->createVertexInputState(inputDesc, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    pipelineState_ = createPipeline(OGL_POSITION_VERT_SHADER, OGL_COLOR_FRAG_SHADER);
+    ASSERT_TRUE(pipelineState_ != nullptr);
+
+    vb_ = iglDev_->createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Vertex,
+                                           data::vertex_index::QUAD_VERT,
+                                           sizeof(data::vertex_index::QUAD_VERT)),
+                                &ret);
+    ASSERT_TRUE(ret.isOk());
+  }
+
+  void TearDown() override {
+    context_->setShouldSkipRedundantUniforms(false);
+  }
+
+  std::shared_ptr<IRenderPipelineState> createPipeline(
+      const char* vertexShader,
+      const char* fragmentShader,
+      std::unordered_map<size_t, igl::NameHandle> fragmentUnitSamplerMap = {}) {
+    std::unique_ptr<IShaderStages> stages;
+    util::createShaderStages(iglDev_,
+                             vertexShader,
+                             data::shader::simpleVertFunc,
+                             fragmentShader,
+                             data::shader::simpleFragFunc,
+                             stages);
+    if (stages == nullptr) {
+      return nullptr;
+    }
+
+    RenderPipelineDesc pipelineDesc;
+    pipelineDesc.vertexInputState = vertexInputState_;
+    pipelineDesc.shaderStages = std::move(stages);
+    pipelineDesc.targetDesc.colorAttachments.resize(1);
+    pipelineDesc.targetDesc.colorAttachments[0].textureFormat =
+        framebuffer_->getColorAttachment(0)->getFormat();
+    pipelineDesc.cullMode = CullMode::Disabled;
+    pipelineDesc.fragmentUnitSamplerMap = std::move(fragmentUnitSamplerMap);
+    Result ret;
+    auto pipelineState = iglDev_->createRenderPipeline(pipelineDesc, &ret);
+    return ret.isOk() ? pipelineState : nullptr;
+  }
+
+  // Returns the number of GL calls the render pass made.
+  unsigned int render(const float color[4]) {
+    const unsigned int callCount = context_->getCallCount();
+    Result ret;
+    auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+    auto encoder = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_);
+    encoder->bindVertexBuffer(data::shader::simplePosIndex, vb_);
+    encoder->bindRenderPipelineState(pipelineState_);
+    UniformDesc uniformDesc;
+    uniformDesc.location = pipelineState_->getIndexByName(IGL_NAMEHANDLE("color"),
+                                                          ShaderStage::Fragment);
+    uniformDesc.type = UniformType::Float4;
+    encoder->bindUniform(uniformDesc, color);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    encoder->endEncoding();
+    cmdQueue_->submit(*cmdBuf);
+    return context_->getCallCount() - callCount;
+  }
+
+  uint32_t readPixel() {
+    std::vector<uint32_t> pixels(OFFSCREEN_TEX_WIDTH * OFFSCREEN_TEX_HEIGHT);
+    framebuffer_->copyBytesColorAttachment(
+        *cmdQueue_,
+        0,
+        pixels.data(),
+        TextureRangeDesc::new2D(0, 0, OFFSCREEN_TEX_WIDTH, OFFSCREEN_TEX_HEIGHT));
+    return pixels[0];
+  }
+
+ protected:
+  std::shared_ptr<IDevice> iglDev_;
+  std::shared_ptr<ICommandQueue> cmdQueue_;
+  opengl::IContext* context_ = nullptr;
+  std::shared_ptr<IFramebuffer> framebuffer_;
+  RenderPassDesc renderPass_;
+  std::shared_ptr<IVertexInputState> vertexInputState_;
+  std::shared_ptr<IRenderPipelineState> pipelineState_;
+  std::shared_ptr<IBuffer> vb_;
+};
+
+TEST_F(UniformAdapterOGLTest, SkipRedundantUniforms) {
+  context_->setShouldSkipRedundantUniforms(true);
+
+  const float red[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+  const float green[4] = {0.0f, 1.0f, 0.0f, 1.0f};
+
+  render(red);
+  EXPECT_EQ(readPixel(), 0xff0000ffu);
+
+  // the program still holds red, so the second pass does not call glUniform4fv
+  const unsigned int redundantCalls = render(red);
+  EXPECT_EQ(readPixel(), 0xff0000ffu);
+  const unsigned int changedCalls = render(green);
+  EXPECT_EQ(readPixel(), 0xff00ff00u);
+  EXPECT_EQ(changedCalls, redundantCalls + 1);
+}
+
+TEST_F(UniformAdapterOGLTest, SkipRedundantSamplerUnits) {
+  context_->setShouldSkipRedundantUniforms(true);
+
+  auto pipelineState = createPipeline(data::shader::OGL_SIMPLE_VERT_SHADER,
+                                      data::shader::OGL_SIMPLE_FRAG_SHADER,
+                                      {{0, IGL_NAMEHANDLE(data::shader::simpleSampler)}});
+  ASSERT_TRUE(pipelineState != nullptr);
+
+  Result ret;
+  const uint32_t pixel = 0xff0000ff;
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8, 1, 1, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  ret = texture->upload(TextureRangeDesc::new2D(0, 0, 1, 1), &pixel);
+  ASSERT_TRUE(ret.isOk());
+  auto sampler = iglDev_->createSamplerState(SamplerStateDesc::newLinear(), &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+  auto encoder = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_);
+  encoder->bindVertexBuffer(data::shader::simplePosIndex, vb_);
+  encoder->bindRenderPipelineState(pipelineState);
+  encoder->bindTexture(0, BindTarget::kFragment, texture.get());
+  encoder->bindSamplerState(0, BindTarget::kFragment, sampler.get());
+  encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+  encoder->endEncoding();
+  cmdQueue_->submit(*cmdBuf);
+  EXPECT_EQ(readPixel(), pixel);
+
+  // the sampler unit went through the shadow of the program
+  const int location = pipelineState->getIndexByName(
+      IGL_NAMEHANDLE(data::shader::simpleSampler), ShaderStage::Fragment);
+  ASSERT_GE(location, 0);
+  const GLint unit = 0;
+  EXPECT_FALSE(static_cast<opengl::RenderPipelineState&>(*pipelineState)
+                   .getUniformShadow()
+                   .update(location, reinterpret_cast<const uint8_t*>(&unit), sizeof(unit)));
+}
+
+TEST_F(UniformAdapterOGLTest, PackedUniformBlock) {
+  if (!iglDev_->hasFeature(DeviceFeatures::UniformBlocks)) {
+    GTEST_SKIP() << "Uniform blocks are not supported";
+  }
+  const auto shaderVersion = iglDev_->getShaderVersion();
+  if (shaderVersion.family == ShaderFamily::GlslEs ? shaderVersion.majorVersion < 3
+                                                   : shaderVersion.majorVersion == 1 &&
+                                                         shaderVersion.minorVersion < 40) {
+    GTEST_SKIP() << "Uniform block declarations are not supported";
+  }
+
+  const std::string version = opengl::getStringFromShaderVersion(shaderVersion) + "\n";
+  const std::string vertexShader = version + IGL_TO_STRING(precision highp float;
+                                                           in vec4 position_in;
+                                                           void main() {
+                                                             gl_Position = position_in;
+                                                           });
+  // the mat3 exercises the std140 matrix stride, and the vec4 the offset that follows it
+  const std::string fragmentShader =
+      version + IGL_TO_STRING(precision highp float;
+                              layout(std140) uniform IGLPackedUniforms {
+                                float scale;
+                                mat3 swizzle;
+                                vec4 color;
+                              };
+                              out vec4 fragColor;
+                              void main() {
+                                fragColor = vec4(swizzle * color.rgb * scale, color.a);
+                              });
+  auto pipelineState = createPipeline(vertexShader.c_str(), fragmentShader.c_str());
+  ASSERT_TRUE(pipelineState != nullptr);
+  ASSERT_TRUE(static_cast<opengl::RenderPipelineState&>(*pipelineState).getPackedUniformBlock() !=
+              nullptr);
+
+  auto uniformDesc = [&pipelineState](const char* name, UniformType type) {
+    UniformDesc desc;
+    desc.location = pipelineState->getIndexByName(igl::genNameHandle(name), ShaderStage::Fragment);
+    desc.type = type;
+    return desc;
+  };
+  const auto scaleDesc = uniformDesc("scale", UniformType::Float);
+  const auto swizzleDesc = uniformDesc("swizzle", UniformType::Mat3x3);
+  const auto colorDesc = uniformDesc("color", UniformType::Float4);
+  ASSERT_GE(scaleDesc.location, 0);
+  ASSERT_GE(swizzleDesc.location, 0);
+  ASSERT_GE(colorDesc.location, 0);
+
+  const float scale = 1.0f;
+  // swaps red and green
+  const float swizzle[9] = {0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+  const float red[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+  const float blue[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+
+  auto render = [&](bool setAll, const float color[4]) {
+    Result ret;
+    auto cmdBuf = cmdQueue_->createCommandBuffer({}, &ret);
+    auto encoder = cmdBuf->createRenderCommandEncoder(renderPass_, framebuffer_);
+    encoder->bindVertexBuffer(data::shader::simplePosIndex, vb_);
+    encoder->bindRenderPipelineState(pipelineState);
+    if (setAll) {
+      encoder->bindUniform(scaleDesc, &scale);
+      encoder->bindUniform(swizzleDesc, swizzle);
+    }
+    encoder->bindUniform(colorDesc, color);
+    encoder->draw(PrimitiveType::TriangleStrip, 0, 4);
+    encoder->endEncoding();
+    cmdQueue_->submit(*cmdBuf);
+  };
+
+  render(true, red);
+  EXPECT_EQ(readPixel(), 0xff00ff00u);
+
+  // scale and swizzle keep the values of the previous draw
+  render(false, blue);
+  EXPECT_EQ(readPixel(), 0xffff0000u);
+}
+
+} // namespace igl::tests
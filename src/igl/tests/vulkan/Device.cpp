@@ -5,15 +5,27 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <gtest/gtest.h>
 #include <igl/IGL.h>
 
+#include "../util/Common.h"
 #include "../util/TestDevice.h"
 
 #if IGL_PLATFORM_WIN || IGL_PLATFORM_ANDROID || IGL_PLATFORM_MACOS || IGL_PLATFORM_LINUX
+#include <igl/vulkan/CommandQueue.h>
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/HWDevice.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/TransientAttachmentPool.h>
+#include <igl/vulkan/TransientUniformAllocator.h>
 #include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+#include <igl/vulkan/VulkanMemoryAllocator.h>
+#include <igl/vulkan/VulkanStagingDevice.h>
+#include <igl/vulkan/VulkanTexture.h>
 #endif
 
 namespace igl {
@@ -124,6 +136,323 @@ TEST_F(DeviceVulkanTest, StagingDeviceLargeBufferTest) {
   }
 }
 
+TEST_F(DeviceVulkanTest, MemoryAllocatorSubAllocation) {
+  const igl::vulkan::VulkanContext& ctx =
+      static_cast<igl::vulkan::Device*>(iglDev_.get())->getVulkanContext();
+
+  // exercise the allocator directly so the test also runs when VMA is enabled
+  igl::vulkan::VulkanMemoryAllocator allocator(ctx);
+
+  const VkMemoryRequirements requirements = {64 * 1024, 256, ~0u};
+  const VkMemoryPropertyFlags props =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+  Result ret;
+  std::vector<igl::vulkan::VulkanMemoryAllocator::Allocation> allocations;
+  for (uint32_t i = 0; i != 64; i++) {
+    allocations.push_back(allocator.allocate(requirements, props, true, &ret));
+    ASSERT_TRUE(ret.isOk()) << ret.message;
+    ASSERT_TRUE(allocations.back().valid());
+    ASSERT_NE(allocations.back().mappedPtr, nullptr);
+    ASSERT_EQ(allocations.back().offset % requirements.alignment, 0u);
+  }
+
+  // all small allocations share a single block
+  for (const auto& allocation : allocations) {
+    ASSERT_EQ(allocation.memory, allocations[0].memory);
+    ASSERT_FALSE(allocation.isDedicated);
+  }
+
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  ctx.vf_.vkGetPhysicalDeviceMemoryProperties(ctx.getVkPhysicalDevice(), &memoryProperties);
+  const uint32_t heapIndex = memoryProperties.memoryTypes[allocations[0].memoryTypeIndex].heapIndex;
+  auto budgets = allocator.getHeapBudgets();
+  ASSERT_EQ(budgets[heapIndex].blockCount, 1u);
+  ASSERT_EQ(budgets[heapIndex].allocationCount, 64u);
+  ASSERT_EQ(budgets[heapIndex].allocationBytes, 64 * requirements.size);
+  ASSERT_GT(budgets[heapIndex].budget, 0u);
+
+  // freed neighbours are coalesced and reused
+  const VkDeviceSize offset = allocations[10].offset;
+  allocator.free(allocations[10]);
+  allocator.free(allocations[11]);
+  const VkMemoryRequirements doubleRequirements = {2 * requirements.size, 256, ~0u};
+  allocations[10] = allocator.allocate(doubleRequirements, props, true, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_EQ(allocations[10].offset, offset);
+  allocations.erase(allocations.begin() + 11);
+
+  for (const auto& allocation : allocations) {
+    allocator.free(allocation);
+  }
+
+  budgets = allocator.getHeapBudgets();
+  ASSERT_EQ(budgets[heapIndex].allocationCount, 0u);
+  ASSERT_EQ(budgets[heapIndex].allocationBytes, 0u);
+}
+
+TEST_F(DeviceVulkanTest, TransientAttachmentPoolAliasing) {
+  igl::vulkan::TransientAttachmentPool pool(static_cast<igl::vulkan::Device&>(*iglDev_));
+
+  const TextureDesc desc = TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                                              256,
+                                              256,
+                                              TextureDesc::TextureUsageBits::Attachment |
+                                                  TextureDesc::TextureUsageBits::Sampled,
+                                              "Transient attachment");
+
+  // `a` and `b` have disjoint lifetimes and can share memory, `c` overlaps both
+  const auto declare = [&pool, &desc]() {
+    pool.beginFrame();
+    const auto a = pool.declare(desc, 0, 0);
+    const auto b = pool.declare(desc, 1, 1);
+    const auto c = pool.declare(desc, 0, 1);
+    return std::array<igl::vulkan::TransientAttachmentPool::Handle, 3>{a, b, c};
+  };
+
+  const auto handles = declare();
+  ASSERT_TRUE(pool.compile().isOk());
+  for (auto handle : handles) {
+    ASSERT_NE(pool.getTexture(handle), nullptr);
+  }
+
+  const auto& stats = pool.getStats();
+  ASSERT_EQ(stats.numAttachments, 3u);
+  ASSERT_EQ(stats.numAliased, 2u);
+  ASSERT_EQ(stats.savedBytes(), stats.requestedBytes / 3);
+
+  // identical declarations reuse the textures of the previous frame
+  const std::shared_ptr<ITexture> texture = pool.getTexture(handles[0]);
+  declare();
+  ASSERT_TRUE(pool.compile().isOk());
+  ASSERT_EQ(pool.getTexture(handles[0]), texture);
+
+  Result ret;
+  auto cmdQueue = iglDev_->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  pool.beginPass(*cmdBuffer, 1);
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+}
+
+TEST_F(DeviceVulkanTest, TransientAttachmentPoolTextureOutlivesPool) {
+  auto pool = std::make_unique<igl::vulkan::TransientAttachmentPool>(
+      static_cast<igl::vulkan::Device&>(*iglDev_));
+
+  pool->beginFrame();
+  const auto handle = pool->declare(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         64,
+                         64,
+                         TextureDesc::TextureUsageBits::Attachment |
+                             TextureDesc::TextureUsageBits::Sampled,
+                         "Transient attachment"),
+      0,
+      0);
+  ASSERT_TRUE(pool->compile().isOk());
+  const std::shared_ptr<ITexture> texture = pool->getTexture(handle);
+  ASSERT_NE(texture, nullptr);
+
+  // the texture keeps the memory it is bound to
+  pool.reset();
+
+  Result ret;
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+  renderPass.colorAttachments[0].clearColor = {1.0f, 0.0f, 0.0f, 1.0f};
+
+  auto cmdQueue = iglDev_->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer);
+  ASSERT_TRUE(encoder != nullptr);
+  encoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  std::vector<uint32_t> pixels(64 * 64);
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue, 0, pixels.data(), TextureRangeDesc::new2D(0, 0, 64, 64));
+  ASSERT_EQ(pixels, std::vector<uint32_t>(64 * 64, 0xff0000ffu));
+}
+
+TEST_F(DeviceVulkanTest, BarrierBatching) {
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  Result ret;
+  const auto createTexture = [this, &ret](TextureDesc::TextureUsage usage) {
+    return iglDev_->createTexture(
+        TextureDesc::new2D(TextureFormat::RGBA_UNorm8, 16, 16, usage), &ret);
+  };
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture =
+      createTexture(TextureDesc::TextureUsageBits::Attachment);
+  framebufferDesc.colorAttachments[1].texture =
+      createTexture(TextureDesc::TextureUsageBits::Attachment);
+  auto sampled = createTexture(TextureDesc::TextureUsageBits::Attachment |
+                               TextureDesc::TextureUsageBits::Sampled);
+  ASSERT_TRUE(ret.isOk());
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(2);
+  Dependencies dependencies;
+  dependencies.textures[0] = sampled.get();
+
+  auto cmdQueue = iglDev_->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  const auto before = ctx.barrierStats_;
+  auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer, dependencies, &ret);
+  ASSERT_TRUE(ret.isOk());
+  const auto after = ctx.barrierStats_;
+
+  // the sampled texture and both color attachments are transitioned with a single call
+  ASSERT_EQ(after.numBarriers - before.numBarriers, 3u);
+  ASSERT_EQ(after.numPipelineBarrierCalls - before.numPipelineBarrierCalls, 1u);
+
+  encoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+}
+
+namespace {
+
+// a full-screen triangle, without vertex buffers
+const char kBindBytesVertexShader[] = IGL_TO_STRING(void main() {
+  const vec2 pos = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+  gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+});
+
+// only the last member is read, so the whole range of the constants has to be bound
+const char kBindBytesFragmentShader[] = IGL_TO_STRING(
+    layout(location = 0) out vec4 out_FragColor;
+    layout(set = 1, binding = 0, std140) uniform Constants { vec4 data[64]; } constants;
+
+    void main() { out_FragColor = constants.data[63]; });
+
+struct BindBytesConstants {
+  float data[64][4] = {};
+};
+
+} // namespace
+
+TEST_F(DeviceVulkanTest, BindBytesTransientBlocks) {
+  ASSERT_TRUE(iglDev_->hasFeature(DeviceFeatures::BindBytes));
+
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  // one draw per pixel, with more draws than the first transient block can hold
+  constexpr uint32_t kWidth = 16;
+  const auto numDraws = static_cast<uint32_t>(
+      ctx.transientUniformAllocator_->getBlockSize() / sizeof(BindBytesConstants) + kWidth);
+  const uint32_t height = (numDraws + kWidth - 1) / kWidth;
+  ASSERT_LE(numDraws, 256u);
+
+  Result ret;
+  auto texture = iglDev_->createTexture(
+      TextureDesc::new2D(TextureFormat::RGBA_UNorm8,
+                         kWidth,
+                         height,
+                         TextureDesc::TextureUsageBits::Attachment |
+                             TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  FramebufferDesc framebufferDesc;
+  framebufferDesc.colorAttachments[0].texture = texture;
+  auto framebuffer = iglDev_->createFramebuffer(framebufferDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  std::unique_ptr<IShaderStages> stages;
+  util::createShaderStages(
+      iglDev_, kBindBytesVertexShader, "main", kBindBytesFragmentShader, "main", stages);
+  ASSERT_TRUE(stages != nullptr);
+
+  RenderPipelineDesc pipelineDesc;
+  pipelineDesc.shaderStages = std::move(stages);
+  pipelineDesc.targetDesc.colorAttachments.resize(1);
+  pipelineDesc.targetDesc.colorAttachments[0].textureFormat = texture->getFormat();
+  pipelineDesc.cullMode = CullMode::Disabled;
+  auto pipelineState = iglDev_->createRenderPipeline(pipelineDesc, &ret);
+  ASSERT_TRUE(ret.isOk());
+
+  RenderPassDesc renderPass;
+  renderPass.colorAttachments.resize(1);
+  renderPass.colorAttachments[0].loadAction = LoadAction::Clear;
+  renderPass.colorAttachments[0].storeAction = StoreAction::Store;
+  renderPass.colorAttachments[0].clearColor = {0.0f, 0.0f, 0.0f, 0.0f};
+
+  auto cmdQueue = iglDev_->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto encoder = cmdBuffer->createRenderCommandEncoder(renderPass, framebuffer);
+  ASSERT_TRUE(encoder != nullptr);
+  encoder->bindRenderPipelineState(pipelineState);
+
+  // every draw writes its index into the red channel of its own pixel
+  std::vector<uint32_t> expectedPixels(kWidth * height, 0u);
+  BindBytesConstants constants;
+  for (uint32_t i = 0; i != numDraws; i++) {
+    const uint32_t x = i % kWidth;
+    const uint32_t y = i / kWidth;
+    encoder->bindViewport({(float)x, (float)y, 1.0f, 1.0f, 0.0f, 1.0f});
+    encoder->bindScissorRect({x, y, 1, 1});
+    const float color[4] = {(float)i / 255.0f, 0.0f, 1.0f, 1.0f};
+    std::copy(std::begin(color), std::end(color), constants.data[63]);
+    encoder->bindBytes(0, BindTarget::kFragment, &constants, sizeof(constants));
+    encoder->draw(PrimitiveType::Triangle, 0, 3);
+    expectedPixels[i] = 0xffff0000u | i;
+  }
+  encoder->endEncoding();
+  cmdQueue->submit(*cmdBuffer);
+  cmdBuffer->waitUntilCompleted();
+
+  std::vector<uint32_t> pixels(kWidth * height);
+  framebuffer->copyBytesColorAttachment(
+      *cmdQueue, 0, pixels.data(), TextureRangeDesc::new2D(0, 0, kWidth, height));
+
+  // compare regardless of the orientation of the viewport: each value is unique to one draw
+  std::sort(pixels.begin(), pixels.end());
+  std::sort(expectedPixels.begin(), expectedPixels.end());
+  ASSERT_EQ(pixels, expectedPixels);
+}
+
+TEST_F(DeviceVulkanTest, TransientBlocksRecycledWithoutPresent) {
+  const auto& ctx = static_cast<igl::vulkan::Device&>(*iglDev_).getVulkanContext();
+
+  // small blocks, so every submission fills two of them
+  igl::vulkan::TransientUniformAllocator allocator(ctx, 256);
+  const std::vector<uint8_t> data(allocator.getBlockSize(), 0x42);
+
+  // offscreen-only submissions: SyncManager never moves to another frame
+  for (uint32_t i = 0; i != 8; i++) {
+    const auto& wrapper = ctx.immediate_->acquire();
+    for (uint32_t j = 0; j != 2; j++) {
+      const auto allocation =
+          allocator.allocate(*ctx.immediate_, wrapper.handle_, data.data(), data.size());
+      ASSERT_NE(allocation.buffer, VK_NULL_HANDLE);
+    }
+    ctx.immediate_->wait(ctx.immediate_->submit(wrapper));
+  }
+
+  // the blocks of completed submissions are reused
+  ASSERT_EQ(allocator.getNumBlocks(), 2u);
+}
+
 GTEST_TEST(VulkanContext, BufferDeviceAddress) {
   std::shared_ptr<igl::IDevice> iglDev = nullptr;
 
@@ -251,6 +580,481 @@ GTEST_TEST(VulkanContext, DescriptorIndexing) {
 
   ASSERT_NE(texture->getTextureId(), 0u);
 }
+
+namespace {
+
+/// Creates a device on the first physical device with the configuration used by these tests,
+/// modified by `configure`. Returns nullptr if the device cannot be created.
+std::shared_ptr<IDevice> createDevice(
+    const std::function<void(igl::vulkan::VulkanContextConfig&)>& configure) {
+  igl::vulkan::VulkanContextConfig config;
+#if IGL_PLATFORM_MACOS
+  config.terminateOnValidationError = false;
+#elif IGL_DEBUG
+  config.enableValidation = true;
+  config.terminateOnValidationError = true;
+#else
+  config.enableValidation = true;
+  config.terminateOnValidationError = false;
+#endif
+#ifdef IGL_DISABLE_VALIDATION
+  config.enableValidation = false;
+  config.terminateOnValidationError = false;
+#endif
+  configure(config);
+
+  auto ctx = igl::vulkan::HWDevice::createContext(config, nullptr);
+
+  Result ret;
+  std::vector<HWDeviceDesc> devices = igl::vulkan::HWDevice::queryDevices(
+      *ctx.get(), HWDeviceQueryDesc(HWDeviceType::Unknown), &ret);
+  if (!ret.isOk() || devices.empty()) {
+    return nullptr;
+  }
+  std::shared_ptr<IDevice> iglDev =
+      igl::vulkan::HWDevice::create(std::move(ctx), devices[0], 0, 0, 0, nullptr, &ret);
+  return ret.isOk() ? iglDev : nullptr;
+}
+
+} // namespace
+
+GTEST_TEST(VulkanContext, TimelineSemaphores) {
+  auto iglDev = createDevice([](igl::vulkan::VulkanContextConfig& config) {
+    config.enableExtraLogs = true;
+    config.enableTimelineSemaphores = true;
+  });
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+
+  const igl::vulkan::VulkanContext& vkCtx =
+      static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+  ASSERT_EQ(vkCtx.immediate_->usesTimelineSemaphore(), vkCtx.useTimelineSemaphores_);
+
+  auto cmdQueue = iglDev->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdQueue, nullptr);
+
+  // submit more command buffers than the fixed-size pool of the fence mode can hold
+  const uint32_t kNumSubmits = 2 * igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers;
+
+  for (uint32_t i = 0; i != kNumSubmits; i++) {
+    auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    const SubmitHandle handle = cmdQueue->submit(*cmdBuffer);
+    ASSERT_NE(handle, 0u);
+    if (i + 1 == kNumSubmits) {
+      cmdBuffer->waitUntilCompleted();
+      ASSERT_TRUE(vkCtx.immediate_->isReady(
+          igl::vulkan::VulkanImmediateCommands::SubmitHandle(handle)));
+    }
+  }
+}
+
+//
+// Submission throughput of VulkanImmediateCommands with fences and with a timeline semaphore.
+// Every frame submits more command buffers than the fixed pool of the fence mode holds. On devices
+// without VK_KHR_timeline_semaphore both runs use fences.
+// Run with --gtest_also_run_disabled_tests.
+//
+GTEST_TEST(VulkanContext, DISABLED_TimelineSemaphoresBenchmark) {
+  constexpr uint32_t kNumFrames = 256;
+  constexpr uint32_t kSubmitsPerFrame =
+      2 * igl::vulkan::VulkanImmediateCommands::kMaxCommandBuffers;
+
+  for (const bool enableTimelineSemaphores : {false, true}) {
+    auto iglDev = createDevice([=](igl::vulkan::VulkanContextConfig& config) {
+      config.enableTimelineSemaphores = enableTimelineSemaphores;
+    });
+    ASSERT_NE(iglDev, nullptr);
+
+    const igl::vulkan::VulkanContext& vkCtx =
+        static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+
+    Result ret;
+    auto cmdQueue = iglDev->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<ICommandBuffer> lastCmdBuffer;
+    for (uint32_t frame = 0; frame != kNumFrames; frame++) {
+      // wait for the previous frame before submitting the next one
+      if (lastCmdBuffer) {
+        lastCmdBuffer->waitUntilCompleted();
+      }
+      for (uint32_t i = 0; i != kSubmitsPerFrame; i++) {
+        auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+        ASSERT_TRUE(ret.isOk());
+        cmdQueue->submit(*cmdBuffer);
+        lastCmdBuffer = std::move(cmdBuffer);
+      }
+    }
+    vkCtx.waitIdle();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    IGL_LOG_INFO("Submit %-8s %8.2f us per command buffer\n",
+                 vkCtx.useTimelineSemaphores_ ? "timeline" : "fences",
+                 elapsed.count() * 1e6 / (kNumFrames * kSubmitsPerFrame));
+  }
+}
+
+GTEST_TEST(VulkanContext, BackgroundDeferredTasks) {
+  auto iglDev = createDevice([](igl::vulkan::VulkanContextConfig& config) {
+    config.enableBackgroundDeferredTasks = true;
+    config.deferredTasksBudgetUs = 1;
+  });
+  ASSERT_NE(iglDev, nullptr);
+
+  Result ret;
+
+  igl::vulkan::VulkanContext& vkCtx =
+      static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+
+  auto cmdQueue = iglDev->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(cmdQueue, nullptr);
+
+  constexpr size_t kBufferSize = 64 * 1024;
+  constexpr uint32_t kNumBuffers = 8;
+
+  const auto statsBefore = vkCtx.getDeferredTaskStats();
+
+  for (uint32_t i = 0; i != kNumBuffers; i++) {
+    auto buffer = iglDev->createBuffer(
+        BufferDesc(BufferDesc::BufferTypeBits::Storage, nullptr, kBufferSize), &ret);
+    ASSERT_TRUE(ret.isOk());
+    ASSERT_NE(buffer, nullptr);
+  }
+
+  const auto statsQueued = vkCtx.getDeferredTaskStats();
+  ASSERT_GE(statsQueued.numQueuedTasks, statsBefore.numQueuedTasks + kNumBuffers);
+  ASSERT_GE(statsQueued.queuedBytes, statsBefore.queuedBytes + kNumBuffers * kBufferSize);
+
+  // retire the tasks incrementally by submitting command buffers
+  for (uint32_t i = 0; i != 4; i++) {
+    auto cmdBuffer = cmdQueue->createCommandBuffer(CommandBufferDesc{}, &ret);
+    ASSERT_TRUE(ret.isOk());
+    cmdQueue->submit(*cmdBuffer);
+    cmdBuffer->waitUntilCompleted();
+  }
+
+  vkCtx.waitDeferredTasks();
+
+  const auto statsRetired = vkCtx.getDeferredTaskStats();
+  ASSERT_EQ(statsRetired.numQueuedTasks, 0u);
+  ASSERT_EQ(statsRetired.queuedBytes, 0u);
+  ASSERT_EQ(statsRetired.numBackgroundTasks, 0u);
+  ASSERT_GE(statsRetired.numRetiredTasks, statsBefore.numRetiredTasks + kNumBuffers);
+  ASSERT_GE(statsRetired.retiredBytes, statsBefore.retiredBytes + kNumBuffers * kBufferSize);
+}
+
+GTEST_TEST(VulkanContext, DirectImageUploads) {
+  auto iglDev = createDevice([](igl::vulkan::VulkanContextConfig& config) {
+    config.enableDirectImageUploads = true;
+  });
+  ASSERT_NE(iglDev, nullptr);
+
+  const igl::vulkan::VulkanContext& vkCtx =
+      static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+
+  constexpr uint32_t kSize = 16;
+
+  Result ret;
+  auto texture = iglDev->createTexture(
+      TextureDesc::new2D(
+          TextureFormat::RGBA_UNorm8, kSize, kSize, TextureDesc::TextureUsageBits::Sampled),
+      &ret);
+  ASSERT_TRUE(ret.isOk());
+  ASSERT_NE(texture, nullptr);
+
+  const igl::vulkan::VulkanImage& image =
+      static_cast<igl::vulkan::Texture*>(texture.get())->getVulkanTexture().getVulkanImage();
+  ASSERT_EQ(image.isHostWritable(), vkCtx.useDirectImageUploads_);
+
+  std::vector<uint32_t> pixels(kSize * kSize);
+  for (uint32_t i = 0; i != pixels.size(); i++) {
+    pixels[i] = 0xff000000u | i;
+  }
+  ASSERT_TRUE(texture->upload(TextureRangeDesc::new2D(0, 0, kSize, kSize), pixels.data()).isOk());
+
+  // overwrite a sub-rectangle with a padded source row pitch
+  constexpr uint32_t kSubSize = 4;
+  constexpr uint32_t kSubOffset = 5;
+  constexpr uint32_t kSubPitch = kSubSize + 3;
+  std::vector<uint32_t> subPixels(kSubPitch * kSubSize, 0xff00ff00u);
+  ASSERT_TRUE(texture
+                  ->upload(TextureRangeDesc::new2D(kSubOffset, kSubOffset, kSubSize, kSubSize),
+                           subPixels.data(),
+                           kSubPitch * sizeof(uint32_t))
+                  .isOk());
+  for (uint32_t y = kSubOffset; y != kSubOffset + kSubSize; y++) {
+    for (uint32_t x = kSubOffset; x != kSubOffset + kSubSize; x++) {
+      pixels[y * kSize + x] = 0xff00ff00u;
+    }
+  }
+
+  std::vector<uint32_t> result(kSize * kSize);
+  vkCtx.stagingDevice_->getImageData2D(
+      image.getVkImage(),
+      0,
+      0,
+      VkRect2D{VkOffset2D{0, 0}, VkExtent2D{kSize, kSize}},
+      TextureFormatProperties::fromTextureFormat(TextureFormat::RGBA_UNorm8),
+      image.imageFormat_,
+      image.imageLayout_,
+      result.data(),
+      kSize * sizeof(uint32_t),
+      false);
+  ASSERT_EQ(result, pixels);
+}
+
+//
+// Texture upload throughput with and without direct image uploads. On devices where not all
+// memory is host-visible both runs use the staging buffer.
+// Run with --gtest_also_run_disabled_tests.
+//
+GTEST_TEST(VulkanContext, DISABLED_DirectImageUploadsBenchmark) {
+  constexpr uint32_t kSize = 1024;
+  constexpr uint32_t kIterations = 64;
+
+  const std::vector<uint32_t> pixels(kSize * kSize, 0xff0000ffu);
+
+  for (const bool enableDirectImageUploads : {false, true}) {
+    auto iglDev = createDevice([=](igl::vulkan::VulkanContextConfig& config) {
+      config.enableDirectImageUploads = enableDirectImageUploads;
+    });
+    ASSERT_NE(iglDev, nullptr);
+
+    Result ret;
+    auto texture = iglDev->createTexture(
+        TextureDesc::new2D(
+            TextureFormat::RGBA_UNorm8, kSize, kSize, TextureDesc::TextureUsageBits::Sampled),
+        &ret);
+    ASSERT_TRUE(ret.isOk());
+
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i != kIterations; i++) {
+      texture->upload(TextureRangeDesc::new2D(0, 0, kSize, kSize), pixels.data());
+    }
+    static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext().waitIdle();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    IGL_LOG_INFO("Texture upload %ux%u %-7s %8.1f MB/s\n",
+                 kSize,
+                 kSize,
+                 enableDirectImageUploads ? "direct" : "staging",
+                 static_cast<double>(pixels.size() * sizeof(uint32_t) * kIterations) /
+                     (1024.0 * 1024.0) / elapsed.count());
+  }
+}
+namespace {
+
+// outputData[i] = inputData[i] + 1
+const char kIncrementComputeShader[] = R"(
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+layout (set = 2, binding = 0, std430) readonly buffer Input {
+  uint inputData[];
+};
+layout (set = 2, binding = 1, std430) writeonly buffer Output {
+  uint outputData[];
+};
+
+void main() {
+  outputData[gl_GlobalInvocationID.x] = inputData[gl_GlobalInvocationID.x] + 1u;
+}
+)";
+
+constexpr uint32_t kNumIncrementElements = 256 * 1024;
+
+class IncrementPass {
+ public:
+  explicit IncrementPass(IDevice& device) {
+    Result ret;
+    auto stages = ShaderStagesCreator::fromModuleStringInput(
+        device, kIncrementComputeShader, "main", "Shader Module: increment", &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+    ComputePipelineDesc desc;
+    desc.shaderStages = std::move(stages);
+    desc.buffersMap[0] = genNameHandle("Input");
+    desc.buffersMap[1] = genNameHandle("Output");
+    pipelineState_ = device.createComputePipeline(desc, &ret);
+    EXPECT_TRUE(ret.isOk()) << ret.message;
+  }
+
+  /// Encodes and submits output = input + 1 to `queue`.
+  SubmitHandle submit(ICommandQueue& queue,
+                      const std::shared_ptr<IBuffer>& input,
+                      const std::shared_ptr<IBuffer>& output) const {
+    Result ret;
+    auto cmdBuffer = queue.createCommandBuffer(CommandBufferDesc{}, &ret);
+    EXPECT_TRUE(ret.isOk());
+    auto encoder = cmdBuffer->createComputeCommandEncoder();
+    encoder->bindComputePipelineState(pipelineState_);
+    encoder->bindBuffer(0, input, 0);
+    encoder->bindBuffer(1, output, 0);
+    encoder->dispatchThreadGroups(Dimensions(kNumIncrementElements / 64, 1, 1),
+                                  Dimensions(64, 1, 1));
+    encoder->endEncoding();
+    return queue.submit(*cmdBuffer);
+  }
+
+ private:
+  std::shared_ptr<IComputePipelineState> pipelineState_;
+};
+
+std::shared_ptr<IBuffer> createIncrementBuffer(IDevice& device, const uint32_t* data = nullptr) {
+  Result ret;
+  auto buffer = device.createBuffer(BufferDesc(BufferDesc::BufferTypeBits::Storage,
+                                               data,
+                                               kNumIncrementElements * sizeof(uint32_t),
+                                               ResourceStorage::Shared),
+                                    &ret);
+  EXPECT_TRUE(ret.isOk());
+  return buffer;
+}
+
+std::vector<uint32_t> readIncrementBuffer(IBuffer& buffer) {
+  Result ret;
+  const auto* data = static_cast<const uint32_t*>(
+      buffer.map(BufferRange(kNumIncrementElements * sizeof(uint32_t), 0), &ret));
+  EXPECT_TRUE(ret.isOk());
+  std::vector<uint32_t> values(data, data + kNumIncrementElements);
+  buffer.unmap();
+  return values;
+}
+
+std::shared_ptr<IDevice> createAsyncComputeDevice() {
+  return createDevice(
+      [](igl::vulkan::VulkanContextConfig& config) { config.enableAsyncCompute = true; });
+}
+
+} // namespace
+
+GTEST_TEST(VulkanContext, AsyncComputeSubmit) {
+  auto iglDev = createAsyncComputeDevice();
+  ASSERT_NE(iglDev, nullptr);
+  const igl::vulkan::VulkanContext& vkCtx =
+      static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+
+  Result ret;
+  auto computeQueue =
+      iglDev->createCommandQueue(CommandQueueDesc{CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  const auto& vkComputeQueue = static_cast<const igl::vulkan::CommandQueue&>(*computeQueue);
+  // devices without a separate compute queue family submit to the graphics queue
+  ASSERT_EQ(vkComputeQueue.isAsyncCompute(), vkCtx.computeImmediate_ != nullptr);
+
+  const std::vector<uint32_t> values(kNumIncrementElements, 41u);
+  auto input = createIncrementBuffer(*iglDev, values.data());
+  auto output = createIncrementBuffer(*iglDev);
+
+  const IncrementPass pass(*iglDev);
+  const SubmitHandle handle = pass.submit(*computeQueue, input, output);
+  ASSERT_NE(handle, 0u);
+  if (vkCtx.computeImmediate_) {
+    vkCtx.computeImmediate_->wait(igl::vulkan::VulkanImmediateCommands::SubmitHandle(handle));
+  } else {
+    vkCtx.immediate_->wait(igl::vulkan::VulkanImmediateCommands::SubmitHandle(handle));
+  }
+
+  ASSERT_EQ(readIncrementBuffer(*output), std::vector<uint32_t>(kNumIncrementElements, 42u));
+}
+
+GTEST_TEST(VulkanContext, AsyncComputeWaitsForSubmit) {
+  auto iglDev = createAsyncComputeDevice();
+  ASSERT_NE(iglDev, nullptr);
+  const igl::vulkan::VulkanContext& vkCtx =
+      static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+  if (vkCtx.computeImmediate_) {
+    ASSERT_EQ(vkCtx.computeImmediate_->signalsTimelineSemaphore(), vkCtx.hasTimelineSemaphores_);
+    ASSERT_EQ(vkCtx.immediate_->signalsTimelineSemaphore(), vkCtx.hasTimelineSemaphores_);
+  }
+
+  Result ret;
+  auto graphicsQueue =
+      iglDev->createCommandQueue(CommandQueueDesc{CommandQueueType::Graphics}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto computeQueue =
+      iglDev->createCommandQueue(CommandQueueDesc{CommandQueueType::Compute}, &ret);
+  ASSERT_TRUE(ret.isOk());
+  auto& vkGraphicsQueue = static_cast<igl::vulkan::CommandQueue&>(*graphicsQueue);
+  auto& vkComputeQueue = static_cast<igl::vulkan::CommandQueue&>(*computeQueue);
+
+  std::vector<uint32_t> values(kNumIncrementElements);
+  for (uint32_t i = 0; i != kNumIncrementElements; i++) {
+    values[i] = i;
+  }
+  auto buffer0 = createIncrementBuffer(*iglDev, values.data());
+  auto buffer1 = createIncrementBuffer(*iglDev);
+  auto buffer2 = createIncrementBuffer(*iglDev);
+  auto buffer3 = createIncrementBuffer(*iglDev);
+
+  const IncrementPass pass(*iglDev);
+
+  // graphics -> async compute -> graphics, each pass reading the output of the previous one
+  const SubmitHandle graphicsHandle = pass.submit(*graphicsQueue, buffer0, buffer1);
+  vkComputeQueue.waitForSubmit(vkGraphicsQueue, graphicsHandle);
+  const SubmitHandle computeHandle = pass.submit(*computeQueue, buffer1, buffer2);
+  vkGraphicsQueue.waitForSubmit(vkComputeQueue, computeHandle);
+  const SubmitHandle lastHandle = pass.submit(*graphicsQueue, buffer2, buffer3);
+  vkCtx.immediate_->wait(igl::vulkan::VulkanImmediateCommands::SubmitHandle(lastHandle));
+
+  for (auto& value : values) {
+    value += 3;
+  }
+  ASSERT_EQ(readIncrementBuffer(*buffer3), values);
+}
+
+GTEST_TEST(VulkanContext, AsyncComputeCpuWaitFallback) {
+  auto iglDev = createAsyncComputeDevice();
+  ASSERT_NE(iglDev, nullptr);
+  const igl::vulkan::VulkanContext& vkCtx =
+      static_cast<igl::vulkan::Device*>(iglDev.get())->getVulkanContext();
+  const VkDevice device = vkCtx.device_->getVkDevice();
+
+  // a producer without a timeline semaphore cannot be waited for on the GPU
+  igl::vulkan::VulkanImmediateCommands producer(vkCtx.vf_,
+                                                device,
+                                                vkCtx.deviceQueues_.graphicsQueueFamilyIndex,
+                                                false,
+                                                false,
+                                                false,
+                                                "Test: producer");
+  igl::vulkan::VulkanImmediateCommands consumer(vkCtx.vf_,
+                                                device,
+                                                vkCtx.deviceQueues_.computeQueueFamilyIndex,
+                                                false,
+                                                false,
+                                                vkCtx.hasTimelineSemaphores_,
+                                                "Test: consumer");
+  ASSERT_FALSE(producer.signalsTimelineSemaphore());
+
+  const auto handle = producer.submit(producer.acquire());
+  if (!consumer.waitForSubmit(producer, handle)) {
+    producer.wait(handle);
+  }
+  ASSERT_TRUE(producer.isReady(handle));
+  consumer.wait(consumer.submit(consumer.acquire()));
+
+  if (!vkCtx.hasTimelineSemaphores_) {
+    return;
+  }
+
+  // the same producer with a timeline semaphore is waited for on the GPU
+  igl::vulkan::VulkanImmediateCommands timelineProducer(
+      vkCtx.vf_,
+      device,
+      vkCtx.deviceQueues_.graphicsQueueFamilyIndex,
+      false,
+      false,
+      true,
+      "Test: timeline producer");
+  const auto timelineHandle = timelineProducer.submit(timelineProducer.acquire());
+  ASSERT_TRUE(consumer.waitForSubmit(timelineProducer, timelineHandle));
+  const auto consumerHandle = consumer.submit(consumer.acquire());
+  consumer.wait(consumerHandle);
+  ASSERT_TRUE(timelineProducer.isReady(timelineHandle));
+}
 #endif
 
 } // namespace tests
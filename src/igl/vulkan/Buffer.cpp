@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cstring>
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/Common.h>
@@ -67,34 +68,78 @@ Result Buffer::create(const BufferDesc& desc) {
     usageFlags |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | optionalBDA;
   }
 
-  const VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
-
   // Store the flag that determines if this buffer contains sub-allocations (i.e. is a ring-buffer)
   isRingBuffer_ = ((desc_.hint & BufferDesc::BufferAPIHintBits::Ring) != 0);
 
-  bufferCount_ = isRingBuffer_ ? device_.getVulkanContext().syncManager_->maxResourceCount() : 1u;
-
+  // Ring buffers are rewritten every frame: keep them host-visible so uploads do not need staging
   if (isRingBuffer_) {
-    // Resize the local copy of the data
-    localData_ = std::make_unique<uint8_t[]>(desc_.length);
+    desc_.storage = ResourceStorage::Shared;
   }
 
-  buffers_ = std::make_unique<std::unique_ptr<VulkanBuffer>[]>(bufferCount_);
+  const VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
+
+  bufferCount_ = isRingBuffer_ ? ctx.syncManager_->maxResourceCount() : 1u;
+
+  // All slices of a ring buffer live in one allocation. Every slice has to be a valid offset for
+  // any kind of binding, hence the alignment
+  const VkPhysicalDeviceLimits& limits = ctx.getVkPhysicalDeviceProperties().limits;
+  VkDeviceSize alignment = std::max<VkDeviceSize>(16, limits.nonCoherentAtomSize);
+  alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+  alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+  ringStride_ = isRingBuffer_ ? (desc_.length + alignment - 1) / alignment * alignment
+                              : desc_.length;
+
   bufferPatches_ = std::make_unique<BufferRange[]>(bufferCount_);
-  Result result;
-  for (size_t bufferIndex = 0; bufferIndex < bufferCount_; ++bufferIndex) {
-    std::string bufferName = desc_.debugName + " - sub-buffer " + std::to_string(bufferIndex);
-    buffers_[bufferIndex] =
-        ctx.createBuffer(desc_.length, usageFlags, memFlags, &result, bufferName.c_str());
+
+  if (!isRingBuffer_) {
+    Result result;
+    buffer_ = ctx.createBuffer(
+        desc_.length, usageFlags, memFlags, &result, desc_.debugName.c_str());
     IGL_VERIFY(result.isOk());
+    return result;
+  }
+
+  // VulkanContext::createBuffer() limits whole uniform buffers to maxUniformBufferRange, but only
+  // one slice of a ring buffer is ever bound
+  if ((usageFlags & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) &&
+      !IGL_VERIFY(desc_.length <= limits.maxUniformBufferRange)) {
+    return Result(Result::Code::InvalidOperation, "Buffer size exceeded maxUniformBufferRange");
+  }
+
+  Result result;
+  buffer_ = std::make_unique<VulkanBuffer>(ctx,
+                                           ctx.device_->getVkDevice(),
+                                           ringStride_ * bufferCount_,
+                                           usageFlags,
+                                           memFlags,
+                                           desc_.debugName.c_str(),
+                                           &result);
+
+  if (!buffer_->valid()) {
+    buffer_ = nullptr;
+    return result;
   }
 
-  return result;
+  if (!buffer_->isMapped()) {
+    return Result(Result::Code::RuntimeError, "Ring buffer memory is not host-visible");
+  }
+
+  return Result();
 }
 
 const std::unique_ptr<VulkanBuffer>& Buffer::currentVulkanBuffer() const {
-  IGL_ASSERT_MSG(buffers_, "There are no sub-allocations available for this buffer");
-  return buffers_[isRingBuffer_ ? device_.getVulkanContext().syncManager_->currentIndex() : 0u];
+  IGL_ASSERT_MSG(buffer_, "There is no VulkanBuffer available for this buffer");
+  return buffer_;
+}
+
+VkDeviceSize Buffer::getVkBufferRange(size_t offset) const {
+  // a ring buffer slice must not overlap with the next one
+  return isRingBuffer_ ? desc_.length - offset : VK_WHOLE_SIZE;
+}
+
+VkDeviceSize Buffer::getVkBufferOffset() const {
+  return isRingBuffer_ ? device_.getVulkanContext().syncManager_->currentIndex() * ringStride_
+                       : 0u;
 }
 
 BufferRange Buffer::getUpdateRange() const {
@@ -143,31 +188,33 @@ igl::Result Buffer::upload(const void* data, const BufferRange& range) {
     return igl::Result(Result::Code::ArgumentOutOfRange, "Out of range");
   }
 
-  // To handle an upload to a ring-buffer, we update the local copy first and upload the entire
-  // local data to the device below
   const VulkanContext& ctx = device_.getVulkanContext();
   if (isRingBuffer_) {
-    // update local data copy
-    checked_memcpy(localData_.get() + range.offset, range.size, (void*)data, range.size);
     // get the current ring buffer index
-    const auto currentBufferIndex = device_.getVulkanContext().syncManager_->currentIndex();
-    BufferRange currentUpdateRange = range;
+    const auto currentBufferIndex = ctx.syncManager_->currentIndex();
     if (currentBufferIndex != previousBufferIndex_) {
+      // the current slice missed the updates made since it was used last time: bring them over
+      // from the most recently updated slice
+      resetUpdateRange(currentBufferIndex, BufferRange());
+      const BufferRange missedRange = getUpdateRange();
+      if (previousBufferIndex_ != UINT32_MAX && missedRange.size) {
+        copyRingSlice(
+            previousBufferIndex_, currentBufferIndex, missedRange.offset, missedRange.size);
+      }
       // if the index has changed update the index
       previousBufferIndex_ = currentBufferIndex;
       // reset update range at the current index, using input range
       resetUpdateRange(currentBufferIndex, range);
-      // get full update range for this index, based on updates made in all the other buffers
-      currentUpdateRange = getUpdateRange();
     } else {
       // increase buffer update range at the current index, based on new range
       extendUpdateRange(currentBufferIndex, range);
     }
-    // use staging to upload data to device-local buffers
-    ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(),
-                                      currentUpdateRange.offset,
-                                      currentUpdateRange.size,
-                                      localData_.get() + currentUpdateRange.offset);
+    // the slice is persistently mapped: a single memcpy, no staging
+    const VkDeviceSize offset = getVkBufferOffset() + range.offset;
+    checked_memcpy(buffer_->getMappedPtr() + offset, range.size, data, range.size);
+    if (!buffer_->isCoherentMemory()) {
+      buffer_->flushMappedMemory(offset, range.size);
+    }
   } else {
     // use staging to upload data to device-local buffers
     ctx.stagingDevice_->bufferSubData(*currentVulkanBuffer(), range.offset, range.size, data);
@@ -175,6 +222,21 @@ igl::Result Buffer::upload(const void* data, const BufferRange& range) {
   return igl::Result();
 }
 
+void Buffer::copyRingSlice(uint32_t srcIndex, uint32_t dstIndex, size_t offset, size_t size) {
+  IGL_PROFILER_FUNCTION();
+
+  const uint8_t* src = buffer_->getMappedPtr() + srcIndex * ringStride_ + offset;
+  uint8_t* dst = buffer_->getMappedPtr() + dstIndex * ringStride_ + offset;
+
+  if (!buffer_->isCoherentMemory()) {
+    buffer_->invalidateMappedMemory(srcIndex * ringStride_ + offset, size);
+  }
+  checked_memcpy(dst, size, src, size);
+  if (!buffer_->isCoherentMemory()) {
+    buffer_->flushMappedMemory(dstIndex * ringStride_ + offset, size);
+  }
+}
+
 size_t Buffer::getSizeInBytes() const {
   return desc_.length;
 }
@@ -183,7 +245,7 @@ uint64_t Buffer::gpuAddress(size_t offset) const {
   IGL_ASSERT_MSG((offset & 7) == 0,
                  "Buffer offset must be 8 bytes aligned as per GLSL_EXT_buffer_reference spec.");
 
-  return (uint64_t)currentVulkanBuffer()->getVkDeviceAddress() + offset;
+  return (uint64_t)currentVulkanBuffer()->getVkDeviceAddress() + getVkBufferOffset() + offset;
 }
 
 VkBuffer Buffer::getVkBuffer() const {
@@ -16,10 +16,10 @@ namespace vulkan {
 class Device;
 class VulkanBuffer;
 
-/// @brief Implements the igl::IBuffer interface for Vulkan. Contains one or more VulkanBuffers,
-/// depending on the type of buffer this class represents. If this class represents a ring buffer,
-/// then there will be multiple VulkanBuffers, each with its own index. Otherwise it contains only
-/// one VulkanBuffer object.
+/// @brief Implements the igl::IBuffer interface for Vulkan. Contains one VulkanBuffer. If this
+/// class represents a ring buffer, the VulkanBuffer is a single host-visible, persistently mapped
+/// allocation partitioned into one aligned slice per frame in flight, and the slice currently in
+/// use starts at getVkBufferOffset().
 class Buffer final : public igl::IBuffer {
   friend class Device;
 
@@ -45,10 +45,15 @@ class Buffer final : public igl::IBuffer {
   }
 
   VkBuffer getVkBuffer() const;
+  /// @brief Returns the offset of the active ring buffer slice inside getVkBuffer(). Always 0 for
+  /// regular buffers. It must be added to all offsets used with getVkBuffer().
+  [[nodiscard]] VkDeviceSize getVkBufferOffset() const;
+  /// @brief Returns the range to use in descriptors for a binding at `offset`.
+  [[nodiscard]] VkDeviceSize getVkBufferRange(size_t offset) const;
   [[nodiscard]] VkBufferUsageFlags getBufferUsageFlags() const;
 
-  /// @brief Returns the current active VulkanBuffer object managed by this class. Since this class
-  /// may be used as a Ring Buffer, the active buffer is the buffer currently being accessed.
+  /// @brief Returns the VulkanBuffer object managed by this class. For ring buffers, it contains
+  /// all slices; see getVkBufferOffset().
   [[nodiscard]] const std::unique_ptr<VulkanBuffer>& currentVulkanBuffer() const;
 
  private:
@@ -56,10 +61,11 @@ class Buffer final : public igl::IBuffer {
   BufferDesc desc_;
   bool isRingBuffer_ = false;
   uint32_t previousBufferIndex_ = UINT32_MAX;
-  std::unique_ptr<std::unique_ptr<VulkanBuffer>[]> buffers_;
-  std::unique_ptr<uint8_t[]> localData_;
+  std::unique_ptr<VulkanBuffer> buffer_;
   std::unique_ptr<BufferRange[]> bufferPatches_;
   uint32_t bufferCount_ = 0;
+  // distance between two consecutive ring buffer slices
+  VkDeviceSize ringStride_ = 0;
 
   Result create(const BufferDesc& desc);
 
@@ -68,6 +74,8 @@ class Buffer final : public igl::IBuffer {
   [[nodiscard]] BufferRange getUpdateRange() const;
   void extendUpdateRange(uint32_t ringBufferIndex, const BufferRange& range);
   void resetUpdateRange(uint32_t ringBufferIndex, const BufferRange& range);
+  // Copies `size` bytes at `offset` from one ring buffer slice to another
+  void copyRingSlice(uint32_t srcIndex, uint32_t dstIndex, size_t offset, size_t size);
 
   // Used for map/unmap API for DEVICE_LOCAL buffers
   std::vector<uint8_t> tmpBuffer_;
@@ -21,9 +21,16 @@
 namespace igl {
 namespace vulkan {
 
-CommandBuffer::CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc) :
-  ctx_(ctx), wrapper_(ctx_.immediate_->acquire()), desc_(std::move(desc)) {
+CommandBuffer::CommandBuffer(VulkanContext& ctx,
+                             VulkanImmediateCommands& immediate,
+                             CommandBufferDesc desc) :
+  ctx_(ctx),
+  immediate_(immediate),
+  wrapper_(immediate_.acquire()),
+  desc_(std::move(desc)),
+  barriers_(ctx) {
   IGL_ASSERT(wrapper_.cmdBuf_ != VK_NULL_HANDLE);
+  barriers_.begin(wrapper_.cmdBuf_);
 }
 
 std::unique_ptr<IComputeCommandEncoder> CommandBuffer::createComputeCommandEncoder() {
@@ -38,21 +45,56 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
   IGL_PROFILER_FUNCTION();
   IGL_ASSERT(framebuffer);
 
+  if (isAsyncCompute()) {
+    IGL_ASSERT_MSG(false, "Render passes cannot be encoded on the async compute queue");
+    Result::setResult(outResult,
+                      Result::Code::Unsupported,
+                      "Render passes cannot be encoded on the async compute queue");
+    return nullptr;
+  }
+
   framebuffer_ = framebuffer;
 
+  // all transitions required by the render pass are recorded with one barrier call
   for (ITexture* IGL_NULLABLE tex : dependencies.textures) {
     if (tex) {
-      transitionToShaderReadOnly(wrapper_.cmdBuf_, tex);
+      transitionToShaderReadOnly(barriers_, tex);
+    }
+  }
+  // buffers written by compute shaders, e.g. indirect draw arguments
+  for (IBuffer* IGL_NULLABLE buf : dependencies.buffers) {
+    if (!buf) {
+      break;
+    }
+    const auto* vkBuf = static_cast<igl::vulkan::Buffer*>(buf);
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                            VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    if (vkBuf->getBufferUsageFlags() & VK_BUFFER_USAGE_INDEX_BUFFER_BIT) {
+      barrier.dstAccessMask |= VK_ACCESS_INDEX_READ_BIT;
     }
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = vkBuf->getVkBuffer();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    barriers_.addBufferBarrier(barrier,
+                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                               VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                                   VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                   VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
   }
 
   // prepare all the color attachments
   for (const auto i : framebuffer->getColorAttachmentIndices()) {
     ITexture* colorTex = framebuffer->getColorAttachment(i).get();
-    transitionToColorAttachment(wrapper_.cmdBuf_, colorTex);
+    transitionToColorAttachment(barriers_, colorTex);
     // handle MSAA
     ITexture* colorResolveTex = framebuffer->getResolveColorAttachment(i).get();
-    transitionToColorAttachment(wrapper_.cmdBuf_, colorResolveTex);
+    transitionToColorAttachment(barriers_, colorResolveTex);
   }
 
   // prepare depth attachment
@@ -64,13 +106,15 @@ std::unique_ptr<IRenderCommandEncoder> CommandBuffer::createRenderCommandEncoder
     const VkImageAspectFlags flags =
         vkDepthTex.getVulkanTexture().getVulkanImage().getImageAspectFlags();
     depthImg.transitionLayout(
-        wrapper_.cmdBuf_,
+        barriers_,
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
         VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
         VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         VkImageSubresourceRange{flags, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
   }
 
+  barriers_.flush();
+
   auto encoder = RenderCommandEncoder::create(
       shared_from_this(), ctx_, renderPass, framebuffer, dependencies, outResult);
 
@@ -144,13 +188,17 @@ void CommandBuffer::popDebugGroupLabel() const {
 void CommandBuffer::waitUntilCompleted() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
-  ctx_.immediate_->wait(lastSubmitHandle_);
+  immediate_.wait(lastSubmitHandle_);
 
   lastSubmitHandle_ = VulkanImmediateCommands::SubmitHandle();
 }
 
 void CommandBuffer::waitUntilScheduled() {}
 
+bool CommandBuffer::isAsyncCompute() const {
+  return &immediate_ == ctx_.computeImmediate_.get();
+}
+
 std::shared_ptr<igl::IFramebuffer> CommandBuffer::getFramebuffer() const {
   return framebuffer_;
 }
@@ -9,6 +9,7 @@
 
 #include <igl/CommandBuffer.h>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanBarrierBatch.h>
 #include <igl/vulkan/VulkanImmediateCommands.h>
 
 namespace igl {
@@ -22,10 +23,11 @@ class CommandBuffer final : public ICommandBuffer,
                             public std::enable_shared_from_this<CommandBuffer> {
  public:
   /// @brief Constructs a CommandBuffer object, acquires a
-  /// `VulkanImmediateCommands::CommandBufferWrapper` from the context's VulkanImmediateCommands
-  /// object, and stores the CommandBufferDesc structure used to construct the underlying command
-  /// buffer.
-  CommandBuffer(VulkanContext& ctx, CommandBufferDesc desc);
+  /// `VulkanImmediateCommands::CommandBufferWrapper` from the `immediate` object of its command
+  /// queue, and stores the CommandBufferDesc structure used to construct the underlying command
+  /// buffer. `immediate` is either the context's graphics VulkanImmediateCommands or, for async
+  /// compute queues, `VulkanContext::computeImmediate_`.
+  CommandBuffer(VulkanContext& ctx, VulkanImmediateCommands& immediate, CommandBufferDesc desc);
 
   /// @brief Creates a ComputeCommandEncoder
   std::unique_ptr<IComputeCommandEncoder> createComputeCommandEncoder() override;
@@ -38,7 +40,8 @@ class CommandBuffer final : public ICommandBuffer,
    * transitioned to depth/stencil attachment optimal layout. Once the RenderCommandEncoder has been
    * created, and if there is an enhanced shader debugging store object defined in the contest, this
    * function also binds an extra storage buffer used by the shader debugging functionality. Returns
-   * a RenderCommandEncoder object.
+   * a RenderCommandEncoder object, or nullptr if the command buffer belongs to an async compute
+   * queue.
    */
   std::unique_ptr<IRenderCommandEncoder> createRenderCommandEncoder(
       const RenderPassDesc& renderPass,
@@ -70,20 +73,43 @@ class CommandBuffer final : public ICommandBuffer,
     return wrapper_.cmdBuf_;
   }
 
+  /// @brief Returns the VulkanImmediateCommands the command buffer is submitted to.
+  const VulkanImmediateCommands& getImmediateCommands() const {
+    return immediate_;
+  }
+
+  /// @brief Returns the handle the command buffer will be submitted with. Resources it reads can
+  /// be recycled once `getImmediateCommands().isReady()` returns true for this handle.
+  VulkanImmediateCommands::SubmitHandle getSubmitHandle() const {
+    return wrapper_.handle_;
+  }
+
   bool isFromSwapchain() const {
     return isFromSwapchain_;
   }
 
+  /// @brief Returns true if the command buffer is submitted to the dedicated compute queue. Only
+  /// compute-compatible pipeline stages can be used in its barriers.
+  bool isAsyncCompute() const;
+
   std::shared_ptr<igl::IFramebuffer> getFramebuffer() const;
 
   std::shared_ptr<ITexture> getPresentedSurface() const;
 
+  /// @brief Barriers recorded into this command buffer. Encoders add their transitions here and
+  /// flush them once before the commands which depend on them.
+  VulkanBarrierBatch& barriers() {
+    return barriers_;
+  }
+
  private:
   friend class CommandQueue;
 
   VulkanContext& ctx_;
+  VulkanImmediateCommands& immediate_;
   const VulkanImmediateCommands::CommandBufferWrapper& wrapper_;
   CommandBufferDesc desc_;
+  VulkanBarrierBatch barriers_;
   // was present() called with a swapchain image?
   mutable bool isFromSwapchain_ = false;
 
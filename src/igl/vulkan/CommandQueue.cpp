@@ -33,7 +33,36 @@ std::shared_ptr<ICommandBuffer> CommandQueue::createCommandBuffer(const CommandB
 
   isInsideFrame_ = true;
 
-  return std::make_shared<CommandBuffer>(device_.getVulkanContext(), desc);
+  return std::make_shared<CommandBuffer>(device_.getVulkanContext(), getImmediateCommands(), desc);
+}
+
+VulkanImmediateCommands& CommandQueue::getImmediateCommands() const {
+  const VulkanContext& ctx = device_.getVulkanContext();
+
+  return isAsyncCompute() ? *ctx.computeImmediate_ : *ctx.immediate_;
+}
+
+bool CommandQueue::isAsyncCompute() const {
+  return desc_.type == CommandQueueType::Compute && device_.getVulkanContext().computeImmediate_;
+}
+
+void CommandQueue::waitForSubmit(const CommandQueue& producer, SubmitHandle handle) {
+  IGL_PROFILER_FUNCTION();
+
+  VulkanImmediateCommands& producerImmediate = producer.getImmediateCommands();
+  VulkanImmediateCommands& immediate = getImmediateCommands();
+
+  const VulkanImmediateCommands::SubmitHandle submitHandle(handle);
+
+  if (&producerImmediate == &immediate || producerImmediate.isReady(submitHandle)) {
+    // submissions to the same VkQueue are already ordered
+    return;
+  }
+
+  if (!immediate.waitForSubmit(producerImmediate, submitHandle)) {
+    // no timeline semaphore to wait for on the GPU
+    producerImmediate.wait(submitHandle);
+  }
 }
 
 SubmitHandle CommandQueue::submit(const ICommandBuffer& cmdBuffer, bool /* endOfFrame */) {
@@ -67,6 +96,21 @@ SubmitHandle CommandQueue::endCommandBuffer(const igl::vulkan::VulkanContext& ct
 
   const bool isGraphicsQueue = desc_.type == CommandQueueType::Graphics;
 
+  if (isAsyncCompute()) {
+    // Submit to the dedicated compute queue. It does not present and does not advance the frame.
+    VulkanImmediateCommands& immediate = *ctx.computeImmediate_;
+    // staging uploads are submitted to the graphics queue
+    ctx.stagingDevice_->waitForUploads(immediate);
+    cmdBuffer->lastSubmitHandle_ = immediate.submit(cmdBuffer->wrapper_);
+    ctx.syncManager_->markComputeSubmitted(cmdBuffer->lastSubmitHandle_);
+    ctx.processDeferredTasks();
+    ctx.stagingDevice_->mergeRegionsAndFreeBuffers();
+
+    isInsideFrame_ = false;
+
+    return cmdBuffer->lastSubmitHandle_.handle();
+  }
+
   // Submit to the graphics queue.
   const bool shouldPresent = isGraphicsQueue && ctx.hasSwapchain() &&
                              cmdBuffer->isFromSwapchain() && present;
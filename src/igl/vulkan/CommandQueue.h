@@ -47,6 +47,18 @@ class CommandQueue final : public ICommandQueue {
     return desc_;
   }
 
+  /** @brief Makes the next submission of this queue wait on the GPU until the submission `handle`
+   * of the `producer` queue has completed, e.g. a graphics queue sampling the results of an async
+   * compute queue or vice versa. Does nothing if both queues submit to the same VkQueue or if the
+   * work has already completed. The dependency is expressed with a value of the timeline semaphore
+   * signaled by every submission of `producer`; if the device does not support timeline semaphores,
+   * this function waits for `handle` on the CPU instead.
+   */
+  void waitForSubmit(const CommandQueue& producer, SubmitHandle handle);
+
+  /// @brief Returns true if this queue submits to the dedicated compute queue family.
+  bool isAsyncCompute() const;
+
  private:
   /** @brief Ends the current command buffer and resets the internal flag tracking an active command
    * buffer. Determines if an image should be presented by (1) checking if this instance belongs to
@@ -66,6 +78,10 @@ class CommandQueue final : public ICommandQueue {
   void enhancedShaderDebuggingPass(const igl::vulkan::VulkanContext& ctx,
                                    const igl::vulkan::CommandBuffer* cmdBuffer);
 
+  /// @brief Returns the VulkanImmediateCommands object the command buffers of this queue are
+  /// allocated from and submitted to.
+  VulkanImmediateCommands& getImmediateCommands() const;
+
  private:
   igl::vulkan::Device& device_;
   CommandQueueDesc desc_;
@@ -18,6 +18,7 @@
 
 #include <igl/vulkan/ShaderModule.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanBarrierBatch.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanHelpers.h>
 #include <igl/vulkan/VulkanImage.h>
@@ -380,37 +381,10 @@ TextureRangeDesc atVkLayer(TextureType type, const TextureRangeDesc& range, uint
   return type == TextureType::Cube ? range.atFace(vkLayer) : range.atLayer(vkLayer);
 }
 
-void transitionToGeneral(VkCommandBuffer cmdBuf, ITexture* texture) {
-  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
-
-  if (!texture) {
-    return;
-  }
-
-  const vulkan::Texture& tex = static_cast<vulkan::Texture&>(*texture);
-  const vulkan::VulkanImage& img = tex.getVulkanTexture().getVulkanImage();
-
-  if (!img.isStorageImage()) {
-    IGL_ASSERT_MSG(false, "Did you forget to specify TextureUsageBits::Storage on your texture?");
-    return;
-  }
-
-  // "frame graph" heuristics: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the previous
-  // compute shader, otherwise wait for previous attachment writes
-  const VkPipelineStageFlags srcStage =
-      (img.imageLayout_ == VK_IMAGE_LAYOUT_GENERAL) ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
-      : img.isDepthOrStencilFormat_                 ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
-                                                    : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  img.transitionLayout(
-      cmdBuf,
-      VK_IMAGE_LAYOUT_GENERAL,
-      srcStage,
-      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-      VkImageSubresourceRange{
-          img.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
-}
+namespace {
 
-void transitionToColorAttachment(VkCommandBuffer cmdBuf, ITexture* colorTex) {
+template<typename Target>
+void transitionToColorAttachmentImpl(Target& target, ITexture* colorTex) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
   if (!colorTex) {
@@ -432,7 +406,7 @@ void transitionToColorAttachment(VkCommandBuffer cmdBuf, ITexture* colorTex) {
   if (img.usageFlags_ & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) {
     // transition to VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
     img.transitionLayout(
-        cmdBuf,
+        target,
         VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // wait for all subsequent fragment/compute
@@ -443,7 +417,8 @@ void transitionToColorAttachment(VkCommandBuffer cmdBuf, ITexture* colorTex) {
   }
 }
 
-void transitionToDepthStencilAttachment(VkCommandBuffer cmdBuf, ITexture* depthStencilTex) {
+template<typename Target>
+void transitionToDepthStencilAttachmentImpl(Target& target, ITexture* depthStencilTex) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
   if (!depthStencilTex) {
@@ -472,7 +447,7 @@ void transitionToDepthStencilAttachment(VkCommandBuffer cmdBuf, ITexture* depthS
       aspectFlags |= VK_IMAGE_ASPECT_STENCIL_BIT;
     }
     img.transitionLayout(
-        cmdBuf,
+        target,
         VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // wait for all subsequent fragment/compute
@@ -483,7 +458,8 @@ void transitionToDepthStencilAttachment(VkCommandBuffer cmdBuf, ITexture* depthS
   }
 }
 
-void transitionToShaderReadOnly(VkCommandBuffer cmdBuf, ITexture* texture) {
+template<typename Target>
+void transitionToShaderReadOnlyImpl(Target& target, ITexture* texture) {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
   if (!texture) {
@@ -498,7 +474,7 @@ void transitionToShaderReadOnly(VkCommandBuffer cmdBuf, ITexture* texture) {
   if (img.usageFlags_ & VK_IMAGE_USAGE_SAMPLED_BIT) {
     // transition sampled images to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     img.transitionLayout(
-        cmdBuf,
+        target,
         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         isColor ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
                 : VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
@@ -509,6 +485,64 @@ void transitionToShaderReadOnly(VkCommandBuffer cmdBuf, ITexture* texture) {
   }
 }
 
+} // namespace
+
+void transitionToGeneral(VkCommandBuffer cmdBuf, ITexture* texture, bool isAsyncCompute) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
+
+  if (!texture) {
+    return;
+  }
+
+  const vulkan::Texture& tex = static_cast<vulkan::Texture&>(*texture);
+  const vulkan::VulkanImage& img = tex.getVulkanTexture().getVulkanImage();
+
+  if (!img.isStorageImage()) {
+    IGL_ASSERT_MSG(false, "Did you forget to specify TextureUsageBits::Storage on your texture?");
+    return;
+  }
+
+  // "frame graph" heuristics: if we are already in VK_IMAGE_LAYOUT_GENERAL, wait for the previous
+  // compute shader, otherwise wait for previous attachment writes. On the async compute queue,
+  // attachment writes of the graphics queue are ordered by semaphores instead.
+  const VkPipelineStageFlags srcStage =
+      (isAsyncCompute || img.imageLayout_ == VK_IMAGE_LAYOUT_GENERAL)
+          ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+      : img.isDepthOrStencilFormat_ ? VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                                    : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  img.transitionLayout(
+      cmdBuf,
+      VK_IMAGE_LAYOUT_GENERAL,
+      srcStage,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VkImageSubresourceRange{
+          img.getImageAspectFlags(), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS});
+}
+
+void transitionToColorAttachment(VkCommandBuffer cmdBuf, ITexture* colorTex) {
+  transitionToColorAttachmentImpl(cmdBuf, colorTex);
+}
+
+void transitionToColorAttachment(VulkanBarrierBatch& batch, ITexture* colorTex) {
+  transitionToColorAttachmentImpl(batch, colorTex);
+}
+
+void transitionToDepthStencilAttachment(VkCommandBuffer cmdBuf, ITexture* depthStencilTex) {
+  transitionToDepthStencilAttachmentImpl(cmdBuf, depthStencilTex);
+}
+
+void transitionToDepthStencilAttachment(VulkanBarrierBatch& batch, ITexture* depthStencilTex) {
+  transitionToDepthStencilAttachmentImpl(batch, depthStencilTex);
+}
+
+void transitionToShaderReadOnly(VkCommandBuffer cmdBuf, ITexture* texture) {
+  transitionToShaderReadOnlyImpl(cmdBuf, texture);
+}
+
+void transitionToShaderReadOnly(VulkanBarrierBatch& batch, ITexture* texture) {
+  transitionToShaderReadOnlyImpl(batch, texture);
+}
+
 void overrideImageLayout(ITexture* texture, VkImageLayout layout) {
   if (!texture) {
     return;
@@ -99,6 +99,8 @@
 
 namespace igl::vulkan {
 
+class VulkanBarrierBatch;
+
 // The color definitions below are used by debugging utility functions, such as the ones provided by
 // VK_EXT_debug_utils
 #define kColorGenerateMipmaps igl::Color(1.f, 0.75f, 0.f)
@@ -120,17 +122,22 @@ VkSurfaceFormatKHR colorSpaceToVkSurfaceFormat(igl::ColorSpace colorSpace, bool
 uint32_t getVkLayer(igl::TextureType type, uint32_t face, uint32_t layer);
 TextureRangeDesc atVkLayer(TextureType type, const TextureRangeDesc& range, uint32_t vkLayer);
 
-/// @brief Transition from the current layout to VK_IMAGE_LAYOUT_GENERAL
-void transitionToGeneral(VkCommandBuffer cmdBuf, ITexture* texture);
+/// @brief Transition from the current layout to VK_IMAGE_LAYOUT_GENERAL. Command buffers of the
+/// async compute queue can only wait for compute shader stages (`isAsyncCompute`).
+void transitionToGeneral(VkCommandBuffer cmdBuf, ITexture* texture, bool isAsyncCompute = false);
 
-/// @brief Transition from the current layout to VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+/// @brief Transition from the current layout to VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL. The
+/// overloads taking a VulkanBarrierBatch add the barrier to the batch instead of recording it.
 void transitionToColorAttachment(VkCommandBuffer cmdBuf, ITexture* colorTex);
+void transitionToColorAttachment(VulkanBarrierBatch& batch, ITexture* colorTex);
 
 /// @brief Transition from the current layout to VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
 void transitionToDepthStencilAttachment(VkCommandBuffer cmdBuf, ITexture* depthStencilTex);
+void transitionToDepthStencilAttachment(VulkanBarrierBatch& batch, ITexture* depthStencilTex);
 
 /// @brief Transition from the current layout to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
 void transitionToShaderReadOnly(VkCommandBuffer cmdBuf, ITexture* texture);
+void transitionToShaderReadOnly(VulkanBarrierBatch& batch, ITexture* texture);
 
 /// @brief Overrides the layout stored in the `texture` with the one in `layout`. This function does
 /// not perform a transition, it only updates the texture's member variable that stores its current
@@ -9,7 +9,9 @@
 
 #include <igl/vulkan/Buffer.h>
 #include <igl/vulkan/ComputePipelineState.h>
+#include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/TransientUniformAllocator.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImage.h>
@@ -24,6 +26,10 @@ ComputeCommandEncoder::ComputeCommandEncoder(const std::shared_ptr<CommandBuffer
                                              VulkanContext& ctx) :
   ctx_(ctx),
   cmdBuffer_(commandBuffer ? commandBuffer->getVkCommandBuffer() : VK_NULL_HANDLE),
+  immediate_(commandBuffer ? &commandBuffer->getImmediateCommands() : nullptr),
+  submitHandle_(commandBuffer ? commandBuffer->getSubmitHandle()
+                              : VulkanImmediateCommands::SubmitHandle()),
+  isAsyncCompute_(commandBuffer && commandBuffer->isAsyncCompute()),
   binder_(commandBuffer, ctx_, VK_PIPELINE_BIND_POINT_COMPUTE) {
   IGL_PROFILER_FUNCTION();
 
@@ -49,8 +55,9 @@ void ComputeCommandEncoder::endEncoding() {
       img->transitionLayout(cmdBuffer_,
                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
-                                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                            isAsyncCompute_ ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                            : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                             VkImageSubresourceRange{img->getImageAspectFlags(),
                                                     0,
                                                     VK_REMAINING_MIP_LEVELS,
@@ -103,7 +110,7 @@ void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCo
     if (!tex) {
       break;
     }
-    igl::vulkan::transitionToGeneral(cmdBuffer_, tex);
+    igl::vulkan::transitionToGeneral(cmdBuffer_, tex, isAsyncCompute_);
   }
   for (IBuffer* buf : dependencies.buffers) {
     if (!buf) {
@@ -114,8 +121,11 @@ void ComputeCommandEncoder::dispatchThreadGroups(const Dimensions& threadgroupCo
                      cmdBuffer_,
                      vkBuf->getVkBuffer(),
                      vkBuf->getBufferUsageFlags(),
-                     VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                     isAsyncCompute_ ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                     : VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                                           VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                                           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
   }
 
@@ -155,7 +165,7 @@ void ComputeCommandEncoder::bindTexture(size_t index, ITexture* texture) {
   const igl::vulkan::VulkanTexture& vkTex = tex->getVulkanTexture();
   const igl::vulkan::VulkanImage* vkImage = &vkTex.getVulkanImage();
 
-  igl::vulkan::transitionToGeneral(cmdBuffer_, texture);
+  igl::vulkan::transitionToGeneral(cmdBuffer_, texture, isAsyncCompute_);
 
   restoreLayout_.push_back(vkImage);
 
@@ -185,8 +195,20 @@ void ComputeCommandEncoder::bindBuffer(size_t index,
   binder_.bindStorageBuffer((int)index, buf, offset);
 }
 
-void ComputeCommandEncoder::bindBytes(size_t /*index*/, const void* /*data*/, size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+void ComputeCommandEncoder::bindBytes(size_t index, const void* data, size_t length) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(immediate_)) {
+    return;
+  }
+
+  const TransientUniformAllocator::Allocation allocation =
+      ctx_.transientUniformAllocator_->allocate(*immediate_, submitHandle_, data, length);
+
+  if (allocation.buffer != VK_NULL_HANDLE) {
+    binder_.bindUniformBuffer(
+        (uint32_t)index, allocation.buffer, allocation.offset, allocation.size);
+  }
 }
 
 void ComputeCommandEncoder::bindPushConstants(const void* data, size_t length, size_t offset) {
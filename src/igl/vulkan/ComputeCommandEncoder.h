@@ -59,7 +59,8 @@ class ComputeCommandEncoder : public IComputeCommandEncoder {
   /// @brief Binds a buffer. If the buffer is not a storage buffer, this function is a no-op
   void bindBuffer(size_t index, const std::shared_ptr<IBuffer>& buffer, size_t offset) override;
 
-  /// @brief Not implemented
+  /// @brief Copies `length` bytes into transient uniform memory and binds them as the
+  /// uniform buffer at `index`.
   void bindBytes(size_t index, const void* data, size_t length) override;
 
   /// @brief Binds push constants pointed by `data` with `length` bytes starting at `offset`.
@@ -74,7 +75,12 @@ class ComputeCommandEncoder : public IComputeCommandEncoder {
  private:
   VulkanContext& ctx_;
   VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
+  // where the command buffer is submitted, to recycle the memory of bindBytes()
+  const VulkanImmediateCommands* immediate_ = nullptr;
+  VulkanImmediateCommands::SubmitHandle submitHandle_;
   bool isEncoding_ = false;
+  // the dedicated compute queue supports only compute-compatible pipeline stages in barriers
+  bool isAsyncCompute_ = false;
 
   igl::vulkan::ResourcesBinder binder_;
 
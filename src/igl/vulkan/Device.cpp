@@ -541,7 +541,7 @@ bool Device::hasFeature(DeviceFeatures feature) const {
   case DeviceFeatures::ShaderLibrary:
     return true;
   case DeviceFeatures::BindBytes:
-    return false;
+    return true;
   case DeviceFeatures::TextureArrayExt:
     return false;
   case DeviceFeatures::SRGB:
@@ -634,7 +634,8 @@ bool Device::getFeatureLimits(DeviceFeatureLimits featureLimits, size_t& result)
     result = 0;
     return true;
   case DeviceFeatureLimits::MaxBindBytesBytes:
-    result = 0;
+    // the same limit as Metal; backed by TransientUniformAllocator
+    result = 4096;
     return true;
   }
 
@@ -17,7 +17,9 @@
 #include <igl/vulkan/Framebuffer.h>
 #include <igl/vulkan/RenderPipelineState.h>
 #include <igl/vulkan/SamplerState.h>
+#include <igl/vulkan/SyncManager.h>
 #include <igl/vulkan/Texture.h>
+#include <igl/vulkan/TransientUniformAllocator.h>
 #include <igl/vulkan/VertexInputState.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
@@ -120,6 +122,10 @@ RenderCommandEncoder::RenderCommandEncoder(const std::shared_ptr<CommandBuffer>&
   IRenderCommandEncoder::IRenderCommandEncoder(commandBuffer),
   ctx_(ctx),
   cmdBuffer_(commandBuffer ? commandBuffer->getVkCommandBuffer() : VK_NULL_HANDLE),
+  immediate_(commandBuffer ? &commandBuffer->getImmediateCommands() : nullptr),
+  submitHandle_(commandBuffer ? commandBuffer->getSubmitHandle()
+                              : VulkanImmediateCommands::SubmitHandle()),
+  barriers_(commandBuffer ? &commandBuffer->barriers() : nullptr),
   binder_(commandBuffer, ctx, VK_PIPELINE_BIND_POINT_GRAPHICS) {
   IGL_PROFILER_FUNCTION();
   IGL_ASSERT(commandBuffer);
@@ -316,13 +322,13 @@ void RenderCommandEncoder::endEncoding() {
       // (TextureDesc::TextureUsageBits::Attachment), don't transition it to a depth/stencil
       // attchment
       if (img.usageFlags_ & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
-        transitionToDepthStencilAttachment(cmdBuffer_, tex);
+        transitionToDepthStencilAttachment(*barriers_, tex);
       }
     } else {
       // If the texture has not been marked as a color attachment
       // (TextureDesc::TextureUsageBits::Attachment), don't transition it to a color attchment
       if (img.usageFlags_ & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) {
-        transitionToColorAttachment(cmdBuffer_, tex);
+        transitionToColorAttachment(*barriers_, tex);
       }
     }
   }
@@ -336,15 +342,17 @@ void RenderCommandEncoder::endEncoding() {
     // is always VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL (check VulkanRenderPassBuilder.cpp)
     overrideImageLayout(attachment.texture.get(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
     overrideImageLayout(attachment.resolveTexture.get(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    transitionToShaderReadOnly(cmdBuffer_, attachment.texture.get());
-    transitionToShaderReadOnly(cmdBuffer_, attachment.resolveTexture.get());
+    transitionToShaderReadOnly(*barriers_, attachment.texture.get());
+    transitionToShaderReadOnly(*barriers_, attachment.resolveTexture.get());
   }
 
   // this must match the final layout of the render pass, which is always
   // VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL (check VulkanRenderPassBuilder.cpp)
   overrideImageLayout(desc.depthAttachment.texture.get(),
                       VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-  transitionToShaderReadOnly(cmdBuffer_, desc.depthAttachment.texture.get());
+  transitionToShaderReadOnly(*barriers_, desc.depthAttachment.texture.get());
+
+  barriers_->flush();
 
 #if defined(IGL_WITH_TRACY_GPU)
   TracyVkCollect(ctx_.tracyCtx_, cmdBuffer_);
@@ -496,7 +504,7 @@ void RenderCommandEncoder::bindBuffer(int index,
     if (IGL_VERIFY(index < IGL_VERTEX_BINDINGS_MAX)) {
       isVertexBufferBound_[index] = true;
     }
-    const VkDeviceSize offset = bufferOffset;
+    const VkDeviceSize offset = buf->getVkBufferOffset() + bufferOffset;
     ctx_.vf_.vkCmdBindVertexBuffers(cmdBuffer_, index, 1, &vkBuf, &offset);
   } else if (isUniformOrStorageBuffer) {
     if (!IGL_VERIFY(target == BindTarget::kAllGraphics)) {
@@ -538,16 +546,34 @@ void RenderCommandEncoder::bindVertexBuffer(uint32_t index,
   if (IGL_VERIFY(index < IGL_ARRAY_NUM_ELEMENTS(isVertexBufferBound_))) {
     isVertexBufferBound_[index] = true;
   }
-  VkBuffer vkBuf = static_cast<igl::vulkan::Buffer*>(buffer.get())->getVkBuffer();
-  const VkDeviceSize offset = bufferOffset;
+  const auto* buf = static_cast<igl::vulkan::Buffer*>(buffer.get());
+  VkBuffer vkBuf = buf->getVkBuffer();
+  const VkDeviceSize offset = buf->getVkBufferOffset() + bufferOffset;
   ctx_.vf_.vkCmdBindVertexBuffers(cmdBuffer_, index, 1, &vkBuf, &offset);
 }
 
-void RenderCommandEncoder::bindBytes(size_t /*index*/,
+void RenderCommandEncoder::bindBytes(size_t index,
                                      uint8_t /*target*/,
-                                     const void* /*data*/,
-                                     size_t /*length*/) {
-  IGL_ASSERT_NOT_IMPLEMENTED();
+                                     const void* data,
+                                     size_t length) {
+  IGL_PROFILER_FUNCTION();
+
+#if IGL_VULKAN_PRINT_COMMANDS
+  IGL_LOG_INFO("%p  bindBytes(%u, %u)\n", cmdBuffer_, (uint32_t)index, (uint32_t)length);
+#endif // IGL_VULKAN_PRINT_COMMANDS
+
+  // uniform buffer bindings are shared by all shader stages, so `target` is irrelevant here
+  if (!IGL_VERIFY(immediate_)) {
+    return;
+  }
+
+  const TransientUniformAllocator::Allocation allocation =
+      ctx_.transientUniformAllocator_->allocate(*immediate_, submitHandle_, data, length);
+
+  if (allocation.buffer != VK_NULL_HANDLE) {
+    binder_.bindUniformBuffer(
+        (uint32_t)index, allocation.buffer, allocation.offset, allocation.size);
+  }
 }
 
 void RenderCommandEncoder::bindPushConstants(const void* data, size_t length, size_t offset) {
@@ -683,7 +709,8 @@ void RenderCommandEncoder::drawIndexed(PrimitiveType primitiveType,
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdBindIndexBuffer(%u)\n", cmdBuffer_, (uint32_t)indexBufferOffset);
 #endif // IGL_VULKAN_PRINT_COMMANDS
-  ctx_.vf_.vkCmdBindIndexBuffer(cmdBuffer_, buf->getVkBuffer(), indexBufferOffset, type);
+  ctx_.vf_.vkCmdBindIndexBuffer(
+      cmdBuffer_, buf->getVkBuffer(), buf->getVkBufferOffset() + indexBufferOffset, type);
 
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkCmdDrawIndexed(%u, %u)\n", cmdBuffer_, (uint32_t)indexCount, instanceCount);
@@ -727,7 +754,7 @@ void RenderCommandEncoder::multiDrawIndirect(PrimitiveType primitiveType,
 
   ctx_.vf_.vkCmdDrawIndirect(cmdBuffer_,
                              bufIndirect->getVkBuffer(),
-                             indirectBufferOffset,
+                             bufIndirect->getVkBufferOffset() + indirectBufferOffset,
                              drawCount,
                              stride ? stride : sizeof(VkDrawIndirectCommand));
 }
@@ -756,11 +783,12 @@ void RenderCommandEncoder::multiDrawIndexedIndirect(PrimitiveType primitiveType,
   const igl::vulkan::Buffer* bufIndirect = static_cast<igl::vulkan::Buffer*>(&indirectBuffer);
 
   const VkIndexType type = indexFormatToVkIndexType(indexFormat);
-  ctx_.vf_.vkCmdBindIndexBuffer(cmdBuffer_, bufIndex->getVkBuffer(), 0, type);
+  ctx_.vf_.vkCmdBindIndexBuffer(
+      cmdBuffer_, bufIndex->getVkBuffer(), bufIndex->getVkBufferOffset(), type);
 
   ctx_.vf_.vkCmdDrawIndexedIndirect(cmdBuffer_,
                                     bufIndirect->getVkBuffer(),
-                                    indirectBufferOffset,
+                                    bufIndirect->getVkBufferOffset() + indirectBufferOffset,
                                     drawCount,
                                     stride ? stride : sizeof(VkDrawIndexedIndirectCommand));
 }
@@ -60,7 +60,8 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
                         const std::shared_ptr<IBuffer>& buffer,
                         size_t bufferOffset) override;
 
-  /// @brief Not implemented
+  /// @brief Copies `length` bytes into transient uniform memory and binds them as the
+  /// uniform buffer at `index`. `target` is ignored: uniform buffers are visible to all stages.
   void bindBytes(size_t index, uint8_t target, const void* data, size_t length) override;
 
   /// @brief Binds push constants pointed by `data` with `length` bytes starting at `offset`.
@@ -139,6 +140,11 @@ class RenderCommandEncoder : public IRenderCommandEncoder {
  private:
   VulkanContext& ctx_;
   VkCommandBuffer cmdBuffer_ = VK_NULL_HANDLE;
+  // where the command buffer is submitted, to recycle the memory of bindBytes()
+  const VulkanImmediateCommands* immediate_ = nullptr;
+  VulkanImmediateCommands::SubmitHandle submitHandle_;
+  // owned by the command buffer; transitions after the render pass are recorded in one batch
+  VulkanBarrierBatch* barriers_ = nullptr;
   bool isEncoding_ = false;
   bool hasDepthAttachment_ = false;
   std::shared_ptr<IFramebuffer> framebuffer_;
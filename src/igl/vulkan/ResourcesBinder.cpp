@@ -40,10 +40,25 @@ void ResourcesBinder::bindUniformBuffer(uint32_t index,
                  "The buffer must be a uniform buffer");
 
   VkBuffer buf = buffer ? buffer->getVkBuffer() : ctx_.dummyUniformBuffer_->getVkBuffer();
+  const VkDeviceSize offset = buffer ? buffer->getVkBufferOffset() + bufferOffset : 0;
+  const VkDeviceSize range = buffer ? buffer->getVkBufferRange(bufferOffset) : VK_WHOLE_SIZE;
+
+  bindUniformBuffer(index, buf, offset, range);
+}
+
+void ResourcesBinder::bindUniformBuffer(uint32_t index,
+                                        VkBuffer buffer,
+                                        VkDeviceSize offset,
+                                        VkDeviceSize range) {
+  if (!IGL_VERIFY(index < IGL_UNIFORM_BLOCKS_BINDING_MAX)) {
+    IGL_ASSERT_MSG(false, "Buffer index should not exceed kMaxBindingSlots");
+    return;
+  }
+
   VkDescriptorBufferInfo& slot = bindingsUniformBuffers_.buffers[index];
 
-  if (slot.buffer != buf || slot.offset != bufferOffset) {
-    slot = {buf, bufferOffset, VK_WHOLE_SIZE};
+  if (slot.buffer != buffer || slot.offset != offset || slot.range != range) {
+    slot = {buffer, offset, range};
     isDirtyFlags_ |= DirtyFlagBits_UniformBuffers;
   }
 }
@@ -62,10 +77,12 @@ void ResourcesBinder::bindStorageBuffer(uint32_t index,
                  "The buffer must be a storage buffer");
 
   VkBuffer buf = buffer ? buffer->getVkBuffer() : ctx_.dummyStorageBuffer_->getVkBuffer();
+  const VkDeviceSize offset = buffer ? buffer->getVkBufferOffset() + bufferOffset : 0;
+  const VkDeviceSize range = buffer ? buffer->getVkBufferRange(bufferOffset) : VK_WHOLE_SIZE;
   VkDescriptorBufferInfo& slot = bindingsStorageBuffers_.buffers[index];
 
-  if (slot.buffer != buf || slot.offset != bufferOffset) {
-    slot = {buf, bufferOffset, VK_WHOLE_SIZE};
+  if (slot.buffer != buf || slot.offset != offset || slot.range != range) {
+    slot = {buf, offset, range};
     isDirtyFlags_ |= DirtyFlagBits_StorageBuffers;
   }
 }
@@ -57,6 +57,10 @@ class ResourcesBinder final {
   /// @brief Binds a uniform buffer with an offset to index equal to `index`
   void bindUniformBuffer(uint32_t index, igl::vulkan::Buffer* buffer, size_t bufferOffset);
 
+  /// @brief Binds a range of a raw Vulkan uniform buffer to index equal to `index`. Used for
+  /// transient uniform data (`bindBytes()`)
+  void bindUniformBuffer(uint32_t index, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
   /// @brief Binds a storage buffer with an offset to index equal to `index`
   void bindStorageBuffer(uint32_t index, igl::vulkan::Buffer* buffer, size_t bufferOffset);
 
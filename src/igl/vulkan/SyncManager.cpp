@@ -7,6 +7,8 @@
 
 #include "SyncManager.h"
 
+#include <utility>
+
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanContext.h>
 
@@ -17,6 +19,7 @@ SyncManager::SyncManager(const VulkanContext& ctx, uint32_t maxResourceCount) :
   IGL_ASSERT_MSG(maxResourceCount_ > 0, "Max resource count needs to be greater than zero");
 
   submitHandles_.resize(maxResourceCount_);
+  computeSubmitHandles_.resize(maxResourceCount_);
 }
 
 uint32_t SyncManager::currentIndex() const noexcept {
@@ -34,6 +37,9 @@ void SyncManager::acquireNext() noexcept {
 
   // Wait for the current buffer to become available
   ctx_.immediate_->wait(submitHandles_[currentIndex_]);
+  if (ctx_.computeImmediate_) {
+    ctx_.computeImmediate_->wait(std::exchange(computeSubmitHandles_[currentIndex_], {}));
+  }
 }
 
 void SyncManager::markSubmitted(SubmitHandle handle) noexcept {
@@ -44,4 +50,8 @@ void SyncManager::markSubmitted(SubmitHandle handle) noexcept {
   acquireNext();
 }
 
+void SyncManager::markComputeSubmitted(SubmitHandle handle) noexcept {
+  computeSubmitHandles_[currentIndex_] = handle;
+}
+
 } // namespace igl::vulkan
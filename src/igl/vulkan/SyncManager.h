@@ -42,11 +42,16 @@ class SyncManager final {
   /// @brief Marks the given handle as submitted.
   void markSubmitted(SubmitHandle handle) noexcept;
 
+  /// @brief Marks the given handle of the async compute queue as submitted. The current index is
+  /// not advanced, but acquireNext() also waits for the last compute submission of each index.
+  void markComputeSubmitted(SubmitHandle handle) noexcept;
+
  private:
   const VulkanContext& ctx_;
   const uint32_t maxResourceCount_ = 1u;
   uint32_t currentIndex_ = 0u;
   std::vector<SubmitHandle> submitHandles_;
+  std::vector<SubmitHandle> computeSubmitHandles_;
 };
 
 } // namespace vulkan
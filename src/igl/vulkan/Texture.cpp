@@ -19,6 +19,21 @@
 namespace igl {
 namespace vulkan {
 
+namespace {
+
+bool isLinearTilingSupported(const VulkanContext& ctx, VkFormat format, VkImageUsageFlags usage) {
+  VkImageFormatProperties properties = {};
+  return ctx.vf_.vkGetPhysicalDeviceImageFormatProperties(ctx.getVkPhysicalDevice(),
+                                                          format,
+                                                          VK_IMAGE_TYPE_2D,
+                                                          VK_IMAGE_TILING_LINEAR,
+                                                          usage,
+                                                          0,
+                                                          &properties) == VK_SUCCESS;
+}
+
+} // namespace
+
 Texture::Texture(const igl::vulkan::Device& device, TextureFormat format) :
   ITexture(format), device_(device) {}
 
@@ -98,12 +113,26 @@ Result Texture::create(const TextureDesc& desc) {
                                                      : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
   }
 
-  // For now, always set this flag so we can read it back
-  usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  // Memoryless attachments only exist inside render passes, so they can be transient and live in
+  // lazily allocated memory which tile-based GPUs never back with physical pages
+  const bool isTransient = desc_.storage == ResourceStorage::Memoryless &&
+                           desc_.usage == TextureDesc::TextureUsageBits::Attachment;
+
+  if (isTransient) {
+    usageFlags |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+  } else {
+    // For now, always set this flag so we can read it back
+    usageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  }
 
   IGL_ASSERT_MSG(usageFlags != 0, "Invalid usage flags");
 
-  const VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
+  VkMemoryPropertyFlags memFlags = resourceStorageToVkMemoryPropertyFlags(desc_.storage);
+
+  if (desc_.storage == ResourceStorage::Memoryless &&
+      (!isTransient || !ctx.hasLazilyAllocatedMemory_)) {
+    memFlags &= ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+  }
 
   const std::string debugNameImage =
       !desc_.debugName.empty() ? IGL_FORMAT("Image: {}", desc_.debugName.c_str()) : "";
@@ -141,6 +170,15 @@ Result Texture::create(const TextureDesc& desc) {
     return Result(Result::Code::Unimplemented, "Unimplemented or unsupported texture type.");
   }
 
+  // on devices where all memory is host-visible, simple sampled textures can skip the staging
+  // buffer: the host writes texels straight into a linear-tiled image
+  const bool isHostWritable =
+      ctx.useDirectImageUploads_ && desc_.storage == ResourceStorage::Shared &&
+      desc_.type == TextureType::TwoD && desc_.numMipLevels == 1 && desc_.numLayers == 1 &&
+      samples == VK_SAMPLE_COUNT_1_BIT && !getProperties().isDepthOrStencil() &&
+      desc_.usage == TextureDesc::TextureUsageBits::Sampled &&
+      isLinearTilingSupported(ctx, vkFormat, usageFlags);
+
   Result result;
   auto image = ctx.createImage(
       imageType,
@@ -148,7 +186,7 @@ Result Texture::create(const TextureDesc& desc) {
       vkFormat,
       (uint32_t)desc_.numMipLevels,
       arrayLayerCount,
-      VK_IMAGE_TILING_OPTIMAL,
+      isHostWritable ? VK_IMAGE_TILING_LINEAR : VK_IMAGE_TILING_OPTIMAL,
       usageFlags,
       memFlags,
       createFlags,
@@ -189,7 +227,7 @@ Result Texture::create(const TextureDesc& desc) {
   texture_ = ctx.createTexture(std::move(image), std::move(imageView), desc.debugName.c_str());
 
   if (aspect == VK_IMAGE_ASPECT_COLOR_BIT && samples == VK_SAMPLE_COUNT_1_BIT &&
-      (usageFlags & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) != 0) {
+      (usageFlags & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) != 0 && !isTransient) {
     // always clear color attachments by default
     clearColorTexture({0, 0, 0, 1});
   }
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/TransientAttachmentPool.h>
+
+#include <algorithm>
+#include <numeric>
+
+#include <igl/vulkan/CommandBuffer.h>
+#include <igl/vulkan/Device.h>
+#include <igl/vulkan/Texture.h>
+#include <igl/vulkan/VulkanContext.h>
+#include <igl/vulkan/VulkanImage.h>
+#include <igl/vulkan/VulkanTexture.h>
+
+namespace igl::vulkan {
+
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+struct TransientAttachmentPool::Memory {
+  explicit Memory(VulkanContext& ctx) : ctx(ctx) {}
+  ~Memory() {
+    if (blocks.empty()) {
+      return;
+    }
+    ctx.deferredTask(std::packaged_task<void()>(
+        [vf = &ctx.vf_, device = ctx.getVkDevice(), blocks = std::move(blocks)]() {
+          for (VkDeviceMemory m : blocks) {
+            vf->vkFreeMemory(device, m, nullptr);
+          }
+        }));
+  }
+  Memory(const Memory&) = delete;
+  Memory& operator=(const Memory&) = delete;
+
+  VulkanContext& ctx;
+  std::vector<VkDeviceMemory> blocks;
+};
+
+TransientAttachmentPool::TransientAttachmentPool(Device& device) : device_(device) {}
+
+TransientAttachmentPool::~TransientAttachmentPool() {
+  release();
+}
+
+void TransientAttachmentPool::beginFrame() {
+  declarations_.clear();
+}
+
+TransientAttachmentPool::Handle TransientAttachmentPool::declare(const TextureDesc& desc,
+                                                                 uint32_t firstPass,
+                                                                 uint32_t lastPass) {
+  IGL_ASSERT(firstPass <= lastPass);
+
+  declarations_.push_back({desc, firstPass, std::max(firstPass, lastPass)});
+
+  return static_cast<Handle>(declarations_.size() - 1);
+}
+
+std::shared_ptr<ITexture> TransientAttachmentPool::getTexture(Handle handle) const {
+  if (!IGL_VERIFY(handle < attachments_.size())) {
+    return nullptr;
+  }
+  return attachments_[handle].texture;
+}
+
+void TransientAttachmentPool::release() {
+  VulkanContext& ctx = device_.getVulkanContext();
+
+  for (const Attachment& attachment : attachments_) {
+    // images wrapped into textures are destroyed by VulkanImage; the others were never used
+    if (!attachment.texture && attachment.image != VK_NULL_HANDLE) {
+      ctx.vf_.vkDestroyImage(ctx.getVkDevice(), attachment.image, nullptr);
+    }
+  }
+  attachments_.clear();
+
+  // the memory is freed here unless textures handed out by getTexture() are still alive
+  memory_.reset();
+
+  compiledDeclarations_.clear();
+  stats_ = {};
+}
+
+Result TransientAttachmentPool::compile() {
+  IGL_PROFILER_FUNCTION();
+
+  if (!attachments_.empty() && declarations_ == compiledDeclarations_) {
+    // same attachments as in the previous frame
+    return Result();
+  }
+
+  release();
+
+  if (declarations_.empty()) {
+    return Result();
+  }
+
+  VulkanContext& ctx = device_.getVulkanContext();
+  const VkDevice device = ctx.getVkDevice();
+
+  attachments_.resize(declarations_.size());
+  stats_.numAttachments = static_cast<uint32_t>(declarations_.size());
+
+  // 1. Create the images and query their memory requirements
+  for (size_t i = 0; i != declarations_.size(); i++) {
+    const TextureDesc& desc = declarations_[i].desc;
+    Attachment& attachment = attachments_[i];
+
+    if (desc.type != TextureType::TwoD || desc.numLayers != 1 || desc.numMipLevels != 1 ||
+        (desc.usage & TextureDesc::TextureUsageBits::Attachment) == 0) {
+      release();
+      return Result(Result::Code::Unsupported,
+                    "Transient attachments must be single-level 2D attachments");
+    }
+
+    const bool isDepthOrStencil =
+        TextureFormatProperties::fromTextureFormat(desc.format).isDepthOrStencil();
+    const bool isTransient = desc.storage == ResourceStorage::Memoryless &&
+                             desc.usage == TextureDesc::TextureUsageBits::Attachment;
+
+    attachment.format = isDepthOrStencil ? ctx.getClosestDepthStencilFormat(desc.format)
+                                         : textureFormatToVkFormat(desc.format);
+    attachment.samples = getVulkanSampleCountFlags(desc.numSamples);
+    attachment.usageFlags = isDepthOrStencil ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                                             : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    attachment.usageFlags |= isTransient ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+                                         : VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (desc.usage & TextureDesc::TextureUsageBits::Sampled) {
+      attachment.usageFlags |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    }
+    if (desc.usage & TextureDesc::TextureUsageBits::Storage) {
+      attachment.usageFlags |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    VkImageCreateInfo ci =
+        ivkGetImageCreateInfo(VK_IMAGE_TYPE_2D,
+                              attachment.format,
+                              VK_IMAGE_TILING_OPTIMAL,
+                              attachment.usageFlags,
+                              VkExtent3D{(uint32_t)desc.width, (uint32_t)desc.height, 1},
+                              1,
+                              1,
+                              0,
+                              attachment.samples);
+
+    // shared with the async compute queue family
+    if (ctx.deviceQueues_.numSharedQueueFamilies) {
+      ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+      ci.queueFamilyIndexCount = ctx.deviceQueues_.numSharedQueueFamilies;
+      ci.pQueueFamilyIndices = ctx.deviceQueues_.sharedQueueFamilyIndices;
+    }
+
+    const VkResult result = ctx.vf_.vkCreateImage(device, &ci, nullptr, &attachment.image);
+    if (result != VK_SUCCESS) {
+      release();
+      return getResultFromVkResult(result);
+    }
+
+    ctx.vf_.vkGetImageMemoryRequirements(device, attachment.image, &attachment.requirements);
+
+    const bool isLazilyAllocated = isTransient && ctx.hasLazilyAllocatedMemory_;
+    const VkMemoryPropertyFlags memFlags =
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+        (isLazilyAllocated ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0);
+
+    attachment.memoryTypeIndex = ivkFindMemoryType(
+        &ctx.vf_, ctx.getVkPhysicalDevice(), attachment.requirements.memoryTypeBits, memFlags);
+
+    stats_.requestedBytes += attachment.requirements.size;
+    stats_.numLazilyAllocated += isLazilyAllocated ? 1 : 0;
+  }
+
+  // 2. Place the attachments, largest first, at the lowest offset which does not overlap any
+  // already placed attachment of the same memory type with an intersecting lifetime
+  std::vector<size_t> order(attachments_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return attachments_[a].requirements.size > attachments_[b].requirements.size;
+  });
+
+  VkDeviceSize heapSizes[VK_MAX_MEMORY_TYPES] = {};
+
+  const auto livesTogether = [this](size_t a, size_t b) {
+    return declarations_[a].firstPass <= declarations_[b].lastPass &&
+           declarations_[b].firstPass <= declarations_[a].lastPass;
+  };
+
+  for (size_t n = 0; n != order.size(); n++) {
+    Attachment& attachment = attachments_[order[n]];
+    const VkDeviceSize size = attachment.requirements.size;
+    const VkDeviceSize alignment = attachment.requirements.alignment;
+
+    std::vector<std::pair<VkDeviceSize, VkDeviceSize>> busyRanges;
+    for (size_t k = 0; k != n; k++) {
+      const Attachment& other = attachments_[order[k]];
+      if (other.memoryTypeIndex == attachment.memoryTypeIndex &&
+          livesTogether(order[n], order[k])) {
+        busyRanges.emplace_back(other.offset, other.offset + other.requirements.size);
+      }
+    }
+    std::sort(busyRanges.begin(), busyRanges.end());
+
+    VkDeviceSize offset = 0;
+    for (const auto& [begin, end] : busyRanges) {
+      if (alignUp(offset, alignment) + size <= begin) {
+        break;
+      }
+      offset = std::max(offset, end);
+    }
+    attachment.offset = alignUp(offset, alignment);
+
+    VkDeviceSize& heapSize = heapSizes[attachment.memoryTypeIndex];
+    heapSize = std::max(heapSize, attachment.offset + size);
+  }
+
+  for (size_t i = 0; i != attachments_.size(); i++) {
+    for (size_t j = i + 1; j != attachments_.size(); j++) {
+      Attachment& a = attachments_[i];
+      Attachment& b = attachments_[j];
+      if (a.memoryTypeIndex == b.memoryTypeIndex && a.offset < b.offset + b.requirements.size &&
+          b.offset < a.offset + a.requirements.size) {
+        a.isAliased = b.isAliased = true;
+      }
+    }
+  }
+
+  // 3. Allocate one memory block per memory type and bind the images
+  VkDeviceMemory memory[VK_MAX_MEMORY_TYPES] = {};
+  memory_ = std::make_shared<Memory>(ctx);
+
+  for (uint32_t type = 0; type != VK_MAX_MEMORY_TYPES; type++) {
+    if (!heapSizes[type]) {
+      continue;
+    }
+    const VkMemoryAllocateInfo ai = {
+        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, heapSizes[type], type};
+    const VkResult result = ctx.vf_.vkAllocateMemory(device, &ai, nullptr, &memory[type]);
+    if (result != VK_SUCCESS) {
+      release();
+      return getResultFromVkResult(result);
+    }
+    memory_->blocks.push_back(memory[type]);
+    stats_.allocatedBytes += heapSizes[type];
+  }
+
+  for (Attachment& attachment : attachments_) {
+    VK_ASSERT(ctx.vf_.vkBindImageMemory(
+        device, attachment.image, memory[attachment.memoryTypeIndex], attachment.offset));
+    stats_.numAliased += attachment.isAliased ? 1 : 0;
+  }
+
+  // 4. Wrap the images into textures; from now on VulkanImage owns the VkImage objects
+  for (size_t i = 0; i != attachments_.size(); i++) {
+    const TextureDesc& desc = declarations_[i].desc;
+    Attachment& attachment = attachments_[i];
+
+    VulkanImageCreateInfo imageCreateInfo;
+    imageCreateInfo.usageFlags = attachment.usageFlags;
+    imageCreateInfo.isExternallyManaged = false;
+    imageCreateInfo.extent = VkExtent3D{(uint32_t)desc.width, (uint32_t)desc.height, 1};
+    imageCreateInfo.type = VK_IMAGE_TYPE_2D;
+    imageCreateInfo.imageFormat = attachment.format;
+    imageCreateInfo.samples = attachment.samples;
+
+    VulkanImageViewCreateInfo imageViewCreateInfo;
+    imageViewCreateInfo.format = attachment.format;
+    imageViewCreateInfo.aspectMask =
+        VulkanImage::isDepthFormat(attachment.format)     ? VK_IMAGE_ASPECT_DEPTH_BIT
+        : VulkanImage::isStencilFormat(attachment.format) ? VK_IMAGE_ASPECT_STENCIL_BIT
+                                                          : VK_IMAGE_ASPECT_COLOR_BIT;
+
+    auto vkTexture = ctx.createTextureFromVkImage(
+        attachment.image, imageCreateInfo, imageViewCreateInfo, desc.debugName.c_str());
+    if (!IGL_VERIFY(vkTexture)) {
+      release();
+      return Result(Result::Code::RuntimeError, "Cannot create transient attachment");
+    }
+    // the texture can outlive this pool entry and keeps the memory it is bound to alive
+    attachment.texture = std::shared_ptr<Texture>(
+        new Texture(device_, std::move(vkTexture), desc),
+        [memory = memory_](Texture* texture) { delete texture; });
+  }
+
+  compiledDeclarations_ = declarations_;
+
+#if IGL_DEBUG || defined(IGL_FORCE_ENABLE_LOGS)
+  if (ctx.config_.enableExtraLogs) {
+    IGL_LOG_INFO(
+        "Transient attachments: %u (%u aliased, %u lazily allocated), %llu KB allocated, %llu KB "
+        "saved\n",
+        stats_.numAttachments,
+        stats_.numAliased,
+        stats_.numLazilyAllocated,
+        (unsigned long long)(stats_.allocatedBytes / 1024),
+        (unsigned long long)(stats_.savedBytes() / 1024));
+  }
+#endif
+
+  return Result();
+}
+
+void TransientAttachmentPool::beginPass(ICommandBuffer& cmdBuffer, uint32_t passIndex) const {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
+
+  const VulkanContext& ctx = device_.getVulkanContext();
+  const VkCommandBuffer cmdBuf = static_cast<CommandBuffer&>(cmdBuffer).getVkCommandBuffer();
+
+  for (size_t i = 0; i != attachments_.size(); i++) {
+    const Attachment& attachment = attachments_[i];
+
+    if (!attachment.isAliased || compiledDeclarations_[i].firstPass != passIndex) {
+      continue;
+    }
+
+    const VulkanImage& img =
+        static_cast<const Texture&>(*attachment.texture).getVulkanTexture().getVulkanImage();
+    const bool isDepthOrStencil = img.isDepthOrStencilFormat_;
+    const VkImageLayout newLayout = isDepthOrStencil
+                                        ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+                                        : VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    // The memory was last written through another image: wait for those writes and discard the
+    // contents. A transition from VulkanImage::imageLayout_ would not wait for anything if the
+    // layout was undefined.
+    ivkImageMemoryBarrier(&ctx.vf_,
+                          cmdBuf,
+                          attachment.image,
+                          VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                              VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                              VK_ACCESS_SHADER_WRITE_BIT,
+                          isDepthOrStencil ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                           : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                                 VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                          VK_IMAGE_LAYOUT_UNDEFINED,
+                          newLayout,
+                          VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                              VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                              VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                          isDepthOrStencil ? VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                                 VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT
+                                           : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                          VkImageSubresourceRange{img.getImageAspectFlags(), 0, 1, 0, 1});
+
+    img.imageLayout_ = newLayout;
+  }
+}
+
+} // namespace igl::vulkan
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <igl/Texture.h>
+#include <igl/vulkan/Common.h>
+
+namespace igl {
+class ICommandBuffer;
+} // namespace igl
+
+namespace igl::vulkan {
+
+class Device;
+
+/// @brief A "frame graph lite" pool for render targets which only live during a part of a frame,
+/// such as G-buffers, MSAA targets or intermediate post-processing images.
+///
+/// Every frame, the application declares its attachments together with the range of passes
+/// [firstPass, lastPass] in which they are used, then calls compile(). Attachments with disjoint
+/// lifetimes are placed into the same device memory, so the pool needs only as much memory as the
+/// largest set of simultaneously live attachments. Attachments with ResourceStorage::Memoryless
+/// and only the Attachment usage are created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT and
+/// lazily allocated memory when the device supports it. If the declarations do not change from
+/// one frame to the next, compile() reuses the existing textures.
+///
+///   pool.beginFrame();
+///   const auto gbuffer = pool.declare(gbufferDesc, 0, 1);
+///   const auto bloom = pool.declare(bloomDesc, 2, 3); // can alias the G-buffer memory
+///   pool.compile();
+///   ...
+///   pool.beginPass(*cmdBuffer, 2); // before creating the render encoder of pass 2
+///
+/// Aliased attachments do not preserve their contents between frames and must be cleared (or fully
+/// overwritten) in their first pass. Textures returned by getTexture() keep their memory alive
+/// after the pool recompiles or is destroyed.
+class TransientAttachmentPool final {
+ public:
+  using Handle = uint32_t;
+
+  struct Stats {
+    uint32_t numAttachments = 0;
+    // attachments sharing memory with at least one other attachment
+    uint32_t numAliased = 0;
+    uint32_t numLazilyAllocated = 0;
+    // the memory the attachments would need without aliasing
+    VkDeviceSize requestedBytes = 0;
+    VkDeviceSize allocatedBytes = 0;
+
+    [[nodiscard]] VkDeviceSize savedBytes() const noexcept {
+      return requestedBytes - allocatedBytes;
+    }
+  };
+
+  explicit TransientAttachmentPool(Device& device);
+  ~TransientAttachmentPool();
+
+  TransientAttachmentPool(const TransientAttachmentPool&) = delete;
+  TransientAttachmentPool& operator=(const TransientAttachmentPool&) = delete;
+
+  /// @brief Starts a new set of declarations.
+  void beginFrame();
+
+  /// @brief Declares a 2D attachment used in the passes [firstPass, lastPass].
+  [[nodiscard]] Handle declare(const TextureDesc& desc, uint32_t firstPass, uint32_t lastPass);
+
+  /// @brief Places the declared attachments into memory and creates their textures, unless the
+  /// declarations are identical to the ones of the previous frame.
+  Result compile();
+
+  [[nodiscard]] std::shared_ptr<ITexture> getTexture(Handle handle) const;
+
+  /// @brief Records the barriers required before the attachments which start their lifetime in
+  /// the pass `passIndex` can overwrite memory previously used by other attachments. Must be
+  /// called outside of render passes.
+  void beginPass(ICommandBuffer& cmdBuffer, uint32_t passIndex) const;
+
+  /// @brief Returns the memory statistics of the last compiled frame.
+  [[nodiscard]] const Stats& getStats() const noexcept {
+    return stats_;
+  }
+
+ private:
+  struct Declaration {
+    TextureDesc desc;
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+
+    bool operator==(const Declaration& other) const {
+      return desc == other.desc && firstPass == other.firstPass && lastPass == other.lastPass;
+    }
+  };
+
+  struct Attachment {
+    std::shared_ptr<ITexture> texture;
+    VkImage image = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImageUsageFlags usageFlags = 0;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkMemoryRequirements requirements = {};
+    uint32_t memoryTypeIndex = 0;
+    VkDeviceSize offset = 0;
+    bool isAliased = false;
+  };
+
+  // the device memory of one compiled frame, freed once the pool and all textures it handed out
+  // have released it
+  struct Memory;
+
+  void release();
+
+ private:
+  Device& device_;
+  std::vector<Declaration> declarations_;
+  std::vector<Declaration> compiledDeclarations_;
+  std::vector<Attachment> attachments_;
+  std::shared_ptr<Memory> memory_;
+  Stats stats_;
+};
+
+} // namespace igl::vulkan
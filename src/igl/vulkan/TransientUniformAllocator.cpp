@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/TransientUniformAllocator.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <igl/vulkan/VulkanBuffer.h>
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl::vulkan {
+
+namespace {
+
+VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+TransientUniformAllocator::TransientUniformAllocator(const VulkanContext& ctx,
+                                                     VkDeviceSize blockSize) :
+  ctx_(ctx),
+  blockSize_(std::min<VkDeviceSize>(
+      blockSize,
+      ctx.getVkPhysicalDeviceProperties().limits.maxUniformBufferRange)) {
+  // keep the ranges multiples of 16 bytes so they can hold any std140 member
+  alignment_ = std::max<VkDeviceSize>(
+      16, ctx.getVkPhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment);
+}
+
+TransientUniformAllocator::~TransientUniformAllocator() = default;
+
+bool TransientUniformAllocator::isFree(Block& block) {
+  for (const User& user : block.users) {
+    if (!user.immediate->isReady(user.handle)) {
+      return false;
+    }
+  }
+  block.users.clear();
+  return true;
+}
+
+TransientUniformAllocator::Allocation TransientUniformAllocator::allocate(
+    const VulkanImmediateCommands& immediate,
+    VulkanImmediateCommands::SubmitHandle handle,
+    const void* data,
+    size_t length) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!IGL_VERIFY(data && length)) {
+    return {};
+  }
+
+  const VkDeviceSize size = alignSize(length, 16);
+
+  if (!IGL_VERIFY(size <= blockSize_)) {
+    IGL_ASSERT_MSG(false,
+                   "Transient uniform data cannot exceed %llu bytes",
+                   (unsigned long long)blockSize_);
+    return {};
+  }
+
+  VkDeviceSize offset = alignSize(offset_, alignment_);
+
+  if (blocks_.empty() || offset + size > blockSize_) {
+    // the current block is full: continue with one the GPU is done with, or with a new one
+    size_t next = 0;
+    while (next != blocks_.size() && (next == currentBlock_ || !isFree(blocks_[next]))) {
+      next++;
+    }
+    if (next == blocks_.size()) {
+      Result result;
+      auto buffer = ctx_.createBuffer(blockSize_,
+                                      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      &result,
+                                      "Buffer: transient uniforms");
+      if (!IGL_VERIFY(result.isOk() && buffer && buffer->isMapped())) {
+        return {};
+      }
+      blocks_.push_back({std::move(buffer), {}});
+    }
+    currentBlock_ = next;
+    offset = 0;
+  }
+
+  Block& block = blocks_[currentBlock_];
+
+  const bool isKnownUser =
+      std::any_of(block.users.begin(), block.users.end(), [&](const User& user) {
+        return user.immediate == &immediate && user.handle.handle() == handle.handle();
+      });
+  if (!isKnownUser) {
+    block.users.push_back({&immediate, handle});
+  }
+
+  // the memory is host-coherent, so no flush is required
+  memcpy(block.buffer->getMappedPtr() + offset, data, length);
+
+  offset_ = offset + size;
+
+  return {block.buffer->getVkBuffer(), offset, size};
+}
+
+} // namespace igl::vulkan
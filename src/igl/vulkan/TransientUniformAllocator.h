@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanImmediateCommands.h>
+
+namespace igl::vulkan {
+
+class VulkanBuffer;
+class VulkanContext;
+
+/// @brief A linear allocator for small, short-lived uniform data such as the per-draw constants
+/// passed to `bindBytes()`. Allocations are bump-allocated from a host-visible, persistently mapped
+/// uniform buffer block and written with a single memcpy; no staging or buffer creation is involved
+/// once the blocks have been allocated. Each block remembers the submissions of the command buffers
+/// that allocated from it. When the current block is full, allocations continue in a block whose
+/// submissions have all completed, so blocks are recycled even when no frame is presented, and
+/// their number is bounded by the work in flight.
+class TransientUniformAllocator final {
+ public:
+  /// @brief A slice of a transient uniform buffer which can be bound to a descriptor.
+  struct Allocation {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+  };
+
+  static constexpr VkDeviceSize kDefaultBlockSize = 64 * 1024;
+
+  explicit TransientUniformAllocator(const VulkanContext& ctx,
+                                     VkDeviceSize blockSize = kDefaultBlockSize);
+  ~TransientUniformAllocator();
+
+  TransientUniformAllocator(const TransientUniformAllocator&) = delete;
+  TransientUniformAllocator& operator=(const TransientUniformAllocator&) = delete;
+
+  /// @brief Copies `length` bytes from `data` into transient memory read by the command buffer
+  /// `handle` of `immediate`. The returned allocation is valid until that submission completes.
+  /// Returns an empty allocation if `length` exceeds the block size or the memory could not be
+  /// allocated.
+  [[nodiscard]] Allocation allocate(const VulkanImmediateCommands& immediate,
+                                    VulkanImmediateCommands::SubmitHandle handle,
+                                    const void* data,
+                                    size_t length);
+
+  [[nodiscard]] VkDeviceSize getBlockSize() const noexcept {
+    return blockSize_;
+  }
+
+  [[nodiscard]] size_t getNumBlocks() const noexcept {
+    return blocks_.size();
+  }
+
+ private:
+  struct User {
+    const VulkanImmediateCommands* immediate = nullptr;
+    VulkanImmediateCommands::SubmitHandle handle;
+  };
+  struct Block {
+    std::unique_ptr<VulkanBuffer> buffer;
+    // command buffers that read the block; it can be rewound once all of them have completed
+    std::vector<User> users;
+  };
+
+  /// Returns true if the GPU is done with `block`, and forgets its users.
+  static bool isFree(Block& block);
+
+  const VulkanContext& ctx_;
+  const VkDeviceSize blockSize_;
+  VkDeviceSize alignment_ = 16;
+  std::vector<Block> blocks_;
+  size_t currentBlock_ = 0;
+  VkDeviceSize offset_ = 0;
+};
+
+} // namespace igl::vulkan
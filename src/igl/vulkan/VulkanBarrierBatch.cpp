@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanBarrierBatch.h>
+
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl::vulkan {
+
+namespace {
+
+bool isSameRange(const VkImageSubresourceRange& a, const VkImageSubresourceRange& b) {
+  return a.aspectMask == b.aspectMask && a.baseMipLevel == b.baseMipLevel &&
+         a.levelCount == b.levelCount && a.baseArrayLayer == b.baseArrayLayer &&
+         a.layerCount == b.layerCount;
+}
+
+} // namespace
+
+VulkanBarrierBatch::VulkanBarrierBatch(const VulkanContext& ctx) : ctx_(ctx) {}
+
+void VulkanBarrierBatch::begin(VkCommandBuffer cmdBuf) {
+  if (cmdBuf_ != cmdBuf) {
+    flush();
+    cmdBuf_ = cmdBuf;
+  }
+}
+
+void VulkanBarrierBatch::addImageBarrier(const VkImageMemoryBarrier& barrier,
+                                         VkPipelineStageFlags srcStageMask,
+                                         VkPipelineStageFlags dstStageMask) {
+  IGL_ASSERT(cmdBuf_ != VK_NULL_HANDLE);
+
+  ctx_.barrierStats_.numBarriers++;
+
+  for (size_t i = 0; i != imageBarriers_.size(); i++) {
+    VkImageMemoryBarrier& pending = imageBarriers_[i];
+    if (pending.image != barrier.image) {
+      continue;
+    }
+    if (!isSameRange(pending.subresourceRange, barrier.subresourceRange)) {
+      // the two transitions have to happen in order
+      flush();
+      break;
+    }
+    // nothing can access the image between the two barriers, so only the first source scope and
+    // the final layout matter
+    IGL_ASSERT(pending.newLayout == barrier.oldLayout);
+    pending.newLayout = barrier.newLayout;
+    pending.dstAccessMask |= barrier.dstAccessMask;
+    imageStages_[i].dst |= dstStageMask;
+    return;
+  }
+
+  imageBarriers_.push_back(barrier);
+  imageStages_.push_back({srcStageMask, dstStageMask});
+}
+
+void VulkanBarrierBatch::addBufferBarrier(const VkBufferMemoryBarrier& barrier,
+                                          VkPipelineStageFlags srcStageMask,
+                                          VkPipelineStageFlags dstStageMask) {
+  IGL_ASSERT(cmdBuf_ != VK_NULL_HANDLE);
+
+  ctx_.barrierStats_.numBarriers++;
+
+  for (size_t i = 0; i != bufferBarriers_.size(); i++) {
+    VkBufferMemoryBarrier& pending = bufferBarriers_[i];
+    if (pending.buffer == barrier.buffer && pending.offset == barrier.offset &&
+        pending.size == barrier.size) {
+      pending.srcAccessMask |= barrier.srcAccessMask;
+      pending.dstAccessMask |= barrier.dstAccessMask;
+      bufferStages_[i].src |= srcStageMask;
+      bufferStages_[i].dst |= dstStageMask;
+      return;
+    }
+  }
+
+  bufferBarriers_.push_back(barrier);
+  bufferStages_.push_back({srcStageMask, dstStageMask});
+}
+
+void VulkanBarrierBatch::flush() {
+  if (empty()) {
+    return;
+  }
+
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
+
+  ctx_.barrierStats_.numPipelineBarrierCalls++;
+
+#if defined(VK_KHR_synchronization2)
+  if (ctx_.useSynchronization2_) {
+    // legacy stage and access bits have the same values in the 64-bit *2 flags
+    std::vector<VkImageMemoryBarrier2KHR> imageBarriers(imageBarriers_.size());
+    for (size_t i = 0; i != imageBarriers_.size(); i++) {
+      const VkImageMemoryBarrier& b = imageBarriers_[i];
+      VkImageMemoryBarrier2KHR& b2 = imageBarriers[i];
+      b2.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+      b2.srcStageMask = imageStages_[i].src;
+      b2.srcAccessMask = b.srcAccessMask;
+      b2.dstStageMask = imageStages_[i].dst;
+      b2.dstAccessMask = b.dstAccessMask;
+      b2.oldLayout = b.oldLayout;
+      b2.newLayout = b.newLayout;
+      b2.srcQueueFamilyIndex = b.srcQueueFamilyIndex;
+      b2.dstQueueFamilyIndex = b.dstQueueFamilyIndex;
+      b2.image = b.image;
+      b2.subresourceRange = b.subresourceRange;
+    }
+    std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers(bufferBarriers_.size());
+    for (size_t i = 0; i != bufferBarriers_.size(); i++) {
+      const VkBufferMemoryBarrier& b = bufferBarriers_[i];
+      VkBufferMemoryBarrier2KHR& b2 = bufferBarriers[i];
+      b2.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+      b2.srcStageMask = bufferStages_[i].src;
+      b2.srcAccessMask = b.srcAccessMask;
+      b2.dstStageMask = bufferStages_[i].dst;
+      b2.dstAccessMask = b.dstAccessMask;
+      b2.srcQueueFamilyIndex = b.srcQueueFamilyIndex;
+      b2.dstQueueFamilyIndex = b.dstQueueFamilyIndex;
+      b2.buffer = b.buffer;
+      b2.offset = b.offset;
+      b2.size = b.size;
+    }
+    VkDependencyInfoKHR dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+    ctx_.vf_.vkCmdPipelineBarrier2KHR(cmdBuf_, &dependencyInfo);
+  } else
+#endif // defined(VK_KHR_synchronization2)
+  {
+    StageMasks stages;
+    for (const StageMasks& s : imageStages_) {
+      stages.src |= s.src;
+      stages.dst |= s.dst;
+    }
+    for (const StageMasks& s : bufferStages_) {
+      stages.src |= s.src;
+      stages.dst |= s.dst;
+    }
+    ctx_.vf_.vkCmdPipelineBarrier(cmdBuf_,
+                                  stages.src,
+                                  stages.dst,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  static_cast<uint32_t>(bufferBarriers_.size()),
+                                  bufferBarriers_.data(),
+                                  static_cast<uint32_t>(imageBarriers_.size()),
+                                  imageBarriers_.data());
+  }
+
+  imageBarriers_.clear();
+  imageStages_.clear();
+  bufferBarriers_.clear();
+  bufferStages_.clear();
+}
+
+} // namespace igl::vulkan
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+
+namespace igl::vulkan {
+
+class VulkanContext;
+
+/// @brief Accumulates image and buffer memory barriers and records all of them with a single
+/// vkCmdPipelineBarrier() call in flush(). With VK_KHR_synchronization2, vkCmdPipelineBarrier2KHR()
+/// is used instead, so every barrier keeps its own stage masks; otherwise the stage masks of all
+/// barriers are combined.
+///
+/// Barriers within one vkCmdPipelineBarrier() call are not ordered relative to each other, so two
+/// barriers of the same image and subresource range are coalesced into one transition from the
+/// layout of the first to the layout of the second. Adding a barrier for an overlapping but
+/// different subresource range of the same image flushes the batch first.
+class VulkanBarrierBatch final {
+ public:
+  explicit VulkanBarrierBatch(const VulkanContext& ctx);
+
+  /// @brief Binds the batch to the command buffer barriers will be recorded into. Pending barriers
+  /// are flushed into the previous command buffer.
+  void begin(VkCommandBuffer cmdBuf);
+
+  void addImageBarrier(const VkImageMemoryBarrier& barrier,
+                       VkPipelineStageFlags srcStageMask,
+                       VkPipelineStageFlags dstStageMask);
+
+  void addBufferBarrier(const VkBufferMemoryBarrier& barrier,
+                        VkPipelineStageFlags srcStageMask,
+                        VkPipelineStageFlags dstStageMask);
+
+  [[nodiscard]] bool empty() const noexcept {
+    return imageBarriers_.empty() && bufferBarriers_.empty();
+  }
+
+  /// @brief Records all pending barriers. Must be called outside of render passes.
+  void flush();
+
+ private:
+  struct StageMasks {
+    VkPipelineStageFlags src = 0;
+    VkPipelineStageFlags dst = 0;
+  };
+
+  const VulkanContext& ctx_;
+  VkCommandBuffer cmdBuf_ = VK_NULL_HANDLE;
+  std::vector<VkImageMemoryBarrier> imageBarriers_;
+  std::vector<StageMasks> imageStages_;
+  std::vector<VkBufferMemoryBarrier> bufferBarriers_;
+  std::vector<StageMasks> bufferStages_;
+};
+
+} // namespace igl::vulkan
@@ -19,7 +19,8 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
                            VkDeviceSize bufferSize,
                            VkBufferUsageFlags usageFlags,
                            VkMemoryPropertyFlags memFlags,
-                           const char* debugName) :
+                           const char* debugName,
+                           Result* outResult) :
   ctx_(ctx),
   device_(device),
   bufferSize_(bufferSize),
@@ -30,7 +31,14 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
   IGL_ASSERT(bufferSize > 0);
 
   // Initialize Buffer Info
-  const VkBufferCreateInfo ci = ivkGetBufferCreateInfo(bufferSize, usageFlags);
+  VkBufferCreateInfo ci = ivkGetBufferCreateInfo(bufferSize, usageFlags);
+
+  // shared with the async compute queue family
+  if (ctx_.deviceQueues_.numSharedQueueFamilies) {
+    ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    ci.queueFamilyIndexCount = ctx_.deviceQueues_.numSharedQueueFamilies;
+    ci.pQueueFamilyIndices = ctx_.deviceQueues_.sharedQueueFamilyIndices;
+  }
 
   if (IGL_VULKAN_USE_VMA) {
     VmaAllocationCreateInfo ciAlloc = {};
@@ -60,9 +68,14 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
 
     ciAlloc.usage = VMA_MEMORY_USAGE_AUTO;
 
-    vmaCreateBuffer(
+    const VkResult result = vmaCreateBuffer(
         (VmaAllocator)ctx_.getVmaAllocator(), &ci, &ciAlloc, &vkBuffer_, &vmaAllocation_, nullptr);
-    IGL_ASSERT(vmaAllocation_ != nullptr);
+    if (result != VK_SUCCESS) {
+      vkBuffer_ = VK_NULL_HANDLE;
+      vmaAllocation_ = nullptr;
+      Result::setResult(outResult, getResultFromVkResult(result));
+      return;
+    }
 
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
@@ -70,7 +83,12 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
     }
   } else {
     // create buffer
-    VK_ASSERT(ctx_.vf_.vkCreateBuffer(device_, &ci, nullptr, &vkBuffer_));
+    const VkResult result = ctx_.vf_.vkCreateBuffer(device_, &ci, nullptr, &vkBuffer_);
+    if (result != VK_SUCCESS) {
+      vkBuffer_ = VK_NULL_HANDLE;
+      Result::setResult(outResult, getResultFromVkResult(result));
+      return;
+    }
 
     // back the buffer with some memory
     {
@@ -80,19 +98,21 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
         isCoherentMemory_ = true;
       }
 
-      VK_ASSERT(ivkAllocateMemory(&ctx_.vf_,
-                                  ctx_.getVkPhysicalDevice(),
-                                  device_,
-                                  &requirements,
-                                  memFlags,
-                                  ctx.config_.enableBufferDeviceAddress,
-                                  &vkMemory_));
-      VK_ASSERT(ctx_.vf_.vkBindBufferMemory(device_, vkBuffer_, vkMemory_, 0));
+      // sub-allocate from a larger block; host-visible blocks are persistently mapped
+      memoryAllocation_ =
+          ctx_.getMemoryAllocator()->allocate(requirements, memFlags, true, outResult);
+      if (!memoryAllocation_.valid()) {
+        ctx_.vf_.vkDestroyBuffer(device_, vkBuffer_, nullptr);
+        vkBuffer_ = VK_NULL_HANDLE;
+        return;
+      }
+      VK_ASSERT(ctx_.vf_.vkBindBufferMemory(
+          device_, vkBuffer_, memoryAllocation_.memory, memoryAllocation_.offset));
     }
 
     // handle memory-mapped buffers
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      VK_ASSERT(ctx_.vf_.vkMapMemory(device_, vkMemory_, 0, bufferSize_, 0, &mappedPtr_));
+      mappedPtr_ = memoryAllocation_.mappedPtr;
     }
   }
 
@@ -109,28 +129,36 @@ VulkanBuffer::VulkanBuffer(const VulkanContext& ctx,
     vkDeviceAddress_ = ctx_.vf_.vkGetBufferDeviceAddressKHR(device_, &ai);
     IGL_ASSERT(vkDeviceAddress_);
   }
+
+  Result::setOk(outResult);
 }
 
 VulkanBuffer::~VulkanBuffer() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
+  if (!valid()) {
+    return;
+  }
+
   if (IGL_VULKAN_USE_VMA) {
     if (mappedPtr_) {
       vmaUnmapMemory((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_);
     }
-    ctx_.deferredTask(std::packaged_task<void()>(
+    std::packaged_task<void()> task(
         [vma = ctx_.getVmaAllocator(), buffer = vkBuffer_, allocation = vmaAllocation_]() {
           vmaDestroyBuffer((VmaAllocator)vma, buffer, allocation);
-        }));
+        });
+    ctx_.deferredTask(std::move(task), VulkanContext::SubmitHandle(), bufferSize_);
   } else {
-    if (mappedPtr_) {
-      ctx_.vf_.vkUnmapMemory(device_, vkMemory_);
-    }
-    ctx_.deferredTask(std::packaged_task<void()>(
-        [vf = &ctx_.vf_, device = device_, buffer = vkBuffer_, memory = vkMemory_]() {
-          vf->vkDestroyBuffer(device, buffer, nullptr);
-          vf->vkFreeMemory(device, memory, nullptr);
-        }));
+    std::packaged_task<void()> task([vf = &ctx_.vf_,
+                                     device = device_,
+                                     buffer = vkBuffer_,
+                                     allocator = ctx_.getMemoryAllocator(),
+                                     allocation = memoryAllocation_]() {
+      vf->vkDestroyBuffer(device, buffer, nullptr);
+      allocator->free(allocation);
+    });
+    ctx_.deferredTask(std::move(task), VulkanContext::SubmitHandle(), bufferSize_);
   }
 }
 
@@ -142,14 +170,7 @@ void VulkanBuffer::flushMappedMemory(VkDeviceSize offset, VkDeviceSize size) con
   if (IGL_VULKAN_USE_VMA) {
     vmaFlushAllocation((VmaAllocator)ctx_.getVmaAllocator(), vmaAllocation_, offset, size);
   } else {
-    const VkMappedMemoryRange memoryRange{
-        VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-        nullptr,
-        vkMemory_,
-        offset,
-        size,
-    };
-    ctx_.vf_.vkFlushMappedMemoryRanges(device_, 1, &memoryRange);
+    ctx_.getMemoryAllocator()->flush(memoryAllocation_, offset, size);
   }
 }
 
@@ -162,14 +183,7 @@ void VulkanBuffer::invalidateMappedMemory(VkDeviceSize offset, VkDeviceSize size
     vmaInvalidateAllocation(
         static_cast<VmaAllocator>(ctx_.getVmaAllocator()), vmaAllocation_, offset, size);
   } else {
-    const VkMappedMemoryRange memoryRange = {
-        VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-        nullptr,
-        vkMemory_,
-        offset,
-        size,
-    };
-    ctx_.vf_.vkInvalidateMappedMemoryRanges(device_, 1, &memoryRange);
+    ctx_.getMemoryAllocator()->invalidate(memoryAllocation_, offset, size);
   }
 }
 
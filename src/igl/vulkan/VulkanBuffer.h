@@ -11,6 +11,7 @@
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
+#include <igl/vulkan/VulkanMemoryAllocator.h>
 
 namespace igl {
 namespace vulkan {
@@ -24,14 +25,16 @@ class VulkanBuffer {
   /** @brief Creates a new VulkanBuffer with a given size, usage flags, memory property flags, and
    * an optional debug name. Uses VMA if IGL is built with VMA support. If memory flags specify
    * that the buffer is visible by the host (the CPU), then the buffer's memory will be mapped into
-   * the application's address space and can be accessed directly.
+   * the application's address space and can be accessed directly. If the buffer or its memory
+   * cannot be created, `outResult` receives the error and valid() returns false.
    */
   VulkanBuffer(const VulkanContext& ctx,
                VkDevice device,
                VkDeviceSize bufferSize,
                VkBufferUsageFlags usageFlags,
                VkMemoryPropertyFlags memFlags,
-               const char* debugName = nullptr);
+               const char* debugName = nullptr,
+               Result* outResult = nullptr);
   ~VulkanBuffer();
 
   VulkanBuffer(const VulkanBuffer&) = delete;
@@ -67,6 +70,12 @@ class VulkanBuffer {
   /// @brief Invalidates the mapped memory range to make it visible to the CPU.
   void invalidateMappedMemory(VkDeviceSize offset, VkDeviceSize size) const;
 
+  /// @brief Returns false if the buffer or its memory could not be created; see the `outResult`
+  /// parameter of the constructor.
+  [[nodiscard]] bool valid() const {
+    return vkBuffer_ != VK_NULL_HANDLE;
+  }
+
   VkBuffer getVkBuffer() const {
     return vkBuffer_;
   }
@@ -91,7 +100,7 @@ class VulkanBuffer {
   const VulkanContext& ctx_;
   VkDevice device_ = VK_NULL_HANDLE;
   VkBuffer vkBuffer_ = VK_NULL_HANDLE;
-  VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
+  VulkanMemoryAllocator::Allocation memoryAllocation_; // used when VMA is disabled
   VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
   VkDeviceAddress vkDeviceAddress_ = 0;
   VkDeviceSize bufferSize_ = 0;
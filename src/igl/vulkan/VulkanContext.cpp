@@ -6,9 +6,13 @@
  */
 
 #include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <igl/IGLSafeC.h>
@@ -27,12 +31,14 @@
 #include <igl/vulkan/Device.h>
 #include <igl/vulkan/EnhancedShaderDebuggingStore.h>
 #include <igl/vulkan/SyncManager.h>
+#include <igl/vulkan/TransientUniformAllocator.h>
 #include <igl/vulkan/VulkanBuffer.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanDescriptorSetLayout.h>
 #include <igl/vulkan/VulkanDevice.h>
 #include <igl/vulkan/VulkanExtensions.h>
 #include <igl/vulkan/VulkanImageView.h>
+#include <igl/vulkan/VulkanMemoryAllocator.h>
 #include <igl/vulkan/VulkanPipelineBuilder.h>
 #include <igl/vulkan/VulkanPipelineLayout.h>
 #include <igl/vulkan/VulkanSampler.h>
@@ -212,12 +218,12 @@ class DescriptorPoolsArena final {
     dsl_(dsl) {
     IGL_ASSERT(debugName);
     dpDebugName_ = IGL_FORMAT("Descriptor Pool: {}", debugName ? debugName : "");
-    switchToNewDescriptorPool(*ctx.immediate_, {});
+    switchToNewDescriptorPool(*ctx.immediate_, {}, nullptr);
   }
   ~DescriptorPoolsArena() {
     // arenas are destroyed by VulkanContext after the GPU has been synchronized, so we do not have
     // to defer the destruction
-    extinct_.push_back({pool_, {}});
+    extinct_.push_back({pool_, {}, {}});
     for (const auto& p : extinct_) {
       vf_.vkDestroyDescriptorPool(device_, p.pool_, nullptr);
     }
@@ -225,12 +231,14 @@ class DescriptorPoolsArena final {
   [[nodiscard]] VkDescriptorSetLayout getVkDescriptorSetLayout() const {
     return dsl_;
   }
+  // `computeIc` tracks the submissions of the async compute queue, if any
   [[nodiscard]] VkDescriptorSet getNextDescriptorSet(
       VulkanImmediateCommands& ic,
-      VulkanImmediateCommands::SubmitHandle lastSubmitHandle) {
+      VulkanImmediateCommands::SubmitHandle lastSubmitHandle,
+      VulkanImmediateCommands* computeIc) {
     VkDescriptorSet dset = VK_NULL_HANDLE;
     if (!numRemainingDSetsInPool_) {
-      switchToNewDescriptorPool(ic, lastSubmitHandle);
+      switchToNewDescriptorPool(ic, lastSubmitHandle, computeIc);
     }
     VK_ASSERT(ivkAllocateDescriptorSet(&vf_, device_, pool_, dsl_, &dset));
     numRemainingDSetsInPool_--;
@@ -239,16 +247,20 @@ class DescriptorPoolsArena final {
 
  private:
   void switchToNewDescriptorPool(VulkanImmediateCommands& ic,
-                                 VulkanImmediateCommands::SubmitHandle lastSubmitHandle) {
+                                 VulkanImmediateCommands::SubmitHandle lastSubmitHandle,
+                                 VulkanImmediateCommands* computeIc) {
     numRemainingDSetsInPool_ = kNumDSetsPerPool_;
 
     if (pool_ != VK_NULL_HANDLE) {
-      extinct_.push_back({pool_, lastSubmitHandle});
+      extinct_.push_back({pool_,
+                          lastSubmitHandle,
+                          computeIc ? computeIc->getLastSubmitHandle()
+                                    : VulkanImmediateCommands::SubmitHandle{}});
     }
     // first, let's try to reuse the oldest extinct pool
     if (extinct_.size() > 1) {
       const ExtinctDescriptorPool p = extinct_.front();
-      if (ic.isRecycled(p.handle_)) {
+      if (ic.isRecycled(p.handle_) && (!computeIc || computeIc->isReady(p.computeHandle_))) {
         pool_ = p.pool_;
         extinct_.pop_front();
         VK_ASSERT(vf_.vkResetDescriptorPool(device_, pool_, VkDescriptorPoolResetFlags{}));
@@ -279,6 +291,7 @@ class DescriptorPoolsArena final {
   struct ExtinctDescriptorPool {
     VkDescriptorPool pool_ = VK_NULL_HANDLE;
     VulkanImmediateCommands::SubmitHandle handle_ = {};
+    VulkanImmediateCommands::SubmitHandle computeHandle_ = {};
   };
 
   std::deque<ExtinctDescriptorPool> extinct_;
@@ -339,6 +352,71 @@ struct VulkanContextImpl final {
         ctx, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, dsl, numBindings, "arenaBuffersStorage_");
     return *arenaBuffersStorage_[dsl].get();
   }
+
+  // Retires deferred tasks handed over by processDeferredTasks() on a background thread
+  // (VulkanContextConfig::enableBackgroundDeferredTasks)
+  class DeferredTaskThread final {
+   public:
+    DeferredTaskThread() : thread_([this]() { run(); }) {}
+    ~DeferredTaskThread() {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isStopping_ = true;
+      }
+      condition_.notify_one();
+      thread_.join();
+    }
+    void enqueue(std::packaged_task<void()>&& task) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.emplace_back(std::move(task));
+      }
+      condition_.notify_one();
+    }
+    // blocks until all enqueued tasks have run
+    void waitIdle() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      idleCondition_.wait(lock, [this]() { return tasks_.empty() && !isBusy_; });
+    }
+    [[nodiscard]] uint32_t getNumPendingTasks() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return static_cast<uint32_t>(tasks_.size()) + (isBusy_ ? 1u : 0u);
+    }
+
+   private:
+    void run() {
+      IGL_PROFILER_THREAD("DeferredTasks");
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true) {
+        condition_.wait(lock, [this]() { return isStopping_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          // stopping
+          return;
+        }
+        std::packaged_task<void()> task = std::move(tasks_.front());
+        tasks_.pop_front();
+        isBusy_ = true;
+        lock.unlock();
+        task();
+        lock.lock();
+        isBusy_ = false;
+        if (tasks_.empty()) {
+          idleCondition_.notify_all();
+        }
+      }
+    }
+
+   private:
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable idleCondition_;
+    std::deque<std::packaged_task<void()>> tasks_;
+    bool isBusy_ = false;
+    bool isStopping_ = false;
+    // declared last so it starts after the other members are initialized
+    std::thread thread_;
+  };
+  std::unique_ptr<DeferredTaskThread> deferredTaskThread_;
 };
 
 VulkanContext::VulkanContext(const VulkanContextConfig& config,
@@ -351,6 +429,10 @@ VulkanContext::VulkanContext(const VulkanContextConfig& config,
 
   pimpl_ = std::make_unique<VulkanContextImpl>();
 
+  if (config_.enableBackgroundDeferredTasks) {
+    pimpl_->deferredTaskThread_ = std::make_unique<VulkanContextImpl::DeferredTaskThread>();
+  }
+
   const auto result = volkInitialize();
 
   // Do not remove for backward compatibility with projects using global functions.
@@ -386,6 +468,7 @@ VulkanContext::~VulkanContext() {
 
   enhancedShaderDebuggingStore_.reset(nullptr);
 
+  transientUniformAllocator_.reset();
   dummyStorageBuffer_.reset();
   dummyUniformBuffer_.reset();
 #if IGL_DEBUG
@@ -424,7 +507,9 @@ VulkanContext::~VulkanContext() {
   swapchain_.reset(nullptr); // Swapchain has to be destroyed prior to Surface
 
   waitDeferredTasks();
+  pimpl_->deferredTaskThread_.reset();
 
+  computeImmediate_.reset(nullptr);
   immediate_.reset(nullptr);
 
   if (device_) {
@@ -443,6 +528,7 @@ VulkanContext::~VulkanContext() {
   if (IGL_VULKAN_USE_VMA) {
     vmaDestroyAllocator(pimpl_->vma_);
   }
+  memoryAllocator_.reset();
 
   device_.reset(nullptr); // Device has to be destroyed prior to Instance
 #if defined(VK_EXT_debug_utils) && !IGL_PLATFORM_ANDROID
@@ -584,6 +670,8 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
   vkPhysicalDevice_ = (VkPhysicalDevice)desc.guid;
 
   useStagingForBuffers_ = !ivkIsHostVisibleSingleHeapMemory(&vf_, vkPhysicalDevice_);
+  useDirectImageUploads_ = config_.enableDirectImageUploads && !useStagingForBuffers_;
+  hasLazilyAllocatedMemory_ = ivkHasLazilyAllocatedMemory(&vf_, vkPhysicalDevice_);
 
   vf_.vkGetPhysicalDeviceFeatures2(vkPhysicalDevice_, &vkPhysicalDeviceFeatures2_);
   vf_.vkGetPhysicalDeviceProperties2(vkPhysicalDevice_, &vkPhysicalDeviceProperties2_);
@@ -625,6 +713,28 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
     (void)IGL_VERIFY(extensions_.enable(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
                                         VulkanExtensions::ExtensionType::Device));
   }
+  // exported fences cannot be emulated with timeline semaphores; async compute uses them for
+  // cross-queue waits in either mode
+  const bool wantsTimelineSemaphores =
+      (config_.enableTimelineSemaphores && !config_.exportableFences) || config_.enableAsyncCompute;
+  hasTimelineSemaphores_ = wantsTimelineSemaphores &&
+                           vkPhysicalDeviceTimelineSemaphoreFeatures_.timelineSemaphore &&
+                           extensions_.enable(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME,
+                                              VulkanExtensions::ExtensionType::Device);
+  useTimelineSemaphores_ =
+      hasTimelineSemaphores_ && config_.enableTimelineSemaphores && !config_.exportableFences;
+#if defined(VK_KHR_synchronization2)
+  useSynchronization2_ = config_.enableSynchronization2 &&
+                         vkPhysicalDeviceSynchronization2Features_.synchronization2 &&
+                         extensions_.enable(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
+                                            VulkanExtensions::ExtensionType::Device);
+#endif // defined(VK_KHR_synchronization2)
+  if (!IGL_VULKAN_USE_VMA) {
+    hasMemoryBudget_ = extensions_.available(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                                             VulkanExtensions::ExtensionType::Device) &&
+                       extensions_.enable(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
+                                          VulkanExtensions::ExtensionType::Device);
+  }
 
   VulkanQueuePool queuePool(vf_, vkPhysicalDevice_);
 
@@ -684,6 +794,8 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                       vkPhysicalDeviceShaderFloat16Int8Features_.shaderFloat16,
                       config_.enableBufferDeviceAddress,
                       config_.enableDescriptorIndexing,
+                      hasTimelineSemaphores_,
+                      useSynchronization2_,
                       &vkPhysicalDeviceFeatures2_.features,
                       &device));
   if (!config_.enableConcurrentVkDevicesSupport) {
@@ -706,12 +818,31 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
 
   device_ =
       std::make_unique<igl::vulkan::VulkanDevice>(vf_, device, "Device: VulkanContext::device_");
+  const bool hasAsyncCompute =
+      config_.enableAsyncCompute &&
+      deviceQueues_.computeQueueFamilyIndex != deviceQueues_.graphicsQueueFamilyIndex;
+  signalSubmitTimelines_ = hasAsyncCompute && hasTimelineSemaphores_;
   immediate_ =
       std::make_unique<igl::vulkan::VulkanImmediateCommands>(vf_,
                                                              device,
                                                              deviceQueues_.graphicsQueueFamilyIndex,
                                                              config_.exportableFences,
+                                                             useTimelineSemaphores_,
+                                                             signalSubmitTimelines_,
                                                              "VulkanContext::immediate_");
+  if (hasAsyncCompute) {
+    computeImmediate_ = std::make_unique<igl::vulkan::VulkanImmediateCommands>(
+        vf_,
+        device,
+        deviceQueues_.computeQueueFamilyIndex,
+        config_.exportableFences,
+        useTimelineSemaphores_,
+        signalSubmitTimelines_,
+        "VulkanContext::computeImmediate_");
+    deviceQueues_.sharedQueueFamilyIndices[0] = deviceQueues_.graphicsQueueFamilyIndex;
+    deviceQueues_.sharedQueueFamilyIndices[1] = deviceQueues_.computeQueueFamilyIndex;
+    deviceQueues_.numSharedQueueFamilies = 2;
+  }
   syncManager_ = std::make_unique<SyncManager>(*this, config_.maxResourceCount);
 
   // create Vulkan pipeline cache
@@ -735,6 +866,8 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                                            apiVersion,
                                            config_.enableBufferDeviceAddress,
                                            &pimpl_->vma_));
+  } else {
+    memoryAllocator_ = std::make_unique<VulkanMemoryAllocator>(*this);
   }
 
   // The staging device will use VMA to allocate a buffer, so this needs
@@ -754,6 +887,10 @@ igl::Result VulkanContext::initContext(const HWDeviceDesc& desc,
                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
                                      nullptr,
                                      "Buffer: dummy storage");
+  if (!IGL_VERIFY(dummyUniformBuffer_ && dummyStorageBuffer_)) {
+    return Result(Result::Code::RuntimeError, "Cannot create dummy buffers");
+  }
+  transientUniformAllocator_ = std::make_unique<TransientUniformAllocator>(*this);
 
   // default texture
   {
@@ -1018,6 +1155,9 @@ Result VulkanContext::present() const {
     return Result(Result::Code::InvalidOperation, "No swapchain available");
   }
 
+  lastFrameBarrierStats_ = barrierStats_;
+  barrierStats_ = {};
+
   return swapchain_->present(immediate_->acquireLastSubmitSemaphore());
 }
 
@@ -1045,9 +1185,12 @@ std::unique_ptr<VulkanBuffer> VulkanContext::createBuffer(VkDeviceSize bufferSiz
   ENSURE_BUFFER_SIZE(VK_BUFFER_USAGE_FLAG_BITS_MAX_ENUM, limits.maxStorageBufferRange);
 #undef ENSURE_BUFFER_SIZE
 
-  Result::setOk(outResult);
-  return std::make_unique<VulkanBuffer>(
-      *this, device_->getVkDevice(), bufferSize, usageFlags, memFlags, debugName);
+  auto buffer = std::make_unique<VulkanBuffer>(
+      *this, device_->getVkDevice(), bufferSize, usageFlags, memFlags, debugName, outResult);
+  if (!buffer->valid()) {
+    return nullptr;
+  }
+  return buffer;
 }
 
 std::unique_ptr<VulkanImage> VulkanContext::createImage(VkImageType imageType,
@@ -1069,19 +1212,24 @@ std::unique_ptr<VulkanImage> VulkanContext::createImage(VkImageType imageType,
     return nullptr;
   }
 
-  return std::make_unique<VulkanImage>(*this,
-                                       device_->getVkDevice(),
-                                       extent,
-                                       imageType,
-                                       format,
-                                       mipLevels,
-                                       arrayLayers,
-                                       tiling,
-                                       usageFlags,
-                                       memFlags,
-                                       flags,
-                                       samples,
-                                       debugName);
+  auto image = std::make_unique<VulkanImage>(*this,
+                                             device_->getVkDevice(),
+                                             extent,
+                                             imageType,
+                                             format,
+                                             mipLevels,
+                                             arrayLayers,
+                                             tiling,
+                                             usageFlags,
+                                             memFlags,
+                                             flags,
+                                             samples,
+                                             debugName,
+                                             outResult);
+  if (!image->valid()) {
+    return nullptr;
+  }
+  return image;
 }
 
 std::unique_ptr<VulkanImage> VulkanContext::createImageFromFileDescriptor(
@@ -1261,6 +1409,9 @@ void VulkanContext::checkAndUpdateDescriptorSets() {
     IGL_LOG_INFO("Updating descriptor set dsBindless_\n");
 #endif // IGL_VULKAN_PRINT_COMMANDS
     immediate_->wait(std::exchange(pimpl_->lastSubmitHandle_, immediate_->getLastSubmitHandle()));
+    if (computeImmediate_) {
+      computeImmediate_->wait(computeImmediate_->getLastSubmitHandle());
+    }
     vf_.vkUpdateDescriptorSets(
         device_->getVkDevice(), static_cast<uint32_t>(write.size()), write.data(), 0, nullptr);
   }
@@ -1451,7 +1602,8 @@ void VulkanContext::updateBindingsTextures(VkCommandBuffer cmdBuf,
   DescriptorPoolsArena& arena = pimpl_->getOrCreateArena_CombinedImageSamplers(
       *this, dsl.getVkDescriptorSetLayout(), dsl.numBindings_);
 
-  VkDescriptorSet dset = arena.getNextDescriptorSet(*immediate_, pimpl_->lastSubmitHandle_);
+  VkDescriptorSet dset =
+      arena.getNextDescriptorSet(*immediate_, pimpl_->lastSubmitHandle_, computeImmediate_.get());
 
   // @fb-only
   VkDescriptorImageInfo infoSampledImages[IGL_TEXTURE_SAMPLERS_MAX]; // uninitialized
@@ -1517,7 +1669,7 @@ void VulkanContext::updateBindingsUniformBuffers(VkCommandBuffer cmdBuf,
       *this, dsl.getVkDescriptorSetLayout(), dsl.numBindings_);
 
   VkDescriptorSet dsetBufUniform =
-      arena.getNextDescriptorSet(*immediate_, pimpl_->lastSubmitHandle_);
+      arena.getNextDescriptorSet(*immediate_, pimpl_->lastSubmitHandle_, computeImmediate_.get());
 
   // @fb-only
   VkWriteDescriptorSet writes[IGL_UNIFORM_BLOCKS_BINDING_MAX]; // uninitialized
@@ -1563,7 +1715,7 @@ void VulkanContext::updateBindingsStorageBuffers(VkCommandBuffer cmdBuf,
       *this, dsl.getVkDescriptorSetLayout(), dsl.numBindings_);
 
   VkDescriptorSet dsetBufStorage =
-      arena.getNextDescriptorSet(*immediate_, pimpl_->lastSubmitHandle_);
+      arena.getNextDescriptorSet(*immediate_, pimpl_->lastSubmitHandle_, computeImmediate_.get());
 
   // @fb-only
   VkWriteDescriptorSet writes[IGL_UNIFORM_BLOCKS_BINDING_MAX]; // uninitialized
@@ -1601,12 +1753,28 @@ void VulkanContext::markSubmitted(const VulkanImmediateCommands::SubmitHandle& h
   pimpl_->lastSubmitHandle_ = handle;
 }
 
-void VulkanContext::deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle) const {
+void VulkanContext::deferredTask(std::packaged_task<void()>&& task,
+                                 SubmitHandle handle,
+                                 VkDeviceSize sizeInBytes) const {
   if (handle.empty()) {
     handle = immediate_->getLastSubmitHandle();
   }
   deferredTasks_.emplace_back(std::move(task), handle);
   deferredTasks_.back().frameId_ = this->getFrameNumber();
+  deferredTasks_.back().sizeInBytes_ = sizeInBytes;
+  if (computeImmediate_) {
+    deferredTasks_.back().computeHandle_ = computeImmediate_->getLastSubmitHandle();
+  }
+  deferredTaskStats_.numQueuedTasks++;
+  deferredTaskStats_.queuedBytes += sizeInBytes;
+}
+
+VulkanContext::DeferredTaskStats VulkanContext::getDeferredTaskStats() const {
+  DeferredTaskStats stats = deferredTaskStats_;
+  if (pimpl_->deferredTaskThread_) {
+    stats.numBackgroundTasks = pimpl_->deferredTaskThread_->getNumPendingTasks();
+  }
+  return stats;
 }
 
 bool VulkanContext::areValidationLayersEnabled() const {
@@ -1623,13 +1791,34 @@ void VulkanContext::processDeferredTasks() const {
   const uint64_t frameId = getFrameNumber();
   constexpr uint64_t kNumWaitFrames = 1u;
 
-  while (!deferredTasks_.empty() && immediate_->isRecycled(deferredTasks_.front().handle_)) {
+  const auto isTaskReady = [this](const DeferredTask& task) {
+    return immediate_->isRecycled(task.handle_) &&
+           (!computeImmediate_ || computeImmediate_->isReady(task.computeHandle_));
+  };
+
+  const auto startTime = std::chrono::steady_clock::now();
+  const std::chrono::microseconds budget(config_.deferredTasksBudgetUs);
+
+  while (!deferredTasks_.empty() && isTaskReady(deferredTasks_.front())) {
     if (frameId && frameId <= deferredTasks_.front().frameId_ + kNumWaitFrames) {
       // do not check anything if it is not yet older than kNumWaitFrames
       break;
     }
-    deferredTasks_.front().task_();
+    DeferredTask& task = deferredTasks_.front();
+    deferredTaskStats_.numQueuedTasks--;
+    deferredTaskStats_.queuedBytes -= task.sizeInBytes_;
+    deferredTaskStats_.numRetiredTasks++;
+    deferredTaskStats_.retiredBytes += task.sizeInBytes_;
+    if (pimpl_->deferredTaskThread_) {
+      pimpl_->deferredTaskThread_->enqueue(std::move(task.task_));
+    } else {
+      task.task_();
+    }
     deferredTasks_.pop_front();
+    if (budget.count() && std::chrono::steady_clock::now() - startTime >= budget) {
+      // the rest is retired by the next submissions
+      break;
+    }
   }
 }
 
@@ -1638,9 +1827,20 @@ void VulkanContext::waitDeferredTasks() {
 
   for (auto& task : deferredTasks_) {
     immediate_->wait(task.handle_);
+    if (computeImmediate_) {
+      computeImmediate_->wait(task.computeHandle_);
+    }
     task.task_();
+    deferredTaskStats_.numRetiredTasks++;
+    deferredTaskStats_.retiredBytes += task.sizeInBytes_;
   }
   deferredTasks_.clear();
+  deferredTaskStats_.numQueuedTasks = 0;
+  deferredTaskStats_.queuedBytes = 0;
+
+  if (pimpl_->deferredTaskThread_) {
+    pimpl_->deferredTaskThread_->waitIdle();
+  }
 }
 
 VkDescriptorSetLayout VulkanContext::getBindlessVkDescriptorSetLayout() const {
@@ -39,11 +39,13 @@ class CommandQueue;
 class ComputeCommandEncoder;
 class RenderCommandEncoder;
 class SyncManager;
+class TransientUniformAllocator;
 class VulkanBuffer;
 class VulkanDevice;
 class VulkanDescriptorSetLayout;
 class VulkanImage;
 class VulkanImageView;
+class VulkanMemoryAllocator;
 class VulkanPipelineLayout;
 class VulkanSampler;
 class VulkanSemaphore;
@@ -78,6 +80,11 @@ struct DeviceQueues {
   VkQueue graphicsQueue = VK_NULL_HANDLE;
   VkQueue computeQueue = VK_NULL_HANDLE;
 
+  // queue families sharing buffers and images (VK_SHARING_MODE_CONCURRENT) when async compute is
+  // enabled; numSharedQueueFamilies == 0 means resources are exclusive to the graphics family
+  uint32_t sharedQueueFamilyIndices[2] = {INVALID, INVALID};
+  uint32_t numSharedQueueFamilies = 0;
+
   DeviceQueues() = default;
 };
 
@@ -100,6 +107,35 @@ struct VulkanContextConfig {
 
   std::vector<CommandQueueType> userQueues;
 
+  // Submit the work of CommandQueueType::Compute queues to a dedicated compute queue family (if the
+  // device has one) so it can overlap graphics work. Resources are then created with
+  // VK_SHARING_MODE_CONCURRENT, which may be slower on some GPUs.
+  bool enableAsyncCompute = false;
+
+  // Track command buffer completion with one timeline semaphore per queue instead of one fence per
+  // command buffer (VK_KHR_timeline_semaphore). Ignored if the device does not support timeline
+  // semaphores or if exportableFences is set.
+  bool enableTimelineSemaphores = false;
+
+  // Record batched barriers with vkCmdPipelineBarrier2KHR() so each barrier keeps its own stage
+  // masks (VK_KHR_synchronization2). Ignored if the device does not support it.
+  bool enableSynchronization2 = false;
+
+  // Run deferred destruction tasks (see VulkanContext::deferredTask()) on a background thread once
+  // their submissions have completed, instead of on the thread submitting command buffers.
+  bool enableBackgroundDeferredTasks = false;
+
+  // Maximum time in microseconds VulkanContext::processDeferredTasks() spends retiring deferred
+  // tasks per command buffer submission. Remaining tasks are retired by later submissions. At
+  // least one task is retired per call. 0 means no limit.
+  uint32_t deferredTasksBudgetUs = 0;
+
+  // Upload sampled 2D textures with a single mip level by writing texels directly into linear-tiled
+  // host-visible images, bypassing the staging buffer. Only used on devices where all memory is
+  // host-visible (UMA GPUs and software rasterizers such as lavapipe or SwiftShader). Sampling
+  // linear-tiled images may be slower on some GPUs.
+  bool enableDirectImageUploads = false;
+
   uint32_t maxResourceCount = 3u;
 
   // owned by the application - should be alive until initContext() returns
@@ -216,13 +252,33 @@ class VulkanContext final {
 
   using SubmitHandle = VulkanImmediateCommands::SubmitHandle;
 
-  // execute a task some time in the future after the submit handle finished processing
-  void deferredTask(std::packaged_task<void()>&& task, SubmitHandle handle = SubmitHandle()) const;
+  // execute a task some time in the future after the submit handle finished processing;
+  // `sizeInBytes` is the amount of memory released by the task, only used for statistics
+  void deferredTask(std::packaged_task<void()>&& task,
+                    SubmitHandle handle = SubmitHandle(),
+                    VkDeviceSize sizeInBytes = 0) const;
+
+  struct DeferredTaskStats {
+    // tasks waiting for their submissions to complete (or for the time budget)
+    uint32_t numQueuedTasks = 0;
+    VkDeviceSize queuedBytes = 0;
+    // tasks handed over to the background thread which have not run yet
+    uint32_t numBackgroundTasks = 0;
+    uint64_t numRetiredTasks = 0;
+    uint64_t retiredBytes = 0;
+  };
+  DeferredTaskStats getDeferredTaskStats() const;
 
   bool areValidationLayersEnabled() const;
 
   void* getVmaAllocator() const;
 
+  /// @brief Returns the sub-allocator used for buffers and images when VMA is disabled, or nullptr
+  /// when IGL_VULKAN_USE_VMA is enabled.
+  VulkanMemoryAllocator* getMemoryAllocator() const {
+    return memoryAllocator_.get();
+  }
+
 #if defined(IGL_WITH_TRACY_GPU)
   TracyVkCtx tracyCtx_ = nullptr;
   std::unique_ptr<VulkanCommandPool> profilingCommandPool_;
@@ -273,10 +329,20 @@ class VulkanContext final {
   VkSurfaceCapabilitiesKHR deviceSurfaceCaps_;
   std::vector<VkPresentModeKHR> devicePresentModes_;
 
+  // Provided by VK_VERSION_1_3
+  VkPhysicalDeviceSynchronization2FeaturesKHR vkPhysicalDeviceSynchronization2Features_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+      nullptr};
+
+  // Provided by VK_VERSION_1_2
+  VkPhysicalDeviceTimelineSemaphoreFeatures vkPhysicalDeviceTimelineSemaphoreFeatures_ = {
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+      &vkPhysicalDeviceSynchronization2Features_};
+
   // Provided by VK_VERSION_1_2
   VkPhysicalDeviceShaderFloat16Int8Features vkPhysicalDeviceShaderFloat16Int8Features_ = {
       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR,
-      nullptr};
+      &vkPhysicalDeviceTimelineSemaphoreFeatures_};
 
   // Provided by VK_VERSION_1_1
   VkPhysicalDeviceProperties2 vkPhysicalDeviceProperties2_ = {
@@ -298,12 +364,40 @@ class VulkanContext final {
   std::unique_ptr<igl::vulkan::VulkanDevice> device_;
   std::unique_ptr<igl::vulkan::VulkanSwapchain> swapchain_;
   std::unique_ptr<igl::vulkan::VulkanImmediateCommands> immediate_;
+  // submissions to the dedicated compute queue; null unless async compute is enabled and available
+  std::unique_ptr<igl::vulkan::VulkanImmediateCommands> computeImmediate_;
   std::unique_ptr<igl::vulkan::VulkanStagingDevice> stagingDevice_;
 
   std::unique_ptr<igl::vulkan::VulkanBuffer> dummyUniformBuffer_;
   std::unique_ptr<igl::vulkan::VulkanBuffer> dummyStorageBuffer_;
   // don't use staging on devices with device-local host-visible memory
   bool useStagingForBuffers_ = true;
+  // eligible textures are linear-tiled and written directly by the host (see
+  // VulkanContextConfig::enableDirectImageUploads)
+  bool useDirectImageUploads_ = false;
+  // VK_KHR_timeline_semaphore is enabled on the device
+  bool hasTimelineSemaphores_ = false;
+  // VulkanImmediateCommands track submissions with timeline semaphores instead of fences
+  bool useTimelineSemaphores_ = false;
+  // VulkanImmediateCommands signal a timeline semaphore with every submission, so that submissions
+  // to the async compute queue and the graphics queue can wait for each other on the GPU
+  bool signalSubmitTimelines_ = false;
+  // VK_EXT_memory_budget is enabled
+  bool hasMemoryBudget_ = false;
+  // memoryless attachments can be backed by VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT memory
+  bool hasLazilyAllocatedMemory_ = false;
+  // VulkanBarrierBatch records barriers with vkCmdPipelineBarrier2KHR()
+  bool useSynchronization2_ = false;
+
+  struct BarrierStats {
+    // image and buffer barriers recorded by VulkanImage::transitionLayout() and VulkanBarrierBatch
+    uint32_t numBarriers = 0;
+    // vkCmdPipelineBarrier() calls recording them
+    uint32_t numPipelineBarrierCalls = 0;
+  };
+  // counters of the current frame; rolled over into lastFrameBarrierStats_ by present()
+  mutable BarrierStats barrierStats_;
+  mutable BarrierStats lastFrameBarrierStats_;
 
   std::unique_ptr<VulkanContextImpl> pimpl_;
 
@@ -358,12 +452,21 @@ class VulkanContext final {
       task_(std::move(task)), handle_(handle) {}
     std::packaged_task<void()> task_;
     SubmitHandle handle_;
+    SubmitHandle computeHandle_; // the last submission to `computeImmediate_`, if any
     uint64_t frameId_ = 0;
+    VkDeviceSize sizeInBytes_ = 0;
   };
 
   mutable std::deque<DeferredTask> deferredTasks_;
+  mutable DeferredTaskStats deferredTaskStats_;
 
   std::unique_ptr<SyncManager> syncManager_;
+
+  // memory for bindBytes(), recycled once the submissions reading it have completed
+  std::unique_ptr<TransientUniformAllocator> transientUniformAllocator_;
+
+  // replaces VMA when IGL_VULKAN_USE_VMA is disabled
+  std::unique_ptr<VulkanMemoryAllocator> memoryAllocator_;
 };
 
 } // namespace vulkan
@@ -237,6 +237,23 @@ bool ivkIsHostVisibleSingleHeapMemory(const struct VulkanFunctionTable* vt,
   return false;
 }
 
+bool ivkHasLazilyAllocatedMemory(const struct VulkanFunctionTable* vt, VkPhysicalDevice physDev) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+
+  vt->vkGetPhysicalDeviceMemoryProperties(physDev, &memProperties);
+
+  const uint32_t flag =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
+
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((memProperties.memoryTypes[i].propertyFlags & flag) == flag) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 uint32_t ivkFindMemoryType(const struct VulkanFunctionTable* vt,
                            VkPhysicalDevice physDev,
                            uint32_t memoryTypeBits,
@@ -274,6 +291,56 @@ VkResult ivkCreateSemaphore(const struct VulkanFunctionTable* vt,
   return vt->vkCreateSemaphore(device, &ci, NULL, outSemaphore);
 }
 
+VkResult ivkCreateTimelineSemaphore(const struct VulkanFunctionTable* vt,
+                                    VkDevice device,
+                                    uint64_t initialValue,
+                                    VkSemaphore* outSemaphore) {
+#if defined(VK_KHR_timeline_semaphore)
+  const VkSemaphoreTypeCreateInfoKHR typeInfo = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+      .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+      .initialValue = initialValue,
+  };
+  const VkSemaphoreCreateInfo ci = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+      .pNext = &typeInfo,
+      .flags = 0,
+  };
+  return vt->vkCreateSemaphore(device, &ci, NULL, outSemaphore);
+#else
+  return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif // defined(VK_KHR_timeline_semaphore)
+}
+
+VkResult ivkGetTimelineSemaphoreValue(const struct VulkanFunctionTable* vt,
+                                      VkDevice device,
+                                      VkSemaphore semaphore,
+                                      uint64_t* outValue) {
+#if defined(VK_KHR_timeline_semaphore)
+  return vt->vkGetSemaphoreCounterValueKHR(device, semaphore, outValue);
+#else
+  return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif // defined(VK_KHR_timeline_semaphore)
+}
+
+VkResult ivkWaitTimelineSemaphore(const struct VulkanFunctionTable* vt,
+                                  VkDevice device,
+                                  VkSemaphore semaphore,
+                                  uint64_t value,
+                                  uint64_t timeoutNanoseconds) {
+#if defined(VK_KHR_timeline_semaphore)
+  const VkSemaphoreWaitInfoKHR waitInfo = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+      .semaphoreCount = 1,
+      .pSemaphores = &semaphore,
+      .pValues = &value,
+  };
+  return vt->vkWaitSemaphoresKHR(device, &waitInfo, timeoutNanoseconds);
+#else
+  return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif // defined(VK_KHR_timeline_semaphore)
+}
+
 VkResult ivkCreateFence(const struct VulkanFunctionTable* vt,
                         VkDevice device,
                         VkFlags flags,
@@ -316,6 +383,8 @@ VkResult ivkCreateDevice(const struct VulkanFunctionTable* vt,
                          VkBool32 enableShaderFloat16,
                          VkBool32 enableBufferDeviceAddress,
                          VkBool32 enableDescriptorIndexing,
+                         VkBool32 enableTimelineSemaphore,
+                         VkBool32 enableSynchronization2,
                          const VkPhysicalDeviceFeatures* supported,
                          VkDevice* outDevice) {
   assert(numQueueCreateInfos >= 1);
@@ -385,6 +454,26 @@ VkResult ivkCreateDevice(const struct VulkanFunctionTable* vt,
     ivkAddNext(&ci, &multiviewFeature);
   }
 
+#if defined(VK_KHR_timeline_semaphore)
+  const VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+      .timelineSemaphore = VK_TRUE,
+  };
+  if (enableTimelineSemaphore == VK_TRUE) {
+    ivkAddNext(&ci, &timelineSemaphoreFeature);
+  }
+#endif // defined(VK_KHR_timeline_semaphore)
+
+#if defined(VK_KHR_synchronization2)
+  const VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Feature = {
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR,
+      .synchronization2 = VK_TRUE,
+  };
+  if (enableSynchronization2 == VK_TRUE) {
+    ivkAddNext(&ci, &synchronization2Feature);
+  }
+#endif // defined(VK_KHR_synchronization2)
+
   return vt->vkCreateDevice(physicalDevice, &ci, NULL, outDevice);
 }
 
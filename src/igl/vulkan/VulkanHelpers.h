@@ -64,6 +64,26 @@ VkResult ivkCreateFence(const struct VulkanFunctionTable* vt,
                         bool exportable,
                         VkFence* outFence);
 
+/// @brief Creates a timeline semaphore (VK_KHR_timeline_semaphore) with the initial value
+/// `initialValue`
+VkResult ivkCreateTimelineSemaphore(const struct VulkanFunctionTable* vt,
+                                    VkDevice device,
+                                    uint64_t initialValue,
+                                    VkSemaphore* outSemaphore);
+
+/// @brief Returns the current counter value of a timeline semaphore in `outValue`
+VkResult ivkGetTimelineSemaphoreValue(const struct VulkanFunctionTable* vt,
+                                      VkDevice device,
+                                      VkSemaphore semaphore,
+                                      uint64_t* outValue);
+
+/// @brief Waits until the counter value of a timeline semaphore reaches `value`
+VkResult ivkWaitTimelineSemaphore(const struct VulkanFunctionTable* vt,
+                                  VkDevice device,
+                                  VkSemaphore semaphore,
+                                  uint64_t value,
+                                  uint64_t timeoutNanoseconds);
+
 /** @brief Creates a platform specific VkSurfaceKHR object. The surface creation functions
  * conditionally-compiled and guarded by their respective platform specific extension macros defined
  * by the Vulkan API. The current supported platforms, and their macros, are:
@@ -95,7 +115,8 @@ VkResult ivkCreateSurface(const struct VulkanFunctionTable* vt,
  * VkPhysicalDeviceShaderFloat16Int8Features::shaderFloat16
  * If the `VK_KHR_buffer_device_address` extension is available, then
  * VkPhysicalDeviceBufferDeviceAddressFeaturesKHR::bufferDeviceAddress is enabled If multiview is
- * enabled, then VkPhysicalDeviceMultiviewFeatures::multiview is enabled
+ * enabled, then VkPhysicalDeviceMultiviewFeatures::multiview is enabled. If timeline semaphores
+ * are enabled, then VkPhysicalDeviceTimelineSemaphoreFeaturesKHR::timelineSemaphore is enabled.
  */
 VkResult ivkCreateDevice(const struct VulkanFunctionTable* vt,
                          VkPhysicalDevice physicalDevice,
@@ -107,6 +128,8 @@ VkResult ivkCreateDevice(const struct VulkanFunctionTable* vt,
                          VkBool32 enableShaderFloat16,
                          VkBool32 enableBufferDeviceAddress,
                          VkBool32 enableDescriptorIndexing,
+                         VkBool32 enableTimelineSemaphore,
+                         VkBool32 enableSynchronization2,
                          const VkPhysicalDeviceFeatures* supported,
                          VkDevice* outDevice);
 
@@ -182,6 +205,10 @@ VkResult ivkAllocateMemory(const struct VulkanFunctionTable* vt,
 bool ivkIsHostVisibleSingleHeapMemory(const struct VulkanFunctionTable* vt,
                                       VkPhysicalDevice physDev);
 
+/// @brief Returns true if the physical device exposes a device-local, lazily allocated memory
+/// type suitable for transient attachments (usually only tile-based GPUs)
+bool ivkHasLazilyAllocatedMemory(const struct VulkanFunctionTable* vt, VkPhysicalDevice physDev);
+
 uint32_t ivkFindMemoryType(const struct VulkanFunctionTable* vt,
                            VkPhysicalDevice physDev,
                            uint32_t memoryTypeBits,
@@ -10,6 +10,7 @@
 #include <array>
 #include <cinttypes>
 #include <igl/vulkan/Common.h>
+#include <igl/vulkan/VulkanBarrierBatch.h>
 #include <igl/vulkan/VulkanContext.h>
 #include <igl/vulkan/VulkanImageView.h>
 
@@ -115,13 +116,15 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
                          VkMemoryPropertyFlags memFlags,
                          VkImageCreateFlags createFlags,
                          VkSampleCountFlagBits samples,
-                         const char* debugName) :
+                         const char* debugName,
+                         Result* outResult) :
   ctx_(&ctx),
   physicalDevice_(ctx.getVkPhysicalDevice()),
   device_(device),
   usageFlags_(usageFlags),
   extent_(extent),
   type_(type),
+  tiling_(tiling),
   imageFormat_(format),
   mipLevels_(mipLevels),
   arrayLayers_(arrayLayers),
@@ -139,30 +142,51 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
 
   setName(debugName);
 
-  const VkImageCreateInfo ci = ivkGetImageCreateInfo(type,
-                                                     imageFormat_,
-                                                     tiling,
-                                                     usageFlags,
-                                                     extent_,
-                                                     mipLevels_,
-                                                     arrayLayers_,
-                                                     createFlags,
-                                                     samples);
+  VkImageCreateInfo ci = ivkGetImageCreateInfo(type,
+                                               imageFormat_,
+                                               tiling,
+                                               usageFlags,
+                                               extent_,
+                                               mipLevels_,
+                                               arrayLayers_,
+                                               createFlags,
+                                               samples);
+
+  // the host can only write into linear images in the PREINITIALIZED or GENERAL layouts
+  if (tiling == VK_IMAGE_TILING_LINEAR && (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+    ci.initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+    imageLayout_ = VK_IMAGE_LAYOUT_PREINITIALIZED;
+  }
+
+  // shared with the async compute queue family
+  if (ctx_->deviceQueues_.numSharedQueueFamilies) {
+    ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    ci.queueFamilyIndexCount = ctx_->deviceQueues_.numSharedQueueFamilies;
+    ci.pQueueFamilyIndices = ctx_->deviceQueues_.sharedQueueFamilyIndices;
+  }
 
   if (IGL_VULKAN_USE_VMA) {
     VmaAllocationCreateInfo ciAlloc = {};
 
     ciAlloc.usage = memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ? VMA_MEMORY_USAGE_CPU_TO_GPU
-                                                                   : VMA_MEMORY_USAGE_AUTO;
+                    : memFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+                        ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED
+                        : VMA_MEMORY_USAGE_AUTO;
 
     VkResult result = vmaCreateImage(
         (VmaAllocator)ctx_->getVmaAllocator(), &ci, &ciAlloc, &vkImage_, &vmaAllocation_, nullptr);
 
-    if (!IGL_VERIFY(result == VK_SUCCESS)) {
+    if (result != VK_SUCCESS) {
       IGL_LOG_ERROR("failed: error result: %d, memflags: %d,  imageformat: %d\n",
                     result,
                     memFlags,
                     imageFormat_);
+      // leave the object invalid, there is nothing to destroy
+      ctx_ = nullptr;
+      vkImage_ = VK_NULL_HANDLE;
+      vmaAllocation_ = nullptr;
+      Result::setResult(outResult, getResultFromVkResult(result));
+      return;
     }
 
     // handle memory-mapped buffers
@@ -177,28 +201,37 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
     }
   } else {
     // create image
-    VK_ASSERT(ctx_->vf_.vkCreateImage(device_, &ci, nullptr, &vkImage_));
+    const VkResult result = ctx_->vf_.vkCreateImage(device_, &ci, nullptr, &vkImage_);
+    if (result != VK_SUCCESS) {
+      ctx_ = nullptr;
+      vkImage_ = VK_NULL_HANDLE;
+      Result::setResult(outResult, getResultFromVkResult(result));
+      return;
+    }
 
     // back the image with some memory
     {
       VkMemoryRequirements memRequirements;
       ctx_->vf_.vkGetImageMemoryRequirements(device, vkImage_, &memRequirements);
 
-      VK_ASSERT(ivkAllocateMemory(&ctx_->vf_,
-                                  physicalDevice_,
-                                  device_,
-                                  &memRequirements,
-                                  memFlags,
-                                  ctx.config_.enableBufferDeviceAddress,
-                                  &vkMemory_));
-      VK_ASSERT(ctx_->vf_.vkBindImageMemory(device_, vkImage_, vkMemory_, 0));
+      // sub-allocate from a larger block; host-visible blocks are persistently mapped
+      memoryAllocation_ = ctx_->getMemoryAllocator()->allocate(
+          memRequirements, memFlags, tiling == VK_IMAGE_TILING_LINEAR, outResult);
+      if (!memoryAllocation_.valid()) {
+        ctx_->vf_.vkDestroyImage(device_, vkImage_, nullptr);
+        ctx_ = nullptr;
+        vkImage_ = VK_NULL_HANDLE;
+        return;
+      }
+      VK_ASSERT(ctx_->vf_.vkBindImageMemory(
+          device_, vkImage_, memoryAllocation_.memory, memoryAllocation_.offset));
 
       allocatedSize = memRequirements.size;
     }
 
     // handle memory-mapped images
     if (memFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-      VK_ASSERT(ctx_->vf_.vkMapMemory(device_, vkMemory_, 0, VK_WHOLE_SIZE, 0, &mappedPtr_));
+      mappedPtr_ = memoryAllocation_.mappedPtr;
     }
   }
 
@@ -207,6 +240,8 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
 
   // Get physical device's properties for the image's format
   ctx_->vf_.vkGetPhysicalDeviceFormatProperties(physicalDevice_, imageFormat_, &formatProperties_);
+
+  Result::setOk(outResult);
 }
 
 VulkanImage::VulkanImage(const VulkanContext& ctx,
@@ -229,6 +264,7 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   usageFlags_(usageFlags),
   extent_(extent),
   type_(type),
+  tiling_(tiling),
   imageFormat_(format),
   mipLevels_(mipLevels),
   arrayLayers_(arrayLayers),
@@ -350,6 +386,7 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   usageFlags_(usageFlags),
   extent_(extent),
   type_(type),
+  tiling_(tiling),
   imageFormat_(format),
   mipLevels_(mipLevels),
   arrayLayers_(arrayLayers),
@@ -513,6 +550,7 @@ VulkanImage::VulkanImage(const VulkanContext& ctx,
   usageFlags_(usageFlags),
   extent_(extent),
   type_(type),
+  tiling_(tiling),
   imageFormat_(format),
   mipLevels_(mipLevels),
   arrayLayers_(arrayLayers),
@@ -622,10 +660,23 @@ void VulkanImage::destroy() {
       if (mappedPtr_) {
         vmaUnmapMemory((VmaAllocator)ctx_->getVmaAllocator(), vmaAllocation_);
       }
-      ctx_->deferredTask(std::packaged_task<void()>(
+      VmaAllocationInfo allocationInfo = {};
+      vmaGetAllocationInfo((VmaAllocator)ctx_->getVmaAllocator(), vmaAllocation_, &allocationInfo);
+      std::packaged_task<void()> task(
           [vma = ctx_->getVmaAllocator(), image = vkImage_, allocation = vmaAllocation_]() {
             vmaDestroyImage((VmaAllocator)vma, image, allocation);
-          }));
+          });
+      ctx_->deferredTask(std::move(task), VulkanContext::SubmitHandle(), allocationInfo.size);
+    } else if (memoryAllocation_.valid()) {
+      std::packaged_task<void()> task([vf = &ctx_->vf_,
+                                       device = device_,
+                                       image = vkImage_,
+                                       allocator = ctx_->getMemoryAllocator(),
+                                       allocation = memoryAllocation_]() {
+        vf->vkDestroyImage(device, image, nullptr);
+        allocator->free(allocation);
+      });
+      ctx_->deferredTask(std::move(task), VulkanContext::SubmitHandle(), memoryAllocation_.size);
     } else {
       if (mappedPtr_) {
         ctx_->vf_.vkUnmapMemory(device_, vkMemory_);
@@ -676,6 +727,32 @@ void VulkanImage::transitionLayout(VkCommandBuffer cmdBuf,
                                    const VkImageSubresourceRange& subresourceRange) const {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_TRANSITION);
 
+  const VkImageMemoryBarrier barrier =
+      prepareTransition(newImageLayout, srcStageMask, dstStageMask, subresourceRange);
+
+  ctx_->vf_.vkCmdPipelineBarrier(
+      cmdBuf, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+  ctx_->barrierStats_.numBarriers++;
+  ctx_->barrierStats_.numPipelineBarrierCalls++;
+}
+
+void VulkanImage::transitionLayout(VulkanBarrierBatch& batch,
+                                   VkImageLayout newImageLayout,
+                                   VkPipelineStageFlags srcStageMask,
+                                   VkPipelineStageFlags dstStageMask,
+                                   const VkImageSubresourceRange& subresourceRange) const {
+  const VkImageMemoryBarrier barrier =
+      prepareTransition(newImageLayout, srcStageMask, dstStageMask, subresourceRange);
+
+  batch.addImageBarrier(barrier, srcStageMask, dstStageMask);
+}
+
+VkImageMemoryBarrier VulkanImage::prepareTransition(
+    VkImageLayout newImageLayout,
+    VkPipelineStageFlags& srcStageMask,
+    VkPipelineStageFlags& dstStageMask,
+    const VkImageSubresourceRange& subresourceRange) const {
   VkAccessFlags srcAccessMask = 0;
   VkAccessFlags dstAccessMask = 0;
 
@@ -778,18 +855,20 @@ void VulkanImage::transitionLayout(VkCommandBuffer cmdBuf,
   dstStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
 #endif // IGL_DEBUG_ENFORCE_FULL_IMAGE_BARRIER
 
-  ivkImageMemoryBarrier(&ctx_->vf_,
-                        cmdBuf,
-                        vkImage_,
-                        srcAccessMask,
-                        dstAccessMask,
-                        imageLayout_,
-                        newImageLayout,
-                        srcStageMask,
-                        dstStageMask,
-                        subresourceRange);
+  VkImageMemoryBarrier barrier = {};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.srcAccessMask = srcAccessMask;
+  barrier.dstAccessMask = dstAccessMask;
+  barrier.oldLayout = imageLayout_;
+  barrier.newLayout = newImageLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = vkImage_;
+  barrier.subresourceRange = subresourceRange;
 
   imageLayout_ = newImageLayout;
+
+  return barrier;
 }
 
 void VulkanImage::clearColorImage(VkCommandBuffer commandBuffer,
@@ -1019,11 +1098,13 @@ VulkanImage& VulkanImage::operator=(VulkanImage&& other) {
   usageFlags_ = std::move(other.usageFlags_);
   vkMemory_ = std::move(other.vkMemory_);
   vmaAllocation_ = std::move(other.vmaAllocation_);
+  memoryAllocation_ = std::move(other.memoryAllocation_);
   formatProperties_ = std::move(other.formatProperties_);
   mappedPtr_ = std::move(other.mappedPtr_);
   isExternallyManaged_ = std::move(other.isExternallyManaged_);
   extent_ = std::move(other.extent_);
   type_ = std::move(other.type_);
+  tiling_ = std::move(other.tiling_);
   imageFormat_ = std::move(other.imageFormat_);
   mipLevels_ = std::move(other.mipLevels_);
   arrayLayers_ = std::move(other.arrayLayers_);
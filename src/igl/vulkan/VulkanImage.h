@@ -12,10 +12,12 @@
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanHelpers.h>
+#include <igl/vulkan/VulkanMemoryAllocator.h>
 
 namespace igl {
 namespace vulkan {
 
+class VulkanBarrierBatch;
 class VulkanContext;
 class VulkanImageView;
 struct VulkanImageViewCreateInfo;
@@ -76,6 +78,9 @@ class VulkanImage final {
    *
    * If the image is host-visible (`memFlags` contains `VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT`), then
    * it is memory mapped until the object's destruction.
+   *
+   * If the image or its memory cannot be created, `outResult` receives the error and valid()
+   * returns false.
    */
   VulkanImage(const VulkanContext& ctx,
               VkDevice device,
@@ -89,7 +94,8 @@ class VulkanImage final {
               VkMemoryPropertyFlags memFlags,
               VkImageCreateFlags createFlags,
               VkSampleCountFlagBits samples,
-              const char* debugName = nullptr);
+              const char* debugName = nullptr,
+              Result* outResult = nullptr);
 
   /**
    * @brief Constructs a `VulkanImage` object and a `VkImage` object from a file descriptor. The
@@ -235,12 +241,29 @@ class VulkanImage final {
                         VkPipelineStageFlags srcStageMask,
                         VkPipelineStageFlags dstStageMask,
                         const VkImageSubresourceRange& subresourceRange) const;
+  /**
+   * @brief Same as above, but adds the Image Memory Barrier to `batch` so it can be recorded
+   * together with other barriers. The layout stored in the object is updated immediately.
+   */
+  void transitionLayout(VulkanBarrierBatch& batch,
+                        VkImageLayout newImageLayout,
+                        VkPipelineStageFlags srcStageMask,
+                        VkPipelineStageFlags dstStageMask,
+                        const VkImageSubresourceRange& subresourceRange) const;
   void clearColorImage(VkCommandBuffer commandBuffer,
                        const igl::Color& rgba,
                        const VkImageSubresourceRange* subresourceRange = nullptr) const;
 
   VkImageAspectFlags getImageAspectFlags() const;
 
+  /**
+   * @brief Returns true if the host can write texels directly into the image memory, i.e. the
+   * image is linear-tiled and persistently mapped
+   */
+  bool isHostWritable() const {
+    return tiling_ == VK_IMAGE_TILING_LINEAR && mappedPtr_ != nullptr;
+  }
+
   static bool isDepthFormat(VkFormat format);
   static bool isStencilFormat(VkFormat format);
 
@@ -252,11 +275,14 @@ class VulkanImage final {
   VkImageUsageFlags usageFlags_ = 0;
   VkDeviceMemory vkMemory_ = VK_NULL_HANDLE;
   VmaAllocation vmaAllocation_ = VK_NULL_HANDLE;
+  // replaces `vkMemory_` when VMA is disabled, unless the memory is imported or exported
+  VulkanMemoryAllocator::Allocation memoryAllocation_;
   VkFormatProperties formatProperties_{};
   void* mappedPtr_ = nullptr;
   bool isExternallyManaged_ = false;
   VkExtent3D extent_ = {0, 0, 0};
   VkImageType type_ = VK_IMAGE_TYPE_MAX_ENUM;
+  VkImageTiling tiling_ = VK_IMAGE_TILING_OPTIMAL;
   VkFormat imageFormat_ = VK_FORMAT_UNDEFINED;
   uint32_t mipLevels_ = 1;
   uint32_t arrayLayers_ = 1;
@@ -275,6 +301,12 @@ class VulkanImage final {
 #endif
 
  private:
+  // deduces the access masks, adjusts the stage masks and updates imageLayout_
+  VkImageMemoryBarrier prepareTransition(VkImageLayout newImageLayout,
+                                         VkPipelineStageFlags& srcStageMask,
+                                         VkPipelineStageFlags& dstStageMask,
+                                         const VkImageSubresourceRange& subresourceRange) const;
+
 #if IGL_PLATFORM_WIN || IGL_PLATFORM_LINUX || IGL_PLATFORM_ANDROID
   /**
    * @brief Constructs a `VulkanImage` object and a `VkImage` object. Except for the debug name, all
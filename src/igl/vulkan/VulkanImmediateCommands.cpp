@@ -7,6 +7,7 @@
 
 #include "VulkanImmediateCommands.h"
 
+#include <algorithm>
 #include <igl/vulkan/Common.h>
 #include <utility>
 
@@ -17,6 +18,8 @@ VulkanImmediateCommands::VulkanImmediateCommands(const VulkanFunctionTable& vf,
                                                  VkDevice device,
                                                  uint32_t queueFamilyIndex,
                                                  bool exportableFences,
+                                                 bool useTimelineSemaphore,
+                                                 bool signalTimelineSemaphore,
                                                  const char* debugName) :
   vf_(vf),
   device_(device),
@@ -26,28 +29,63 @@ VulkanImmediateCommands::VulkanImmediateCommands(const VulkanFunctionTable& vf,
                    VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
                queueFamilyIndex,
                debugName),
-  debugName_(debugName) {
+  debugName_(debugName),
+  useTimelineSemaphore_(useTimelineSemaphore) {
   IGL_PROFILER_FUNCTION();
 
   vf_.vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue_);
 
-  buffers_.reserve(kMaxCommandBuffers);
-
-  for (uint32_t i = 0; i != kMaxCommandBuffers; i++) {
-    buffers_.emplace_back(
-        VulkanFence(vf_,
-                    device_,
-                    VkFenceCreateFlagBits{},
-                    exportableFences,
-                    IGL_FORMAT("Fence: commandBuffer #{}", i).c_str()),
-        VulkanSemaphore(
-            vf_, device, false, IGL_FORMAT("Semaphore: {} ({})", debugName, i).c_str()));
-    VK_ASSERT(ivkAllocateCommandBuffer(
-        &vf_, device_, commandPool_.getVkCommandPool(), &buffers_[i].cmdBufAllocated_));
-    buffers_[i].handle_.bufferIndex_ = i;
+  IGL_ASSERT_MSG(!(useTimelineSemaphore && exportableFences),
+                 "Exportable fences are not available with timeline semaphores");
+
+  if (useTimelineSemaphore || signalTimelineSemaphore) {
+    timelineSemaphore_ = std::make_unique<VulkanSemaphore>(VulkanSemaphore::createTimeline(
+        vf_, device_, timelineValue_, IGL_FORMAT("Semaphore: {} (timeline)", debugName).c_str()));
+  }
+
+  const uint32_t numCommandBuffers =
+      useTimelineSemaphore ? kNumInitialTimelineCommandBuffers : kMaxCommandBuffers;
+
+  for (uint32_t i = 0; i != numCommandBuffers; i++) {
+    addCommandBuffer(exportableFences);
   }
 }
 
+void VulkanImmediateCommands::addCommandBuffer(bool exportableFences) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  const auto i = static_cast<uint32_t>(buffers_.size());
+
+  VulkanSemaphore semaphore(
+      vf_, device_, false, IGL_FORMAT("Semaphore: {} ({})", debugName_, i).c_str());
+
+  if (useTimelineSemaphore_) {
+    buffers_.emplace_back(std::move(semaphore));
+  } else {
+    buffers_.emplace_back(VulkanFence(vf_,
+                                      device_,
+                                      VkFenceCreateFlagBits{},
+                                      exportableFences,
+                                      IGL_FORMAT("Fence: commandBuffer #{}", i).c_str()),
+                          std::move(semaphore));
+  }
+  VK_ASSERT(ivkAllocateCommandBuffer(
+      &vf_, device_, commandPool_.getVkCommandPool(), &buffers_[i].cmdBufAllocated_));
+  buffers_[i].handle_.bufferIndex_ = i;
+  numAvailableCommandBuffers_++;
+}
+
+uint64_t VulkanImmediateCommands::updateCompletedTimelineValue() const {
+  IGL_ASSERT(timelineSemaphore_);
+
+  uint64_t value = 0;
+  VK_ASSERT(
+      ivkGetTimelineSemaphoreValue(&vf_, device_, timelineSemaphore_->vkSemaphore_, &value));
+  completedTimelineValue_ = std::max(completedTimelineValue_, value);
+
+  return completedTimelineValue_;
+}
+
 VulkanImmediateCommands::~VulkanImmediateCommands() {
   waitAll();
 }
@@ -55,16 +93,31 @@ VulkanImmediateCommands::~VulkanImmediateCommands() {
 void VulkanImmediateCommands::purge() {
   IGL_PROFILER_FUNCTION();
 
+  if (useTimelineSemaphore_) {
+    // a single query recycles all completed command buffers
+    const uint64_t completedValue = updateCompletedTimelineValue();
+
+    for (auto& buf : buffers_) {
+      if (buf.cmdBuf_ == VK_NULL_HANDLE || buf.isEncoding_ || buf.timelineValue_ > completedValue) {
+        continue;
+      }
+      VK_ASSERT(vf_.vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
+      buf.cmdBuf_ = VK_NULL_HANDLE;
+      numAvailableCommandBuffers_++;
+    }
+    return;
+  }
+
   for (auto& buf : buffers_) {
     if (buf.cmdBuf_ == VK_NULL_HANDLE || buf.isEncoding_) {
       continue;
     }
 
-    const VkResult result = vf_.vkWaitForFences(device_, 1, &buf.fence_.vkFence_, VK_TRUE, 0);
+    const VkResult result = vf_.vkWaitForFences(device_, 1, &buf.fence_->vkFence_, VK_TRUE, 0);
 
     if (result == VK_SUCCESS) {
       VK_ASSERT(vf_.vkResetCommandBuffer(buf.cmdBuf_, VkCommandBufferResetFlags{0}));
-      VK_ASSERT(vf_.vkResetFences(device_, 1, &buf.fence_.vkFence_));
+      VK_ASSERT(vf_.vkResetFences(device_, 1, &buf.fence_->vkFence_));
       buf.cmdBuf_ = VK_NULL_HANDLE;
       numAvailableCommandBuffers_++;
     } else {
@@ -82,9 +135,23 @@ const VulkanImmediateCommands::CommandBufferWrapper& VulkanImmediateCommands::ac
     purge();
   }
 
+  if (!numAvailableCommandBuffers_ && useTimelineSemaphore_ &&
+      buffers_.size() < kMaxTimelineCommandBuffers) {
+    // grow instead of stalling
+    addCommandBuffer(false);
+  }
+
   while (!numAvailableCommandBuffers_) {
     IGL_LOG_INFO("Waiting for command buffers...\n");
     IGL_PROFILER_ZONE("Waiting for command buffers...", IGL_PROFILER_COLOR_WAIT);
+    if (useTimelineSemaphore_ && completedTimelineValue_ < timelineValue_) {
+      // block until the oldest pending submission completes instead of polling
+      VK_ASSERT(ivkWaitTimelineSemaphore(&vf_,
+                                         device_,
+                                         timelineSemaphore_->vkSemaphore_,
+                                         completedTimelineValue_ + 1,
+                                         UINT64_MAX));
+    }
     purge();
     IGL_PROFILER_ZONE_END();
   }
@@ -129,8 +196,16 @@ void VulkanImmediateCommands::wait(const SubmitHandle handle, uint64_t timeoutNa
 
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
-  VK_ASSERT(vf_.vkWaitForFences(
-      device_, 1, &buffers_[handle.bufferIndex_].fence_.vkFence_, VK_TRUE, timeoutNanoseconds));
+  if (useTimelineSemaphore_) {
+    VK_ASSERT(ivkWaitTimelineSemaphore(&vf_,
+                                       device_,
+                                       timelineSemaphore_->vkSemaphore_,
+                                       buffers_[handle.bufferIndex_].timelineValue_,
+                                       timeoutNanoseconds));
+  } else {
+    VK_ASSERT(vf_.vkWaitForFences(
+        device_, 1, &buffers_[handle.bufferIndex_].fence_->vkFence_, VK_TRUE, timeoutNanoseconds));
+  }
 
   purge();
 }
@@ -138,6 +213,16 @@ void VulkanImmediateCommands::wait(const SubmitHandle handle, uint64_t timeoutNa
 void VulkanImmediateCommands::waitAll() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_WAIT);
 
+  if (useTimelineSemaphore_) {
+    // every submitted command buffer has completed once the last signaled value is reached
+    if (completedTimelineValue_ < timelineValue_) {
+      VK_ASSERT(ivkWaitTimelineSemaphore(
+          &vf_, device_, timelineSemaphore_->vkSemaphore_, timelineValue_, UINT64_MAX));
+    }
+    purge();
+    return;
+  }
+
   // @lint-ignore CLANGTIDY
   VkFence fences[kMaxCommandBuffers];
 
@@ -145,7 +230,7 @@ void VulkanImmediateCommands::waitAll() {
 
   for (const auto& buf : buffers_) {
     if (buf.cmdBuf_ != VK_NULL_HANDLE && !buf.isEncoding_) {
-      fences[numFences++] = buf.fence_.vkFence_;
+      fences[numFences++] = buf.fence_->vkFence_;
     }
   }
 
@@ -157,7 +242,7 @@ void VulkanImmediateCommands::waitAll() {
 }
 
 bool VulkanImmediateCommands::isRecycled(SubmitHandle handle) const {
-  IGL_ASSERT(handle.bufferIndex_ < kMaxCommandBuffers);
+  IGL_ASSERT(handle.bufferIndex_ < buffers_.size());
 
   if (handle.empty()) {
     // a null handle
@@ -169,7 +254,7 @@ bool VulkanImmediateCommands::isRecycled(SubmitHandle handle) const {
 }
 
 bool VulkanImmediateCommands::isReady(const SubmitHandle handle) const {
-  IGL_ASSERT(handle.bufferIndex_ < kMaxCommandBuffers);
+  IGL_ASSERT(handle.bufferIndex_ < buffers_.size());
 
   if (handle.empty()) {
     // a null handle
@@ -188,7 +273,15 @@ bool VulkanImmediateCommands::isReady(const SubmitHandle handle) const {
     return true;
   }
 
-  return vf_.vkWaitForFences(device_, 1, &buf.fence_.vkFence_, VK_TRUE, 0) == VK_SUCCESS;
+  if (useTimelineSemaphore_) {
+    if (buf.isEncoding_) {
+      return false;
+    }
+    return buf.timelineValue_ <= completedTimelineValue_ ||
+           buf.timelineValue_ <= updateCompletedTimelineValue();
+  }
+
+  return vf_.vkWaitForFences(device_, 1, &buf.fence_->vkFence_, VK_TRUE, 0) == VK_SUCCESS;
 }
 
 VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
@@ -198,25 +291,61 @@ VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
   VK_ASSERT(ivkEndCommandBuffer(&vf_, wrapper.cmdBuf_));
 
   // @lint-ignore CLANGTIDY
-  const VkPipelineStageFlags waitStageMasks[] = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+  VkPipelineStageFlags waitStageMasks[kMaxWaitSemaphores + 1];
+  // @lint-ignore CLANGTIDY
+  VkSemaphore waitSemaphores[kMaxWaitSemaphores + 1];
   // @lint-ignore CLANGTIDY
-  VkSemaphore waitSemaphores[] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+  uint64_t waitValues[kMaxWaitSemaphores + 1] = {}; // ignored for binary semaphores
   uint32_t numWaitSemaphores = 0;
-  if (waitSemaphore_) {
-    waitSemaphores[numWaitSemaphores++] = waitSemaphore_;
+  bool hasTimelineWaits = false;
+  for (uint32_t i = 0; i != numWaitSemaphores_; i++) {
+    hasTimelineWaits |= waitSemaphoreValues_[i] != 0;
+    waitValues[numWaitSemaphores] = waitSemaphoreValues_[i];
+    waitSemaphores[numWaitSemaphores++] = waitSemaphores_[i];
   }
   if (lastSubmitSemaphore_) {
     waitSemaphores[numWaitSemaphores++] = lastSubmitSemaphore_;
   }
 
-  const VkSubmitInfo si = ivkGetSubmitInfo(&wrapper.cmdBuf_,
-                                           numWaitSemaphores,
-                                           waitSemaphores,
-                                           waitStageMasks,
-                                           &wrapper.semaphore_.vkSemaphore_);
+  for (uint32_t i = 0; i != numWaitSemaphores; i++) {
+    waitStageMasks[i] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+  }
+
+  VkSubmitInfo si = ivkGetSubmitInfo(&wrapper.cmdBuf_,
+                                     numWaitSemaphores,
+                                     waitSemaphores,
+                                     waitStageMasks,
+                                     &wrapper.semaphore_.vkSemaphore_);
+  // @lint-ignore CLANGTIDY
+  VkFence vkFence = VK_NULL_HANDLE;
+
+  // signal the binary semaphore (used by presentation and the next submission) and, if there is
+  // one, the next value of the timeline, which replaces the fence in the timeline semaphore mode
   // @lint-ignore CLANGTIDY
-  const VkFence vkFence = wrapper.fence_.vkFence_;
+  const VkSemaphore signalSemaphores[] = {
+      wrapper.semaphore_.vkSemaphore_,
+      timelineSemaphore_ ? timelineSemaphore_->vkSemaphore_ : VK_NULL_HANDLE};
+  // @lint-ignore CLANGTIDY
+  uint64_t signalValues[2] = {};
+  VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+
+  if (timelineSemaphore_ || hasTimelineWaits) {
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+    timelineInfo.waitSemaphoreValueCount = numWaitSemaphores;
+    timelineInfo.pWaitSemaphoreValues = waitValues;
+    si.pNext = &timelineInfo;
+  }
+  if (timelineSemaphore_) {
+    signalValues[1] = ++timelineValue_;
+    const_cast<CommandBufferWrapper&>(wrapper).timelineValue_ = timelineValue_;
+    timelineInfo.signalSemaphoreValueCount = 2;
+    timelineInfo.pSignalSemaphoreValues = signalValues;
+    si.signalSemaphoreCount = 2;
+    si.pSignalSemaphores = signalSemaphores;
+  }
+  if (!useTimelineSemaphore_) {
+    vkFence = wrapper.fence_->vkFence_;
+  }
   IGL_PROFILER_ZONE("vkQueueSubmit()", IGL_PROFILER_COLOR_SUBMIT);
 #if IGL_VULKAN_PRINT_COMMANDS
   IGL_LOG_INFO("%p vkQueueSubmit()\n\n", wrapper.cmdBuf_);
@@ -226,7 +355,7 @@ VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
 
   lastSubmitSemaphore_ = wrapper.semaphore_.vkSemaphore_;
   lastSubmitHandle_ = wrapper.handle_;
-  waitSemaphore_ = VK_NULL_HANDLE;
+  numWaitSemaphores_ = 0;
 
   // reset
   const_cast<CommandBufferWrapper&>(wrapper).isEncoding_ = false;
@@ -240,10 +369,51 @@ VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::submit(
   return lastSubmitHandle_;
 }
 
-void VulkanImmediateCommands::waitSemaphore(VkSemaphore semaphore) {
-  IGL_ASSERT(waitSemaphore_ == VK_NULL_HANDLE);
+void VulkanImmediateCommands::waitSemaphore(VkSemaphore semaphore, uint64_t value) {
+  if (!IGL_VERIFY(numWaitSemaphores_ < kMaxWaitSemaphores)) {
+    return;
+  }
+
+  waitSemaphoreValues_[numWaitSemaphores_] = value;
+  waitSemaphores_[numWaitSemaphores_++] = semaphore;
+}
+
+bool VulkanImmediateCommands::waitForSubmit(const VulkanImmediateCommands& producer,
+                                            SubmitHandle handle) {
+  IGL_ASSERT(&producer != this);
+
+  if (producer.isReady(handle)) {
+    return true;
+  }
+
+  if (!producer.timelineSemaphore_) {
+    return false;
+  }
+
+  const CommandBufferWrapper& buf = producer.buffers_[handle.bufferIndex_];
+
+  if (!IGL_VERIFY(!buf.isEncoding_)) {
+    // waiting for a buffer which has not been submitted cannot be expressed with a timeline value
+    return false;
+  }
+
+  const VkSemaphore semaphore = producer.timelineSemaphore_->vkSemaphore_;
+
+  // a timeline value also covers all earlier submissions, so one wait per producer is enough
+  for (uint32_t i = 0; i != numWaitSemaphores_; i++) {
+    if (waitSemaphores_[i] == semaphore) {
+      waitSemaphoreValues_[i] = std::max(waitSemaphoreValues_[i], buf.timelineValue_);
+      return true;
+    }
+  }
+
+  if (numWaitSemaphores_ == kMaxWaitSemaphores) {
+    return false;
+  }
+
+  waitSemaphore(semaphore, buf.timelineValue_);
 
-  waitSemaphore_ = semaphore;
+  return true;
 }
 
 VkSemaphore VulkanImmediateCommands::acquireLastSubmitSemaphore() {
@@ -257,11 +427,11 @@ VulkanImmediateCommands::SubmitHandle VulkanImmediateCommands::getLastSubmitHand
 VkFence VulkanImmediateCommands::getVkFenceFromSubmitHandle(SubmitHandle handle) {
   IGL_ASSERT(handle.bufferIndex_ < buffers_.size());
 
-  if (isRecycled(handle)) {
+  if (isRecycled(handle) || useTimelineSemaphore_) {
     return VK_NULL_HANDLE;
   }
 
-  return buffers_[handle.bufferIndex_].fence_.vkFence_;
+  return buffers_[handle.bufferIndex_].fence_->vkFence_;
 }
 
 } // namespace vulkan
@@ -7,7 +7,9 @@
 
 #pragma once
 
-#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
 
 #include <igl/vulkan/Common.h>
 #include <igl/vulkan/VulkanCommandPool.h>
@@ -25,18 +27,33 @@ class VulkanImmediateCommands final {
   // The maximum number of command buffers which can simultaneously exist in the system; when we run
   // out of buffers, we stall and wait until an existing buffer becomes available
   static constexpr uint32_t kMaxCommandBuffers = 32;
+  // In the timeline semaphore mode, command buffers are allocated on demand up to this limit
+  static constexpr uint32_t kMaxTimelineCommandBuffers = 1024;
+  static constexpr uint32_t kNumInitialTimelineCommandBuffers = 4;
+  // The maximum number of external semaphores (swapchain, other queues) a submission can wait for
+  static constexpr uint32_t kMaxWaitSemaphores = 4;
 
   /** @brief Creates an instance of the class for a specific queue family and whether the fences
    * created for each command buffer are exportable (see VulkanFence for more details about the
    * exportable flag). The optional `debugName` parameter can be used to name the resource to make
    * it easier for debugging
    * The constructor initializes the vector of `CommandBufferWrapper` structures with
-   * a total of `kMaxCommandBuffers`
+   * a total of `kMaxCommandBuffers`.
+   * If `useTimelineSemaphore` is true, no fences are created. Every submission signals the next
+   * value of a single timeline semaphore instead, so completion of all command buffers is tracked
+   * by one monotonically increasing counter, and command buffers are allocated on demand starting
+   * from `kNumInitialTimelineCommandBuffers` up to `kMaxTimelineCommandBuffers`. Timeline
+   * semaphores cannot be combined with exportable fences.
+   * If `signalTimelineSemaphore` is true, submissions also signal a timeline semaphore in the fence
+   * mode, so that submissions to other queues can wait for them on the GPU (see
+   * `waitForSubmit()`). It is implied by `useTimelineSemaphore`.
    */
   VulkanImmediateCommands(const VulkanFunctionTable& vf,
                           VkDevice device,
                           uint32_t queueFamilyIndex,
                           bool exportableFences,
+                          bool useTimelineSemaphore,
+                          bool signalTimelineSemaphore,
                           const char* debugName);
   ~VulkanImmediateCommands();
   VulkanImmediateCommands(const VulkanImmediateCommands&) = delete;
@@ -85,6 +102,8 @@ class VulkanImmediateCommands final {
   struct CommandBufferWrapper {
     CommandBufferWrapper(VulkanFence&& fence, VulkanSemaphore&& semaphore) :
       fence_(std::move(fence)), semaphore_(std::move(semaphore)) {}
+    explicit CommandBufferWrapper(VulkanSemaphore&& semaphore) :
+      semaphore_(std::move(semaphore)) {}
 
     /// @brief The command buffer handle. It is initialied to VK_NULL_HANDLE. The command buffer
     /// handle stored in `cmdBufAllocated_` is copied into `cmdBuf_` when the command buffer is
@@ -96,8 +115,11 @@ class VulkanImmediateCommands final {
     SubmitHandle handle_ = {};
     /// @brief A VulkanFence object that is associated with the submission of the command buffer. It
     /// is used to check whether a command buffer is still executing or for waiting the command
-    /// buffer to finish execution by the GPU
-    VulkanFence fence_;
+    /// buffer to finish execution by the GPU. Empty in the timeline semaphore mode
+    std::optional<VulkanFence> fence_;
+    /// @brief The value of the timeline semaphore signaled by the submission of the command buffer
+    /// (only if submissions signal a timeline semaphore)
+    uint64_t timelineValue_ = 0;
     /// @brief A VulkanSemaphore object associated with the submission of the command buffer for
     /// execution.
     VulkanSemaphore semaphore_;
@@ -112,15 +134,24 @@ class VulkanImmediateCommands final {
    * returns the `SubmitHandle` associated with the command buffer. Caches the semaphore associated
    * with the command buffer bineg submitted as the last submitted semaphore
    * (`lastSubmitSemaphore_`). Caches the SubmitHandle associated with the command buffer being
-   * submitted for execution in `lastSubmitHandle_`. Resets the current wait semaphore member
-   * variable (`waitSemaphore_`).
+   * submitted for execution in `lastSubmitHandle_`. Resets the current wait semaphores
+   * (`waitSemaphores_`).
    *  Submitting a command buffer also marks the `CommandBufferWrapper::encoding_` variable to
    * `false`
    */
   SubmitHandle submit(const CommandBufferWrapper& wrapper);
 
-  /// @brief Stores the semaphore as the current wait semaphore (`waitSemaphore_`)
-  void waitSemaphore(VkSemaphore semaphore);
+  /// @brief Adds the semaphore to the semaphores the next submission waits for (`waitSemaphores_`).
+  /// `value` is the value to wait for if `semaphore` is a timeline semaphore
+  void waitSemaphore(VkSemaphore semaphore, uint64_t value = 0);
+
+  /** @brief Makes the next submission wait on the GPU until the submission `handle` of `producer`,
+   * which submits to another VkQueue, has completed. The dependency is expressed with the timeline
+   * semaphore of `producer`, so it does not consume any semaphore `producer` relies on. Returns
+   * false if `producer` does not signal a timeline semaphore (or too many semaphores are already
+   * waited for); the caller has to wait for `handle` on the CPU instead.
+   */
+  [[nodiscard]] bool waitForSubmit(const VulkanImmediateCommands& producer, SubmitHandle handle);
 
   /// @brief Returns the last semaphore (`lastSubmitSemaphore_`) and reset the member variable to
   /// `VK_NULL_HANDLE`
@@ -136,7 +167,8 @@ class VulkanImmediateCommands final {
 
   /** @brief Checks whether a SubmitHandle is ready. A SubmitHandle is ready if it is recycled or
    * empty. If it has not been recycled and is not empty, a SubmitHandle is ready if the fence
-   * associated with the command buffer referred by the SubmitHandle structure has been signaled.
+   * associated with the command buffer referred by the SubmitHandle structure has been signaled
+   * (or, in the timeline semaphore mode, if the timeline has reached the value of its submission).
    *  Note that this function does not wait for a fence to be signaled if it has not been signaled.
    * It merely checks the fence status
    */
@@ -148,26 +180,55 @@ class VulkanImmediateCommands final {
   void wait(SubmitHandle handle, uint64_t timeoutNanoseconds = UINT64_MAX);
 
   /// @brief Wait for _all_ fences for all command buffers stored in `VulkanImmediateCommands` to
-  /// become signaled. The maximum wait time is `UINT64_MAX` nanoseconds
+  /// become signaled (a single wait for the last value in the timeline semaphore mode). The maximum
+  /// wait time is `UINT64_MAX` nanoseconds
   void waitAll();
 
   /// @brief Returns the fence associated with the handle if the handle has not been recycled.
-  /// Returns `VK_NULL_HANDLE` otherwise.
+  /// Returns `VK_NULL_HANDLE` otherwise or in the timeline semaphore mode.
   VkFence getVkFenceFromSubmitHandle(SubmitHandle handle);
 
+  /// @brief Returns true if submissions are tracked with a timeline semaphore instead of fences
+  [[nodiscard]] bool usesTimelineSemaphore() const {
+    return useTimelineSemaphore_;
+  }
+
+  /// @brief Returns true if submissions signal a timeline semaphore other queues can wait for
+  [[nodiscard]] bool signalsTimelineSemaphore() const {
+    return timelineSemaphore_ != nullptr;
+  }
+
  private:
   /// @brief Resets all commands buffers and their associated fences that are valid, are not being
   /// encoded, and have completed execution by the GPU (their fences have been signaled). Resets the
   /// number of available command buffers.
   void purge();
 
+  /// @brief Allocates a new command buffer along with its synchronization objects
+  void addCommandBuffer(bool exportableFences);
+
+  /// @brief Returns the last value signaled by the GPU on the timeline semaphore and caches it in
+  /// `completedTimelineValue_`
+  uint64_t updateCompletedTimelineValue() const;
+
  private:
   const VulkanFunctionTable& vf_;
   VkDevice device_ = VK_NULL_HANDLE;
   VkQueue queue_ = VK_NULL_HANDLE;
   VulkanCommandPool commandPool_;
   std::string debugName_;
-  std::vector<CommandBufferWrapper> buffers_;
+  // a deque keeps references returned by acquire() valid when new command buffers are added
+  std::deque<CommandBufferWrapper> buffers_;
+
+  /// @brief True if submissions are tracked with `timelineSemaphore_` instead of fences
+  bool useTimelineSemaphore_ = false;
+  /// @brief The timeline semaphore signaled by every submission (timeline semaphore mode, or if
+  /// requested for waits from other queues)
+  std::unique_ptr<VulkanSemaphore> timelineSemaphore_;
+  /// @brief The value signaled by the last submission
+  uint64_t timelineValue_ = 0;
+  /// @brief The last value known to be signaled by the GPU
+  mutable uint64_t completedTimelineValue_ = 0;
 
   /// @brief The last submitted handle. Updated on `submit()`
   SubmitHandle lastSubmitHandle_ = SubmitHandle();
@@ -175,10 +236,13 @@ class VulkanImmediateCommands final {
   /// @brief The semaphore submitted with the last command buffer. Updated on `submit()`
   VkSemaphore lastSubmitSemaphore_ = VK_NULL_HANDLE;
 
-  /// @brief A semaphore to be associated with the next command buffer to be submitted. Can be used
-  /// with command buffers that present swapchain images.
-  VkSemaphore waitSemaphore_ = VK_NULL_HANDLE;
-  uint32_t numAvailableCommandBuffers_ = kMaxCommandBuffers;
+  /// @brief Semaphores to be associated with the next command buffer to be submitted. Can be used
+  /// with command buffers that present swapchain images or that depend on other queues.
+  VkSemaphore waitSemaphores_[kMaxWaitSemaphores] = {};
+  /// @brief The values to wait for, for the timeline semaphores in `waitSemaphores_`
+  uint64_t waitSemaphoreValues_[kMaxWaitSemaphores] = {};
+  uint32_t numWaitSemaphores_ = 0;
+  uint32_t numAvailableCommandBuffers_ = 0;
 
   // @brief The submission counter. Incremented on `submit()`
   uint32_t submitCounter_ = 1;
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <igl/vulkan/VulkanMemoryAllocator.h>
+
+#include <algorithm>
+
+#include <igl/vulkan/VulkanContext.h>
+
+namespace igl::vulkan {
+
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+VkDeviceSize alignDown(VkDeviceSize value, VkDeviceSize alignment) {
+  return value / alignment * alignment;
+}
+
+void eraseFreeBySize(std::multimap<VkDeviceSize, VkDeviceSize>& freeBySize,
+                     VkDeviceSize size,
+                     VkDeviceSize offset) {
+  auto range = freeBySize.equal_range(size);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == offset) {
+      freeBySize.erase(it);
+      return;
+    }
+  }
+  IGL_ASSERT_NOT_REACHED();
+}
+
+} // namespace
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(const VulkanContext& ctx,
+                                             VkDeviceSize preferredBlockSize) :
+  ctx_(ctx) {
+  ctx_.vf_.vkGetPhysicalDeviceMemoryProperties(ctx_.getVkPhysicalDevice(), &memoryProperties_);
+
+  nonCoherentAtomSize_ = std::max<VkDeviceSize>(
+      1, ctx_.getVkPhysicalDeviceProperties().limits.nonCoherentAtomSize);
+  hasMemoryBudget_ = ctx_.hasMemoryBudget_;
+
+  const uint32_t numHeaps = memoryProperties_.memoryHeapCount;
+
+  heapBlockSizes_.resize(numHeaps);
+  heapAllocatedBytes_.resize(numHeaps, 0);
+  heapNumDedicatedAllocations_.resize(numHeaps, 0);
+  heapDedicatedBytes_.resize(numHeaps, 0);
+
+  for (uint32_t i = 0; i != numHeaps; i++) {
+    // small heaps (e.g. 256 MB of device-local host-visible memory) get smaller blocks
+    const VkDeviceSize heapSize = memoryProperties_.memoryHeaps[i].size;
+    heapBlockSizes_[i] =
+        alignUp(std::max<VkDeviceSize>(std::min(preferredBlockSize, heapSize / 8), 1024 * 1024),
+                nonCoherentAtomSize_);
+  }
+
+  pools_.resize(2 * memoryProperties_.memoryTypeCount);
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator() {
+  for (uint32_t i = 0; i != pools_.size(); i++) {
+    for (const auto& block : pools_[i].blocks) {
+      IGL_ASSERT_MSG(block->numAllocations == 0,
+                     "Leaked %u allocation(s) in memory type %u",
+                     block->numAllocations,
+                     i / 2);
+      freeDeviceMemory(i / 2, block->size, block->memory);
+    }
+  }
+}
+
+uint32_t VulkanMemoryAllocator::findMemoryType(uint32_t memoryTypeBits,
+                                               VkMemoryPropertyFlags properties) const {
+  for (uint32_t i = 0; i < memoryProperties_.memoryTypeCount; i++) {
+    const bool hasProperties =
+        (memoryProperties_.memoryTypes[i].propertyFlags & properties) == properties;
+    if ((memoryTypeBits & (1u << i)) && hasProperties) {
+      return i;
+    }
+  }
+  return UINT32_MAX;
+}
+
+VkResult VulkanMemoryAllocator::allocateDeviceMemory(uint32_t memoryTypeIndex,
+                                                     VkDeviceSize size,
+                                                     VkDeviceMemory* outMemory,
+                                                     void** outMappedPtr) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  const VkMemoryAllocateFlags flags =
+      ctx_.config_.enableBufferDeviceAddress ? VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR : 0;
+  const VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo = {
+      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO, nullptr, flags, 0};
+  const VkMemoryAllocateInfo ai = {
+      VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      &memoryAllocateFlagsInfo,
+      size,
+      memoryTypeIndex,
+  };
+
+  const VkDevice device = ctx_.getVkDevice();
+
+  VkResult result = ctx_.vf_.vkAllocateMemory(device, &ai, nullptr, outMemory);
+  if (result != VK_SUCCESS) {
+    return result;
+  }
+
+  *outMappedPtr = nullptr;
+
+  if (isHostVisible(memoryTypeIndex)) {
+    result = ctx_.vf_.vkMapMemory(device, *outMemory, 0, VK_WHOLE_SIZE, 0, outMappedPtr);
+    if (result != VK_SUCCESS) {
+      ctx_.vf_.vkFreeMemory(device, *outMemory, nullptr);
+      *outMemory = VK_NULL_HANDLE;
+      return result;
+    }
+  }
+
+  heapAllocatedBytes_[getHeapIndex(memoryTypeIndex)] += size;
+
+  return VK_SUCCESS;
+}
+
+void VulkanMemoryAllocator::freeDeviceMemory(uint32_t memoryTypeIndex,
+                                             VkDeviceSize size,
+                                             VkDeviceMemory memory) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
+
+  // vkFreeMemory() implicitly unmaps the memory
+  ctx_.vf_.vkFreeMemory(ctx_.getVkDevice(), memory, nullptr);
+
+  heapAllocatedBytes_[getHeapIndex(memoryTypeIndex)] -= size;
+}
+
+bool VulkanMemoryAllocator::allocateFromBlock(Block& block,
+                                              VkDeviceSize size,
+                                              VkDeviceSize alignment,
+                                              VkDeviceSize& outOffset) const {
+  // best fit: the smallest free range which can hold the aligned allocation
+  for (auto it = block.freeBySize.lower_bound(size); it != block.freeBySize.end(); ++it) {
+    const VkDeviceSize freeSize = it->first;
+    const VkDeviceSize freeOffset = it->second;
+    const VkDeviceSize offset = alignUp(freeOffset, alignment);
+
+    if (offset + size > freeOffset + freeSize) {
+      continue;
+    }
+
+    block.freeBySize.erase(it);
+    block.freeByOffset.erase(freeOffset);
+
+    // return the alignment padding and the tail to the free lists
+    if (offset > freeOffset) {
+      block.freeByOffset.emplace(freeOffset, offset - freeOffset);
+      block.freeBySize.emplace(offset - freeOffset, freeOffset);
+    }
+    const VkDeviceSize end = offset + size;
+    if (end < freeOffset + freeSize) {
+      block.freeByOffset.emplace(end, freeOffset + freeSize - end);
+      block.freeBySize.emplace(freeOffset + freeSize - end, end);
+    }
+
+    block.allocations.emplace(offset, SubAllocation{size, alignment});
+    block.allocatedBytes += size;
+    block.numAllocations++;
+
+    outOffset = offset;
+
+    return true;
+  }
+
+  return false;
+}
+
+void VulkanMemoryAllocator::freeInBlock(Block& block, VkDeviceSize offset) const {
+  auto allocation = block.allocations.find(offset);
+
+  if (!IGL_VERIFY(allocation != block.allocations.end())) {
+    return;
+  }
+
+  VkDeviceSize size = allocation->second.size;
+
+  block.allocations.erase(allocation);
+  block.allocatedBytes -= size;
+  block.numAllocations--;
+
+  // coalesce with the next free range
+  auto next = block.freeByOffset.find(offset + size);
+  if (next != block.freeByOffset.end()) {
+    eraseFreeBySize(block.freeBySize, next->second, next->first);
+    size += next->second;
+    block.freeByOffset.erase(next);
+  }
+
+  // coalesce with the previous free range
+  auto prev = block.freeByOffset.lower_bound(offset);
+  if (prev != block.freeByOffset.begin()) {
+    --prev;
+    if (prev->first + prev->second == offset) {
+      eraseFreeBySize(block.freeBySize, prev->second, prev->first);
+      offset = prev->first;
+      size += prev->second;
+      block.freeByOffset.erase(prev);
+    }
+  }
+
+  block.freeByOffset.emplace(offset, size);
+  block.freeBySize.emplace(size, offset);
+}
+
+VulkanMemoryAllocator::Allocation VulkanMemoryAllocator::allocateLocked(uint32_t memoryTypeIndex,
+                                                                        bool isLinear,
+                                                                        VkDeviceSize size,
+                                                                        VkDeviceSize alignment,
+                                                                        const Block* excludedBlock,
+                                                                        VkResult& outResult) {
+  const uint32_t heapIndex = getHeapIndex(memoryTypeIndex);
+  const VkDeviceSize blockSize = heapBlockSizes_[heapIndex];
+
+  Allocation allocation;
+  allocation.memoryTypeIndex = memoryTypeIndex;
+  allocation.isLinear = isLinear;
+  allocation.size = size;
+
+  outResult = VK_SUCCESS;
+
+  if (size > blockSize / 2) {
+    if (excludedBlock) {
+      // defragmentation never moves anything into dedicated allocations
+      outResult = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+      return {};
+    }
+    void* mappedPtr = nullptr;
+    outResult = allocateDeviceMemory(memoryTypeIndex, size, &allocation.memory, &mappedPtr);
+    if (outResult != VK_SUCCESS) {
+      return {};
+    }
+    allocation.mappedPtr = mappedPtr;
+    allocation.isDedicated = true;
+    heapNumDedicatedAllocations_[heapIndex]++;
+    heapDedicatedBytes_[heapIndex] += size;
+    return allocation;
+  }
+
+  Pool& pool = getPool(memoryTypeIndex, isLinear);
+
+  // prefer the fullest blocks so that sparsely used blocks can drain and be released
+  std::vector<Block*> candidates;
+  candidates.reserve(pool.blocks.size());
+  for (const auto& block : pool.blocks) {
+    if (block.get() != excludedBlock && block->size - block->allocatedBytes >= size) {
+      candidates.push_back(block.get());
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [](const Block* a, const Block* b) {
+    return a->allocatedBytes > b->allocatedBytes;
+  });
+
+  for (Block* block : candidates) {
+    if (allocateFromBlock(*block, size, alignment, allocation.offset)) {
+      allocation.memory = block->memory;
+      allocation.mappedPtr = block->mappedPtr ? block->mappedPtr + allocation.offset : nullptr;
+      return allocation;
+    }
+  }
+
+  if (excludedBlock) {
+    // defragmentation only reuses existing blocks
+    outResult = VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    return {};
+  }
+
+  auto block = std::make_unique<Block>();
+  block->size = blockSize;
+
+  void* mappedPtr = nullptr;
+  outResult = allocateDeviceMemory(memoryTypeIndex, blockSize, &block->memory, &mappedPtr);
+  if (outResult != VK_SUCCESS) {
+    return {};
+  }
+  block->mappedPtr = static_cast<uint8_t*>(mappedPtr);
+  block->freeByOffset.emplace(0, blockSize);
+  block->freeBySize.emplace(blockSize, 0);
+
+  const bool allocated = allocateFromBlock(*block, size, alignment, allocation.offset);
+  IGL_ASSERT(allocated);
+  (void)allocated;
+
+  allocation.memory = block->memory;
+  allocation.mappedPtr = block->mappedPtr ? block->mappedPtr + allocation.offset : nullptr;
+
+  pool.blocks.push_back(std::move(block));
+
+  return allocation;
+}
+
+VulkanMemoryAllocator::Allocation VulkanMemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags properties,
+    bool isLinear,
+    Result* outResult) {
+  IGL_PROFILER_FUNCTION();
+
+  const uint32_t memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, properties);
+
+  if (memoryTypeIndex == UINT32_MAX) {
+    Result::setResult(outResult, Result::Code::Unsupported, "No suitable memory type found");
+    return {};
+  }
+
+  VkDeviceSize size = requirements.size;
+  VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+  const bool isCoherent = (memoryProperties_.memoryTypes[memoryTypeIndex].propertyFlags &
+                           VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+  if (isHostVisible(memoryTypeIndex) && !isCoherent) {
+    // flushing a range must not touch neighbouring allocations
+    alignment = std::max(alignment, nonCoherentAtomSize_);
+    size = alignUp(size, nonCoherentAtomSize_);
+  }
+
+  VkResult result = VK_SUCCESS;
+  Allocation allocation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    allocation = allocateLocked(memoryTypeIndex, isLinear, size, alignment, nullptr, result);
+  }
+
+  if (result != VK_SUCCESS) {
+    setResultFrom(outResult, result);
+    return {};
+  }
+
+  Result::setOk(outResult);
+
+  return allocation;
+}
+
+void VulkanMemoryAllocator::freeLocked(const Allocation& allocation) {
+  const uint32_t heapIndex = getHeapIndex(allocation.memoryTypeIndex);
+
+  if (allocation.isDedicated) {
+    freeDeviceMemory(allocation.memoryTypeIndex, allocation.size, allocation.memory);
+    heapNumDedicatedAllocations_[heapIndex]--;
+    heapDedicatedBytes_[heapIndex] -= allocation.size;
+    return;
+  }
+
+  Pool& pool = getPool(allocation.memoryTypeIndex, allocation.isLinear);
+
+  auto it = std::find_if(pool.blocks.begin(), pool.blocks.end(), [&allocation](const auto& block) {
+    return block->memory == allocation.memory;
+  });
+
+  if (!IGL_VERIFY(it != pool.blocks.end())) {
+    return;
+  }
+
+  Block& block = **it;
+
+  freeInBlock(block, allocation.offset);
+
+  if (block.numAllocations) {
+    return;
+  }
+
+  // keep one empty block around to avoid vkAllocateMemory() churn
+  const bool hasOtherEmptyBlock =
+      std::any_of(pool.blocks.begin(), pool.blocks.end(), [&block](const auto& b) {
+        return b.get() != &block && b->numAllocations == 0;
+      });
+
+  if (hasOtherEmptyBlock) {
+    freeDeviceMemory(allocation.memoryTypeIndex, block.size, block.memory);
+    pool.blocks.erase(it);
+  }
+}
+
+void VulkanMemoryAllocator::free(const Allocation& allocation) {
+  IGL_PROFILER_FUNCTION();
+
+  if (!allocation.valid()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  freeLocked(allocation);
+}
+
+void VulkanMemoryAllocator::flushOrInvalidate(const Allocation& allocation,
+                                              VkDeviceSize offset,
+                                              VkDeviceSize size,
+                                              bool flush) const {
+  if (!IGL_VERIFY(allocation.valid())) {
+    return;
+  }
+
+  const VkDeviceSize allocationEnd = allocation.offset + allocation.size;
+  const VkDeviceSize begin = alignDown(allocation.offset + offset, nonCoherentAtomSize_);
+  VkDeviceSize end = size == VK_WHOLE_SIZE ? allocationEnd : allocation.offset + offset + size;
+  // non-coherent allocations are padded to the atom size in allocate(), so this stays inside
+  end = std::min(alignUp(end, nonCoherentAtomSize_), alignUp(allocationEnd, nonCoherentAtomSize_));
+
+  const VkMappedMemoryRange memoryRange = {
+      VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+      nullptr,
+      allocation.memory,
+      begin,
+      end - begin,
+  };
+
+  if (flush) {
+    ctx_.vf_.vkFlushMappedMemoryRanges(ctx_.getVkDevice(), 1, &memoryRange);
+  } else {
+    ctx_.vf_.vkInvalidateMappedMemoryRanges(ctx_.getVkDevice(), 1, &memoryRange);
+  }
+}
+
+void VulkanMemoryAllocator::flush(const Allocation& allocation,
+                                  VkDeviceSize offset,
+                                  VkDeviceSize size) const {
+  flushOrInvalidate(allocation, offset, size, true);
+}
+
+void VulkanMemoryAllocator::invalidate(const Allocation& allocation,
+                                       VkDeviceSize offset,
+                                       VkDeviceSize size) const {
+  flushOrInvalidate(allocation, offset, size, false);
+}
+
+std::vector<VulkanMemoryAllocator::HeapBudget> VulkanMemoryAllocator::getHeapBudgets() const {
+  IGL_PROFILER_FUNCTION();
+
+  std::vector<HeapBudget> budgets(memoryProperties_.memoryHeapCount);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (uint32_t i = 0; i != pools_.size(); i++) {
+      HeapBudget& budget = budgets[getHeapIndex(i / 2)];
+      for (const auto& block : pools_[i].blocks) {
+        budget.blockBytes += block->size;
+        budget.blockCount++;
+        budget.allocationBytes += block->allocatedBytes;
+        budget.allocationCount += block->numAllocations;
+      }
+    }
+    for (uint32_t i = 0; i != budgets.size(); i++) {
+      budgets[i].blockBytes += heapDedicatedBytes_[i];
+      budgets[i].blockCount += heapNumDedicatedAllocations_[i];
+      budgets[i].allocationBytes += heapDedicatedBytes_[i];
+      budgets[i].allocationCount += heapNumDedicatedAllocations_[i];
+      budgets[i].usage = heapAllocatedBytes_[i];
+      budgets[i].budget = memoryProperties_.memoryHeaps[i].size / 10 * 8;
+    }
+  }
+
+  if (hasMemoryBudget_) {
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT memoryBudget = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT};
+    VkPhysicalDeviceMemoryProperties2 props = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2, &memoryBudget};
+    ctx_.vf_.vkGetPhysicalDeviceMemoryProperties2(ctx_.getVkPhysicalDevice(), &props);
+    for (uint32_t i = 0; i != budgets.size(); i++) {
+      budgets[i].usage = memoryBudget.heapUsage[i];
+      budgets[i].budget = memoryBudget.heapBudget[i];
+    }
+  }
+
+  return budgets;
+}
+
+std::vector<VulkanMemoryAllocator::DefragmentationMove> VulkanMemoryAllocator::
+    beginDefragmentation(uint32_t maxMoves) {
+  IGL_PROFILER_FUNCTION();
+
+  std::vector<DefragmentationMove> moves;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (uint32_t i = 0; i != pools_.size() && moves.size() < maxMoves; i++) {
+    Pool& pool = pools_[i];
+
+    if (pool.blocks.size() < 2) {
+      continue;
+    }
+
+    // drain the most sparsely populated block of every pool into the other blocks
+    auto sparsest = std::min_element(
+        pool.blocks.begin(), pool.blocks.end(), [](const auto& a, const auto& b) {
+          return a->numAllocations && (!b->numAllocations || a->allocatedBytes < b->allocatedBytes);
+        });
+    const Block* src = sparsest->get();
+
+    if (!src->numAllocations) {
+      continue;
+    }
+
+    // copy the list since new allocations may split free ranges of other blocks
+    const std::map<VkDeviceSize, SubAllocation> allocations = src->allocations;
+
+    for (const auto& [offset, subAllocation] : allocations) {
+      if (moves.size() >= maxMoves) {
+        break;
+      }
+      VkResult result = VK_SUCCESS;
+      const VkDeviceSize size = subAllocation.size;
+      Allocation dst =
+          allocateLocked(i / 2, (i % 2) != 0, size, subAllocation.alignment, src, result);
+      if (result != VK_SUCCESS) {
+        break;
+      }
+      Allocation srcAllocation;
+      srcAllocation.memory = src->memory;
+      srcAllocation.offset = offset;
+      srcAllocation.size = size;
+      srcAllocation.mappedPtr = src->mappedPtr ? src->mappedPtr + offset : nullptr;
+      srcAllocation.memoryTypeIndex = i / 2;
+      srcAllocation.isLinear = (i % 2) != 0;
+      moves.push_back({srcAllocation, dst});
+    }
+  }
+
+  return moves;
+}
+
+void VulkanMemoryAllocator::endDefragmentation(const std::vector<DefragmentationMove>& moves) {
+  IGL_PROFILER_FUNCTION();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const DefragmentationMove& move : moves) {
+    freeLocked(move.src);
+  }
+}
+
+} // namespace igl::vulkan
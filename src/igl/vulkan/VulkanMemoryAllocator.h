@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <igl/vulkan/Common.h>
+
+namespace igl::vulkan {
+
+class VulkanContext;
+
+/// @brief A block sub-allocator for device memory which is used by VulkanBuffer and VulkanImage
+/// when IGL_VULKAN_USE_VMA is disabled. Instead of calling vkAllocateMemory() for every resource,
+/// memory is allocated in large blocks (64 MB by default, less on small heaps) and resources are
+/// placed into them using a best-fit free list with immediate coalescing of neighbouring ranges.
+/// Every memory type has two pools, one for buffers and linear images and one for optimally tiled
+/// images, so `bufferImageGranularity` never has to be taken into account. Resources larger than
+/// half a block get a dedicated allocation. Host-visible blocks are persistently mapped.
+///
+/// The allocator is thread-safe.
+class VulkanMemoryAllocator final {
+ public:
+  static constexpr VkDeviceSize kDefaultBlockSize = 64ull * 1024 * 1024;
+
+  struct Allocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    /// Offset of the allocation inside `memory`; resources are bound at this offset
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    /// Points to `offset` bytes into the mapped block, or nullptr if the memory is not
+    /// host-visible
+    void* mappedPtr = nullptr;
+    uint32_t memoryTypeIndex = 0;
+    bool isLinear = true;
+    bool isDedicated = false;
+
+    [[nodiscard]] bool valid() const noexcept {
+      return memory != VK_NULL_HANDLE;
+    }
+  };
+
+  /// @brief Memory usage of a single memory heap. `usage` and `budget` come from
+  /// VK_EXT_memory_budget when it is enabled and cover the whole process; otherwise `usage` is
+  /// the amount of memory allocated by this allocator and `budget` is 80% of the heap size.
+  struct HeapBudget {
+    VkDeviceSize blockBytes = 0; // bytes allocated with vkAllocateMemory()
+    VkDeviceSize allocationBytes = 0; // bytes handed out to resources
+    uint32_t blockCount = 0;
+    uint32_t allocationCount = 0;
+    VkDeviceSize usage = 0;
+    VkDeviceSize budget = 0;
+  };
+
+  /// @brief A request to move the contents of `src` into `dst`. See beginDefragmentation().
+  struct DefragmentationMove {
+    Allocation src;
+    Allocation dst;
+  };
+
+  explicit VulkanMemoryAllocator(const VulkanContext& ctx,
+                                 VkDeviceSize preferredBlockSize = kDefaultBlockSize);
+  ~VulkanMemoryAllocator();
+
+  VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+  VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+
+  /// @brief Allocates memory satisfying `requirements` from a memory type with the `properties`.
+  /// `isLinear` must be false for optimally tiled images. Returns an invalid allocation and sets
+  /// `outResult` on failure.
+  [[nodiscard]] Allocation allocate(const VkMemoryRequirements& requirements,
+                                    VkMemoryPropertyFlags properties,
+                                    bool isLinear,
+                                    Result* outResult = nullptr);
+
+  /// @brief Returns the allocation to its block. The GPU must no longer use it.
+  void free(const Allocation& allocation);
+
+  /// @brief Flushes/invalidates a range of a host-visible allocation. `offset` is relative to the
+  /// allocation and the range is expanded to `nonCoherentAtomSize` as required by Vulkan.
+  void flush(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+  void invalidate(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size) const;
+
+  /// @brief Returns the budget of every memory heap, indexed by heap index.
+  [[nodiscard]] std::vector<HeapBudget> getHeapBudgets() const;
+
+  /// @brief Defragmentation hooks. Picks up to `maxMoves` allocations from the most sparsely
+  /// populated blocks and reserves new places for them in denser blocks of the same pool. The
+  /// caller owns the resources: it has to copy the contents of every `src` into `dst`, recreate
+  /// the resource bound to `src` on `dst`, and call endDefragmentation() once the GPU is done with
+  /// the old resources. Until then, both allocations of every move stay reserved.
+  [[nodiscard]] std::vector<DefragmentationMove> beginDefragmentation(uint32_t maxMoves);
+
+  /// @brief Releases the source allocations of the moves and frees blocks which became empty.
+  void endDefragmentation(const std::vector<DefragmentationMove>& moves);
+
+ private:
+  struct SubAllocation {
+    VkDeviceSize size = 0;
+    VkDeviceSize alignment = 1; // the requested alignment, respected when moving the allocation
+  };
+
+  struct Block {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    uint8_t* mappedPtr = nullptr;
+    VkDeviceSize allocatedBytes = 0;
+    uint32_t numAllocations = 0;
+    // free ranges indexed both ways: by offset for coalescing and by size for best-fit lookups
+    std::map<VkDeviceSize, VkDeviceSize> freeByOffset;
+    std::multimap<VkDeviceSize, VkDeviceSize> freeBySize;
+    // live allocations by offset
+    std::map<VkDeviceSize, SubAllocation> allocations;
+  };
+
+  struct Pool {
+    std::vector<std::unique_ptr<Block>> blocks;
+  };
+
+  [[nodiscard]] Pool& getPool(uint32_t memoryTypeIndex, bool isLinear) {
+    return pools_[2 * memoryTypeIndex + (isLinear ? 1 : 0)];
+  }
+  [[nodiscard]] uint32_t getHeapIndex(uint32_t memoryTypeIndex) const {
+    return memoryProperties_.memoryTypes[memoryTypeIndex].heapIndex;
+  }
+  [[nodiscard]] bool isHostVisible(uint32_t memoryTypeIndex) const {
+    return (memoryProperties_.memoryTypes[memoryTypeIndex].propertyFlags &
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+  }
+  [[nodiscard]] uint32_t findMemoryType(uint32_t memoryTypeBits,
+                                        VkMemoryPropertyFlags properties) const;
+  [[nodiscard]] VkResult allocateDeviceMemory(uint32_t memoryTypeIndex,
+                                              VkDeviceSize size,
+                                              VkDeviceMemory* outMemory,
+                                              void** outMappedPtr);
+  void freeDeviceMemory(uint32_t memoryTypeIndex, VkDeviceSize size, VkDeviceMemory memory);
+  [[nodiscard]] bool allocateFromBlock(Block& block,
+                                       VkDeviceSize size,
+                                       VkDeviceSize alignment,
+                                       VkDeviceSize& outOffset) const;
+  void freeInBlock(Block& block, VkDeviceSize offset) const;
+  [[nodiscard]] Allocation allocateLocked(uint32_t memoryTypeIndex,
+                                          bool isLinear,
+                                          VkDeviceSize size,
+                                          VkDeviceSize alignment,
+                                          const Block* excludedBlock,
+                                          VkResult& outResult);
+  void freeLocked(const Allocation& allocation);
+  void flushOrInvalidate(const Allocation& allocation,
+                         VkDeviceSize offset,
+                         VkDeviceSize size,
+                         bool flush) const;
+
+ private:
+  const VulkanContext& ctx_;
+  VkPhysicalDeviceMemoryProperties memoryProperties_ = {};
+  std::vector<VkDeviceSize> heapBlockSizes_;
+  std::vector<VkDeviceSize> heapAllocatedBytes_; // everything allocated with vkAllocateMemory()
+  std::vector<uint32_t> heapNumDedicatedAllocations_;
+  std::vector<VkDeviceSize> heapDedicatedBytes_;
+  std::vector<Pool> pools_;
+  VkDeviceSize nonCoherentAtomSize_ = 1;
+  bool hasMemoryBudget_ = false;
+  mutable std::mutex mutex_;
+};
+
+} // namespace igl::vulkan
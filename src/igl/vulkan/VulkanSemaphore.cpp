@@ -23,6 +23,26 @@ VulkanSemaphore::VulkanSemaphore(const VulkanFunctionTable& vf,
       vf_, device_, VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)vkSemaphore_, debugName));
 }
 
+VulkanSemaphore::VulkanSemaphore(TimelineTag,
+                                 const VulkanFunctionTable& vf,
+                                 VkDevice device,
+                                 uint64_t initialValue,
+                                 const char* debugName) :
+  vf_(&vf), device_(device) {
+  IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_CREATE);
+
+  VK_ASSERT(ivkCreateTimelineSemaphore(vf_, device_, initialValue, &vkSemaphore_));
+  VK_ASSERT(ivkSetDebugObjectName(
+      vf_, device_, VK_OBJECT_TYPE_SEMAPHORE, (uint64_t)vkSemaphore_, debugName));
+}
+
+VulkanSemaphore VulkanSemaphore::createTimeline(const VulkanFunctionTable& vf,
+                                                VkDevice device,
+                                                uint64_t initialValue,
+                                                const char* debugName) {
+  return VulkanSemaphore(TimelineTag{}, vf, device, initialValue, debugName);
+}
+
 VulkanSemaphore ::~VulkanSemaphore() {
   IGL_PROFILER_FUNCTION_COLOR(IGL_PROFILER_COLOR_DESTROY);
 
@@ -29,6 +29,12 @@ class VulkanSemaphore final {
                            const char* debugName = nullptr);
   ~VulkanSemaphore();
 
+  /// @brief Creates a timeline semaphore (VK_KHR_timeline_semaphore) with the given initial value
+  [[nodiscard]] static VulkanSemaphore createTimeline(const VulkanFunctionTable& vf,
+                                                      VkDevice device,
+                                                      uint64_t initialValue,
+                                                      const char* debugName);
+
   VulkanSemaphore(VulkanSemaphore&& other) noexcept;
   VulkanSemaphore& operator=(VulkanSemaphore&& other) noexcept;
 
@@ -39,6 +45,14 @@ class VulkanSemaphore final {
 
   [[nodiscard]] int getFileDescriptor() const noexcept;
 
+ private:
+  struct TimelineTag {};
+  VulkanSemaphore(TimelineTag,
+                  const VulkanFunctionTable& vf,
+                  VkDevice device,
+                  uint64_t initialValue,
+                  const char* debugName);
+
  public:
   const VulkanFunctionTable* vf_{};
   VkDevice device_ = VK_NULL_HANDLE;
@@ -25,6 +25,43 @@ namespace igl {
 
 namespace vulkan {
 
+namespace {
+
+// the layout and access mask an image is left in after uploading data into it
+VkImageLayout getUploadTargetLayout(const VulkanImage& image, VkAccessFlags& dstAccessMask) {
+  const bool isSampled = (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_SAMPLED_BIT) != 0;
+  const bool isStorage = (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_STORAGE_BIT) != 0;
+  const bool isColorAttachment =
+      (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) != 0;
+  const bool isDepthStencilAttachment =
+      (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0;
+
+  // a ternary cascade...
+  const VkImageLayout targetLayout =
+      isSampled ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                : (isStorage ? VK_IMAGE_LAYOUT_GENERAL
+                             : (isColorAttachment
+                                    ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                                    : (isDepthStencilAttachment
+                                           ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+                                           : VK_IMAGE_LAYOUT_UNDEFINED)));
+
+  IGL_ASSERT_MSG(targetLayout != VK_IMAGE_LAYOUT_UNDEFINED, "Missing usage flags");
+
+  dstAccessMask =
+      isSampled
+          ? VK_ACCESS_SHADER_READ_BIT
+          : (isStorage ? VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+                       : (isColorAttachment ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                            : (isDepthStencilAttachment
+                                                   ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                                   : 0)));
+
+  return targetLayout;
+}
+
+} // namespace
+
 VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
   IGL_PROFILER_FUNCTION();
 
@@ -38,6 +75,8 @@ VulkanStagingDevice::VulkanStagingDevice(VulkanContext& ctx) : ctx_(ctx) {
       ctx_.device_->getVkDevice(),
       ctx_.deviceQueues_.graphicsQueueFamilyIndex,
       ctx_.config_.exportableFences,
+      ctx_.useTimelineSemaphores_,
+      ctx_.signalSubmitTimelines_,
       "VulkanStagingDevice::immediate_");
   IGL_ASSERT(immediate_.get());
 }
@@ -62,6 +101,10 @@ void VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer,
   while (size) {
     // finds a free memory block to store the data in the staging buffer
     MemoryRegion memoryChunk = nextFreeBlock(size, false);
+    if (!IGL_VERIFY(memoryChunk.size > 0)) {
+      // the staging buffer could not be allocated
+      return;
+    }
     const VkDeviceSize copySize = std::min(static_cast<VkDeviceSize>(size), memoryChunk.size);
 
 #if IGL_VULKAN_DEBUG_STAGING_DEVICE
@@ -88,6 +131,13 @@ void VulkanStagingDevice::bufferSubData(VulkanBuffer& buffer,
   }
 }
 
+void VulkanStagingDevice::waitForUploads(VulkanImmediateCommands& immediate) {
+  const VulkanImmediateCommands::SubmitHandle handle = immediate_->getLastSubmitHandle();
+  if (!immediate.waitForSubmit(*immediate_, handle)) {
+    immediate_->wait(handle);
+  }
+}
+
 void VulkanStagingDevice::mergeRegionsAndFreeBuffers() {
   uint32_t regionIndex = 0;
   while (regionIndex < regions_.size() && immediate_->isReady(regions_[regionIndex].handle)) {
@@ -182,7 +232,7 @@ VulkanStagingDevice::MemoryRegion VulkanStagingDevice::nextFreeBlock(VkDeviceSiz
 
   IGL_ASSERT(regionItr != regions_.end());
 
-  if (regionItr->size >= requestedAlignedSize) {
+  if (regionItr != regions_.end() && regionItr->size >= requestedAlignedSize) {
     const uint32_t newSize = regionItr->size - requestedAlignedSize;
     const uint32_t newOffset = regionItr->offset + requestedAlignedSize;
     const uint32_t stagingBufferIndex = regionItr->stagingBufferIndex;
@@ -250,6 +300,10 @@ void VulkanStagingDevice::getBufferSubData(const VulkanBuffer& buffer,
 
   while (size) {
     const MemoryRegion memoryChunk = nextFreeBlock(size, false);
+    if (!IGL_VERIFY(memoryChunk.size > 0)) {
+      // the staging buffer could not be allocated
+      return;
+    }
     const VkDeviceSize copySize = std::min(static_cast<VkDeviceSize>(size), memoryChunk.size);
 
     // do the transfer
@@ -285,6 +339,11 @@ void VulkanStagingDevice::imageData(const VulkanImage& image,
                                     const void* data) {
   IGL_PROFILER_FUNCTION();
 
+  if (image.isHostWritable()) {
+    imageDataDirect(image, range, properties, bytesPerRow, data);
+    return;
+  }
+
   const uint32_t storageSize =
       static_cast<uint32_t>(properties.getBytesPerRange(range, bytesPerRow));
 
@@ -300,7 +359,9 @@ void VulkanStagingDevice::imageData(const VulkanImage& image,
   // get next staging buffer free offset
   MemoryRegion memoryChunk = nextFreeBlock(storageSize, true);
 
-  IGL_ASSERT(memoryChunk.size >= storageSize);
+  if (!IGL_VERIFY(memoryChunk.size >= storageSize)) {
+    return;
+  }
   auto& stagingBuffer = stagingBuffers_[memoryChunk.stagingBufferIndex];
 
   // 1. Copy the pixel data into the host visible staging buffer
@@ -388,33 +449,8 @@ void VulkanStagingDevice::imageData(const VulkanImage& image,
                                   static_cast<uint32_t>(copyRegions.size()),
                                   copyRegions.data());
 
-  const bool isSampled = (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_SAMPLED_BIT) != 0;
-  const bool isStorage = (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_STORAGE_BIT) != 0;
-  const bool isColorAttachment =
-      (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) != 0;
-  const bool isDepthStencilAttachment =
-      (image.getVkImageUsageFlags() & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0;
-
-  // a ternary cascade...
-  const VkImageLayout targetLayout =
-      isSampled ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-                : (isStorage ? VK_IMAGE_LAYOUT_GENERAL
-                             : (isColorAttachment
-                                    ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-                                    : (isDepthStencilAttachment
-                                           ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
-                                           : VK_IMAGE_LAYOUT_UNDEFINED)));
-
-  IGL_ASSERT_MSG(targetLayout != VK_IMAGE_LAYOUT_UNDEFINED, "Missing usage flags");
-
-  const VkAccessFlags dstAccessMask =
-      isSampled
-          ? VK_ACCESS_SHADER_READ_BIT
-          : (isStorage ? VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
-                       : (isColorAttachment ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
-                                            : (isDepthStencilAttachment
-                                                   ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
-                                                   : 0)));
+  VkAccessFlags dstAccessMask = 0;
+  const VkImageLayout targetLayout = getUploadTargetLayout(image, dstAccessMask);
 
   // 3. Transition TRANSFER_DST_OPTIMAL into `targetLayout`
   ivkImageMemoryBarrier(&ctx_.vf_,
@@ -437,6 +473,83 @@ void VulkanStagingDevice::imageData(const VulkanImage& image,
   regions_.push_back(memoryChunk);
 }
 
+void VulkanStagingDevice::imageDataDirect(const VulkanImage& image,
+                                          const TextureRangeDesc& range,
+                                          const TextureFormatProperties& properties,
+                                          uint32_t bytesPerRow,
+                                          const void* data) {
+  IGL_PROFILER_FUNCTION();
+
+  IGL_ASSERT(image.type_ == VK_IMAGE_TYPE_2D && image.mipLevels_ == 1 && image.arrayLayers_ == 1);
+  IGL_ASSERT(range.mipLevel == 0 && range.numMipLevels == 1);
+
+#if IGL_VULKAN_DEBUG_STAGING_DEVICE
+  IGL_LOG_INFO("Direct image upload requested for data with %u bytes\n",
+               static_cast<uint32_t>(properties.getBytesPerRange(range, bytesPerRow)));
+#endif
+
+  const VkImageSubresourceRange subresourceRange = {image.getImageAspectFlags(), 0, 1, 0, 1};
+
+  // 1. Host writes are only defined for the PREINITIALIZED and GENERAL layouts. Move the image into
+  // GENERAL and wait until the GPU is done with its previous contents
+  if (image.imageLayout_ != VK_IMAGE_LAYOUT_PREINITIALIZED &&
+      image.imageLayout_ != VK_IMAGE_LAYOUT_GENERAL) {
+    auto& wrapper = immediate_->acquire();
+    ivkImageMemoryBarrier(&ctx_.vf_,
+                          wrapper.cmdBuf_,
+                          image.getVkImage(),
+                          0,
+                          VK_ACCESS_HOST_WRITE_BIT,
+                          image.imageLayout_,
+                          VK_IMAGE_LAYOUT_GENERAL,
+                          VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                          VK_PIPELINE_STAGE_HOST_BIT,
+                          subresourceRange);
+    immediate_->wait(immediate_->submit(wrapper));
+    image.imageLayout_ = VK_IMAGE_LAYOUT_GENERAL;
+  }
+
+  // 2. Copy the texels row by row, honoring the row pitch of the linear image
+  const VkImageSubresource subresource = {image.getImageAspectFlags(), 0, 0};
+  VkSubresourceLayout layout = {};
+  ctx_.vf_.vkGetImageSubresourceLayout(
+      ctx_.getVkDevice(), image.getVkImage(), &subresource, &layout);
+
+  const size_t srcRowPitch = bytesPerRow ? bytesPerRow : properties.getBytesPerRow(range);
+  const size_t rowSize = properties.getBytesPerRow(range);
+  const size_t numRows = properties.getRows(range);
+  const size_t firstRow = range.y / properties.blockHeight;
+  const size_t rowOffset = (range.x / properties.blockWidth) * properties.bytesPerBlock;
+
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  uint8_t* dst = static_cast<uint8_t*>(image.mappedPtr_) + layout.offset +
+                 firstRow * layout.rowPitch + rowOffset;
+  for (size_t row = 0; row != numRows; row++) {
+    checked_memcpy(dst, rowSize, src, rowSize);
+    src += srcRowPitch;
+    dst += layout.rowPitch;
+  }
+
+  // 3. Make the host writes available to the GPU and transition the image into `targetLayout`
+  VkAccessFlags dstAccessMask = 0;
+  const VkImageLayout targetLayout = getUploadTargetLayout(image, dstAccessMask);
+
+  auto& wrapper = immediate_->acquire();
+  ivkImageMemoryBarrier(&ctx_.vf_,
+                        wrapper.cmdBuf_,
+                        image.getVkImage(),
+                        VK_ACCESS_HOST_WRITE_BIT,
+                        dstAccessMask,
+                        image.imageLayout_,
+                        targetLayout,
+                        VK_PIPELINE_STAGE_HOST_BIT,
+                        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                        subresourceRange);
+  immediate_->submit(wrapper);
+
+  image.imageLayout_ = targetLayout;
+}
+
 void VulkanStagingDevice::getImageData2D(VkImage srcImage,
                                          const uint32_t level,
                                          const uint32_t layer,
@@ -469,7 +582,9 @@ void VulkanStagingDevice::getImageData2D(VkImage srcImage,
   // get next staging buffer free offset
   MemoryRegion const memoryChunk = nextFreeBlock(storageSize, true);
 
-  IGL_ASSERT(memoryChunk.size >= storageSize);
+  if (!IGL_VERIFY(memoryChunk.size >= storageSize)) {
+    return;
+  }
   auto& wrapper1 = immediate_->acquire();
 
   // 1. Transition to VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
@@ -608,15 +723,22 @@ void VulkanStagingDevice::allocateStagingBuffer(VkDeviceSize minimumSize) {
   ++stagingBufferCounter_;
 
   // Create a new staging buffer with the new size
-  stagingBuffers_.emplace_back(std::make_unique<VulkanBuffer>(
+  Result result;
+  auto buffer = std::make_unique<VulkanBuffer>(
       ctx_,
       ctx_.device_->getVkDevice(),
       stagingBufferSize,
       VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
       IGL_FORMAT("Buffer: staging buffer #{} with {}B", stagingBufferCounter_, stagingBufferSize)
-          .c_str()));
-  IGL_ASSERT(stagingBuffers_.back().get());
+          .c_str(),
+      &result);
+  if (!IGL_VERIFY(buffer->valid())) {
+    // no region is added, callers see an empty region
+    IGL_LOG_ERROR("Cannot create staging buffer: %s\n", result.message.c_str());
+    return;
+  }
+  stagingBuffers_.emplace_back(std::move(buffer));
 
   // Add region that represents the entire buffer
   regions_.push_front({0,
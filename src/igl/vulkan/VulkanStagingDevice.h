@@ -93,6 +93,10 @@ class VulkanStagingDevice final {
   /// unused staging buffers.
   void mergeRegionsAndFreeBuffers();
 
+  /// @brief Makes the next submission of `immediate`, which submits to another queue, wait for all
+  /// uploads submitted so far. Waits for them on the CPU if `immediate` cannot wait on the GPU.
+  void waitForUploads(VulkanImmediateCommands& immediate);
+
  private:
   struct MemoryRegion {
     VkDeviceSize offset = 0u;
@@ -117,6 +121,14 @@ class VulkanStagingDevice final {
 
   [[nodiscard]] VkDeviceSize getAlignedSize(VkDeviceSize size) const;
 
+  /// @brief Uploads texture data by writing it directly into the memory of a linear-tiled
+  /// host-visible image (see VulkanImage::isHostWritable()), without a staging buffer
+  void imageDataDirect(const VulkanImage& image,
+                       const TextureRangeDesc& range,
+                       const TextureFormatProperties& properties,
+                       uint32_t bytesPerRow,
+                       const void* data);
+
   /// @brief Waits for all memory blocks to become available and resets the staging device's
   /// internal state
   void waitAndReset();
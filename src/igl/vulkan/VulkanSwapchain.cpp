@@ -204,14 +204,14 @@ VkImage VulkanSwapchain::getDepthVkImage() const {
   if (!depthTexture_) {
     lazyAllocateDepthBuffer();
   }
-  return depthTexture_->getVulkanImage().getVkImage();
+  return depthTexture_ ? depthTexture_->getVulkanImage().getVkImage() : VK_NULL_HANDLE;
 }
 
 VkImageView VulkanSwapchain::getDepthVkImageView() const {
   if (!depthTexture_) {
     lazyAllocateDepthBuffer();
   }
-  return depthTexture_->getVulkanImageView().getVkImageView();
+  return depthTexture_ ? depthTexture_->getVulkanImageView().getVkImageView() : VK_NULL_HANDLE;
 }
 
 void VulkanSwapchain::lazyAllocateDepthBuffer() const {
@@ -230,6 +230,7 @@ void VulkanSwapchain::lazyAllocateDepthBuffer() const {
       VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 #endif
 
+  Result result;
   auto depthImage = std::make_unique<VulkanImage>(ctx_,
                                                   device_,
                                                   VkExtent3D{width_, height_, 1},
@@ -242,7 +243,12 @@ void VulkanSwapchain::lazyAllocateDepthBuffer() const {
                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                                                   0,
                                                   VK_SAMPLE_COUNT_1_BIT,
-                                                  "Image: swapchain depth");
+                                                  "Image: swapchain depth",
+                                                  &result);
+  if (!IGL_VERIFY(depthImage->valid())) {
+    IGL_LOG_ERROR("Cannot create swapchain depth image: %s\n", result.message.c_str());
+    return;
+  }
   auto depthImageView = depthImage->createImageView(
       VK_IMAGE_VIEW_TYPE_2D, depthFormat, aspectMask, 0, 1, 0, 1, "Image View: swapchain depth");
 